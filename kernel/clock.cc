@@ -2,10 +2,12 @@
 // George F. Riley, (and others) Georgia Tech, Fall 2010
 
 #include <list>
+#include <sstream>
 #include <cstdlib>
 
 #include "clock.h"
 #include "manifold.h"
+#include "stat_report.h"
 
 using namespace std;
 
@@ -15,6 +17,8 @@ namespace kernel {
 // Map of all clocks
 Clock::ClockVec_t* Clock::clocks = 0;
 
+Tick_pool* Clock::tickPool = 0;
+
 Clock::Clock(double f) : period(1/f), freq(f), nextRising(true), nextTick(0),
                          calendar(CLOCK_CALENDAR_LENGTH, EventVec_t())
 {
@@ -26,6 +30,9 @@ Clock::Clock(double f) : period(1/f), freq(f), nextRising(true), nextTick(0),
   clocks->push_back(this);
 
     stats = new Clock_stat_engine();
+    std::ostringstream name;
+    name << "clock" << clocks->size() - 1;
+    Stat_report :: Register(name.str(), stats);
 }
 
 Clock::~Clock()
@@ -35,33 +42,75 @@ Clock::~Clock()
 
 void Clock::Rising()
 { // Call rising edge function on all registered objects
-  list<tickObjBase*>::iterator iter;
-  for(iter=tickObjs.begin(); iter!=tickObjs.end(); iter++)
+  StepHandlers(true);
+}
+
+void Clock::Falling()
+{ // Call falling edge function on all registered objects
+  StepHandlers(false);
+}
+
+void Clock::StepHandlers(bool rising)
+{
+  list<tickObjBase*>::iterator iter = tickObjs.begin();
+  while (iter != tickObjs.end())
     {
       tickObjBase* to = *iter;
+      if (tickPool && to->parallel)
+        {
+          iter = StepBatch(iter, rising);
+          continue;
+        }
       if (to->enabled) {
-        to->CallRisingTick();
+        Profiler::CallTick(to, rising);
 	#ifdef STATS
-	stats->registered_events++;
+	if (rising)
+	  stats->registered_events++;
 	#endif
       }
+      ++iter;
     }
 }
 
-void Clock::Falling()
-{ // Call falling edge function on all registered objects
-  list<tickObjBase*>::iterator iter;
-  for(iter=tickObjs.begin(); iter!=tickObjs.end(); iter++)
+list<tickObjBase*>::iterator Clock::StepBatch(list<tickObjBase*>::iterator iter, bool rising)
+{
+  batch.clear();
+  for (; iter != tickObjs.end() && (*iter)->parallel; ++iter)
     {
-      tickObjBase* to = *iter;
-      if (to->enabled) {
-        to->CallFallingTick();
-      }
+      if ((*iter)->enabled)
+        batch.push_back(*iter);
+    }
+
+  if (batch.size() > 1)
+    tickPool->step(batch, rising);
+  else if (batch.size() == 1)
+    { // nothing to overlap with; step it here, without deferring anything
+      Profiler::CallTick(batch[0], rising);
+    }
+
+  // Carry out what the handlers deferred, in registration order
+  for (size_t i = 0; i < batch.size(); ++i)
+    {
+      DeferredActionVec_t& actions = batch[i]->deferred;
+      for (size_t j = 0; j < actions.size(); ++j)
+        {
+          actions[j]->Run();
+          delete actions[j];
+        }
+      actions.clear();
     }
+
+  #ifdef STATS
+  if (rising)
+    stats->registered_events += batch.size();
+  #endif
+  return iter;
 }
 
 TickEventId Clock::Insert(TickEventBase* ev)
 {
+  // handlers stepped in parallel may only schedule through links
+  assert(Deferred_actions() == 0);
   Ticks_t when = nextTick + ev->time;
   // First make sure it's in range for the calendar queue
   if (ev->time >= CLOCK_CALENDAR_LENGTH)
@@ -139,7 +188,7 @@ void Clock::ProcessThisTick()
           if (ev->time > thisTick) break; // Not time for this event
           assert(ev->time==thisTick);
           // Process the event
-          ev->CallHandler();
+          Profiler::CallHandler(ev, Profile_site::TICK_EVENT);
           // Delete the event
           delete ev;
           // Remove from queue
@@ -164,7 +213,7 @@ void Clock::ProcessThisTick()
       if (ev->rising && !nextRising) continue;
       assert(ev->time==nextTick);
       // Process the event
-      ev->CallHandler();
+      Profiler::CallHandler(ev, Profile_site::TICK_EVENT);
 
       #ifdef STATS
       if(nextRising)
@@ -230,6 +279,14 @@ Ticks_t Clock::NowHalf(Clock& c)
   return c.NowHalfTicks();
 }
 
+void Clock::SetTickThreads(unsigned n)
+{
+  delete tickPool;
+  tickPool = 0;
+  if (n > 1)
+    tickPool = new Tick_pool(n);
+}
+
 Clock::ClockVec_t& Clock::GetClocks()
 {
   if (!clocks)
@@ -334,6 +391,14 @@ void Clock_stat_engine::print_stats (ostream & out)
     registered_events.print(out);
 }
 
+void Clock_stat_engine::report_stats(Stat_report & r)
+{
+    r.add(queued_events);
+    r.add(rising_calendar_events);
+    r.add(falling_calendar_events);
+    r.add(registered_events);
+}
+
 void Clock_stat_engine::clear_stats()
 {
     queued_events.clear();
@@ -15,6 +15,8 @@
 
 #include "common-defs.h"
 #include "manifold-decl.h"
+#include "tick_pool.h"
+#include "profiler.h"
 
 namespace manifold {
 namespace kernel {
@@ -26,7 +28,7 @@ class tickObjBase
  public:
 
  //! By default tick handlers are enabled
- tickObjBase() : enabled(true) {}
+ tickObjBase() : enabled(true), parallel(false) {}
 
  //! Virtual rising tick handler
  virtual void CallRisingTick() = 0;
@@ -34,13 +36,25 @@ class tickObjBase
  //! Virtual falling tick handler
  virtual void CallFallingTick() = 0;
 
+ //! Tells the profiler which handler is called on which object.
+ virtual void GetProfileSite(Profile_site& s, bool rising) const = 0;
+
  //! Enables tick handlers
  void         Enable() {enabled = true;}
 
  //! Disables tick handlers.
  void         Disable() {enabled = false;}
 
+ //! Allows the handlers to be stepped in parallel with adjacent parallel
+ //! handlers of the same clock; see Clock::SetTickThreads().
+ void         SetParallel(bool p) {parallel = p;}
+
  bool         enabled;
+
+ bool         parallel;
+
+ //! Actions deferred while the handler was stepped in parallel
+ DeferredActionVec_t deferred;
 };
 
 
@@ -78,6 +92,15 @@ class tickObj : public tickObjBase {
       }
   }
 
+ //! Tells the profiler which handler is called on which object.
+ void GetProfileSite(Profile_site& s, bool rising) const
+  {
+    if (rising)
+      s.Set(obj, risingFunct);
+    else
+      s.Set(obj, fallingFunct);
+  }
+
  //! Object registered with clock.
  OBJ* obj;
 
@@ -177,6 +200,19 @@ class Clock
   //! Returns the vector of clock objects
   static ClockVec_t& GetClocks();
 
+  /** Sets the number of threads used to step parallel tick handlers.
+   *  Consecutively registered handlers marked with SetParallel() are
+   *  stepped as one batch spread over the threads. A handler in such a
+   *  batch may only affect the rest of the simulation by sending on its
+   *  links or calling Manifold::Terminate(); both are recorded and
+   *  carried out after the batch, handler by handler in registration
+   *  order, so events are scheduled exactly as in a sequential step.
+   *  The one difference is that a termination takes effect after the
+   *  whole batch has been stepped rather than right after its handler.
+   *  @arg \c n Number of threads; 0 or 1 steps all handlers sequentially.
+   */
+  static void SetTickThreads(unsigned n);
+
   /** Register an object with the specified clock object
    *  Uses "master" clock
    * @arg \c obj A pointer to the component to register with the clock.
@@ -258,6 +294,16 @@ private:
   //! Called at early termination. Disables all registered components.
   void disableAll();
 
+  //! Calls the rising or falling handlers of all registered objects.
+  void StepHandlers(bool rising);
+
+  //! Steps the run of parallel handlers starting at iter as one batch.
+  //! @return The first handler after the run.
+  std::list<tickObjBase*>::iterator StepBatch(std::list<tickObjBase*>::iterator iter, bool rising);
+
+  //! Enabled handlers of the batch being stepped
+  std::vector<tickObjBase*> batch;
+
   //! Stores the actual calendar queue
   EventVecVec_t calendar;
 
@@ -273,6 +319,9 @@ private:
   //! Stores the vector of clock objects
   static ClockVec_t* clocks;
 
+  //! Threads stepping parallel handlers; 0 if they are stepped sequentially
+  static Tick_pool* tickPool;
+
   Clock_stat_engine* stats;
 
 };
@@ -289,6 +338,7 @@ class Clock_stat_engine : public Stat_engine
 
         void global_stat_merge(Stat_engine *);
         void print_stats(std::ostream & out);
+        void report_stats(Stat_report & r);
         void clear_stats();
 
         void start_warmup();
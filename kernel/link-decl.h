@@ -15,6 +15,7 @@
 
 #include "common-defs.h"
 #include "serialize.h"
+#include "tick_pool.h"
 
 
 namespace manifold {
@@ -22,6 +23,8 @@ namespace kernel {
 
 class Clock;
 
+template <typename T> class DeferredSend;
+
 /** Base class for objects keeping track of link arrival handlers.
  */
 template <typename T>
@@ -49,12 +52,20 @@ public:
     //! @arg \c t The actual data to send by the link
     void    Send(const T& t)
     {
+        if (DeferredActionVec_t* d = Deferred_actions()) {
+            d->push_back(new DeferredSend<T>(this, t, DeferredSend<T>::SEND, 0, 0));
+            return;
+        }
         data = t;
         ScheduleRxEvent();
     }
 
     void    SendTick(const T& t, Ticks_t delay)
     {
+        if (DeferredActionVec_t* d = Deferred_actions()) {
+            d->push_back(new DeferredSend<T>(this, t, DeferredSend<T>::SEND_TICK, delay, 0));
+            return;
+        }
 	data = t;
 	Ticks_t default_latency = latency;
 	latency = delay;
@@ -64,6 +75,10 @@ public:
 
     void SendTime(const T& t, Time_t delay)
     {
+        if (DeferredActionVec_t* d = Deferred_actions()) {
+            d->push_back(new DeferredSend<T>(this, t, DeferredSend<T>::SEND_TIME, 0, delay));
+            return;
+        }
 	data = t;
 	Time_t default_latency = timeLatency;
 	timeLatency+=delay;
@@ -96,6 +111,42 @@ public:
 };
 
 
+/** A send on a link output recorded while the sender was stepped in
+ *  parallel; see Clock::SetTickThreads().
+ */
+template <typename T>
+class DeferredSend : public DeferredAction
+{
+public:
+    enum { SEND, SEND_TICK, SEND_TIME };
+
+    DeferredSend(LinkOutputBase<T>* o, const T& t, int k, Ticks_t ticks, Time_t time)
+      : output(o), data(t), kind(k), tickDelay(ticks), timeDelay(time) {}
+
+    void Run()
+    {
+        switch (kind) {
+            case SEND:
+                output->Send(data);
+                break;
+            case SEND_TICK:
+                output->SendTick(data, tickDelay);
+                break;
+            case SEND_TIME:
+                output->SendTime(data, timeDelay);
+                break;
+        }
+    }
+
+private:
+    LinkOutputBase<T>* output;
+    T       data;
+    int     kind;
+    Ticks_t tickDelay;
+    Time_t  timeDelay;
+};
+
+
 template <typename T1> class Link;
 
 /** LinkOutput class subclasses LinkOutputBase, templated
@@ -1,6 +1,7 @@
 #ifndef MANIFOLD_KERNEL_MANIFOLD_EVENT_H
 #define MANIFOLD_KERNEL_MANIFOLD_EVENT_H
 #include "common-defs.h"
+#include "profiler.h"
 
 namespace manifold {
 namespace kernel {
@@ -31,6 +32,10 @@ class TickEventBase
   /** Virtual function, all subclasses must implement CallHandler
    */
   virtual void CallHandler() = 0;
+
+  /** Tells the profiler what CallHandler calls.
+   */
+  virtual void GetProfileSite(Profile_site& s) const { s.type = &typeid(*this); }
   
  public:
  
@@ -112,6 +117,10 @@ public:
   /** Calls the callback function when the event is processed.
    */
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T, typename OBJ>
@@ -155,6 +164,10 @@ public:
   /** Calls the callback function when the event is processed.
    */
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T, typename OBJ, typename U1, typename T1>
@@ -205,6 +218,10 @@ public:
   /** Calls the callback function when the event is processed.
    */
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T, typename OBJ, 
@@ -262,6 +279,10 @@ public:
    /** Calls the callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T,  typename OBJ,
@@ -325,6 +346,10 @@ public:
    /** Calls the callback function when the event is processed.
     */  
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T,  typename OBJ,
@@ -365,6 +390,10 @@ public:
   /** Calls the static callback function when the event is processed.
    */  
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 /** TickEvent1Stat subclasses TickEventBase, it defines a 
@@ -398,6 +427,10 @@ public:
   /** Calls the static callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1>
@@ -443,6 +476,10 @@ public:
   /** Calls the static callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1,
@@ -494,6 +531,10 @@ public:
    /** Calls the static callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1,
@@ -552,6 +593,10 @@ public:
    /** Calls the static callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1,
@@ -584,6 +629,10 @@ class EventBase
   /** Virtual function, all subclasses must implement CallHandler
    */   
   virtual void CallHandler() = 0;
+
+  /** Tells the profiler what CallHandler calls.
+   */
+  virtual void GetProfileSite(Profile_site& s) const { s.type = &typeid(*this); }
   
  public:
  
@@ -649,6 +698,10 @@ public:
   /** Calls the callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T, typename OBJ>
@@ -691,6 +744,10 @@ public:
   /** Calls the callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T, typename OBJ, typename U1, typename T1>
@@ -740,6 +797,10 @@ public:
   /** Calls the callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T, typename OBJ, 
@@ -796,6 +857,10 @@ public:
    /** Calls the callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T,  typename OBJ,
@@ -858,6 +923,10 @@ public:
    /** Calls the callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.Set(obj, handler); }
 };
 
 template <typename T,  typename OBJ,
@@ -896,6 +965,10 @@ public:
   /** Calls the callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 /** Event1Stat subclasses EventBase, it defines a 
@@ -928,6 +1001,10 @@ public:
   /** Calls the callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1>
@@ -972,6 +1049,10 @@ public:
   /** Calls the callback function when the event is processed.
    */ 
   void CallHandler();
+
+  /** Identifies the callback for the profiler.
+   */
+  void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1,
@@ -1022,6 +1103,10 @@ public:
    /** Calls the callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1,
@@ -1079,6 +1164,10 @@ public:
    /** Calls the callback function when the event is processed.
     */ 
    void CallHandler();
+
+   /** Identifies the callback for the profiler.
+    */
+   void GetProfileSite(Profile_site& s) const { s.SetStatic(handler); }
 };
 
 template <typename U1, typename T1,
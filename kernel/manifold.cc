@@ -9,6 +9,9 @@
 #include "messenger.h"
 #endif
 #include "clock.h"
+#include "stat_report.h"
+#include "stat_sampler.h"
+#include "sync_telemetry.h"
 
 namespace manifold {
 namespace kernel {
@@ -101,6 +104,17 @@ void Manifold::Init(SchedulerType t)
   if(TheScheduler)
       return;  //scheduler already created
 
+  if(const char* prefix = getenv("MANIFOLD_PROFILE"))
+      Profiler :: Enable(prefix);
+
+  if(const char* prefix = getenv("MANIFOLD_STATS"))
+      Stat_report :: Enable(prefix);
+
+  if(const char* prefix = getenv("MANIFOLD_SAMPLE")) {
+      const char* interval = getenv("MANIFOLD_SAMPLE_INTERVAL");
+      Stat_sampler :: Enable(prefix, interval ? strtoull(interval, 0, 10) : 100000);
+  }
+
   switch(t) {
       case TICKED:
 	  TheScheduler = new Seq_TickedScheduler();
@@ -125,6 +139,22 @@ void Manifold::Init(int argc, char** argv, SchedulerType t,SyncAlg::SyncAlgType_
 
   TheMessenger.init(argc, argv);
 
+  if(const char* prefix = getenv("MANIFOLD_PROFILE"))
+      Profiler :: Enable(prefix);
+
+  if(const char* prefix = getenv("MANIFOLD_STATS"))
+      Stat_report :: Enable(prefix);
+
+  if(const char* prefix = getenv("MANIFOLD_SAMPLE")) {
+      const char* interval = getenv("MANIFOLD_SAMPLE_INTERVAL");
+      Stat_sampler :: Enable(prefix, interval ? strtoull(interval, 0, 10) : 100000);
+  }
+
+  if(const char* prefix = getenv("MANIFOLD_SYNC_LOG")) {
+      const char* width = getenv("MANIFOLD_SYNC_BUCKET");
+      Sync_telemetry :: Enable(prefix, width ? atof(width) : 1e-6);
+  }
+
   if(TheMessenger.get_node_size() == 1) {
       switch(t) {
 	  case TICKED:
@@ -202,6 +232,11 @@ void Manifold::Init(int argc, char** argv, SchedulerType t,SyncAlg::SyncAlgType_
 //====================================================================
 void Manifold::Finalize()
 {
+  Clock :: SetTickThreads(0);
+  Stat_sampler :: Stop();
+  Profiler :: Report();
+  Stat_report :: Write();
+  Sync_telemetry :: Close();
 #ifndef NO_MPI
   TheMessenger.finalize();
 #endif
@@ -212,16 +247,30 @@ void Manifold::Finalize()
 //====================================================================
 void Manifold::Run()
 {
+    Stat_sampler :: Start();
+    uint64_t start = Sync_telemetry :: WallNow();
     TheScheduler->Run();
+    TheScheduler->add_run_time(Sync_telemetry :: WallNow() - start);
 }
 
 
 //====================================================================
 //Terminate the simulation. In a parallel simulation, this means all
-//processes should terminate.
+//processes should terminate. If called from a tick handler stepped in
+//parallel, termination is deferred until the handler's batch is done.
 //====================================================================
+class DeferredTerminate : public DeferredAction {
+public:
+    void Run() { Manifold :: Terminate(); }
+};
+
 void Manifold :: Terminate()
 {
+    if(DeferredActionVec_t* d = Deferred_actions()) {
+        d->push_back(new DeferredTerminate);
+        return;
+    }
+
     vector<Clock*> clocks = Clock :: GetClocks();
     for(int i=0; i<clocks.size(); i++) {
         clocks[i]->terminate();
@@ -6,6 +6,7 @@
 #include <assert.h>
 
 #include "messenger.h"
+#include "sync_telemetry.h"
 
 using namespace std;
 
@@ -143,6 +144,32 @@ void Messenger :: allGather(char* item, int itemSize, char* recvbuf)
                   itemSize, MPI_BYTE, MPI_COMM_WORLD);
 }
 
+//====================================================================
+//! Gather items of different sizes at root.
+//! @param item   address of the data to send
+//! @param itemSize    size of the data in terms of bytes
+//! @param array    on root, the items of all nodes in order of node id
+//! @param sizes    on root, the size of the item of each node
+//! @param root    node id of the root
+//====================================================================
+void Messenger :: gather(char* item, int itemSize, std::vector<char>& array, std::vector<int>& sizes, int root)
+{
+    sizes.resize(m_nodeSize);
+    MPI_Gather(&itemSize, 1, MPI_INT, &sizes[0], 1, MPI_INT, root, MPI_COMM_WORLD);
+
+    std::vector<int> displs(m_nodeSize, 0);
+    int total = 0;
+    if(m_nodeId == root) {
+	for(int i=0; i<m_nodeSize; i++) {
+	    displs[i] = total;
+	    total += sizes[i];
+	}
+    }
+    array.resize(total);
+    MPI_Gatherv(item, itemSize, MPI_BYTE, total ? &array[0] : 0, &sizes[0], &displs[0],
+                MPI_BYTE, root, MPI_COMM_WORLD);
+}
+
 
 //====================================================================
 //====================================================================
@@ -556,6 +583,7 @@ NullMsg_t* Messenger::RecvPendingNullMsg()
     {
       msg=*it;
       nullMsgQueue.erase(it);
+      Sync_telemetry :: NullReceived(1);
       return &msg;
     }
   }
@@ -564,7 +592,10 @@ NullMsg_t* Messenger::RecvPendingNullMsg()
   while(MPI::COMM_WORLD.Iprobe(MPI::ANY_SOURCE, TAG_NULLMSG))
   {
     MPI::COMM_WORLD.Recv(&msg, sizeof(msg), MPI::BYTE, MPI::ANY_SOURCE, TAG_NULLMSG);
-    if(msg.txCnt<=m_rxcount[msg.src]) return &msg;
+    if(msg.txCnt<=m_rxcount[msg.src]) {
+      Sync_telemetry :: NullReceived(1);
+      return &msg;
+    }
     else nullMsgQueue.push_back(msg);
   }
 
@@ -575,6 +606,7 @@ void Messenger::SendNullMsg(NullMsg_t* msg)
 {
   msg->txCnt=m_txcount[msg->dst];
   MPI::COMM_WORLD.Send(msg, sizeof(NullMsg_t), MPI::BYTE, msg->dst, TAG_NULLMSG);
+  Sync_telemetry :: NullSent(1);
 }
 
 
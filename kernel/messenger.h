@@ -6,6 +6,7 @@
 #define KERNEL_ANY_DATA_SIZE
 
 #include <stdint.h>
+#include <vector>
 
 #include "message.h"
 #include "mpi.h"
@@ -46,6 +47,9 @@ public:
     //! Perform an AllGather.
     void allGather(char* item, int itemSize, char* array);
 
+    //! Gather items of different sizes at root.
+    void gather(char* item, int itemSize, std::vector<char>& array, std::vector<int>& sizes, int root);
+
     void send_uint32_msg(int dest, int compIndex, int inputIndex,
                          Ticks_t sendTick, Ticks_t recvTick, uint32_t data);
 
@@ -0,0 +1,275 @@
+// Implementation of the kernel profiler
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <stdlib.h>
+#include <stdio.h>
+#include <cxxabi.h>
+#include <execinfo.h>
+
+#include "profiler.h"
+#include "component-decl.h"
+#include "manifold.h"
+
+using namespace std;
+
+namespace manifold {
+namespace kernel {
+
+bool Profiler::enabled = false;
+string Profiler::prefix;
+uint64_t Profiler::startTime = 0;
+pthread_mutex_t Profiler::tablesLock = PTHREAD_MUTEX_INITIALIZER;
+vector<Profiler::Table*> Profiler::tables;
+
+//Table of the calling thread
+static __thread void* Thread_table = 0;
+
+
+CompId_t Profile_comp_id(const Component* c)
+{
+    return c->getComponentId();
+}
+
+
+void Profiler :: Enable(const char* p)
+{
+    prefix = p;
+    startTime = Now();
+    enabled = true;
+}
+
+
+Profiler::Table :: Table() : entries(256), used(0)
+{
+    for (size_t i = 0; i < entries.size(); i++)
+        entries[i].calls = 0;
+}
+
+
+static inline size_t Site_hash(const Profile_site& s)
+{
+    uint64_t h = (uint64_t)s.fn * 0x9e3779b97f4a7c15ULL;
+    h ^= (uint64_t)(uintptr_t)s.obj * 0xc2b2ae3d27d4eb4fULL;
+    h ^= s.kind;
+    return (size_t)(h ^ (h >> 29));
+}
+
+
+//! Returns the entry of s, adding it if needed.
+Profiler::Entry* Profiler::Table :: Find(const Profile_site& s)
+{
+    size_t mask = entries.size() - 1;
+    size_t i = Site_hash(s) & mask;
+    while (entries[i].calls != 0) {
+        if (entries[i].site == s)
+            return &entries[i];
+        i = (i + 1) & mask;
+    }
+
+    // keep the table at most half full
+    if ((used + 1) * 2 > entries.size()) {
+        Grow();
+        return Find(s);
+    }
+    used++;
+    entries[i].site = s;
+    entries[i].cycles = 0;
+    return &entries[i];
+}
+
+
+void Profiler::Table :: Grow()
+{
+    vector<Entry> old;
+    old.swap(entries);
+    entries.resize(old.size() * 2);
+    for (size_t i = 0; i < entries.size(); i++)
+        entries[i].calls = 0;
+
+    size_t mask = entries.size() - 1;
+    for (size_t j = 0; j < old.size(); j++) {
+        if (old[j].calls == 0)
+            continue;
+        size_t i = Site_hash(old[j].site) & mask;
+        while (entries[i].calls != 0)
+            i = (i + 1) & mask;
+        entries[i] = old[j];
+    }
+}
+
+
+Profiler::Table* Profiler :: ThreadTable()
+{
+    if (Thread_table == 0) {
+        Table* t = new Table;
+        pthread_mutex_lock(&tablesLock);
+        tables.push_back(t);
+        pthread_mutex_unlock(&tablesLock);
+        Thread_table = t;
+    }
+    return (Table*)Thread_table;
+}
+
+
+void Profiler :: Record(const Profile_site& s, uint64_t cycles)
+{
+    Entry* e = ThreadTable()->Find(s);
+    e->calls++;
+    e->cycles += cycles;
+}
+
+
+static string Demangle(const char* name)
+{
+    int status;
+    char* d = abi::__cxa_demangle(name, 0, 0, &status);
+    if (status != 0)
+        return name;
+    string r = d;
+    free(d);
+    return r;
+}
+
+
+//! Name of the function at fn, if the executable exports its symbols
+//! (-rdynamic), else its address.
+static string Function_name(uintptr_t fn)
+{
+    ostringstream addr;
+    if (fn & 1) { // Itanium ABI: pointer to a virtual member function
+        addr << "virtual+" << (fn - 1);
+        return addr.str();
+    }
+    addr << "0x" << hex << fn;
+
+    void* p = (void*)fn;
+    char** syms = backtrace_symbols(&p, 1);
+    if (syms == 0)
+        return addr.str();
+
+    // "binary(symbol+0x10) [0x...]"
+    string sym = syms[0];
+    free(syms);
+    size_t open = sym.find('(');
+    size_t plus = sym.find_first_of("+)", open);
+    if (open == string::npos || plus == string::npos || plus == open + 1)
+        return addr.str();
+    return Demangle(sym.substr(open + 1, plus - open - 1).c_str());
+}
+
+
+static const char* Kind_name(Profile_site::Kind k)
+{
+    switch (k) {
+        case Profile_site::RISING_TICK: return "rising";
+        case Profile_site::FALLING_TICK: return "falling";
+        case Profile_site::TICK_EVENT: return "tick_event";
+        case Profile_site::TIMED_EVENT: return "timed_event";
+    }
+    return "unknown";
+}
+
+
+//! Quotes a CSV field; names of templates contain commas.
+static string Csv_quote(const string& s)
+{
+    string r = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"')
+            r += '"';
+        r += s[i];
+    }
+    return r + "\"";
+}
+
+
+void Profiler :: Report()
+{
+    if (prefix.empty())
+        return;
+    uint64_t elapsed = Now() - startTime;
+    bool was_enabled = enabled;
+    enabled = false;
+
+    // Merge the tables of all threads; the same object and handler may have
+    // run on several of them.
+    struct Row { Profile_site site; uint64_t calls; uint64_t cycles; };
+    map<string, Row> rows; // by flame graph stack
+    map<uintptr_t, string> fn_names;
+
+    pthread_mutex_lock(&tablesLock);
+    for (size_t t = 0; t < tables.size(); t++) {
+        vector<Entry>& entries = tables[t]->entries;
+        for (size_t i = 0; i < entries.size(); i++) {
+            Entry& e = entries[i];
+            if (e.calls == 0)
+                continue;
+
+            const Profile_site& s = e.site;
+            string type = s.type ? Demangle(s.type->name()) : "static";
+            ostringstream obj;
+            obj << type;
+            if (s.comp >= 0)
+                obj << "[" << s.comp << "]";
+            else if (s.obj)
+                obj << "@" << s.obj;
+
+            map<uintptr_t, string>::iterator fn = fn_names.find(s.fn);
+            if (fn == fn_names.end())
+                fn = fn_names.insert(make_pair(s.fn, Function_name(s.fn))).first;
+
+            string stack = string(Kind_name(s.kind)) + ";" + obj.str() + ";" + fn->second;
+            map<string, Row>::iterator r = rows.find(stack);
+            if (r == rows.end()) {
+                Row row = { s, e.calls, e.cycles };
+                rows.insert(make_pair(stack, row));
+            }
+            else {
+                r->second.calls += e.calls;
+                r->second.cycles += e.cycles;
+            }
+            e.calls = 0;
+        }
+        tables[t]->used = 0;
+    }
+    pthread_mutex_unlock(&tablesLock);
+
+    LpId_t lp = Manifold::GetRank();
+    ostringstream base;
+    base << prefix << ".lp" << lp;
+
+    string folded_name = base.str() + ".folded";
+    ofstream folded(folded_name.c_str());
+    string csv_name = base.str() + ".csv";
+    ofstream csv(csv_name.c_str());
+    if (!folded || !csv) {
+        cerr << "Profiler: cannot write " << base.str() << ".*" << endl;
+        return;
+    }
+
+    // share: fraction of the wall time of the LP since profiling started;
+    // handlers stepped in parallel can add up to more than 1.
+    csv << "lp,kind,comp_id,object,handler,calls,cycles,avg_cycles,share\n";
+    for (map<string, Row>::iterator it = rows.begin(); it != rows.end(); ++it) {
+        const Row& r = it->second;
+        folded << "lp" << lp << ";" << it->first << " " << r.cycles << "\n";
+
+        size_t first = it->first.find(';');
+        size_t second = it->first.find(';', first + 1);
+        csv << lp << "," << Kind_name(r.site.kind) << "," << r.site.comp << ","
+            << Csv_quote(it->first.substr(first + 1, second - first - 1)) << ","
+            << Csv_quote(it->first.substr(second + 1)) << ","
+            << r.calls << "," << r.cycles << "," << r.cycles / r.calls << ","
+            << (elapsed ? (double)r.cycles / elapsed : 0) << "\n";
+    }
+
+    startTime = Now();
+    enabled = was_enabled;
+}
+
+
+} //namespace kernel
+} //namespace manifold
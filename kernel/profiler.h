@@ -0,0 +1,199 @@
+/** @file profiler.h
+ *  Opt-in profiler that attributes the time spent in tick handlers and
+ *  events to the component and handler that ran.
+ */
+
+#ifndef MANIFOLD_KERNEL_PROFILER_H
+#define MANIFOLD_KERNEL_PROFILER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include <pthread.h>
+
+#include "common-defs.h"
+
+namespace manifold {
+namespace kernel {
+
+class Component;
+
+//! Component id of the object a handler is called on, or -1 if it is not a
+//! component.
+CompId_t Profile_comp_id(const Component* c);
+inline CompId_t Profile_comp_id(const void*) { return -1; }
+
+
+/** What is called: the type of the object, the object itself and the
+ *  function. Filled in by the event and tick objects, only when profiling.
+ */
+struct Profile_site
+{
+  enum Kind { RISING_TICK, FALLING_TICK, TICK_EVENT, TIMED_EVENT };
+
+  Profile_site() : type(0), obj(0), fn(0), comp(-1), kind(TICK_EVENT) {}
+
+  //! Member function called on obj.
+  template <typename OBJ, typename F>
+  void Set(OBJ* o, F f)
+  {
+    type = &typeid(OBJ);
+    obj = o;
+    comp = Profile_comp_id(o);
+    SetFn(f);
+  }
+
+  //! Static function.
+  template <typename F>
+  void SetStatic(F f)
+  {
+    type = 0;
+    obj = 0;
+    comp = -1;
+    SetFn(f);
+  }
+
+  //! Keeps the first word of a function or member function pointer: the
+  //! address of a non-virtual function, or the vtable offset of a virtual one.
+  template <typename F>
+  void SetFn(F f)
+  {
+    fn = 0;
+    memcpy(&fn, &f, sizeof(f) < sizeof(fn) ? sizeof(f) : sizeof(fn));
+  }
+
+  bool operator==(const Profile_site& s) const
+  {
+    return fn == s.fn && obj == s.obj && kind == s.kind && type == s.type;
+  }
+
+  const std::type_info* type;
+  const void* obj;
+  uintptr_t fn;
+  CompId_t comp;
+  Kind kind;
+};
+
+
+/** Times every tick handler and event the kernel calls with the time stamp
+ *  counter, and adds the cycles up per handler and object. Each thread keeps
+ *  its own table, so the threads of a Tick_pool never contend; the tables are
+ *  only merged for the report. When profiling is off, each call costs one
+ *  test of a flag.
+ *
+ *  Profiling is turned on by Enable(), or by setting MANIFOLD_PROFILE to the
+ *  report prefix before Manifold::Init(); the report is then written by
+ *  Manifold::Finalize(). Each LP writes <prefix>.lp<N>.folded, which
+ *  flamegraph.pl reads directly (lp;kind;component;handler cycles), and
+ *  <prefix>.lp<N>.csv with the call counts.
+ */
+class Profiler
+{
+ public:
+  //! Starts profiling; the report is written to files starting with prefix.
+  static void Enable(const char* prefix);
+
+  //! Stops profiling, leaving the results in place for Report().
+  static void Disable() { enabled = false; }
+
+  static bool IsEnabled() { return enabled; }
+
+  //! Writes the report of this LP, if profiling was enabled, and clears the
+  //! results.
+  static void Report();
+
+  //! Time stamp counter
+  static inline uint64_t Now()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+  }
+
+  //! Calls the handler of a tick or timed event, timing it if enabled.
+  template <typename EV>
+  static inline void CallHandler(EV* ev, Profile_site::Kind kind)
+  {
+    if (__builtin_expect(!enabled, 1)) {
+      ev->CallHandler();
+      return;
+    }
+    uint64_t start = Now();
+    ev->CallHandler();
+    uint64_t cycles = Now() - start;
+
+    Profile_site s;
+    ev->GetProfileSite(s);
+    s.kind = kind;
+    Record(s, cycles);
+  }
+
+  //! Calls the rising or falling handler of a tick object, timing it if
+  //! enabled.
+  template <typename TO>
+  static inline void CallTick(TO* to, bool rising)
+  {
+    if (__builtin_expect(!enabled, 1)) {
+      if (rising)
+        to->CallRisingTick();
+      else
+        to->CallFallingTick();
+      return;
+    }
+    uint64_t start = Now();
+    if (rising)
+      to->CallRisingTick();
+    else
+      to->CallFallingTick();
+    uint64_t cycles = Now() - start;
+
+    Profile_site s;
+    to->GetProfileSite(s, rising);
+    s.kind = rising ? Profile_site::RISING_TICK : Profile_site::FALLING_TICK;
+    Record(s, cycles);
+  }
+
+ private:
+  struct Entry
+  {
+    Profile_site site;
+    uint64_t calls;
+    uint64_t cycles;
+  };
+
+  //! Open addressing table of one thread
+  struct Table
+  {
+    Table();
+    Entry* Find(const Profile_site& s);
+    void Grow();
+
+    std::vector<Entry> entries; // size is a power of 2; unused if calls == 0
+    size_t used;
+  };
+
+  static void Record(const Profile_site& s, uint64_t cycles);
+  static Table* ThreadTable();
+
+  static bool enabled;
+  static std::string prefix;
+  static uint64_t startTime; //time stamp when enabled
+
+  static pthread_mutex_t tablesLock; //protects tables
+  static std::vector<Table*> tables; //one per thread that recorded anything
+};
+
+
+} //namespace kernel
+} //namespace manifold
+
+#endif //MANIFOLD_KERNEL_PROFILER_H
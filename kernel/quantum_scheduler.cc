@@ -2,6 +2,7 @@
 #include "quantum_scheduler.h"
 #include "component.h"
 #include "clock.h"
+#include "sync_telemetry.h"
 
 #include <cstring>
 #include <stdlib.h>
@@ -430,6 +431,8 @@ void Quantum_Scheduler::Run()
 	        break;
         }
         else {
+	    uint64_t wait_start = Sync_telemetry :: IsEnabled() ? Sync_telemetry :: WallNow() : 0;
+
 	    //enter barrier
 	    enterBarrier();
 
@@ -443,6 +446,9 @@ void Quantum_Scheduler::Run()
 
 	    next_barrier += m_init_quantum;
 	    TheMessenger.barrier();
+
+	    Sync_telemetry :: Synced();
+	    Sync_telemetry :: Wait(m_simTime, wait_start, m_init_quantum * Clock::Master().period);
         }
 
         quantum_handle_incoming_messages();
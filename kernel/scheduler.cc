@@ -3,13 +3,16 @@
 #include <iostream>
 
 #include "scheduler.h"
+#include "stat_report.h"
 #ifndef NO_MPI
 #include "messenger.h"
 #endif
 
 #include "clock.h"
 #include "component.h"
+#include "sync_telemetry.h"
 #include <sys/time.h>
+#include <sys/resource.h>
 
 using namespace std;
 
@@ -24,6 +27,7 @@ Scheduler :: Scheduler() : m_halted(false), m_simTime(0), m_terminate_initiated(
     m_syncAlg = 0;
     #endif
     stats = new Scheduler_stat_engine();
+    Stat_report :: Register("scheduler", stats);
 }
 
 
@@ -44,6 +48,12 @@ void Scheduler :: print_stats(ostream& out)
 }
 
 
+void Scheduler :: add_run_time(uint64_t ns)
+{
+    stats->run_ns += ns;
+}
+
+
 void Scheduler :: terminate()
 {
     m_halted = true;
@@ -257,7 +267,7 @@ void Seq_TimedScheduler::Run()
             assert(nextEvent->time>=m_simTime);
             m_simTime = nextEvent->time;
             // Call the event handler
-            nextEvent->CallHandler();
+            Profiler::CallHandler(nextEvent, Profile_site::TIMED_EVENT);
             // Remove the event from the pending list
             m_timedEvents.erase(m_timedEvents.begin());
             // And delete the event
@@ -291,7 +301,7 @@ void Seq_MixedScheduler::Run()
             }
             else { // Process timed event
                 // Call the event handler
-                nextEvent->CallHandler();
+                Profiler::CallHandler(nextEvent, Profile_site::TIMED_EVENT);
                 // Remove the event from the pending list
                 m_timedEvents.erase(m_timedEvents.begin());
                 // And delete the event
@@ -399,7 +409,7 @@ void LBTS_TimedScheduler::Run()
             assert(nextEvent->time>=m_simTime);
             m_simTime = nextEvent->time;
             // Call the event handler
-            nextEvent->CallHandler();
+            Profiler::CallHandler(nextEvent, Profile_site::TIMED_EVENT);
             // Remove the event from the pending list
             m_timedEvents.erase(m_timedEvents.begin());
             // And delete the event
@@ -460,7 +470,7 @@ void LBTS_MixedScheduler::Run()
             }
             else { // Process timed event
                 // Call the event handler
-                nextEvent->CallHandler();
+                Profiler::CallHandler(nextEvent, Profile_site::TIMED_EVENT);
                 // Remove the event from the pending list
                 m_timedEvents.erase(m_timedEvents.begin());
                 // And delete the event
@@ -770,7 +780,7 @@ void CMB_TimedScheduler::Run()
             assert(nextEvent->time>=m_simTime);
             m_simTime = nextEvent->time;
             // Call the event handler
-            nextEvent->CallHandler();
+            Profiler::CallHandler(nextEvent, Profile_site::TIMED_EVENT);
             // Remove the event from the pending list
             m_timedEvents.erase(m_timedEvents.begin());
             // And delete the event
@@ -832,7 +842,7 @@ void CMB_MixedScheduler::Run()
             }
             else { // Process timed event
                 // Call the event handler
-                nextEvent->CallHandler();
+                Profiler::CallHandler(nextEvent, Profile_site::TIMED_EVENT);
                 // Remove the event from the pending list
                 m_timedEvents.erase(m_timedEvents.begin());
                 // And delete the event
@@ -1031,7 +1041,7 @@ void CMB_TickedForecastScheduler::Run()
 
 
 
-Scheduler_stat_engine::Scheduler_stat_engine ()
+Scheduler_stat_engine::Scheduler_stat_engine () : run_ns(0)
 {
 }
 
@@ -1051,6 +1061,22 @@ void Scheduler_stat_engine::print_stats (ostream & out)
     #endif
 }
 
+void Scheduler_stat_engine::report_stats(Stat_report & r)
+{
+    #ifndef NO_MPI
+    r.add("messages sent", TheMessenger.get_numSent());
+    r.add("messages received", TheMessenger.get_numReceived());
+    #endif
+    r.add("run seconds", run_ns / 1e9);
+
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+        r.add("peak rss kb", ru.ru_maxrss); //kilobytes on Linux
+
+    if (Sync_telemetry :: IsEnabled())
+        r.add("sync blocked seconds", Sync_telemetry :: BlockedNs() / 1e9);
+}
+
 void Scheduler_stat_engine::clear_stats()
 {
 }
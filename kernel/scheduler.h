@@ -49,6 +49,9 @@ public:
 
     virtual void print_stats(std::ostream&);
 
+    //! Wall time spent in Run(), for the report of the run.
+    void add_run_time(uint64_t ns);
+
 
 #ifndef NO_MPI
     std::vector<LpId_t>& get_predecessors() { return predecessors; }
@@ -133,11 +136,14 @@ public:
 
     void global_stat_merge(Stat_engine *);
     void print_stats(std::ostream & out);
+    void report_stats(Stat_report & r);
     void clear_stats();
 
     void start_warmup();
     void end_warmup();
     void save_samples();
+
+    uint64_t run_ns; //wall time in Manifold::Run()
 };
 
 
@@ -3,10 +3,12 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <math.h>
 #include <cassert>
 #include <vector>
 #include <map>
+#include <string>
 
 namespace manifold {
 namespace kernel {
@@ -41,6 +43,22 @@ template<> inline bool data_ok<float>(float data)
     return false;
 }
 
+// values of a statistic in the form written to the stats report (see
+// stat_report.h)
+struct Stat_values {
+    enum Kind { SCALAR, ARRAY, HISTOGRAM };
+
+    Stat_values() : kind(SCALAR), sum(0), sq_sum(0), count(0) {}
+
+    Kind kind;
+    string name;
+    vector<string> labels; // array elements or lower bounds of histogram bins
+    vector<double> values;
+    double sum; // of the samples of a histogram
+    double sq_sum;
+    double count;
+};
+
 // virtual class from which all system statistics will derive
 // this guarantees all statistics will provide a name, description, and
 // a common interface
@@ -88,6 +106,7 @@ public:
     Persistent_stat& operator+=(T d);
     Persistent_stat& operator=(T d);
     T get_value();
+    void get_values(Stat_values & v);
     void clear();
 };
 
@@ -113,6 +132,7 @@ public:
 
     void collect(T * val);
     T& operator[](int index);
+    void get_values(Stat_values & v);
 };
 
 template<typename T>
@@ -159,6 +179,7 @@ public:
     void collect(T m);
     void clear();
     void merge(Persistent_histogram_stat<T> * hist);
+    void get_values(Stat_values & v);
     void print_statistics(ostream & out);
     double get_pop_std_dev();
     double get_average();
@@ -260,6 +281,14 @@ T Persistent_stat<T>::get_value()
     return value;
 }
 
+template<typename T>
+void Persistent_stat<T>::get_values(Stat_values & v)
+{
+    v.kind = Stat_values::SCALAR;
+    v.name = this->name;
+    v.values.assign(1, (double) value);
+}
+
 /*
  * Persistent_array_stat template class definition
  */
@@ -356,6 +385,28 @@ T& Persistent_array_stat<T>::operator[](int n)
     return array[n];
 }
 
+/* the name of an array stat is always "Persistent_array_stat"; report it
+ * by its description */
+template<typename T>
+void Persistent_array_stat<T>::get_values(Stat_values & v)
+{
+    v.kind = Stat_values::ARRAY;
+    v.name = this->desc;
+    v.labels.clear();
+    v.values.clear();
+    for (unsigned int i = 0; i < size; i++) {
+        if (elem_names.size()) {
+            v.labels.push_back(*elem_names[i]);
+        }
+        else {
+            ostringstream label;
+            label << i;
+            v.labels.push_back(label.str());
+        }
+        v.values.push_back((double) array[i]);
+    }
+}
+
 /*
  * Persistent_2D_stat template class definition
  */
@@ -515,6 +566,24 @@ void Persistent_histogram_stat<T>::merge(
     total += histogram->total;
 }
 
+template<typename T>
+void Persistent_histogram_stat<T>::get_values(Stat_values & v)
+{
+    v.kind = Stat_values::HISTOGRAM;
+    v.name = this->name;
+    v.labels.clear();
+    v.values.clear();
+    for (unsigned int i = 0; i < intervals; i++) {
+        ostringstream label;
+        label << start + (T)(i * width);
+        v.labels.push_back(label.str());
+        v.values.push_back((double) hist_slot[i]);
+    }
+    v.sum = cumm_sum;
+    v.sq_sum = cumm_sq_sum;
+    v.count = total;
+}
+
 template<typename T>
 void Persistent_histogram_stat<T>::collect(T m)
 {
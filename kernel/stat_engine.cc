@@ -1,4 +1,5 @@
 #include "stat_engine.h"
+#include "stat_report.h"
 
 namespace manifold {
 namespace kernel {
@@ -10,6 +11,7 @@ Stat_engine::Stat_engine()
 
 Stat_engine::~Stat_engine()
 {
+    Stat_report::Unregister(this);
 }
 
 } // namespace kernel
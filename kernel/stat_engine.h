@@ -8,6 +8,8 @@ using namespace std;
 namespace manifold {
 namespace kernel {
 
+class Stat_report;
+
 class Stat_engine {
 public:
     Stat_engine();
@@ -17,6 +19,10 @@ public:
     virtual void print_stats(ostream & out) = 0;
     virtual void clear_stats() = 0;
 
+    //! Adds the stats to the report of the run; engines that do not
+    //! override it are registered but left out.
+    virtual void report_stats(Stat_report &) {}
+
     //TODO remove start_warmup, end_warmup, save_samples, commit_stats, rollback_stats?
     virtual void start_warmup() = 0;
     virtual void end_warmup() = 0;
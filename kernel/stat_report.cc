@@ -0,0 +1,485 @@
+// Implementation of the stats report
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cxxabi.h>
+#include <typeinfo>
+
+#include "stat_report.h"
+#include "stat_engine.h"
+#include "manifold.h"
+#ifndef NO_MPI
+#include "messenger.h"
+#endif
+
+using namespace std;
+
+namespace manifold {
+namespace kernel {
+
+string Stat_report::prefix;
+vector<Stat_report::Entry>* Stat_report::engines = 0;
+
+
+void Stat_report :: Enable(const char* p)
+{
+    prefix = p;
+}
+
+
+void Stat_report :: Register(const string& name, Stat_engine* e)
+{
+    if (engines == 0)
+        engines = new vector<Entry>;
+    Entry entry = { name, e };
+    engines->push_back(entry);
+}
+
+
+void Stat_report :: Unregister(Stat_engine* e)
+{
+    if (engines == 0)
+        return;
+    for (vector<Entry>::iterator it = engines->begin(); it != engines->end(); ++it) {
+        if (it->engine == e) {
+            engines->erase(it);
+            return;
+        }
+    }
+}
+
+
+void Stat_report :: SaveSamples()
+{
+    if (engines == 0)
+        return;
+    for (size_t i = 0; i < engines->size(); i++)
+        (*engines)[i].engine->save_samples();
+}
+
+
+void Stat_report :: add(const char* name, double value)
+{
+    values.push_back(Stat_values());
+    values.back().name = name;
+    values.back().values.assign(1, value);
+}
+
+
+//! The stats of one component, as gathered from its LP
+struct Component_stats {
+    LpId_t lp;
+    string name;
+    string type;
+    vector<Stat_values> values;
+};
+
+
+//====================================================================
+// Packing of the stats of an LP for the gather
+//====================================================================
+static void Put(vector<char>& buf, const void* p, size_t n)
+{
+    buf.insert(buf.end(), (const char*)p, (const char*)p + n);
+}
+
+static void Put_uint(vector<char>& buf, uint32_t v) { Put(buf, &v, sizeof(v)); }
+static void Put_double(vector<char>& buf, double v) { Put(buf, &v, sizeof(v)); }
+
+static void Put_string(vector<char>& buf, const string& s)
+{
+    Put_uint(buf, s.size());
+    Put(buf, s.data(), s.size());
+}
+
+
+class Unpacker {
+public:
+    Unpacker(const char* b, const char* e) : cur(b), end(e) {}
+
+    bool done() const { return cur >= end; }
+
+    void get(void* p, size_t n)
+    {
+        if (cur + n > end) {
+            cerr << "Stat_report: corrupt stats from an LP" << endl;
+            exit(1);
+        }
+        memcpy(p, cur, n);
+        cur += n;
+    }
+
+    uint32_t get_uint() { uint32_t v; get(&v, sizeof(v)); return v; }
+    double get_double() { double v; get(&v, sizeof(v)); return v; }
+
+    string get_string()
+    {
+        uint32_t n = get_uint();
+        string s(n, ' ');
+        if (n)
+            get(&s[0], n);
+        return s;
+    }
+
+private:
+    const char* cur;
+    const char* end;
+};
+
+
+static void Pack(vector<char>& buf, const Component_stats& c)
+{
+    Put_string(buf, c.name);
+    Put_string(buf, c.type);
+    Put_uint(buf, c.values.size());
+    for (size_t i = 0; i < c.values.size(); i++) {
+        const Stat_values& v = c.values[i];
+        Put_uint(buf, v.kind);
+        Put_string(buf, v.name);
+        Put_uint(buf, v.labels.size());
+        for (size_t j = 0; j < v.labels.size(); j++)
+            Put_string(buf, v.labels[j]);
+        Put_uint(buf, v.values.size());
+        for (size_t j = 0; j < v.values.size(); j++)
+            Put_double(buf, v.values[j]);
+        Put_double(buf, v.sum);
+        Put_double(buf, v.sq_sum);
+        Put_double(buf, v.count);
+    }
+}
+
+
+static void Unpack(Unpacker& in, Component_stats& c)
+{
+    c.name = in.get_string();
+    c.type = in.get_string();
+    c.values.resize(in.get_uint());
+    for (size_t i = 0; i < c.values.size(); i++) {
+        Stat_values& v = c.values[i];
+        v.kind = (Stat_values::Kind)in.get_uint();
+        v.name = in.get_string();
+        v.labels.resize(in.get_uint());
+        for (size_t j = 0; j < v.labels.size(); j++)
+            v.labels[j] = in.get_string();
+        v.values.resize(in.get_uint());
+        for (size_t j = 0; j < v.values.size(); j++)
+            v.values[j] = in.get_double();
+        v.sum = in.get_double();
+        v.sq_sum = in.get_double();
+        v.count = in.get_double();
+    }
+}
+
+
+//====================================================================
+// Reduction over the engines of each type
+//====================================================================
+struct Stat_total {
+    Stat_total() : instances(0), min(0), max(0), consistent(true) {}
+    Stat_values sum;
+    unsigned instances;
+    double min; // of the first value, for counters
+    double max;
+    bool consistent; // same labels in all engines
+};
+
+struct Type_total {
+    Type_total() : instances(0) {}
+    unsigned instances;
+    vector<string> order; // of the stats, as first seen
+    map<string, Stat_total> stats;
+};
+
+
+static void Reduce(Type_total& t, const Component_stats& c)
+{
+    t.instances++;
+    for (size_t i = 0; i < c.values.size(); i++) {
+        const Stat_values& v = c.values[i];
+        map<string, Stat_total>::iterator it = t.stats.find(v.name);
+        if (it == t.stats.end()) {
+            t.order.push_back(v.name);
+            Stat_total& s = t.stats[v.name];
+            s.sum = v;
+            s.instances = 1;
+            s.min = s.max = v.values.empty() ? 0 : v.values[0];
+            continue;
+        }
+
+        Stat_total& s = it->second;
+        s.instances++;
+        if (v.kind != s.sum.kind || v.labels != s.sum.labels || v.values.size() != s.sum.values.size()) {
+            s.consistent = false;
+            continue;
+        }
+        for (size_t j = 0; j < v.values.size(); j++)
+            s.sum.values[j] += v.values[j];
+        s.sum.sum += v.sum;
+        s.sum.sq_sum += v.sq_sum;
+        s.sum.count += v.count;
+        if (!v.values.empty()) {
+            if (v.values[0] < s.min)
+                s.min = v.values[0];
+            if (v.values[0] > s.max)
+                s.max = v.values[0];
+        }
+    }
+}
+
+
+//====================================================================
+// Output
+//====================================================================
+static string Demangle(const char* name)
+{
+    int status;
+    char* d = abi::__cxa_demangle(name, 0, 0, &status);
+    if (status != 0)
+        return name;
+    string r = d;
+    free(d);
+    return r;
+}
+
+
+//! Counters are written as integers, so they survive parsers that read
+//! every number as a double.
+static string Number(double v)
+{
+    if (isnan(v) || isinf(v))
+        return "null";
+    ostringstream s;
+    if (v == floor(v) && fabs(v) < 1e15)
+        s << (long long)v;
+    else {
+        s.precision(17);
+        s << v;
+    }
+    return s.str();
+}
+
+
+static string Json_string(const string& s)
+{
+    string r = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') {
+            r += '\\';
+            r += c;
+        }
+        else if ((unsigned char)c < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            r += esc;
+        }
+        else
+            r += c;
+    }
+    return r + "\"";
+}
+
+
+static string Csv_quote(const string& s)
+{
+    if (s.find_first_of(",\"\n") == string::npos)
+        return s;
+    string r = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"')
+            r += '"';
+        r += s[i];
+    }
+    return r + "\"";
+}
+
+
+static void Json_list(ostream& out, const vector<string>& l)
+{
+    out << "[";
+    for (size_t i = 0; i < l.size(); i++)
+        out << (i ? ", " : "") << Json_string(l[i]);
+    out << "]";
+}
+
+
+static void Json_list(ostream& out, const vector<double>& l)
+{
+    out << "[";
+    for (size_t i = 0; i < l.size(); i++)
+        out << (i ? ", " : "") << Number(l[i]);
+    out << "]";
+}
+
+
+static void Json_value(ostream& out, const Stat_values& v)
+{
+    switch (v.kind) {
+        case Stat_values::SCALAR:
+            out << (v.values.empty() ? "null" : Number(v.values[0]));
+            break;
+        case Stat_values::ARRAY:
+            out << "{\"labels\": ";
+            Json_list(out, v.labels);
+            out << ", \"values\": ";
+            Json_list(out, v.values);
+            out << "}";
+            break;
+        case Stat_values::HISTOGRAM:
+            out << "{\"bins\": ";
+            Json_list(out, v.labels);
+            out << ", \"counts\": ";
+            Json_list(out, v.values);
+            out << ", \"sum\": " << Number(v.sum) << ", \"sq_sum\": " << Number(v.sq_sum)
+                << ", \"count\": " << Number(v.count) << "}";
+            break;
+    }
+}
+
+
+//! Rows lp,component,type,stat,element,value of one stat
+static void Csv_rows(ostream& out, const string& key, const Stat_values& v)
+{
+    string row = key + Csv_quote(v.name) + ",";
+    switch (v.kind) {
+        case Stat_values::SCALAR:
+            if (!v.values.empty())
+                out << row << "," << Number(v.values[0]) << "\n";
+            break;
+        case Stat_values::ARRAY:
+        case Stat_values::HISTOGRAM:
+            for (size_t i = 0; i < v.values.size(); i++)
+                out << row << Csv_quote(i < v.labels.size() ? v.labels[i] : "") << "," << Number(v.values[i]) << "\n";
+            if (v.kind == Stat_values::HISTOGRAM)
+                out << row << "sum," << Number(v.sum) << "\n"
+                    << row << "sq_sum," << Number(v.sq_sum) << "\n"
+                    << row << "count," << Number(v.count) << "\n";
+            break;
+    }
+}
+
+
+static void Write_files(const string& prefix, int num_lps, const vector<Component_stats>& comps)
+{
+    map<string, Type_total> totals;
+    for (size_t i = 0; i < comps.size(); i++)
+        Reduce(totals[comps[i].type], comps[i]);
+
+    string json_name = prefix + ".json";
+    ofstream json(json_name.c_str());
+    string csv_name = prefix + ".csv";
+    ofstream csv(csv_name.c_str());
+    if (!json || !csv) {
+        cerr << "Stat_report: cannot write " << prefix << ".*" << endl;
+        return;
+    }
+
+    json << "{\n\"num_lps\": " << num_lps << ",\n\"components\": [";
+    csv << "lp,component,type,stat,element,value\n";
+    for (size_t i = 0; i < comps.size(); i++) {
+        const Component_stats& c = comps[i];
+        json << (i ? ",\n" : "\n") << "  {\"lp\": " << c.lp << ", \"name\": " << Json_string(c.name)
+             << ", \"type\": " << Json_string(c.type) << ", \"stats\": {";
+        ostringstream key;
+        key << c.lp << "," << Csv_quote(c.name) << "," << Csv_quote(c.type) << ",";
+        for (size_t j = 0; j < c.values.size(); j++) {
+            json << (j ? ", " : "") << Json_string(c.values[j].name) << ": ";
+            Json_value(json, c.values[j]);
+            Csv_rows(csv, key.str(), c.values[j]);
+        }
+        json << "}}";
+    }
+
+    json << "\n],\n\"totals\": [";
+    bool first = true;
+    for (map<string, Type_total>::iterator it = totals.begin(); it != totals.end(); ++it) {
+        const Type_total& t = it->second;
+        json << (first ? "\n" : ",\n") << "  {\"type\": " << Json_string(it->first)
+             << ", \"instances\": " << t.instances << ", \"stats\": {";
+        first = false;
+        string key = "all,*," + Csv_quote(it->first) + ",";
+        for (size_t j = 0; j < t.order.size(); j++) {
+            const Stat_total& s = t.stats.find(t.order[j])->second;
+            json << (j ? ", " : "") << Json_string(s.sum.name) << ": ";
+            if (!s.consistent) {
+                // e.g. histograms with different bins
+                json << "null";
+                continue;
+            }
+            if (s.sum.kind == Stat_values::SCALAR && !s.sum.values.empty()) {
+                double sum = s.sum.values[0];
+                json << "{\"sum\": " << Number(sum) << ", \"min\": " << Number(s.min)
+                     << ", \"max\": " << Number(s.max) << ", \"mean\": " << Number(sum / s.instances) << "}";
+                string row = key + Csv_quote(s.sum.name) + ",";
+                csv << row << "sum," << Number(sum) << "\n"
+                    << row << "min," << Number(s.min) << "\n"
+                    << row << "max," << Number(s.max) << "\n"
+                    << row << "mean," << Number(sum / s.instances) << "\n";
+            }
+            else {
+                Json_value(json, s.sum);
+                Csv_rows(csv, key, s.sum);
+            }
+        }
+        json << "}}";
+    }
+    json << "\n]\n}\n";
+}
+
+
+void Stat_report :: Write()
+{
+    if (!IsEnabled())
+        return;
+
+    vector<char> buf;
+    if (engines) {
+        for (size_t i = 0; i < engines->size(); i++) {
+            Component_stats c;
+            c.name = (*engines)[i].name;
+            c.type = Demangle(typeid(*(*engines)[i].engine).name());
+            Stat_report r;
+            (*engines)[i].engine->report_stats(r);
+            c.values.swap(r.values);
+            Pack(buf, c);
+        }
+    }
+
+    int num_lps = 1;
+    vector<char> all;
+    vector<int> sizes(1, buf.size());
+#ifndef NO_MPI
+    if (TheMessenger.get_node_size() > 1) {
+        num_lps = TheMessenger.get_node_size();
+        TheMessenger.gather(buf.empty() ? 0 : &buf[0], buf.size(), all, sizes, 0);
+        if (Manifold::GetRank() != 0)
+            return;
+    }
+    else
+#endif
+        all.swap(buf);
+
+    vector<Component_stats> comps;
+    const char* p = all.empty() ? 0 : &all[0];
+    for (LpId_t lp = 0; lp < (LpId_t)sizes.size(); lp++) {
+        Unpacker in(p, p + sizes[lp]);
+        while (!in.done()) {
+            comps.push_back(Component_stats());
+            comps.back().lp = lp;
+            Unpack(in, comps.back());
+        }
+        p += sizes[lp];
+    }
+
+    Write_files(prefix, num_lps, comps);
+}
+
+
+} // namespace kernel
+} // namespace manifold
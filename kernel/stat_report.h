@@ -0,0 +1,73 @@
+/** @file stat_report.h
+ *  Report of the statistics of all LPs, gathered at the end of a run into one
+ *  machine-readable file.
+ */
+
+#ifndef MANIFOLD_KERNEL_STAT_REPORT_H
+#define MANIFOLD_KERNEL_STAT_REPORT_H
+
+#include <string>
+#include <vector>
+
+#include "stat.h"
+
+namespace manifold {
+namespace kernel {
+
+class Stat_engine;
+
+/** Stat engines are registered under the name of the component they belong
+ *  to. At the end of the run, Write() asks every registered engine for its
+ *  stats (Stat_engine::report_stats()), gathers them from all LPs on LP 0 and
+ *  reduces them per engine type, like global_stat_merge() would: counters,
+ *  arrays and histograms are added up, and the minimum, maximum and mean over
+ *  the engines are kept for counters.
+ *
+ *  LP 0 writes <prefix>.json and <prefix>.csv, keyed by component name and LP.
+ *  The report is turned on by Enable(), or by setting MANIFOLD_STATS to the
+ *  prefix before Manifold::Init(); Manifold::Finalize() then writes it.
+ */
+class Stat_report {
+public:
+    //! Turns the report on; it is written to files starting with prefix.
+    static void Enable(const char* prefix);
+    static bool IsEnabled() { return !prefix.empty(); }
+
+    //! Registers the engine of a component; names need only be unique on the
+    //! LP. Engines must stay alive until Write(), or unregister themselves.
+    static void Register(const std::string& name, Stat_engine* e);
+    static void Unregister(Stat_engine* e);
+
+    //! Collective: all LPs must call it. Writes the report if enabled.
+    static void Write();
+
+    //! Calls save_samples() on all registered engines.
+    static void SaveSamples();
+
+    //! Called by Stat_engine::report_stats() for each of its stats.
+    template <typename S>
+    void add(S& stat)
+    {
+        values.push_back(Stat_values());
+        stat.get_values(values.back());
+    }
+
+    //! A counter that is not kept in a stat object.
+    void add(const char* name, double value);
+
+    std::vector<Stat_values> values;
+
+private:
+    struct Entry {
+        std::string name;
+        Stat_engine* engine;
+    };
+
+    static std::string prefix;
+    static std::vector<Entry>* engines; //in order of registration
+};
+
+} // namespace kernel
+} // namespace manifold
+
+#endif // MANIFOLD_KERNEL_STAT_REPORT_H
@@ -0,0 +1,211 @@
+// Implementation of the interval sampler
+
+#include <iostream>
+#include <sstream>
+#include <string.h>
+#include <assert.h>
+
+#include "stat_sampler.h"
+#include "stat_report.h"
+#include "manifold.h"
+#include "clock.h"
+
+using namespace std;
+
+namespace manifold {
+namespace kernel {
+
+// rows per block, and blocks in the ring
+static const unsigned Block_rows = 1024;
+static const unsigned Num_blocks = 4;
+
+string Stat_sampler::prefix;
+Ticks_t Stat_sampler::interval = 100000;
+vector<Stat_sampler::Column>* Stat_sampler::columns = 0;
+bool Stat_sampler::started = false;
+FILE* Stat_sampler::file = 0;
+Stat_sampler::Block* Stat_sampler::cur = 0;
+vector<Stat_sampler::Block*> Stat_sampler::free_blocks;
+vector<Stat_sampler::Block*> Stat_sampler::full_blocks;
+bool Stat_sampler::stopping = false;
+pthread_t Stat_sampler::writer;
+pthread_mutex_t Stat_sampler::lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t Stat_sampler::work = PTHREAD_COND_INITIALIZER;
+pthread_cond_t Stat_sampler::freed = PTHREAD_COND_INITIALIZER;
+
+
+//! Target of the tick event that takes the samples
+class Sample_trigger {
+public:
+    void fire() { Stat_sampler :: Sample(); }
+};
+
+static Sample_trigger Trigger;
+
+
+void Stat_sampler :: Enable(const char* p, Ticks_t i)
+{
+    assert(i > 0);
+    prefix = p;
+    interval = i;
+}
+
+
+void Stat_sampler :: AddColumn(const string& name, const void* counter, Reader read)
+{
+    if (started) {
+        cerr << "Stat_sampler: " << name << " added after sampling started; not sampled" << endl;
+        return;
+    }
+    if (columns == 0)
+        columns = new vector<Column>;
+    Column c = { name, counter, read };
+    columns->push_back(c);
+}
+
+
+void Stat_sampler :: Start()
+{
+    if (!IsEnabled() || started)
+        return;
+    started = true;
+    if (columns == 0)
+        columns = new vector<Column>;
+
+    Stat_sample_header h;
+    memset(&h, 0, sizeof(h));
+    h.magic = STAT_SAMPLE_MAGIC;
+    h.version = STAT_SAMPLE_VERSION;
+    h.lp = Manifold::GetRank();
+    h.num_columns = columns->size() + 1;
+    h.interval = interval;
+    h.period = Clock::Master().period;
+
+    ostringstream name;
+    name << prefix << ".lp" << h.lp << ".samples";
+    file = fopen(name.str().c_str(), "wb");
+    if (file == 0) {
+        cerr << "Stat_sampler: cannot open " << name.str() << endl;
+        prefix.clear();
+        return;
+    }
+    fwrite(&h, sizeof(h), 1, file);
+    string tick = "tick";
+    uint32_t len = tick.size();
+    fwrite(&len, sizeof(len), 1, file);
+    fwrite(tick.data(), 1, len, file);
+    for (size_t i = 0; i < columns->size(); i++) {
+        len = (*columns)[i].name.size();
+        fwrite(&len, sizeof(len), 1, file);
+        fwrite((*columns)[i].name.data(), 1, len, file);
+    }
+
+    for (unsigned i = 0; i < Num_blocks; i++) {
+        Block* b = new Block;
+        b->data.resize((columns->size() + 1) * Block_rows);
+        b->rows = 0;
+        free_blocks.push_back(b);
+    }
+    cur = free_blocks.back();
+    free_blocks.pop_back();
+
+    stopping = false;
+    if (pthread_create(&writer, 0, Writer, 0) != 0) {
+        cerr << "Stat_sampler: cannot create the writer thread" << endl;
+        exit(1);
+    }
+
+    Manifold :: ScheduleClock(interval, Clock::Master(), &Sample_trigger::fire, &Trigger);
+}
+
+
+void Stat_sampler :: Sample()
+{
+    if (file == 0)
+        return;
+
+    Stat_report :: SaveSamples();
+
+    // column-major within the block
+    unsigned row = cur->rows++;
+    cur->data[row] = Clock::Master().NowTicks();
+    for (size_t i = 0; i < columns->size(); i++) {
+        const Column& c = (*columns)[i];
+        cur->data[(i + 1) * Block_rows + row] = c.read(c.counter);
+    }
+    if (cur->rows == Block_rows)
+        Submit(cur);
+
+    Manifold :: ScheduleClock(interval, Clock::Master(), &Sample_trigger::fire, &Trigger);
+}
+
+
+//! Hands a full block to the writer and takes a free one, waiting if the
+//! writer is behind.
+void Stat_sampler :: Submit(Block* b)
+{
+    pthread_mutex_lock(&lock);
+    full_blocks.push_back(b);
+    pthread_cond_signal(&work);
+    while (free_blocks.empty())
+        pthread_cond_wait(&freed, &lock);
+    cur = free_blocks.back();
+    free_blocks.pop_back();
+    pthread_mutex_unlock(&lock);
+}
+
+
+void* Stat_sampler :: Writer(void*)
+{
+    pthread_mutex_lock(&lock);
+    while (true) {
+        while (full_blocks.empty() && !stopping)
+            pthread_cond_wait(&work, &lock);
+        if (full_blocks.empty())
+            break;
+
+        Block* b = full_blocks.front();
+        full_blocks.erase(full_blocks.begin());
+        pthread_mutex_unlock(&lock);
+
+        uint32_t rows = b->rows;
+        fwrite(&rows, sizeof(rows), 1, file);
+        for (size_t i = 0; i <= columns->size(); i++)
+            fwrite(&b->data[i * Block_rows], sizeof(double), rows, file);
+        b->rows = 0;
+
+        pthread_mutex_lock(&lock);
+        free_blocks.push_back(b);
+        pthread_cond_signal(&freed);
+    }
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+
+void Stat_sampler :: Stop()
+{
+    if (file == 0)
+        return;
+
+    pthread_mutex_lock(&lock);
+    if (cur->rows > 0)
+        full_blocks.push_back(cur);
+    else
+        free_blocks.push_back(cur);
+    cur = 0;
+    stopping = true;
+    pthread_cond_signal(&work);
+    pthread_mutex_unlock(&lock);
+    pthread_join(writer, 0);
+
+    fclose(file);
+    file = 0;
+    for (size_t i = 0; i < free_blocks.size(); i++)
+        delete free_blocks[i];
+    free_blocks.clear();
+}
+
+
+} //namespace kernel
+} //namespace manifold
@@ -0,0 +1,131 @@
+/** @file stat_sampler.h
+ *  Time series of model counters, sampled at a fixed tick interval.
+ */
+
+#ifndef MANIFOLD_KERNEL_STAT_SAMPLER_H
+#define MANIFOLD_KERNEL_STAT_SAMPLER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "common-defs.h"
+#include "stat.h"
+
+namespace manifold {
+namespace kernel {
+
+/** Layout of the file <prefix>.lp<N>.samples: a Stat_sample_header, then
+ *  num_columns names (uint32_t length and the characters), then blocks of
+ *  samples. A block is a uint32_t row count followed by the rows of each
+ *  column in turn, as doubles; the first column is the tick of the master
+ *  clock at which the row was taken. Counters are written as they are, so
+ *  rates are the differences between rows.
+ */
+#define STAT_SAMPLE_MAGIC 0x4c504d53464e414dULL //"MANFSMPL"
+#define STAT_SAMPLE_VERSION 1
+
+struct Stat_sample_header
+{
+  uint64_t magic;
+  uint32_t version;
+  int32_t lp;
+  uint32_t num_columns; //including the tick
+  uint32_t reserved;
+  uint64_t interval; //ticks of the master clock between rows
+  double period; //of the master clock
+};
+
+
+/** Models add their counters once, when they are built; names need only be
+ *  unique on the LP. The counters must stay valid until
+ *  Manifold::Finalize(). Every interval ticks, the sampler calls
+ *  save_samples() on the stat engines registered with Stat_report and copies
+ *  the counters into a row of a preallocated block; full blocks are written
+ *  out by a separate thread, so the simulation only waits when all blocks
+ *  are waiting to be written.
+ *
+ *  Sampling is turned on by Enable(), or by setting MANIFOLD_SAMPLE to the
+ *  file prefix (and optionally MANIFOLD_SAMPLE_INTERVAL to the interval in
+ *  ticks, default 100000) before Manifold::Init(). It starts when
+ *  Manifold::Run() is first called; counters added later are not sampled.
+ */
+class Stat_sampler
+{
+ public:
+  static void Enable(const char* prefix, Ticks_t interval);
+  static bool IsEnabled() { return !prefix.empty(); }
+
+  //! A plain counter of any arithmetic type.
+  template <typename T>
+  static void Add(const std::string& name, const T* counter)
+  {
+    AddColumn(name, counter, &Read_value<T>);
+  }
+
+  template <typename T>
+  static void Add(const std::string& name, Persistent_stat<T>* stat)
+  {
+    AddColumn(name, stat, &Read_stat<T>);
+  }
+
+  //! Opens the file and schedules the first sample. Called by Manifold::Run().
+  static void Start();
+
+  //! Writes the rows taken so far and closes the file. Called by
+  //! Manifold::Finalize().
+  static void Stop();
+
+  //! Takes one row; called every interval ticks.
+  static void Sample();
+
+ private:
+  typedef double (*Reader)(const void*);
+
+  struct Column
+  {
+    std::string name;
+    const void* counter;
+    Reader read;
+  };
+
+  //! Rows of all columns, column after column
+  struct Block
+  {
+    std::vector<double> data;
+    unsigned rows;
+  };
+
+  template <typename T>
+  static double Read_value(const void* p) { return (double)*(const T*)p; }
+
+  template <typename T>
+  static double Read_stat(const void* p) { return (double)((Persistent_stat<T>*)p)->get_value(); }
+
+  static void AddColumn(const std::string& name, const void* counter, Reader read);
+  static void Submit(Block* b);
+  static void* Writer(void*);
+
+  static std::string prefix;
+  static Ticks_t interval;
+  static std::vector<Column>* columns;
+  static bool started;
+
+  static FILE* file;
+  static Block* cur; //being filled
+  static std::vector<Block*> free_blocks;
+  static std::vector<Block*> full_blocks; //in order
+  static bool stopping;
+  static pthread_t writer;
+  static pthread_mutex_t lock;
+  static pthread_cond_t work; //a block is full, or stopping
+  static pthread_cond_t freed; //a block was written
+};
+
+
+} //namespace kernel
+} //namespace manifold
+
+#endif //MANIFOLD_KERNEL_STAT_SAMPLER_H
@@ -0,0 +1,188 @@
+// Implementation of the synchronization telemetry
+
+#include <iostream>
+#include <assert.h>
+#include <sstream>
+#include <string.h>
+#include <time.h>
+
+#include "sync_telemetry.h"
+#include "manifold.h"
+#ifndef NO_MPI
+#include "messenger.h"
+#endif
+
+using namespace std;
+
+namespace manifold {
+namespace kernel {
+
+bool Sync_telemetry::enabled = false;
+FILE* Sync_telemetry::file = 0;
+Time_t Sync_telemetry::width = 1e-6;
+Sync_log_bucket Sync_telemetry::cur;
+uint64_t Sync_telemetry::totalBlocked = 0;
+uint64_t Sync_telemetry::curWallStart = 0;
+map<LpId_t, Sync_log_constraint> Sync_telemetry::curConstraints;
+bool Sync_telemetry::blocked = false;
+uint64_t Sync_telemetry::blockedSince = 0;
+LpId_t Sync_telemetry::blockedOn = -1;
+bool Sync_telemetry::windowOpen = false;
+Time_t Sync_telemetry::windowStart = 0;
+Time_t Sync_telemetry::windowHorizon = 0;
+
+
+uint64_t Sync_telemetry :: WallNow()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+void Sync_telemetry :: Enable(const char* prefix, Time_t bucketWidth)
+{
+    assert(bucketWidth > 0);
+    if (enabled)
+        Close();
+
+    Sync_log_header h;
+    memset(&h, 0, sizeof(h));
+    h.magic = SYNC_LOG_MAGIC;
+    h.version = SYNC_LOG_VERSION;
+    h.lp = Manifold::GetRank();
+#ifndef NO_MPI
+    h.num_lps = TheMessenger.get_node_size();
+#else
+    h.num_lps = 1;
+#endif
+    h.bucket_width = bucketWidth;
+
+    ostringstream name;
+    name << prefix << ".lp" << h.lp << ".sync";
+    file = fopen(name.str().c_str(), "wb");
+    if (file == 0) {
+        cerr << "Sync_telemetry: cannot open " << name.str() << endl;
+        return;
+    }
+    fwrite(&h, sizeof(h), 1, file);
+
+    width = bucketWidth;
+    memset(&cur, 0, sizeof(cur));
+    curWallStart = WallNow();
+    curConstraints.clear();
+    blocked = false;
+    windowOpen = false;
+    enabled = true;
+}
+
+
+void Sync_telemetry :: Close()
+{
+    if (!enabled)
+        return;
+    Flush();
+    fclose(file);
+    file = 0;
+    enabled = false;
+}
+
+
+//! Moves on to the bucket of time now, writing the current one out.
+void Sync_telemetry :: Advance(Time_t now)
+{
+    uint64_t b = now > 0 ? (uint64_t)(now / width) : 0;
+    if (b == cur.bucket)
+        return;
+
+    Flush();
+    memset(&cur, 0, sizeof(cur));
+    cur.bucket = b;
+    curWallStart = WallNow();
+}
+
+
+void Sync_telemetry :: Flush()
+{
+    cur.wall_ns = WallNow() - curWallStart;
+    cur.num_constraints = curConstraints.size();
+    totalBlocked += cur.blocked_ns;
+    fwrite(&cur, sizeof(cur), 1, file);
+    for (map<LpId_t, Sync_log_constraint>::iterator it = curConstraints.begin(); it != curConstraints.end(); ++it)
+        fwrite(&it->second, sizeof(Sync_log_constraint), 1, file);
+    curConstraints.clear();
+}
+
+
+//! The LP has to wait: account for how much of the time it was allowed to
+//! run ahead it actually ran through.
+void Sync_telemetry :: CloseWindow(Time_t now)
+{
+    if (!windowOpen)
+        return;
+    windowOpen = false;
+
+    Time_t used = now - windowStart;
+    Time_t window = windowHorizon - windowStart;
+    if (window < used)
+        window = used;
+    cur.window += window;
+    cur.used += used;
+}
+
+
+void Sync_telemetry :: DoCheck(Time_t now, Time_t horizon, bool safe, LpId_t constraint)
+{
+    Advance(now);
+
+    if (!safe) {
+        if (!blocked) {
+            blocked = true;
+            blockedSince = WallNow();
+            CloseWindow(now);
+        }
+        blockedOn = constraint;
+        return;
+    }
+
+    if (blocked) {
+        uint64_t ns = WallNow() - blockedSince;
+        cur.blocked_ns += ns;
+        cur.blocks++;
+
+        Sync_log_constraint& c = curConstraints[blockedOn];
+        c.lp = blockedOn;
+        c.blocks++;
+        c.blocked_ns += ns;
+        blocked = false;
+    }
+
+    if (!windowOpen) {
+        windowOpen = true;
+        windowStart = now;
+        windowHorizon = horizon;
+    }
+    else if (horizon > windowHorizon)
+        windowHorizon = horizon;
+}
+
+
+void Sync_telemetry :: DoWait(Time_t now, uint64_t start, Time_t window)
+{
+    Advance(now);
+
+    uint64_t ns = WallNow() - start;
+    cur.blocked_ns += ns;
+    cur.blocks++;
+    cur.window += window;
+    cur.used += window;
+
+    Sync_log_constraint& c = curConstraints[-1];
+    c.lp = -1;
+    c.blocks++;
+    c.blocked_ns += ns;
+}
+
+
+} //namespace kernel
+} //namespace manifold
@@ -0,0 +1,147 @@
+/** @file sync_telemetry.h
+ *  Time-bucketed log of how the synchronization of a parallel simulation
+ *  behaves on each LP.
+ */
+
+#ifndef MANIFOLD_KERNEL_SYNC_TELEMETRY_H
+#define MANIFOLD_KERNEL_SYNC_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+
+#include "common-defs.h"
+
+namespace manifold {
+namespace kernel {
+
+/** Layout of the log file <prefix>.lp<N>.sync: a Sync_log_header, then one
+ *  Sync_log_bucket for each bucket of simulated time in which the LP did
+ *  anything, in time order, each followed by bucket.num_constraints
+ *  Sync_log_constraint. All fields are in the byte order of the host.
+ */
+#define SYNC_LOG_MAGIC 0x434e5953464e414dULL //"MANFSYNC"
+#define SYNC_LOG_VERSION 1
+
+struct Sync_log_header
+{
+  uint64_t magic;
+  uint32_t version;
+  int32_t lp;
+  int32_t num_lps;
+  uint32_t reserved;
+  double bucket_width; //simulated seconds
+};
+
+struct Sync_log_bucket
+{
+  uint64_t bucket; //starts at bucket * bucket_width
+  uint64_t wall_ns; //wall time the LP spent in the bucket
+  uint64_t blocked_ns; //of which waiting for a safe time
+  uint32_t blocks; //number of times it had to wait
+  uint32_t null_sent; //null messages
+  uint32_t null_recv;
+  uint32_t syncs; //LBTS all-gathers or quantum barriers
+  double window; //simulated time it was allowed to run ahead
+  double used; //part of window it ran through before it had to wait
+  uint32_t num_constraints;
+  uint32_t reserved;
+};
+
+//! Time the LP waited on one predecessor; lp is -1 when the wait is not due
+//! to a single LP (messages in flight, barriers).
+struct Sync_log_constraint
+{
+  int32_t lp;
+  uint32_t blocks;
+  uint64_t blocked_ns;
+};
+
+
+/** Collects the telemetry of this LP. Turned on by Enable(), or by setting
+ *  MANIFOLD_SYNC_LOG to the log prefix (and optionally MANIFOLD_SYNC_BUCKET
+ *  to the bucket width in simulated seconds, default 1e-6) before
+ *  Manifold::Init(). The sync algorithms report every check for a safe time;
+ *  while the telemetry is off, each report costs one test of a flag.
+ */
+class Sync_telemetry
+{
+ public:
+  static void Enable(const char* prefix, Time_t bucketWidth);
+  static bool IsEnabled() { return enabled; }
+
+  //! Writes the last bucket and closes the log.
+  static void Close();
+
+  //! Result of a check whether the next event is safe to process.
+  //! @arg \c now Current simulated time of the LP
+  //! @arg \c horizon Time up to which events are safe
+  //! @arg \c constraint Predecessor that holds the horizon back, or -1
+  static inline void Check(Time_t now, Time_t horizon, bool safe, LpId_t constraint)
+  {
+    if (__builtin_expect(enabled, 0))
+      DoCheck(now, horizon, safe, constraint);
+  }
+
+  //! A wait that is not reported through Check(), such as a barrier, which
+  //! blocked the LP from start (CLOCK_MONOTONIC ns) until now.
+  static inline void Wait(Time_t now, uint64_t start, Time_t window)
+  {
+    if (__builtin_expect(enabled, 0))
+      DoWait(now, start, window);
+  }
+
+  static inline void NullSent(unsigned n)
+  {
+    if (__builtin_expect(enabled, 0))
+      cur.null_sent += n;
+  }
+
+  static inline void NullReceived(unsigned n)
+  {
+    if (__builtin_expect(enabled, 0))
+      cur.null_recv += n;
+  }
+
+  static inline void Synced()
+  {
+    if (__builtin_expect(enabled, 0))
+      cur.syncs++;
+  }
+
+  //! Wall clock in ns
+  static uint64_t WallNow();
+
+  //! Wall time the LP has spent waiting for a safe time so far, in ns
+  static uint64_t BlockedNs() { return totalBlocked + cur.blocked_ns; }
+
+ private:
+  static void DoCheck(Time_t now, Time_t horizon, bool safe, LpId_t constraint);
+  static void DoWait(Time_t now, uint64_t start, Time_t window);
+  static void Advance(Time_t now);
+  static void Flush();
+  static void CloseWindow(Time_t now);
+
+  static bool enabled;
+  static FILE* file;
+  static Time_t width;
+
+  static Sync_log_bucket cur; //bucket being filled
+  static uint64_t totalBlocked; //in the buckets written out
+  static uint64_t curWallStart;
+  static std::map<LpId_t, Sync_log_constraint> curConstraints;
+
+  static bool blocked;
+  static uint64_t blockedSince;
+  static LpId_t blockedOn;
+
+  static bool windowOpen;
+  static Time_t windowStart;
+  static Time_t windowHorizon;
+};
+
+
+} //namespace kernel
+} //namespace manifold
+
+#endif //MANIFOLD_KERNEL_SYNC_TELEMETRY_H
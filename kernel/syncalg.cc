@@ -73,11 +73,20 @@ void SyncAlg :: updateOutputTick(LpId_t src, LpId_t dst, Ticks_t when, Clock* cl
 LbtsSyncAlg::LbtsSyncAlg(Lookahead::LookaheadType_t laType) : SyncAlg(laType)
 {
     m_grantedTime = 0;
+    m_constraint = -1;
     m_stats_LBTS_sync = 0;
 }
 
 
 bool LbtsSyncAlg::isSafeToProcess(double requestTime)
+{
+    bool safe = check_safe(requestTime);
+    Sync_telemetry :: Check(Manifold::Now(), m_grantedTime, safe, m_constraint);
+    return safe;
+}
+
+
+bool LbtsSyncAlg::check_safe(double requestTime)
 {
     static LBTS_Msg* LBTS = new LBTS_Msg[TheMessenger.get_node_size()];
 
@@ -93,6 +102,7 @@ bool LbtsSyncAlg::isSafeToProcess(double requestTime)
 	LBTS[nodeId] = lbts_msg;
 
 	TheMessenger.allGather((char*)&(lbts_msg), sizeof(LBTS_Msg), (char*)LBTS);
+	Sync_telemetry :: Synced();
 
 	#ifdef STATS
 	m_stats_LBTS_sync++;
@@ -102,6 +112,7 @@ bool LbtsSyncAlg::isSafeToProcess(double requestTime)
 	int rx=0;
 	int tx=0;
 	double smallest_time = LBTS[0].smallest_time;
+	m_constraint = 0;
 
 	for(int i=0; i<TheMessenger.get_node_size(); i++) {
 	    tx+=LBTS[i].tx_count;
@@ -109,6 +120,7 @@ bool LbtsSyncAlg::isSafeToProcess(double requestTime)
 
 	    if(LBTS[i].smallest_time < smallest_time) {
 		smallest_time=LBTS[i].smallest_time;
+		m_constraint = i;
 	    }
 	}
 	if(rx==tx) {
@@ -123,6 +135,7 @@ bool LbtsSyncAlg::isSafeToProcess(double requestTime)
 		return false;
         }
 	else {
+	    m_constraint = -1; //messages in flight
 	    return false;
 	}
     }
@@ -280,12 +293,14 @@ bool CmbSyncAlg::isSafeToProcess(double requestTime)
     //find the min input NULL message
     ts_t::iterator it = m_eits.begin();
     m_min_null = it->second;
+    LpId_t min_lp = it->first;
     ++it;
 
     for(; it!=m_eits.end(); ++it) {
 	Time_t itTime = it->second;
 	if(itTime < m_min_null) {
 	    m_min_null = itTime;
+	    min_lp = it->first;
 	}
     }
 
@@ -303,6 +318,7 @@ bool CmbSyncAlg::isSafeToProcess(double requestTime)
 #endif
 
 //cout << "min null= " << m_min_null << " reqTime= " << requestTime << endl;
+  Sync_telemetry :: Check(Manifold::Now(), m_min_null, requestTime <= m_min_null, min_lp);
   if(requestTime <= m_min_null) {
 //cout << "min null= " << m_min_null << " reqTime= " << requestTime << "  safe" << endl;
       return true;
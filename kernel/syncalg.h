@@ -13,6 +13,7 @@
 #include "common-defs.h"
 #include "messenger.h"
 #include "lookahead.h"
+#include "sync_telemetry.h"
 
 namespace manifold {
 namespace kernel {
@@ -96,7 +97,10 @@ private:
         Time_t smallest_time;
     };
 
+    bool check_safe(double requestTime);
+
     Time_t m_grantedTime;
+    LpId_t m_constraint; //LP with the smallest time in the last all-gather, or -1
     unsigned long m_stats_LBTS_sync;
 };
 
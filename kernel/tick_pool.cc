@@ -0,0 +1,122 @@
+// Implementation of the tick handler thread pool
+
+#include <iostream>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "tick_pool.h"
+#include "clock.h"
+
+using namespace std;
+
+namespace manifold {
+namespace kernel {
+
+//Deferred action list of the handler the calling thread is stepping.
+static __thread DeferredActionVec_t* Current_deferred = 0;
+
+DeferredActionVec_t* Deferred_actions()
+{
+    return Current_deferred;
+}
+
+
+Tick_pool :: Tick_pool(unsigned n) :
+    m_generation(0), m_exit(false), m_batch(0), m_rising(true), m_next(0), m_busy(0)
+{
+    assert(n > 0);
+    pthread_mutex_init(&m_lock, 0);
+    pthread_cond_init(&m_start, 0);
+    pthread_cond_init(&m_done, 0);
+
+    m_workers.resize(n - 1);
+    for (unsigned i = 0; i < m_workers.size(); i++) {
+        if (pthread_create(&m_workers[i], 0, worker_main, this) != 0) {
+            cerr << "Tick_pool: cannot create thread" << endl;
+            exit(1);
+        }
+    }
+}
+
+
+Tick_pool :: ~Tick_pool()
+{
+    pthread_mutex_lock(&m_lock);
+    m_exit = true;
+    pthread_cond_broadcast(&m_start);
+    pthread_mutex_unlock(&m_lock);
+
+    for (unsigned i = 0; i < m_workers.size(); i++)
+        pthread_join(m_workers[i], 0);
+
+    pthread_cond_destroy(&m_done);
+    pthread_cond_destroy(&m_start);
+    pthread_mutex_destroy(&m_lock);
+}
+
+
+void Tick_pool :: step(vector<tickObjBase*>& batch, bool rising)
+{
+    pthread_mutex_lock(&m_lock);
+    m_batch = &batch;
+    m_rising = rising;
+    m_next = 0;
+    m_busy = m_workers.size();
+    m_generation++;
+    pthread_cond_broadcast(&m_start);
+    pthread_mutex_unlock(&m_lock);
+
+    run_tasks();
+
+    pthread_mutex_lock(&m_lock);
+    while (m_busy > 0)
+        pthread_cond_wait(&m_done, &m_lock);
+    m_batch = 0;
+    pthread_mutex_unlock(&m_lock);
+}
+
+
+//! Takes handlers from the current batch until none are left.
+void Tick_pool :: run_tasks()
+{
+    vector<tickObjBase*>& batch = *m_batch;
+    while (true) {
+        unsigned i = __sync_fetch_and_add(&m_next, 1);
+        if (i >= batch.size())
+            break;
+
+        tickObjBase* to = batch[i];
+        Current_deferred = &to->deferred;
+        Profiler::CallTick(to, m_rising);
+        Current_deferred = 0;
+    }
+}
+
+
+void* Tick_pool :: worker_main(void* arg)
+{
+    Tick_pool* pool = (Tick_pool*)arg;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool->m_lock);
+    while (true) {
+        while (pool->m_generation == seen && !pool->m_exit)
+            pthread_cond_wait(&pool->m_start, &pool->m_lock);
+        if (pool->m_exit)
+            break;
+        seen = pool->m_generation;
+        pthread_mutex_unlock(&pool->m_lock);
+
+        pool->run_tasks();
+
+        pthread_mutex_lock(&pool->m_lock);
+        if (--pool->m_busy == 0)
+            pthread_cond_signal(&pool->m_done);
+    }
+    pthread_mutex_unlock(&pool->m_lock);
+    return 0;
+}
+
+
+} //namespace kernel
+} //namespace manifold
@@ -0,0 +1,77 @@
+/** @file tick_pool.h
+ *  Thread pool used to step the tick handlers of a clock in parallel.
+ */
+
+#ifndef MANIFOLD_KERNEL_TICK_POOL_H
+#define MANIFOLD_KERNEL_TICK_POOL_H
+
+#include <vector>
+#include <pthread.h>
+
+namespace manifold {
+namespace kernel {
+
+class tickObjBase;
+
+/** Something a tick handler did, while it was being stepped in parallel, that
+ *  touches state shared with other handlers, such as sending on a link or
+ *  terminating the simulation. It is recorded instead of performed, and
+ *  performed by the simulation thread once the whole batch has been stepped.
+ */
+class DeferredAction
+{
+ public:
+  virtual ~DeferredAction() {}
+
+  //! Performs the recorded action.
+  virtual void Run() = 0;
+};
+
+typedef std::vector<DeferredAction*> DeferredActionVec_t;
+
+//! Returns the list in which the calling thread records deferred actions, or 0
+//! if the thread is not stepping a tick handler in parallel.
+DeferredActionVec_t* Deferred_actions();
+
+
+/** A fixed set of threads that step a batch of tick handlers. The simulation
+ *  thread takes part, so a pool of n threads starts n-1 workers. Each handler
+ *  is stepped by exactly one thread, and the actions it defers are kept in the
+ *  handler's own list, so the order in which they are later performed does not
+ *  depend on which thread stepped it.
+ */
+class Tick_pool
+{
+ public:
+  //! @arg \c n Number of threads, including the simulation thread.
+  Tick_pool(unsigned n);
+  ~Tick_pool();
+
+  unsigned get_num_threads() const { return m_workers.size() + 1; }
+
+  //! Calls the rising (or falling) tick handler of every object in batch and
+  //! returns when all of them are done.
+  void step(std::vector<tickObjBase*>& batch, bool rising);
+
+ private:
+  static void* worker_main(void* arg);
+  void run_tasks();
+
+  std::vector<pthread_t> m_workers;
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_start; //signaled when a batch is ready
+  pthread_cond_t m_done; //signaled when the last worker finishes a batch
+  unsigned m_generation; //incremented for each batch
+  bool m_exit;
+
+  std::vector<tickObjBase*>* m_batch;
+  bool m_rising;
+  unsigned m_next; //index of the next handler to hand out
+  unsigned m_busy; //workers that have not finished the current batch
+};
+
+
+} //namespace kernel
+} //namespace manifold
+
+#endif //MANIFOLD_KERNEL_TICK_POOL_H
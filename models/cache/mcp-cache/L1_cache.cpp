@@ -1,10 +1,12 @@
 #include "L1_cache.h"
 #include "kernel/manifold.h"
+#include "kernel/stat_sampler.h"
 #include "debug.h"
 
 
 #include <assert.h>
 #include <iostream>
+#include <sstream>
 
 
 using namespace std;
@@ -35,12 +37,8 @@ L1_cache::L1_cache (int nid, const cache_settings& parameters, const L1_cache_se
 
     this->my_table = new hash_table (parameters);
 
-    //mshr is created as a fully associated hash table.
-    cache_settings mshr_parameters = parameters;
-    mshr_parameters.assoc = settings.mshr_sz;
-    mshr_parameters.size = mshr_parameters.assoc * mshr_parameters.block_size; //1 set.
-
-    this->mshr = new hash_table (mshr_parameters);
+    this->mshr = new mshr_table (parameters, settings.mshr_sz);
+    mshr_map.resize(mshr->get_num_entries(), 0);
 
     mcp_stalled_req.resize(my_table->get_num_entries());
     //mcp_stalled_um_req.resize(my_table->get_num_entries());
@@ -54,6 +52,13 @@ L1_cache::L1_cache (int nid, const cache_settings& parameters, const L1_cache_se
     //flow control
     m_downstream_credits = settings.downstream_credits;
 
+    //each outstanding request may have a message and a credit in flight
+    m_proc_requests.reserve(settings.mshr_sz);
+    m_net_requests.reserve(settings.mshr_sz);
+    m_downstream_output_buffer.reserve(settings.downstream_credits + settings.mshr_sz);
+    m_credit_out_ticks.reserve(settings.mshr_sz);
+    m_msg_out_ticks.reserve(settings.downstream_credits + settings.mshr_sz);
+
     //stats
     stats_cycles = 0;
     stats_processor_read_requests = 0;
@@ -67,6 +72,13 @@ L1_cache::L1_cache (int nid, const cache_settings& parameters, const L1_cache_se
     stats_stall_buffer_max_size = 0;
     stats_table_occupancy = 0;
     stats_table_empty_cycles = 0;
+
+    ostringstream name;
+    name << "l1_" << nid << ".";
+    Stat_sampler :: Add(name.str() + "read_requests", &stats_processor_read_requests);
+    Stat_sampler :: Add(name.str() + "write_requests", &stats_processor_write_requests);
+    Stat_sampler :: Add(name.str() + "hits", &stats_hits);
+    Stat_sampler :: Add(name.str() + "misses", &stats_misses);
 }
 
 
@@ -247,7 +259,7 @@ void L1_cache :: process_processor_request (cache_req *request, bool first)
         DBG_L1_CACHE(cout, "  LRU_BUSY_STALL.\n");
 
         assert(first);
-        mshr_entry->invalidate();
+        mshr->release(mshr_entry);
         stall (request, C_LRU_BUSY_STALL);
         stats_LRU_BUSY_STALLs++;
             return;
@@ -267,7 +279,7 @@ void L1_cache :: process_processor_request (cache_req *request, bool first)
         //Treat TRANS_STALL the same way as LRU_BUSY_STALL. That is, we free the mshr and
         //wait for wakeup when the victim finishes.
         assert(first);
-        mshr_entry->invalidate();
+        mshr->release(mshr_entry);
         stall (request, C_TRANS_STALL);
         stats_TRANS_STALLs++;
             return;
@@ -720,7 +732,7 @@ void L1_cache :: release_mshr_entry(hash_entry* mshr_entry)
     DBG_L1_CACHE(cout, "    release_mshr_entry, entry= " << mshr_entry << "\n");
 
     mshr_map[mshr_entry->get_idx()] = 0;
-    mshr_entry->invalidate();
+    mshr->release(mshr_entry);
 
     //check the stall buffer and see if any request waiting for mshr
     std::list<Stall_buffer_entry>::iterator it = stalled_client_req_buffer.begin();
@@ -792,6 +804,60 @@ void L1_cache :: print_stats(std::ostream& out)
 }
 
 
+//####################################################################
+// functional warm-up
+//####################################################################
+warm_state_t L1_cache :: warm_get_state(paddr_t addr)
+{
+    hash_entry* e = my_table->get_entry(addr);
+    if(e == 0)
+        return WARM_I;
+    return clients[e->get_idx()]->warm_get_state();
+}
+
+
+//! Sets the state of a line that is present; WARM_I also frees the line.
+void L1_cache :: warm_set_state(paddr_t addr, warm_state_t st)
+{
+    hash_entry* e = my_table->get_entry(addr);
+    if(e == 0)
+        return;
+    clients[e->get_idx()]->warm_set_state(st);
+    if(st == WARM_I)
+        e->invalidate();
+}
+
+
+//! Frees a way in the set of addr if there is none, by dropping the LRU line.
+//! Returns true if a line is dropped; its address and state are returned in
+//! victim and victim_st, so the caller can tell its home L2.
+bool L1_cache :: warm_make_room(paddr_t addr, paddr_t& victim, warm_state_t& victim_st)
+{
+    std::vector<hash_entry*> entries;
+    my_table->get_set(addr)->get_entries(entries);
+    for(unsigned i=0; i<entries.size(); i++) {
+        if(clients[entries[i]->get_idx()]->warm_get_state() == WARM_I)
+            return false;
+    }
+
+    hash_entry* e = my_table->get_replacement_entry(addr);
+    victim = e->get_line_addr();
+    victim_st = clients[e->get_idx()]->warm_get_state();
+    clients[e->get_idx()]->warm_set_state(WARM_I);
+    e->invalidate();
+    return true;
+}
+
+
+void L1_cache :: warm_fill(paddr_t addr, warm_state_t st)
+{
+    hash_entry* e = my_table->reserve_block_for(addr);
+    assert(e);
+    e->set_have_data(true);
+    clients[e->get_idx()]->warm_set_state(st);
+}
+
+
 //####################################################################
 // for DestMap
 //####################################################################
@@ -6,6 +6,8 @@
 #include "coherence/ClientInterface.h"
 #include "kernel/component.h"
 #include "hash_table.h"
+#include "mshr_table.h"
+#include "ring_buffer.h"
 #include "cache_req.h"
 #include "coh_mem_req.h"
 #include "uarch/DestMap.h"
@@ -54,6 +56,13 @@ public:
 
     hash_entry* get_hash_entry_by_idx(unsigned idx) { return hash_entries[idx]; }
 
+    //functional warm-up; see Cache_warmup. Only valid when no request is in flight.
+    warm_state_t warm_get_state(paddr_t addr);
+    void warm_set_state(paddr_t addr, warm_state_t st);
+    bool warm_make_room(paddr_t addr, paddr_t& victim, warm_state_t& victim_st);
+    void warm_fill(paddr_t addr, warm_state_t st);
+    int warm_home(paddr_t addr) { return l2_map->lookup(addr); }
+
     void print_stats(std::ostream&);
 
     void set_l2_map(manifold::uarch::DestMap *m);
@@ -118,8 +127,8 @@ protected:
     int node_id;
     manifold::uarch::DestMap* l2_map;
     hash_table *my_table;
-    hash_table *mshr; /** Can view MSHRs as temporary blocks for use while an eviction is pending. Thus, a fully associative hash_table works great. */
-    std::map<int, hash_entry*> mshr_map; //map an mshr entry id to an entry in the hash table
+    mshr_table *mshr;
+    std::vector<hash_entry*> mshr_map; //map an mshr entry id to an entry in the hash table
 
     std::vector<ClientInterface*> clients;
     std::vector<hash_entry*> hash_entries; //allows mapping from client to hash_entry
@@ -149,21 +158,21 @@ protected:
     //LIST<pair <cache_req *, stall_type_t> > stalled_peer_message_buffer;
 
 
-    std::list<cache_req*> m_proc_requests; //store requests from processor
-    std::list<manifold::uarch::NetworkPacket*> m_net_requests; //store requests from network
+    Ring_buffer<cache_req*> m_proc_requests; //store requests from processor
+    Ring_buffer<manifold::uarch::NetworkPacket*> m_net_requests; //store requests from network
 
 
     //flow control
     int m_downstream_credits;
     const int DOWNSTREAM_FULL_CREDITS; //for debug purpose only
-    std::list<manifold::uarch::NetworkPacket*> m_downstream_output_buffer; //buffer holding output msg to peer or manager
+    Ring_buffer<manifold::uarch::NetworkPacket*> m_downstream_output_buffer; //buffer holding output msg to peer or manager
     void send_msg_after_lookup_time(manifold::uarch::NetworkPacket* pkt);
     virtual void try_send();
     virtual void send_credit_downstream();
 
     //output prediction
-    std::list<manifold::kernel::Ticks_t> m_credit_out_ticks;
-    std::list<manifold::kernel::Ticks_t> m_msg_out_ticks;
+    Ring_buffer<manifold::kernel::Ticks_t> m_credit_out_ticks;
+    Ring_buffer<manifold::kernel::Ticks_t> m_msg_out_ticks;
 
     //stats
     unsigned long stats_cycles;
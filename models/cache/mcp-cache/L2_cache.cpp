@@ -1,6 +1,8 @@
 #include <assert.h>
+#include <sstream>
 #include "L2_cache.h"
 #include "kernel/manifold.h"
+#include "kernel/stat_sampler.h"
 #include "debug.h"
 
 using namespace manifold::uarch;
@@ -32,17 +34,18 @@ L2_cache :: L2_cache (int nid, const cache_settings& parameters, const L2_cache_
 
     this->my_table = new hash_table (parameters);
 
-    //mshr is created as a fully associated hash table.
-    cache_settings mshr_settings = parameters;
-    mshr_settings.assoc = settings.mshr_sz;
-    mshr_settings.size = mshr_settings.assoc * mshr_settings.block_size; //1 set.
-
-    this->mshr = new hash_table (mshr_settings);
+    this->mshr = new mshr_table (parameters, settings.mshr_sz);
+    mshr_map.resize(mshr->get_num_entries(), 0);
 
     mcp_stalled_req.resize(my_table->get_num_entries());
     for(unsigned i=0; i<mcp_stalled_req.size(); i++)
         mcp_stalled_req[i] = 0;
 
+    //output queues start with room for a full window of credits; they grow if needed
+    m_downstream_output_buffer.reserve(settings.downstream_credits + settings.mshr_sz);
+    m_credit_out_ticks.reserve(settings.mshr_sz);
+    m_msg_out_ticks.reserve(settings.downstream_credits + settings.mshr_sz);
+
     //stats
     stats_num_reqs = 0;
     stats_miss = 0;
@@ -57,6 +60,13 @@ L2_cache :: L2_cache (int nid, const cache_settings& parameters, const L2_cache_
     stats_mshr_empty_cycles = 0;
     stats_read_mem = 0;
     stats_dirty_to_mem = 0;
+
+    std::ostringstream name;
+    name << "l2_" << nid << ".";
+    Stat_sampler :: Add(name.str() + "requests", &stats_num_reqs);
+    Stat_sampler :: Add(name.str() + "misses", &stats_miss);
+    Stat_sampler :: Add(name.str() + "read_mem", &stats_read_mem);
+    Stat_sampler :: Add(name.str() + "dirty_to_mem", &stats_dirty_to_mem);
 }
 
 
@@ -258,7 +268,7 @@ void L2_cache::process_client_request (Coh_msg* request, bool first)
         if(managers[0]->is_invalidation_request(request)) {
             DBG_L2_CACHE(cout, "    L2_cache: a missed invalidation request; ignore it.\n");
 
-            mshr_entry->invalidate();
+            mshr->release(mshr_entry);
             delete request;
             return;
         }
@@ -307,7 +317,7 @@ void L2_cache::process_client_request (Coh_msg* request, bool first)
                 DBG_L2_CACHE(cout, "    LRU BUSY_STALL waiting for " <<hex<< my_table->get_replacement_entry(request->addr)->get_line_addr() <<dec<< "\n");
 
                 assert(first);
-                mshr_entry->invalidate();
+                mshr->release(mshr_entry);
                 stall (request, C_LRU_BUSY_STALL);
                 stats_LRU_BUSY_STALLs++;
                 return;
@@ -335,7 +345,7 @@ void L2_cache::process_client_request (Coh_msg* request, bool first)
             DBG_L2_CACHE(cout, "    L2_cache: TRANS_STALL\n");
 
             assert(first);
-            mshr_entry->invalidate();
+            mshr->release(mshr_entry);
             stall (request, C_TRANS_STALL);
             stats_TRANS_STALLs++;
             return;
@@ -741,7 +751,7 @@ void L2_cache :: ignore(ManagerInterface* mgr)
 void L2_cache :: release_mshr_entry(hash_entry* mshr_entry)
 {
     mshr_map[mshr_entry->get_idx()] = 0;
-    mshr_entry->invalidate();
+    mshr->release(mshr_entry);
 
 
     //check the stall buffer and see if any request waiting for mshr
@@ -827,6 +837,74 @@ void L2_cache :: print_stats(std::ostream& out)
         << "    dirty to mem= " << stats_dirty_to_mem << endl;
 }
 
+//####################################################################
+// functional warm-up
+//####################################################################
+hash_entry* L2_cache :: warm_get_entry(paddr_t addr)
+{
+    if (l2_map->get_page_offset_bits() > my_table->get_offset_bits())
+        addr = l2_map->get_local_addr(addr);
+    return my_table->get_entry(addr);
+}
+
+
+//! Makes addr present, dropping the LRU line of the set if there is no free
+//! way. Returns true if addr was not present. If a line is dropped, its address
+//! is returned in victim and the L1s that hold it are added to inv.
+bool L2_cache :: warm_fill(paddr_t addr, std::vector<int>& inv, paddr_t& victim)
+{
+    if(warm_get_entry(addr))
+        return false;
+
+    paddr_t laddr = addr;
+    if (l2_map->get_page_offset_bits() > my_table->get_offset_bits())
+        laddr = l2_map->get_local_addr(addr);
+
+    hash_entry* e = my_table->reserve_block_for(laddr);
+    if(e == 0) {
+        hash_entry* v = my_table->get_replacement_entry(laddr);
+        managers[v->get_idx()]->warm_evict(inv);
+        victim = v->get_line_addr();
+        if (l2_map->get_page_offset_bits() > my_table->get_offset_bits())
+            victim = l2_map->get_global_addr(victim, node_id);
+        v->invalidate();
+        e = my_table->reserve_block_for(laddr);
+        assert(e);
+    }
+    e->set_have_data(true);
+    return true;
+}
+
+
+//! The line must be present. The L1s to invalidate are added to inv; down is
+//! set to the L1 to downgrade to S, or -1.
+warm_state_t L2_cache :: warm_request(paddr_t addr, int src, bool write, std::vector<int>& inv, int& down)
+{
+    hash_entry* e = warm_get_entry(addr);
+    assert(e);
+    return managers[e->get_idx()]->warm_request(src, write, inv, down);
+}
+
+
+//! Eviction of an E or M line by L1 src; the line is dropped, as in the
+//! timing model.
+void L2_cache :: warm_put(paddr_t addr, int src)
+{
+    hash_entry* e = warm_get_entry(addr);
+    assert(e);
+    if(managers[e->get_idx()]->warm_put(src))
+        e->invalidate();
+}
+
+
+void L2_cache :: warm_set_dirty(paddr_t addr)
+{
+    hash_entry* e = warm_get_entry(addr);
+    assert(e);
+    e->set_dirty(true);
+}
+
+
 //####################################################################
 // for DestMap
 //####################################################################
@@ -6,6 +6,8 @@
 #include "coherence/ManagerInterface.h"
 #include "kernel/component.h"
 #include "hash_table.h"
+#include "mshr_table.h"
+#include "ring_buffer.h"
 #include "coh_mem_req.h"
 #include "uarch/networkPacket.h"
 #include "uarch/DestMap.h"
@@ -55,6 +57,12 @@ public:
 
     hash_entry* get_hash_entry_by_idx(unsigned idx) { return hash_entries[idx]; }
 
+    //functional warm-up; see Cache_warmup. Addresses are global.
+    bool warm_fill(paddr_t addr, std::vector<int>& inv, paddr_t& victim);
+    warm_state_t warm_request(paddr_t addr, int src, bool write, std::vector<int>& inv, int& down);
+    void warm_put(paddr_t addr, int src);
+    void warm_set_dirty(paddr_t addr);
+
     void print_stats(std::ostream&);
 
     static void Set_msg_types(int coh, int mem, int credit)
@@ -88,6 +96,8 @@ private:
 
     static void update_hash_entry(hash_entry* e1, hash_entry* e2);
 
+    hash_entry* warm_get_entry(paddr_t addr);
+
     void release_mshr_entry(hash_entry* mshr_entry);
 
     //debug
@@ -111,13 +121,13 @@ protected:
     manifold::uarch::DestMap* l2_map;
 
     hash_table *my_table;
-    hash_table *mshr; /** Can view MSHRs as temporary blocks for use while an eviction is pending. Thus, a fully associative hash_table works great. */
+    mshr_table *mshr;
 
     std::vector<ManagerInterface*> managers;
     std::vector<hash_entry*> hash_entries; //allows mapping from manager to hash_entry
 
 
-    std::map<int, hash_entry*> mshr_map; //map an mshr entry id to an entry in the hash table
+    std::vector<hash_entry*> mshr_map; //map an mshr entry id to an entry in the hash table
 
     struct Stall_buffer_entry {
         Coh_msg* req;
@@ -137,15 +147,15 @@ protected:
     //flow control
     int m_downstream_credits;
     const int DOWNSTREAM_FULL_CREDITS; //for debug purpose only
-    std::list<manifold::uarch::NetworkPacket*> m_downstream_output_buffer; //buffer holding output msg to L1
+    Ring_buffer<manifold::uarch::NetworkPacket*> m_downstream_output_buffer; //buffer holding output msg to L1
     void send_msg_after_lookup_time(manifold::uarch::NetworkPacket* pkt);
     virtual void try_send();
     void schedule_send_credit();
     virtual void send_credit_downstream();
 
     //output prediction
-    std::list<manifold::kernel::Ticks_t> m_credit_out_ticks;
-    std::list<manifold::kernel::Ticks_t> m_msg_out_ticks;
+    Ring_buffer<manifold::kernel::Ticks_t> m_credit_out_ticks;
+    Ring_buffer<manifold::kernel::Ticks_t> m_msg_out_ticks;
 
     //stats
     unsigned long stats_cycles;
@@ -22,6 +22,7 @@ namespace mcp_cache_namespace {
 LLP_cache :: LLP_cache (int nid, const cache_settings& parameters, const L1_cache_settings& settings) :
       L1_cache (nid, parameters, settings), m_mux(0)
 {
+    m_lls_requests.reserve(settings.mshr_sz);
 }
 
 
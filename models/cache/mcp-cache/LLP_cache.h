@@ -54,7 +54,7 @@ protected:
     virtual void try_send();
     virtual void send_credit_downstream();
 
-    std::list<Coh_msg*> m_lls_requests;
+    Ring_buffer<Coh_msg*> m_lls_requests;
 };
 
 
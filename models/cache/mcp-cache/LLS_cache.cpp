@@ -17,6 +17,7 @@ namespace mcp_cache_namespace {
 LLS_cache :: LLS_cache (int nid, const cache_settings& parameters, const L2_cache_settings& settings) :
     L2_cache (nid, parameters, settings), m_mux(0)
 {
+    m_llp_incoming.reserve(settings.mshr_sz);
     stats_cycles = 0;
 }
 
@@ -39,7 +39,7 @@ public:
 
 private:
     MuxDemux* m_mux;
-    std::list<Coh_msg*> m_llp_incoming;
+    Ring_buffer<Coh_msg*> m_llp_incoming;
 
     void add_to_output_buffer(manifold::uarch::NetworkPacket* pkt);
 
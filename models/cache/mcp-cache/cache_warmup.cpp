@@ -0,0 +1,104 @@
+#include "cache_warmup.h"
+#include <stdlib.h>
+
+using namespace std;
+
+namespace manifold {
+namespace mcp_cache_namespace {
+
+
+Cache_warmup :: Cache_warmup() : stats_accesses(0), stats_l1_hits(0), stats_l2_misses(0)
+{
+}
+
+
+L1_cache* Cache_warmup :: get_l1(int node)
+{
+    map<int, L1_cache*>::iterator it = m_l1s.find(node);
+    if(it == m_l1s.end()) {
+        cerr << "Cache_warmup: no L1 with node id " << node << endl;
+        exit(1);
+    }
+    return (*it).second;
+}
+
+
+L2_cache* Cache_warmup :: get_l2(int node)
+{
+    map<int, L2_cache*>::iterator it = m_l2s.find(node);
+    if(it == m_l2s.end()) {
+        cerr << "Cache_warmup: no L2 with node id " << node << endl;
+        exit(1);
+    }
+    return (*it).second;
+}
+
+
+void Cache_warmup :: invalidate_l1s(const vector<int>& nodes, paddr_t addr)
+{
+    for(unsigned i=0; i<nodes.size(); i++)
+        get_l1(nodes[i])->warm_set_state(addr, WARM_I);
+}
+
+
+void Cache_warmup :: access(int node, paddr_t addr, bool is_read)
+{
+    stats_accesses++;
+
+    L1_cache* l1 = get_l1(node);
+    warm_state_t st = l1->warm_get_state(addr);
+
+    //hit: E is upgraded to M locally, as the client does.
+    if(st == WARM_M || st == WARM_E || (st == WARM_S && is_read)) {
+        stats_l1_hits++;
+        if(!is_read && st == WARM_E)
+            l1->warm_set_state(addr, WARM_M);
+        return;
+    }
+
+    //make room in the L1; only E and M evictions are seen by the L2.
+    if(st == WARM_I) {
+        paddr_t victim;
+        warm_state_t victim_st;
+        if(l1->warm_make_room(addr, victim, victim_st) && (victim_st == WARM_E || victim_st == WARM_M))
+            get_l2(l1->warm_home(victim))->warm_put(victim, node);
+    }
+
+    L2_cache* l2 = get_l2(l1->warm_home(addr));
+
+    vector<int> inv;
+    paddr_t victim;
+    if(l2->warm_fill(addr, inv, victim)) {
+        assert(st == WARM_I); //an L1 in S is a sharer, so the line is in the L2.
+        stats_l2_misses++;
+        invalidate_l1s(inv, victim);
+        inv.clear();
+    }
+
+    int down;
+    warm_state_t granted = l2->warm_request(addr, node, !is_read, inv, down);
+    invalidate_l1s(inv, addr);
+    if(down != -1) {
+        L1_cache* owner = get_l1(down);
+        if(owner->warm_get_state(addr) == WARM_M)
+            l2->warm_set_dirty(addr);
+        owner->warm_set_state(addr, WARM_S);
+    }
+
+    if(st == WARM_I)
+        l1->warm_fill(addr, granted);
+    else
+        l1->warm_set_state(addr, granted);
+}
+
+
+void Cache_warmup :: print_stats(ostream& out)
+{
+    out << "Cache warm-up: " << stats_accesses << " references, "
+        << m_l1s.size() << " L1s, " << m_l2s.size() << " L2s" << endl
+        << "    L1 hits= " << stats_l1_hits << " L2 misses= " << stats_l2_misses << endl;
+}
+
+
+} //namespace mcp_cache_namespace
+} //namespace manifold
@@ -0,0 +1,62 @@
+#ifndef MANIFOLD_MCP_CACHE_CACHE_WARMUP_H
+#define MANIFOLD_MCP_CACHE_CACHE_WARMUP_H
+
+#include <map>
+#include <iostream>
+#include "L1_cache.h"
+#include "L2_cache.h"
+
+namespace manifold {
+namespace mcp_cache_namespace {
+
+
+//! @brief Functional warm-up of the MESI caches: applies memory references to
+//! the tag arrays and coherence states directly, without messages, the
+//! network or timing, so a run can start with warm caches instead of
+//! simulating the warm-up in detail.
+//!
+//! Each reference leaves the caches in the state the timing model would reach
+//! once the request and the messages it causes are done: LRU replacement,
+//! silent eviction of S lines, write-back and removal from the L2 of E and M
+//! lines evicted by an L1, and invalidation of the L1 copies of a line evicted
+//! from the L2. Dirty lines evicted from the L2 are dropped, as memory has no
+//! state to warm.
+//!
+//! It must be used before the simulation starts, and all the L1s and L2s must
+//! be added, so every cache has to be on this LP.
+class Cache_warmup {
+public:
+    Cache_warmup();
+
+    void add_l1(L1_cache* l1) { m_l1s[l1->get_node_id()] = l1; }
+    void add_l2(L2_cache* l2) { m_l2s[l2->get_node_id()] = l2; }
+
+    //! Applies a reference of the L1 with the given node id.
+    void access(int node, paddr_t addr, bool is_read);
+
+    void print_stats(std::ostream&);
+
+    unsigned long get_accesses() const { return stats_accesses; }
+    unsigned long get_l1_hits() const { return stats_l1_hits; }
+    unsigned long get_l2_misses() const { return stats_l2_misses; }
+
+private:
+    L1_cache* get_l1(int node);
+    L2_cache* get_l2(int node);
+
+    void invalidate_l1s(const std::vector<int>& nodes, paddr_t addr);
+
+    std::map<int, L1_cache*> m_l1s;
+    std::map<int, L2_cache*> m_l2s;
+
+    //stats
+    unsigned long stats_accesses;
+    unsigned long stats_l1_hits;
+    unsigned long stats_l2_misses;
+};
+
+
+} //namespace mcp_cache_namespace
+} //namespace manifold
+
+#endif //MANIFOLD_MCP_CACHE_CACHE_WARMUP_H
@@ -9,6 +9,15 @@ namespace mcp_cache_namespace {
 
 class hash_entry;
 
+//! Stable states used by the functional warm-up; protocols map their own
+//! states onto these.
+typedef enum {
+    WARM_I = 0,
+    WARM_S,     /** read permission */
+    WARM_E,     /** read and write permission, clean */
+    WARM_M      /** read and write permission, dirty */
+} warm_state_t;
+
 typedef enum {
     NO_CLIENT = 0,
     SIMPLE_CLIENT,
@@ -60,6 +69,10 @@ class ClientInterface
         /** Called by the Manager to complete preivous SupplyInvalidate demand.  Supplies data packet and signifies realm invalidation has completed */
         virtual void SupplyInvalidateAck() = 0;
 
+        /** Functional warm-up: current stable state, and setting it directly without sending messages. */
+        virtual warm_state_t warm_get_state() = 0;
+        virtual void warm_set_state(warm_state_t) = 0;
+
 
     protected:
         /** ID of the client */
@@ -200,347 +200,131 @@ bool MESI_client :: req_pending()
 }
 
 
-
-
-//! @param \c fwdID  The ID of the client to forward msg to. If no forward, can be any value.
-void MESI_client::process(int msg, int fwdID)
+warm_state_t MESI_client :: warm_get_state()
 {
-    MESI_messages_t m = (MESI_messages_t) msg;
-
-    switch(state)
-    {
-	case MESI_C_I:
-            do_I(m);
-            break;
-	case MESI_C_S:
-            do_S(m);
-            break;
-	case MESI_C_E:
-            do_E(m, fwdID);
-            break;
-        case MESI_C_M:
-            do_M(m, fwdID);
-            break;
-        case MESI_C_IE:
-            do_IE(m);
-            break;
-        case MESI_C_EI:
-            do_EI(m, fwdID);
-            break;
-        case MESI_C_MI:
-            do_MI(m, fwdID);
-            break;
-        case MESI_C_SE:
-            do_SE(m);
-            break;
-        //case MESI_C_SIE:
-            //do_SIE(m);
-            //break;
-        default:
-            invalid_msg((MESI_messages_t)msg);
-            break;
-    }
-}
-
-
-
-inline void MESI_client::do_I(MESI_messages_t msg)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client in state I, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case GET_E:
-            sendmsg(true, MESI_CM_I_to_E);
-            transition_to_ie();
-            break;
-        case GET_S:
-            sendmsg(true, MESI_CM_I_to_S);
-            transition_to_ie();
-            break;
-        default:
-            invalid_msg(msg);
-	    break;
-    }
-}
-
-
-
-inline void MESI_client::do_S(MESI_messages_t msg)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client in state S, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case GET_E:
-            sendmsg(true, MESI_CM_I_to_E); //should we create a new message MESI_CM_S_to_E and
-	                                   //use it instead ??????????????????????????????
-            //transition_to_sie();
-            transition_to_se(); //go to SE and wait for GRANT_E, as manager won't send DEMAND_I to us.
-            break;
-        case GET_S:
-            break;
-        case GET_EVICT:
-            transition_to_i();
-            break;
-        case MESI_MC_DEMAND_I:
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-            transition_to_i();
-            break;
-        default:
-            invalid_msg(msg);
-	    break;
-    }
-}
-
-
-
-
-inline void MESI_client::do_E(MESI_messages_t msg, int fwdID)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client in state E, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case GET_E:
-            transition_to_m();
-            break;
-        case GET_S:
-            break;
-        case MESI_MC_FWD_E:
-            sendmsg(false, MESI_CC_E_DATA, fwdID); // send to client in IE.
-            transition_to_i();
-            break;
-        case MESI_MC_FWD_S:
-            sendmsg(false, MESI_CC_S_DATA, fwdID); // send to client in IE.
-            sendmsg(false, MESI_CM_CLEAN);
-            transition_to_s();
-            break;
-        case GET_EVICT:
-            sendmsg(true, MESI_CM_E_to_I);
-            transition_to_ei();
-            break;
-        case MESI_MC_DEMAND_I:
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-            transition_to_i();
-            break;
-        default:
-            invalid_msg(msg);
-	    break;
-    }
-}
-
-inline void MESI_client::do_M(MESI_messages_t msg, int fwdID)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client in state M, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case GET_E:
-        case GET_S:
-            break;
-        case MESI_MC_DEMAND_I:
-            sendmsg(false, MESI_CM_UNBLOCK_I_DIRTY);
-            transition_to_i();
-            break;
-        case GET_EVICT:
-            sendmsg(true, MESI_CM_M_to_I);
-            transition_to_mi();
-            break;
-        case MESI_MC_FWD_E:
-            sendmsg(false, MESI_CC_M_DATA, fwdID);
-             transition_to_i();
-             break;
-        case MESI_MC_FWD_S:
-            sendmsg(false, MESI_CC_S_DATA, fwdID);
-            sendmsg(false, MESI_CM_WRITEBACK);
-            transition_to_s();
-            break;
-        default:
-            invalid_msg(msg);
-	    break;
+    switch(state) {
+        case MESI_C_I: return WARM_I;
+        case MESI_C_S: return WARM_S;
+        case MESI_C_E: return WARM_E;
+        case MESI_C_M: return WARM_M;
+	default:
+	    invalid_state();
+	    assert(0);
+	    return WARM_I;
     }
 }
 
 
-
-inline void MESI_client::do_IE(MESI_messages_t msg)
+//! Unlike transition_to_i(), this does not call invalidate(); the cache
+//! frees the line itself.
+void MESI_client :: warm_set_state(warm_state_t s)
 {
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client " << id << " in state IE, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case MESI_CC_E_DATA: // data forwarded to me
-            sendmsg(false, MESI_CM_UNBLOCK_E);
-            transition_to_e();
-            break;
-        case MESI_CC_S_DATA: // data forwarded to me
-            sendmsg(false, MESI_CM_UNBLOCK_S);
-            transition_to_s();
-            break;
-        case MESI_MC_GRANT_E_DATA: // data given to me by manager
-            sendmsg(false, MESI_CM_UNBLOCK_E);
-            transition_to_e();
-            break;
-        case MESI_MC_GRANT_S_DATA: // sharing
-            sendmsg(false, MESI_CM_UNBLOCK_S);
-            transition_to_s();
-            break;
-        case MESI_CC_M_DATA: // data forwarded by M state guy Will never happen?
-            sendmsg(false, MESI_CM_UNBLOCK_E);
-            transition_to_m();
-            break;
-	//DEMAND_I could happen like this: The line was in S but was evicted. Manager was not notified. Later,
-	//A request for the SAME line caused an I_to_E sent to manager. At the same time, the line was evicted
-	//on manager side, so manager sends a DEMAND_I.
-        case MESI_MC_DEMAND_I: //when a line X was evicted in the S state, manager still thinks it's a sharer;
-	                       //a store for X would cause manager to invalidate X first (i.e., MC_DEMAND_I);
-			       //so we need to respond.
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-	    break;
-        default:
-            invalid_msg(msg);
-	    break;
+    assert(!req_pending());
+    switch(s) {
+        case WARM_I: state = MESI_C_I; break;
+        case WARM_S: state = MESI_C_S; break;
+        case WARM_E: state = MESI_C_E; break;
+        case WARM_M: state = MESI_C_M; break;
     }
 }
 
 
-inline void MESI_client::do_SE(MESI_messages_t msg)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client " << id << " in state SE, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case MESI_MC_GRANT_E_DATA: // data given to me by manager
-            sendmsg(false, MESI_CM_UNBLOCK_E);
-            transition_to_e();
-            break;
-        case MESI_MC_DEMAND_I: //while client changing from S to E, manager is evicting the same line.
-	                       //The client's write request will be processed in due time, so we respond
-			       //to allow manager to finish eviciton first.
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-            transition_to_ie();
-	    break;
-        case MESI_CC_M_DATA: // This happens during a race condition. While we are going from S to E, another
-	                     // client writes to the same line and its request got to the manager before us.
-			     // Finally when our I_to_E is being processed, the other client already is the owner,
-			     // so it will send us CC_M_DATA.
-            sendmsg(false, MESI_CM_UNBLOCK_E);
-            transition_to_m();
-            break;
-        default:
-            invalid_msg(msg);
-	    break;
-    }
-}
-
 
 
-inline void MESI_client::do_EI(MESI_messages_t msg, int fwdID)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client in state EI, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case MESI_MC_GRANT_I:
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-            transition_to_i();
-            break;
-        case MESI_MC_FWD_S: //we have started eviction, but manager just got a LOAD request and wants us to
-	                    //transit to S state. We act as if the eviction never happened and we were still in E,
-			    //but silenly transit to I.
-			    //Manager would ignore the CM_E_to_I we just sent.
-	    sendmsg(false, MESI_CC_E_DATA, fwdID); // send to peer in IE. Send CC_E_DATA so it would enter E state.
-	    //sendmsg(false, MESI_CM_CLEAN); NO msg to manager since it will get UNBLOCK_E from peer.
-	    transition_to_i();
-            break;
-        case MESI_MC_FWD_E: //we have started eviction, but manager just got a STORE request and wants us to
-	                    //transit to I state. We act as if the eviction never happened and we were still in E,
-			    //and silently transit to I.
-			    //Manager would ignore the CM_E_to_I we just sent.
-	    sendmsg(false, MESI_CC_E_DATA, fwdID);
-	    transition_to_i();
-	    break;
-        case MESI_MC_DEMAND_I: //we have started eviction, but manager just got a request and wants to invalidate us.
-	                    //We act as if the eviction never happened and we were still in E,
-			    //and silently transit to I.
-			    //Manager would ignore the CM_E_to_I we just sent.
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-	    transition_to_i();
-	    break;
-        default:
-            invalid_msg(msg);
-            break;
-    }
-}
+static const int NONE = -1;
+
+//! The MESI client protocol. For each legal (state, msg) pair: the request to
+//! send to the manager, the reply to send to the forwarding client, the reply
+//! to send to the manager, in that order, and the next state. Messages sent in
+//! a transition to I are sent before the line is invalidated.
+const MESI_client :: Transition MESI_client :: Client_transitions[] = {
+    //state      msg                   request           reply to fwdID   reply to manager          next
+    { MESI_C_I,  GET_E,                MESI_CM_I_to_E,   NONE,            NONE,                     MESI_C_IE },
+    { MESI_C_I,  GET_S,                MESI_CM_I_to_S,   NONE,            NONE,                     MESI_C_IE },
+
+    //should we create a new message MESI_CM_S_to_E and use it instead ??????????????????????????????
+    //go to SE and wait for GRANT_E, as manager won't send DEMAND_I to us.
+    { MESI_C_S,  GET_E,                MESI_CM_I_to_E,   NONE,            NONE,                     MESI_C_SE },
+    { MESI_C_S,  GET_S,                NONE,             NONE,            NONE,                     MESI_C_S },
+    { MESI_C_S,  GET_EVICT,            NONE,             NONE,            NONE,                     MESI_C_I },
+    { MESI_C_S,  MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_I },
+
+    { MESI_C_E,  GET_E,                NONE,             NONE,            NONE,                     MESI_C_M },
+    { MESI_C_E,  GET_S,                NONE,             NONE,            NONE,                     MESI_C_E },
+    { MESI_C_E,  MESI_MC_FWD_E,        NONE,             MESI_CC_E_DATA,  NONE,                     MESI_C_I },
+    { MESI_C_E,  MESI_MC_FWD_S,        NONE,             MESI_CC_S_DATA,  MESI_CM_CLEAN,            MESI_C_S },
+    { MESI_C_E,  GET_EVICT,            MESI_CM_E_to_I,   NONE,            NONE,                     MESI_C_EI },
+    { MESI_C_E,  MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_I },
+
+    { MESI_C_M,  GET_E,                NONE,             NONE,            NONE,                     MESI_C_M },
+    { MESI_C_M,  GET_S,                NONE,             NONE,            NONE,                     MESI_C_M },
+    { MESI_C_M,  MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I_DIRTY,  MESI_C_I },
+    { MESI_C_M,  GET_EVICT,            MESI_CM_M_to_I,   NONE,            NONE,                     MESI_C_MI },
+    { MESI_C_M,  MESI_MC_FWD_E,        NONE,             MESI_CC_M_DATA,  NONE,                     MESI_C_I },
+    { MESI_C_M,  MESI_MC_FWD_S,        NONE,             MESI_CC_S_DATA,  MESI_CM_WRITEBACK,        MESI_C_S },
+
+    { MESI_C_IE, MESI_CC_E_DATA,       NONE,             NONE,            MESI_CM_UNBLOCK_E,        MESI_C_E }, //data forwarded to me
+    { MESI_C_IE, MESI_CC_S_DATA,       NONE,             NONE,            MESI_CM_UNBLOCK_S,        MESI_C_S }, //data forwarded to me
+    { MESI_C_IE, MESI_MC_GRANT_E_DATA, NONE,             NONE,            MESI_CM_UNBLOCK_E,        MESI_C_E }, //data given to me by manager
+    { MESI_C_IE, MESI_MC_GRANT_S_DATA, NONE,             NONE,            MESI_CM_UNBLOCK_S,        MESI_C_S }, //sharing
+    { MESI_C_IE, MESI_CC_M_DATA,       NONE,             NONE,            MESI_CM_UNBLOCK_E,        MESI_C_M }, //data forwarded by M state guy
+    //DEMAND_I could happen like this: The line was in S but was evicted. Manager was not notified. Later,
+    //A request for the SAME line caused an I_to_E sent to manager. At the same time, the line was evicted
+    //on manager side, so manager sends a DEMAND_I.
+    { MESI_C_IE, MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_IE },
+
+    { MESI_C_SE, MESI_MC_GRANT_E_DATA, NONE,             NONE,            MESI_CM_UNBLOCK_E,        MESI_C_E },
+    //while client changing from S to E, manager is evicting the same line. The client's write request
+    //will be processed in due time, so we respond to allow manager to finish eviciton first.
+    { MESI_C_SE, MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_IE },
+    //This happens during a race condition. While we are going from S to E, another client writes to the
+    //same line and its request got to the manager before us. Finally when our I_to_E is being processed,
+    //the other client already is the owner, so it will send us CC_M_DATA.
+    { MESI_C_SE, MESI_CC_M_DATA,       NONE,             NONE,            MESI_CM_UNBLOCK_E,        MESI_C_M },
+
+    //In EI and MI, a request from the manager takes precedence: we act as if the eviction never happened
+    //and we were still in E (M), and silently transit to I. Manager would ignore the CM_E_to_I (CM_M_to_I)
+    //we sent. On FWD_S we send E (M) data so the requestor would enter E (M); no msg to manager since it
+    //will get UNBLOCK_E from the requestor.
+    { MESI_C_EI, MESI_MC_GRANT_I,      NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_I },
+    { MESI_C_EI, MESI_MC_FWD_S,        NONE,             MESI_CC_E_DATA,  NONE,                     MESI_C_I },
+    { MESI_C_EI, MESI_MC_FWD_E,        NONE,             MESI_CC_E_DATA,  NONE,                     MESI_C_I },
+    { MESI_C_EI, MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_I },
+
+    { MESI_C_MI, MESI_MC_GRANT_I,      NONE,             NONE,            MESI_CM_UNBLOCK_I,        MESI_C_I },
+    { MESI_C_MI, MESI_MC_FWD_S,        NONE,             MESI_CC_M_DATA,  NONE,                     MESI_C_I },
+    { MESI_C_MI, MESI_MC_FWD_E,        NONE,             MESI_CC_M_DATA,  NONE,                     MESI_C_I },
+    { MESI_C_MI, MESI_MC_DEMAND_I,     NONE,             NONE,            MESI_CM_UNBLOCK_I_DIRTY,  MESI_C_I },
+};
+
+
+const MESI_client :: Table MESI_client :: Transitions(Client_transitions, sizeof(Client_transitions)/sizeof(Client_transitions[0]));
 
 
-inline void MESI_client::do_MI(MESI_messages_t msg, int fwdID)
+//! @param \c fwdID  The ID of the client to forward msg to. If no forward, can be any value.
+void MESI_client::process(int msg, int fwdID)
 {
 #ifdef DBG_MESI_CLIENT
-std::cout << "Client in state MI, msg= " << msg << std::endl;
+std::cout << "Client " << id << " in state " << state << ", msg= " << msg << std::endl;
 #endif
-    switch (msg)
-    {
-        case MESI_MC_GRANT_I:
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-            transition_to_i();
-            break;
-        case MESI_MC_FWD_S: //we have started eviction, but manager just got a LOAD request and wants us to
-	                    //transit to S state. We act as if the eviction never happened and we were still in M,
-			    //but silenly transit to I.
-			    //Manager would ignore the CM_M_to_I we just sent.
-	    sendmsg(false, MESI_CC_M_DATA, fwdID); // send MESI_CC_M_DATA so requestor would enter M state.
-	    //sendmsg(false, MESI_CM_WRITEBACK); No msg to manager since it will get UNBLOCK_E from requestor.
-	    transition_to_i();
-	    break;
-        case MESI_MC_FWD_E: //we have started eviction, but manager just got a STORE request and wants us to
-	                    //transit to I state. We act as if the eviction never happened and we were still in M,
-			    //and silently transit to I.
-			    //Manager would ignore the CM_M_to_I we just sent.
-	    sendmsg(false, MESI_CC_M_DATA, fwdID);
-	    transition_to_i(); //go to I as if we were evicting in S state.
-	    break;
-        case MESI_MC_DEMAND_I: //we have started eviction, but manager just got a request and wants to invalidate us.
-	                    //We act as if the eviction never happened and we were still in M,
-			    //and silently transit to I.
-			    //Manager would ignore the CM_M_to_I we just sent.
-            sendmsg(false, MESI_CM_UNBLOCK_I_DIRTY);
-	    transition_to_i();
-	    break;
-        default:
-            invalid_msg(msg);
-            break;
+    const Transition* t = Transitions.lookup(state, msg);
+    if(t == 0) {
+        invalid_msg((MESI_messages_t)msg);
+        return;
     }
-}
-
 
-
-/*
-inline void MESI_client::do_SIE(MESI_messages_t msg)
-{
-#ifdef DBG_MESI_CLIENT
-std::cout << "Client in state SIE, msg= " << msg << std::endl;
-#endif
-    switch (msg)
-    {
-        case MESI_MC_DEMAND_I:
-            sendmsg(false, MESI_CM_UNBLOCK_I);
-            transition_to_ie();
-            break;
-        default:
-            invalid_msg(msg);
-            break;
-    }
+    if(t->req != NONE)
+        sendmsg(true, (MESI_messages_t)t->req);
+    if(t->fwd_reply != NONE)
+        sendmsg(false, (MESI_messages_t)t->fwd_reply, fwdID);
+    if(t->reply != NONE)
+        sendmsg(false, (MESI_messages_t)t->reply);
+
+    if(t->next == MESI_C_I)
+        transition_to_i();
+    else
+        state = t->next;
 }
-*/
 
 
 
@@ -550,14 +334,6 @@ void MESI_client::transition_to_i()
     invalidate();
 }
 
-void MESI_client::transition_to_ie() { state = MESI_C_IE; }
-void MESI_client::transition_to_se() { state = MESI_C_SE; }
-void MESI_client::transition_to_s() {state = MESI_C_S;}
-void MESI_client::transition_to_e() {state = MESI_C_E;}
-void MESI_client::transition_to_ei() {state = MESI_C_EI;}
-void MESI_client::transition_to_m() {state = MESI_C_M;}
-void MESI_client::transition_to_mi() {state = MESI_C_MI;}
-//void MESI_client::transition_to_sie() {state = MESI_C_SIE;}
 void MESI_client::invalid_msg(MESI_messages_t msg) {printf("Invalid message %d for state %d\n", msg, state); assert(0);}
 void MESI_client::invalid_state() {printf("Invalid state %d", state);}
 
@@ -3,6 +3,7 @@
 
 #include "ClientInterface.h"
 #include "MESI_enum.h"
+#include "transition_table.h"
 
 namespace manifold {
 namespace mcp_cache_namespace {
@@ -45,6 +46,9 @@ class MESI_client : public ClientInterface
         /** Called by the Manager to complete previous SupplyInvalidate demand.  Supplies data packet and signifies realm invalidation has completed */
         void SupplyInvalidateAck();
 
+        warm_state_t warm_get_state();
+        void warm_set_state(warm_state_t);
+
 
     protected:
 	//! @param \c req  Whether it's an initial request or a reply.
@@ -62,26 +66,21 @@ class MESI_client : public ClientInterface
 #endif
         MESI_client_state_t state;
 
-	inline void do_I(MESI_messages_t msg);
-	inline void do_S(MESI_messages_t msg);
-	inline void do_E(MESI_messages_t msg, int fwdID);
-	inline void do_M(MESI_messages_t msg, int fwdID);
-	inline void do_IE(MESI_messages_t msg);
-	inline void do_SE(MESI_messages_t msg);
+        //! A transition of the protocol; a message field is -1 if nothing is sent.
+        struct Transition {
+            MESI_client_state_t state;
+            MESI_messages_t msg;
+            int req; //request to manager
+            int fwd_reply; //reply to the client named in the forwarded request
+            int reply; //reply to manager
+            MESI_client_state_t next;
+        };
+        typedef Transition_table<Transition, MESI_C_NUM_STATES, MESI_NUM_MESSAGES> Table;
 
-	inline void do_EI(MESI_messages_t msg, int fwdID);
-	inline void do_MI(MESI_messages_t msg, int fwdID);
-	inline void do_SIE(MESI_messages_t msg);
+        static const Transition Client_transitions[];
+        static const Table Transitions;
 
         void transition_to_i();
-        void transition_to_s();
-        void transition_to_e();
-        void transition_to_m();
-        void transition_to_ie();
-        void transition_to_ei();
-        void transition_to_mi();
-        //void transition_to_sie();
-        void transition_to_se();
         void invalid_msg(MESI_messages_t);
         void invalid_state();
 
@@ -18,6 +18,8 @@ typedef enum {
     MESI_C_MI,
     MESI_C_SE,
     MESI_C_SIE, //transiting from S to E
+
+    MESI_C_NUM_STATES //for sizing tables; not a state
 } MESI_client_state_t;
 
 typedef enum {
@@ -33,6 +35,8 @@ typedef enum {
     MESI_MNG_EI_PUT,     /** EI from owner client eviction eviction. */
     MESI_MNG_EI_EVICT,        /** EI from manager eviction action. */
     MESI_MNG_SI_EVICT,
+
+    MESI_MNG_NUM_STATES //for sizing tables; not a state
 } MESI_manager_state_t;
 
 typedef enum {
@@ -64,6 +68,8 @@ typedef enum {
     GET_E,
     GET_S,
     GET_EVICT,
+
+    MESI_NUM_MESSAGES //for sizing tables; not a message
 } MESI_messages_t;
 
 }
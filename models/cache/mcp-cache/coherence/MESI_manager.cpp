@@ -93,332 +93,359 @@ bool MESI_manager :: req_pending()
 
 
 
-
-
-
-void MESI_manager :: process(int msg_type, int src_id)
+//! Same outcome as process() for I_to_S/I_to_E followed by the replies:
+//! a read of a line nobody holds is granted E; a read of an E line makes
+//! the owner and the requestor sharers; a write takes the line from the
+//! owner or the sharers and leaves the requestor in M.
+warm_state_t MESI_manager :: warm_request(int src, bool write, std::vector<int>& inv, int& down)
 {
-    MESI_messages_t msg = (MESI_messages_t)msg_type;
+    assert(!req_pending());
+    down = -1;
 
-    switch(state)
-    {
+    switch(state) {
         case MESI_MNG_I:
-            do_I(msg, src_id);
-            break;
+            owner = src;
+            state = MESI_MNG_E;
+            return write ? WARM_M : WARM_E;
         case MESI_MNG_E:
-            do_E(msg, src_id);
-            break;
+            assert(owner != -1 && owner != src);
+            if(write) {
+                inv.push_back(owner);
+                owner = src;
+                return WARM_M;
+            }
+            down = owner;
+            sharersList.set(owner);
+            sharersList.set(src);
+            owner = -1;
+            state = MESI_MNG_S;
+            return WARM_S;
         case MESI_MNG_S:
-            do_S(msg, src_id);
-            break;
-        case MESI_MNG_IE:
-            do_IE(msg, src_id);
-            break;
-        case MESI_MNG_EE:
-            do_EE(msg, src_id);
-            break;
-        case MESI_MNG_EI_PUT:
-            do_EI_PUT(msg, src_id);
-            break;
-        case MESI_MNG_EI_EVICT:
-            do_EI_EVICT(msg);
-
-            break;
-        case MESI_MNG_ES:
-            do_ES(msg, src_id);
-            break;
-        case MESI_MNG_SS:
-            do_SS(msg, src_id);
-            break;
-        case MESI_MNG_SIE:
-            do_SIE(msg, src_id);
-            break;
-        case MESI_MNG_SI_EVICT:
-            do_SI_EVICT(msg, src_id);
-            break;
+            if(write) {
+                sharersList.reset(src);
+                sharersList.ones(inv);
+                sharersList.clear();
+                owner = src;
+                state = MESI_MNG_E;
+                return WARM_M;
+            }
+            sharersList.set(src);
+            return WARM_S;
         default:
-            invalid_msg((MESI_messages_t)msg_type);
-	    break;
+            assert(0);
+            return WARM_I;
     }
 }
 
 
+//! Owner's eviction (E_to_I or M_to_I). Evictions in S are silent, so a
+//! sharer never gets here.
+bool MESI_manager :: warm_put(int src)
+{
+    assert(state == MESI_MNG_E && owner == src);
+    owner = -1;
+    state = MESI_MNG_I;
+    return true;
+}
+
+
+void MESI_manager :: warm_evict(std::vector<int>& inv)
+{
+    assert(!req_pending());
+    if(state == MESI_MNG_E)
+        inv.push_back(owner);
+    else if(state == MESI_MNG_S)
+        sharersList.ones(inv);
+    sharersList.clear();
+    owner = -1;
+    state = MESI_MNG_I;
+}
+
+
+
+
+
+
+//! The MESI manager protocol: the action for each legal (state, msg) pair.
+const MESI_manager :: Transition MESI_manager :: Manager_transitions[] = {
+    { MESI_MNG_I,         MESI_CM_I_to_E,          ACT_GRANT_E },
+    { MESI_MNG_I,         MESI_CM_I_to_S,          ACT_GRANT_E },
+    { MESI_MNG_I,         MESI_CM_E_to_I,          ACT_STALE_PUT },
+    { MESI_MNG_I,         MESI_CM_M_to_I,          ACT_STALE_PUT },
+
+    { MESI_MNG_E,         MESI_CM_I_to_E,          ACT_FWD_E },
+    { MESI_MNG_E,         MESI_CM_I_to_S,          ACT_FWD_S },
+    { MESI_MNG_E,         GET_EVICT,               ACT_EVICT_OWNER },
+    { MESI_MNG_E,         MESI_CM_E_to_I,          ACT_PUT },
+    { MESI_MNG_E,         MESI_CM_M_to_I,          ACT_PUT },
+
+    { MESI_MNG_S,         MESI_CM_I_to_S,          ACT_GRANT_S },
+    { MESI_MNG_S,         MESI_CM_I_to_E,          ACT_INVALIDATE_SHARERS },
+    { MESI_MNG_S,         GET_EVICT,               ACT_EVICT_SHARERS },
+    { MESI_MNG_S,         MESI_CM_E_to_I,          ACT_STALE_PUT_IN_S },
+    { MESI_MNG_S,         MESI_CM_M_to_I,          ACT_STALE_PUT_IN_S },
+
+    { MESI_MNG_IE,        MESI_CM_UNBLOCK_E,       ACT_UNBLOCK_E },
+    { MESI_MNG_EE,        MESI_CM_UNBLOCK_E,       ACT_UNBLOCK_E },
+    { MESI_MNG_EI_PUT,    MESI_CM_UNBLOCK_I,       ACT_UNBLOCK_I },
+    { MESI_MNG_EI_EVICT,  MESI_CM_UNBLOCK_I,       ACT_UNBLOCK_I },
+    { MESI_MNG_EI_EVICT,  MESI_CM_UNBLOCK_I_DIRTY, ACT_UNBLOCK_I },
+
+    { MESI_MNG_ES,        MESI_CM_UNBLOCK_E,       ACT_ES_UNBLOCK_E },
+    { MESI_MNG_ES,        MESI_CM_UNBLOCK_S,       ACT_ES_UNBLOCK_S },
+    { MESI_MNG_ES,        MESI_CM_CLEAN,           ACT_ES_CLEAN },
+    { MESI_MNG_ES,        MESI_CM_WRITEBACK,       ACT_ES_CLEAN },
+
+    { MESI_MNG_SS,        MESI_CM_UNBLOCK_S,       ACT_UNBLOCK_S },
+    { MESI_MNG_SIE,       MESI_CM_UNBLOCK_I,       ACT_SIE_ACK },
+    { MESI_MNG_SI_EVICT,  MESI_CM_UNBLOCK_I,       ACT_SI_EVICT_ACK },
+};
+
+
+const MESI_manager :: Table MESI_manager :: Transitions(Manager_transitions, sizeof(Manager_transitions)/sizeof(Manager_transitions[0]));
 
 
-inline void MESI_manager::do_I(MESI_messages_t msg_type, int src_id)
+
+void MESI_manager :: process(int msg_type, int src_id)
 {
 #ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state I, msg= " << msg_type << std::endl;
+std::cout << "Manager in state " << state << ", msg= " << msg_type << std::endl;
 #endif
-    switch(msg_type)
-    {
-        case MESI_CM_I_to_E:
-        case MESI_CM_I_to_S:
-            sendmsg(false, MESI_MC_GRANT_E_DATA, src_id);
-            // who sent it? record sender.
-            owner = src_id;
-            transition_to_ie();
-            break;
-        case MESI_CM_E_to_I:
-        case MESI_CM_M_to_I:
-	    //This happens when manager sends DEMAND_I to client, and client
-	    //before receiving it already sent E_to_I or M_to_I, which would
-	    //stall. Client in EI or MI state processes DEMAND_I and enters I.
-	    //The E_to_I or M_to_I should simply be ignored.
-	    ignore();
-	    break;
-        default:
-            invalid_msg((MESI_messages_t)msg_type);
-	    break;
+    const Transition* t = Transitions.lookup(state, msg_type);
+    if(t == 0) {
+        invalid_msg((MESI_messages_t)msg_type);
+        return;
+    }
+
+    MESI_messages_t msg = (MESI_messages_t)msg_type;
+    switch(t->action) {
+        case ACT_GRANT_E: grant_e(msg, src_id); break;
+        case ACT_STALE_PUT: stale_put(msg, src_id); break;
+        case ACT_FWD_E: fwd_e(msg, src_id); break;
+        case ACT_FWD_S: fwd_s(msg, src_id); break;
+        case ACT_EVICT_OWNER: evict_owner(msg, src_id); break;
+        case ACT_PUT: put(msg, src_id); break;
+        case ACT_GRANT_S: grant_s(msg, src_id); break;
+        case ACT_INVALIDATE_SHARERS: invalidate_sharers(msg, src_id); break;
+        case ACT_EVICT_SHARERS: evict_sharers(msg, src_id); break;
+        case ACT_STALE_PUT_IN_S: stale_put_in_s(msg, src_id); break;
+        case ACT_UNBLOCK_E: unblock_e(msg, src_id); break;
+        case ACT_UNBLOCK_S: unblock_s(msg, src_id); break;
+        case ACT_UNBLOCK_I: unblock_i(msg, src_id); break;
+        case ACT_ES_UNBLOCK_E: es_unblock_e(msg, src_id); break;
+        case ACT_ES_UNBLOCK_S: es_unblock_s(msg, src_id); break;
+        case ACT_ES_CLEAN: es_clean(msg, src_id); break;
+        case ACT_SI_EVICT_ACK: si_evict_ack(msg, src_id); break;
+        case ACT_SIE_ACK: sie_ack(msg, src_id); break;
     }
 }
 
 
 
 
-inline void MESI_manager::do_E(MESI_messages_t msg_type, int srcID)
+//####################################################################
+// Actions in I
+//####################################################################
+void MESI_manager::grant_e(MESI_messages_t, int srcID)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state E, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_I_to_E:
-            // must be an owner here...
-            assert(owner != -1);
-	    assert(owner != srcID);
-            // has to be sent to current owner though.
-            // we have a new owner record it.
-            sendmsg(true, MESI_MC_FWD_E, owner, srcID);
-            owner = srcID;
-            transition_to_ee();
-            break;
-        case MESI_CM_I_to_S:
-            // No more owner we have sharers now.
-            sendmsg(true, MESI_MC_FWD_S, owner, srcID); //send msg to owner
-            sharersList.set(owner);
-            sharersList.set(srcID);
-            owner =-1;
-            transition_to_es();
-            break;
-        case GET_EVICT:
-            sendmsg(true, MESI_MC_DEMAND_I, owner);
-            // has to be sent to owner.
-            // no owner anymore
-            owner = -1;
-            transition_to_ei_evict();
-            break;
-        case MESI_CM_E_to_I: // no more owner
-        case MESI_CM_M_to_I: // no more owner
-	    if(srcID == owner) {
-		if(msg_type == MESI_CM_M_to_I)
-		    client_writeback();
-		sendmsg(false, MESI_MC_GRANT_I, owner);
-		owner = -1;
-		transition_to_ei_put();
-	    }
-	    else {
-	        //This happens in a race condition; right before receiving his
-		//E_to_I or M_to_I, we got a write request, which is now complete
-		//and owner has changed. Since owner also has detected the race
-		//condition and has changed to I, we just call ignore().
-	        ignore();
-	    }
-            break;
-        default:
-            invalid_msg((MESI_messages_t)msg_type);
-            break;
+    sendmsg(false, MESI_MC_GRANT_E_DATA, srcID);
+    // who sent it? record sender.
+    owner = srcID;
+    transition_to_ie();
+}
+
+
+//This happens when manager sends DEMAND_I to client, and client
+//before receiving it already sent E_to_I or M_to_I, which would
+//stall. Client in EI or MI state processes DEMAND_I and enters I.
+//The E_to_I or M_to_I should simply be ignored.
+void MESI_manager::stale_put(MESI_messages_t, int)
+{
+    ignore();
+}
+
+
+
+//####################################################################
+// Actions in E
+//####################################################################
+void MESI_manager::fwd_e(MESI_messages_t, int srcID)
+{
+    // must be an owner here...
+    assert(owner != -1);
+    assert(owner != srcID);
+    // has to be sent to current owner though.
+    // we have a new owner record it.
+    sendmsg(true, MESI_MC_FWD_E, owner, srcID);
+    owner = srcID;
+    transition_to_ee();
+}
+
+
+void MESI_manager::fwd_s(MESI_messages_t, int srcID)
+{
+    // No more owner we have sharers now.
+    sendmsg(true, MESI_MC_FWD_S, owner, srcID); //send msg to owner
+    sharersList.set(owner);
+    sharersList.set(srcID);
+    owner =-1;
+    transition_to_es();
+}
+
+
+void MESI_manager::evict_owner(MESI_messages_t, int)
+{
+    sendmsg(true, MESI_MC_DEMAND_I, owner);
+    // has to be sent to owner.
+    // no owner anymore
+    owner = -1;
+    transition_to_ei_evict();
+}
+
+
+void MESI_manager::put(MESI_messages_t msg_type, int srcID)
+{
+    if(srcID == owner) {
+        if(msg_type == MESI_CM_M_to_I)
+            client_writeback();
+        sendmsg(false, MESI_MC_GRANT_I, owner);
+        owner = -1;
+        transition_to_ei_put();
+    }
+    else {
+        //This happens in a race condition; right before receiving his
+        //E_to_I or M_to_I, we got a write request, which is now complete
+        //and owner has changed. Since owner also has detected the race
+        //condition and has changed to I, we just call ignore().
+        ignore();
     }
 }
 
 
+
+//####################################################################
+// Actions in S
+//####################################################################
+void MESI_manager::grant_s(MESI_messages_t, int srcID)
+{
+    sendmsg(false, MESI_MC_GRANT_S_DATA, srcID);
+    sharersList.set(srcID);
+    transition_to_ss();
+}
+
+
+void MESI_manager::invalidate_sharers(MESI_messages_t, int srcID)
+{
+    sharersList.reset(srcID); //don't send DEMAND_I to requestor if it's a sharer.
+    sendmsgtosharers(MESI_MC_DEMAND_I);
+    num_invalidations = 0;
+    num_invalidations_req = sharersList.count();
+    sharersList.clear();
+    owner = srcID;
+    transition_to_sie();
+}
+
+
+void MESI_manager::evict_sharers(MESI_messages_t, int)
+{
+    sendmsgtosharers(MESI_MC_DEMAND_I);
+    num_invalidations = 0;
+    num_invalidations_req = sharersList.count();
+    sharersList.clear();
+    transition_to_si_evict();
+}
+
+
 //In S state we can receive CM_E_to_I. Here is the scenario:
 //
 //    C0              M               C1
 //     |------1------>|                |
-//     |              |---2---  ---3---|  
+//     |              |---2---  ---3---|
 //     |              |       \/       |
 //     |              |       /\       |
 //     |              |<------  ------>|
 //
 // 1. Client C0 sends I_to_S to LOAD a missed line.
-// 2. The line is in E state, so manager M sends FWD_S to owner C1.
+// 2. The line is in E state, so manager M sends ACT_FWD_S to owner C1.
 // 3. Before 2 reaches C1, the line is being evicted in C1, so it
-//    sends CM_E_to_I to M. 
+//    sends CM_E_to_I to M.
 // 4. When E_to_I from C1 reaches M, it PREV_PEND_STALLs since an
 //    mshr entry for the same line already exists.
-// 5. C1 receives FWD_S in the EI state. It processes it as if it were
+// 5. C1 receives ACT_FWD_S in the EI state. It processes it as if it were
 //    in the E state: it sends CC_S_DATA to C0, and CM_CLEAN to M.
 //    Then it silently enters I state.
-// 6. M gets CM_CLEAN from C1, and UNBLOCK_S from C0 and enters S state.
+// 6. M gets CM_CLEAN from C1, and ACT_UNBLOCK_S from C0 and enters S state.
 // 7. Now M, in S state, processes E_to_I in step 3.
 //    Since C1 is already in I state, there's nothing to be done, so we
 //    call ignore() in case the owning object needs cleanup.
-inline void MESI_manager::do_S(MESI_messages_t msg_type, int srcID)
+void MESI_manager::stale_put_in_s(MESI_messages_t msg_type, int)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state S, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_I_to_S:
-            sendmsg(false, MESI_MC_GRANT_S_DATA, srcID);
-            sharersList.set(srcID);
-            transition_to_ss();
-            break;
-        case MESI_CM_I_to_E:
-	    sharersList.reset(srcID); //don't send DEMAND_I to requestor if it's a sharer.
-            sendmsgtosharers(MESI_MC_DEMAND_I);
-            num_invalidations = 0;
-            num_invalidations_req = sharersList.count();
-            sharersList.clear();
-            owner = srcID;
-            transition_to_sie();
-            break;
-        case GET_EVICT:
-            sendmsgtosharers(MESI_MC_DEMAND_I);
-            num_invalidations = 0;
-            num_invalidations_req = sharersList.count();
-            sharersList.clear();
-            transition_to_si_evict();
-            break;
-	    /* The following shouldn't happen! The race between E_to_I and FWD_S has been re-implemented.
-        case MESI_CM_E_to_I: //E_to_I was sent before the client turns into S. Since client already
-	                     //transits to I, we do nothing.
-        case MESI_CM_M_to_I: //same as E_to_I above.
-	    ignore();
-	    {
-		assert(sharersList.count() == 2);
-		sharersList.reset(srcID);
-		std::vector<int> shers;
-		sharersList.ones(shers);
-		owner = shers[0];
-		sharersList.reset(owner);
-	    }
-	    transition_to_e();
-            break;
-	    */
-        case MESI_CM_E_to_I: //E_to_I was delayed; manager already in S state.
-	    std::cout << "WARNING: manager receiving CM_E_to_I in S state.\n";
-	    ignore();
-            break;
-        case MESI_CM_M_to_I: //M_to_I was delayed; manager already in S state.
-	    std::cout << "WARNING: manager receiving CM_M_to_I in S state.\n";
-	    ignore();
-            break;
-        default:
-            invalid_msg((MESI_messages_t)msg_type);
-	    break;
-    }
+    if(msg_type == MESI_CM_E_to_I) //E_to_I was delayed; manager already in S state.
+        std::cout << "WARNING: manager receiving CM_E_to_I in S state.\n";
+    else //M_to_I was delayed; manager already in S state.
+        std::cout << "WARNING: manager receiving CM_M_to_I in S state.\n";
+    ignore();
 }
 
 
-inline void MESI_manager::do_IE(MESI_messages_t msg_type, int srcID)
+
+//####################################################################
+// Actions in transient states
+//####################################################################
+void MESI_manager::unblock_e(MESI_messages_t, int)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state IE, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_E:
-            transition_to_e();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
+    transition_to_e();
 }
 
 
+void MESI_manager::unblock_s(MESI_messages_t, int)
+{
+    transition_to_s();
+}
 
 
-inline void MESI_manager::do_EE(MESI_messages_t msg_type, int srcID)
+void MESI_manager::unblock_i(MESI_messages_t msg_type, int)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state EE, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_E:
-            transition_to_e();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
+    if(msg_type == MESI_CM_UNBLOCK_I_DIRTY)
+        client_writeback(); // Writeback
+    transition_to_i();
 }
 
 
-inline void MESI_manager::do_EI_PUT(MESI_messages_t msg_type, int srcID)
+//a race condition occurred on client side. While we sent ACT_FWD_S
+//to client, it was trying to evict the line. Since manager request
+//takes priority, it sent CC_E_DATA to requestor, which in turn sent
+//this ACT_UNBLOCK_E to us.
+void MESI_manager::es_unblock_e(MESI_messages_t, int srcID)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state EI_PUT, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_I:
-            transition_to_i();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
+    sharersList.clear();
+    owner = srcID;
+    transition_to_e();
 }
 
 
+void MESI_manager::es_unblock_s(MESI_messages_t, int)
+{
+    assert(!unblocked_s_recv);
+    unblocked_s_recv = true;
+    es_check_done();
+}
+
 
-inline void MESI_manager::do_EI_EVICT(MESI_messages_t msg_type)
+void MESI_manager::es_clean(MESI_messages_t msg_type, int)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state EI_EVICT, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_I:
-            transition_to_i();
-            break;
-        case MESI_CM_UNBLOCK_I_DIRTY:
-            // Writeback
-	    client_writeback();
-            transition_to_i();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
+    assert(!clean_wb_recv);
+    clean_wb_recv = true;
+    if(msg_type == MESI_CM_WRITEBACK)
+        client_writeback();
+    es_check_done();
 }
 
 
-inline void MESI_manager::do_ES(MESI_messages_t msg_type, int srcID)
+//! ES ends when both the requestor's ACT_UNBLOCK_S and the old owner's CLEAN or
+//! WRITEBACK have been received.
+void MESI_manager::es_check_done()
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state ES, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_E: //a race condition occurred on client side. While we sent FWD_S
-	                        //to client, it was trying to evict the line. Since manager request
-				//takes priority, it sent CC_E_DATA to requestor, which in turn sent
-				//this UNBLOCK_E to us.
-	    sharersList.clear();
-	    owner = srcID;
-	    transition_to_e();
-            break;
-        case MESI_CM_UNBLOCK_S:
-            assert(!unblocked_s_recv);
-            unblocked_s_recv = true;
-            break;
-        case MESI_CM_CLEAN:
-        case MESI_CM_WRITEBACK:
-            assert(!clean_wb_recv);
-            clean_wb_recv = true;
-	    if(msg_type == MESI_CM_WRITEBACK)
-	        client_writeback();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
     if (unblocked_s_recv && clean_wb_recv)
     {
         unblocked_s_recv = false;
@@ -428,59 +455,21 @@ std::cout << "Manager in state ES, msg= " << msg_type << std::endl;
 }
 
 
-
-inline void MESI_manager::do_SS(MESI_messages_t msg_type, int srcID)
+void MESI_manager::si_evict_ack(MESI_messages_t, int)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state SS, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_S:
-            transition_to_s();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
+    num_invalidations++;
+    if (num_invalidations == num_invalidations_req)
+        transition_to_i();
 }
 
-inline void MESI_manager::do_SI_EVICT(MESI_messages_t msg_type, int srcID)
-{
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state SI_EVICT, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
-    {
-        case MESI_CM_UNBLOCK_I:
-            num_invalidations++;
-            if (num_invalidations == num_invalidations_req)
-                transition_to_i();
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
-    }
-}
 
-inline void MESI_manager::do_SIE(MESI_messages_t msg_type, int srcID)
+void MESI_manager::sie_ack(MESI_messages_t, int)
 {
-#ifdef DBG_MESI_MANAGER
-std::cout << "Manager in state SIE, msg= " << msg_type << std::endl;
-#endif
-    switch(msg_type)
+    num_invalidations++;
+    if (num_invalidations == num_invalidations_req)
     {
-        case MESI_CM_UNBLOCK_I:
-            num_invalidations++;
-            if (num_invalidations == num_invalidations_req)
-            {
-                transition_to_ie();
-                sendmsg(false, MESI_MC_GRANT_E_DATA, owner);
-            }
-            break;
-        default:
-            invalid_msg(msg_type);
-            break;
+        transition_to_ie();
+        sendmsg(false, MESI_MC_GRANT_E_DATA, owner);
     }
 }
 
@@ -488,6 +477,7 @@ std::cout << "Manager in state SIE, msg= " << msg_type << std::endl;
 void MESI_manager::sendmsgtosharers(MESI_messages_t msg)
 {
     std::vector<int> sharerIDs;
+    sharerIDs.reserve(sharersList.count());
     sharersList.ones(sharerIDs);
 
     for (unsigned int i = 0; i < sharerIDs.size(); i++)
@@ -3,6 +3,7 @@
 
 #include "ManagerInterface.h"
 #include "MESI_enum.h"
+#include "transition_table.h"
 #include "sharers.h"
 
 namespace manifold {
@@ -43,6 +44,10 @@ class MESI_manager : public ManagerInterface
 
 	bool IsRequestComplete();
 
+        warm_state_t warm_request(int src, bool write, std::vector<int>& inv, int& down);
+        bool warm_put(int src);
+        void warm_evict(std::vector<int>& inv);
+
 
 #ifndef MCP_CACHE_UTEST
     protected:
@@ -75,17 +80,59 @@ class MESI_manager : public ManagerInterface
         bool unblocked_s_recv;
         bool clean_wb_recv;
 
-	inline void do_I(MESI_messages_t msg_type, int srcID);
-	inline void do_E(MESI_messages_t msg_type, int srcID);
-	inline void do_S(MESI_messages_t msg_type, int srcID);
-	inline void do_IE(MESI_messages_t msg_type, int srcID);
-	inline void do_EE(MESI_messages_t msg_type, int srcID);
-	inline void do_EI_PUT(MESI_messages_t msg_type, int srcID);
-	inline void do_EI_EVICT(MESI_messages_t msg_type);
-	inline void do_ES(MESI_messages_t msg_type, int srcID);
-	inline void do_SS(MESI_messages_t msg_type, int srcID);
-	inline void do_SIE(MESI_messages_t msg_type, int srcID);
-	inline void do_SI_EVICT(MESI_messages_t msg_type, int srcID);
+        //! Actions of the protocol, dispatched by process().
+        enum Action_t {
+            ACT_GRANT_E,
+            ACT_STALE_PUT,
+            ACT_FWD_E,
+            ACT_FWD_S,
+            ACT_EVICT_OWNER,
+            ACT_PUT,
+            ACT_GRANT_S,
+            ACT_INVALIDATE_SHARERS,
+            ACT_EVICT_SHARERS,
+            ACT_STALE_PUT_IN_S,
+            ACT_UNBLOCK_E,
+            ACT_UNBLOCK_S,
+            ACT_UNBLOCK_I,
+            ACT_ES_UNBLOCK_E,
+            ACT_ES_UNBLOCK_S,
+            ACT_ES_CLEAN,
+            ACT_SI_EVICT_ACK,
+            ACT_SIE_ACK
+        };
+
+        //! A transition of the protocol: the action taken for msg in state.
+        struct Transition {
+            MESI_manager_state_t state;
+            MESI_messages_t msg;
+            Action_t action;
+        };
+        typedef Transition_table<Transition, MESI_MNG_NUM_STATES, MESI_NUM_MESSAGES> Table;
+
+        static const Transition Manager_transitions[];
+        static const Table Transitions;
+
+        //actions
+        void grant_e(MESI_messages_t, int srcID);
+        void stale_put(MESI_messages_t, int srcID);
+        void fwd_e(MESI_messages_t, int srcID);
+        void fwd_s(MESI_messages_t, int srcID);
+        void evict_owner(MESI_messages_t, int srcID);
+        void put(MESI_messages_t, int srcID);
+        void grant_s(MESI_messages_t, int srcID);
+        void invalidate_sharers(MESI_messages_t, int srcID);
+        void evict_sharers(MESI_messages_t, int srcID);
+        void stale_put_in_s(MESI_messages_t, int srcID);
+        void unblock_e(MESI_messages_t, int srcID);
+        void unblock_s(MESI_messages_t, int srcID);
+        void unblock_i(MESI_messages_t, int srcID);
+        void es_unblock_e(MESI_messages_t, int srcID);
+        void es_unblock_s(MESI_messages_t, int srcID);
+        void es_clean(MESI_messages_t, int srcID);
+        void es_check_done();
+        void si_evict_ack(MESI_messages_t, int srcID);
+        void sie_ack(MESI_messages_t, int srcID);
 
         void transition_to_i();
         void transition_to_e();
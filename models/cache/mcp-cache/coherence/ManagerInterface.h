@@ -2,6 +2,9 @@
 #define MANAGERINTERFACE_H
 
 #include <stdint.h>
+#include <vector>
+
+#include "ClientInterface.h" //warm_state_t
 
 
 namespace manifold {
@@ -49,6 +52,17 @@ class ManagerInterface
         /** Called from the client to complete previous GetEvict request. Supplies data packet and signifies paired client is now invalid */
         virtual void GrantEvict() = 0;
 
+        /** Functional warm-up: the following change the stable state directly without sending
+            messages; the caller applies the result to the lower clients. */
+        //! Lower client src asks for read (write=false) or write permission. Clients that must
+        //! give up the line are added to inv; the one that must downgrade to read-only is put in
+        //! down (-1 if none). Returns the state the requestor ends up in.
+        virtual warm_state_t warm_request(int src, bool write, std::vector<int>& inv, int& down) = 0;
+        //! Lower client src gives up its exclusive copy. Returns true if no client holds the line.
+        virtual bool warm_put(int src) = 0;
+        //! The line is evicted; clients that hold it are added to inv.
+        virtual void warm_evict(std::vector<int>& inv) = 0;
+
 
     protected:
         int id;
@@ -1,4 +1,5 @@
 #include "sharers.h"
+#include <assert.h>
 
 namespace manifold {
 namespace mcp_cache_namespace {
@@ -6,9 +7,9 @@ namespace mcp_cache_namespace {
 
 /** @brief sharers
   *
-  * @todo: document this function
+  * @param size  Initial size. Only affects size(); storage grows as needed.
   */
-sharers::sharers(size_t size) : data(size)
+sharers::sharers(size_t size) : m_num_ptrs(0), m_size(size)
 {
 
 }
@@ -22,17 +23,41 @@ sharers::~sharers()
 
 }
 
+/** @brief to_bitset
+  *
+  * Move the ids in the pointer list into the bitset.
+  */
+void sharers::to_bitset()
+{
+    assert(!is_bitset());
+    for (int i = 0; i < m_num_ptrs; i++) {
+        unsigned w = m_ptrs[i] >> 6;
+        if (w >= m_bits.size())
+            m_bits.resize(w + 1, 0);
+        m_bits[w] |= (uint64_t)1 << (m_ptrs[i] & 63);
+    }
+    m_num_ptrs = -1;
+}
+
 /** @brief get
   *
   * Get the status of a cache represented by the given index.
   */
 bool sharers::get(int index)
 {
-    if (index >= data.size()) {
-        data.resize(index + 1);
-	data[index] = false;
+    assert(index >= 0);
+    if (index >= m_size)
+        m_size = index + 1;
+
+    if (is_bitset()) {
+        unsigned w = index >> 6;
+        return w < m_bits.size() && (m_bits[w] >> (index & 63)) & 1;
     }
-    return data[index];
+    for (int i = 0; i < m_num_ptrs; i++) {
+        if (m_ptrs[i] == index)
+            return true;
+    }
+    return false;
 }
 
 /** @brief size
@@ -41,31 +66,34 @@ bool sharers::get(int index)
   */
 int sharers::size() const
 {
-    return data.size();
+    return m_size;
 }
 
 /** @brief count
   *
-  * @todo: counts the number of 1's
+  * counts the number of 1's
   */
 int sharers::count() const
 {
+    if (!is_bitset())
+        return m_num_ptrs;
+
     int count = 0;
-    for (int i = 0; i < data.size(); i++)
-    {
-    
-        if (data[i]) count++;
-    }
+    for (unsigned i = 0; i < m_bits.size(); i++)
+        count += __builtin_popcountll(m_bits[i]);
     return count;
 }
 
 /** @brief clear
   *
-  * @todo: document this function
+  * Removes all sharers. The bitset, if any, is released so a line that once had
+  * many sharers does not keep the storage.
   */
 void sharers::clear()
 {
-    data.clear();
+    m_num_ptrs = 0;
+    std::vector<uint64_t>().swap(m_bits);
+    m_size = 0;
 }
 
 /** @brief set
@@ -74,9 +102,30 @@ void sharers::clear()
   */
 void sharers::set(int index)
 {
-    if (index >= data.size())
-        data.resize(index + 1);
-    data[index] = true;
+    assert(index >= 0);
+    if (index >= m_size)
+        m_size = index + 1;
+
+    if (!is_bitset()) {
+        int pos = 0;
+        while (pos < m_num_ptrs && m_ptrs[pos] < index)
+            pos++;
+        if (pos < m_num_ptrs && m_ptrs[pos] == index)
+            return;
+        if (m_num_ptrs < MAX_PTRS) {
+            for (int i = m_num_ptrs; i > pos; i--)
+                m_ptrs[i] = m_ptrs[i-1];
+            m_ptrs[pos] = index;
+            m_num_ptrs++;
+            return;
+        }
+        to_bitset();
+    }
+
+    unsigned w = index >> 6;
+    if (w >= m_bits.size())
+        m_bits.resize(w + 1, 0);
+    m_bits[w] |= (uint64_t)1 << (index & 63);
 }
 
 /** @brief reset
@@ -85,24 +134,47 @@ void sharers::set(int index)
   */
 void sharers::reset(int index)
 {
-    if (index >= data.size())
-        data.resize(index + 1);
-    data[index] = false;
+    assert(index >= 0);
+    if (index >= m_size)
+        m_size = index + 1;
+
+    if (is_bitset()) {
+        unsigned w = index >> 6;
+        if (w < m_bits.size())
+            m_bits[w] &= ~((uint64_t)1 << (index & 63));
+        return;
+    }
+    for (int i = 0; i < m_num_ptrs; i++) {
+        if (m_ptrs[i] == index) {
+            for (int j = i; j < m_num_ptrs - 1; j++)
+                m_ptrs[j] = m_ptrs[j+1];
+            m_num_ptrs--;
+            return;
+        }
+    }
 }
 
 /** @brief ones
   *
-  * @todo: document this function
+  * Appends the ids of the sharers to ret in ascending order.
   */
 void sharers::ones(std::vector<int>& ret)
 {
-    for (int i = 0; i < data.size(); i++)
-    {
-        if (data[i]) ret.push_back(i);
+    if (!is_bitset()) {
+        for (int i = 0; i < m_num_ptrs; i++)
+            ret.push_back(m_ptrs[i]);
+        return;
+    }
+
+    for (unsigned i = 0; i < m_bits.size(); i++) {
+        uint64_t w = m_bits[i];
+        while (w) {
+            ret.push_back((i << 6) + __builtin_ctzll(w));
+            w &= w - 1;
+        }
     }
 }
 
 
 } //namespace mcp_cache_namespace
 } //namespace manifold
-
@@ -3,14 +3,22 @@
 
 #include <vector>
 #include <stddef.h> //for size_t
+#include <stdint.h>
 
 namespace manifold {
 namespace mcp_cache_namespace {
 
-// bitsets class that can shrink and grow I didn't want to add a dependancy on boost.
+// Set of sharers, indexed by cache id. Up to MAX_PTRS sharers are kept as a
+// sorted list of ids stored in the object itself (limited-pointer directory);
+// beyond that the set switches to a packed bitset until it's cleared. So in the
+// common case of few sharers per line the size of a directory entry does not
+// depend on the number of caches, and count()/ones() cost is proportional to
+// the number of sharers (or words of the bitset), not the largest id.
 class sharers
 {
 	public:
+		enum { MAX_PTRS = 4 };
+
 		sharers(size_t size = 0);
 		~sharers();
 		void set(int index);
@@ -19,14 +27,20 @@ class sharers
 		void clear();
 		int count() const;
 		int size() const;
-		void ones(std::vector<int>& ret);
+		void ones(std::vector<int>& ret); //ids of the sharers in ascending order
 
 #ifdef MCP_CACHE_UTEST
 	public:
 #else
 	private:
 #endif
-		std::vector<bool> data; //true means the cache represented by the index is a sharer.
+		bool is_bitset() const { return m_num_ptrs < 0; }
+		void to_bitset();
+
+		int m_num_ptrs; //number of ids in m_ptrs; -1 if the bitset is used
+		int m_ptrs[MAX_PTRS]; //sorted
+		std::vector<uint64_t> m_bits; //bit i is set if cache i is a sharer
+		int m_size; //1 + largest index seen since last clear()
 };
 
 }
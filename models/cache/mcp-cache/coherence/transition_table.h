@@ -0,0 +1,45 @@
+#ifndef MANIFOLD_MCP_CACHE_TRANSITION_TABLE_H
+#define MANIFOLD_MCP_CACHE_TRANSITION_TABLE_H
+
+#include <assert.h>
+#include <string.h>
+
+namespace manifold {
+namespace mcp_cache_namespace {
+
+// Dense state x message lookup over a protocol's list of transitions. A
+// protocol is written as a constant array of rows, each with at least the
+// fields "state" and "msg"; the table maps every (state, msg) pair to its row,
+// or to 0 if the pair is not a legal transition. The rows are what the
+// protocol does (messages to send, next state, or an action), so another
+// protocol only needs another array of rows.
+template<typename Row, int N_STATES, int N_MSGS>
+class Transition_table
+{
+	public:
+		Transition_table(const Row* rows, unsigned n)
+		{
+			memset(table, 0, sizeof(table));
+			for(unsigned i=0; i<n; i++) {
+				assert(rows[i].state >= 0 && rows[i].state < N_STATES);
+				assert(rows[i].msg >= 0 && rows[i].msg < N_MSGS);
+				assert(table[rows[i].state][rows[i].msg] == 0); //no duplicate
+				table[rows[i].state][rows[i].msg] = &rows[i];
+			}
+		}
+
+		const Row* lookup(int state, int msg) const
+		{
+			if(state < 0 || state >= N_STATES || msg < 0 || msg >= N_MSGS)
+				return 0;
+			return table[state][msg];
+		}
+
+	private:
+		const Row* table[N_STATES][N_MSGS];
+};
+
+} //namespace mcp_cache_namespace
+} //namespace manifold
+
+#endif //MANIFOLD_MCP_CACHE_TRANSITION_TABLE_H
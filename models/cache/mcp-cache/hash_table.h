@@ -40,6 +40,7 @@ public:
 #endif
     friend class hash_set;
     friend class hash_table;
+    friend class mshr_table;
 
     hash_set * const my_set;
     const unsigned idx; //index within the whole table.
@@ -0,0 +1,145 @@
+#include "mshr_table.h"
+
+using namespace std;
+using namespace manifold::mcp_cache_namespace;
+
+
+//! mshr_table: Constructor
+//!
+//! @param \c parameters  Settings of the cache the MSHR belongs to.
+//! @param \c num_entries  Number of MSHR entries.
+mshr_table::mshr_table (const cache_settings& parameters, unsigned num_entries)
+{
+    assert(num_entries > 0);
+
+    cache_settings settings = parameters;
+    settings.assoc = num_entries;
+    settings.size = settings.assoc * settings.block_size; //1 set.
+    m_table = new hash_table (settings);
+
+    vector<hash_set*> sets;
+    m_table->get_sets(sets);
+    assert(sets.size() == 1);
+    vector<hash_entry*> entries;
+    sets[0]->get_entries(entries);
+
+    m_entries.resize(num_entries);
+    for (unsigned i = 0; i < entries.size(); i++)
+        m_entries[entries[i]->get_idx()] = entries[i];
+
+    //Entries are handed out lowest idx first.
+    for (unsigned i = num_entries; i > 0; i--)
+        m_free.push_back(i - 1);
+
+    //Keep the index at most half full.
+    unsigned nslots = 2;
+    while (nslots < 2 * num_entries)
+        nslots <<= 1;
+    Slot empty;
+    empty.line_addr = 0;
+    empty.idx = -1;
+    m_slots.resize(nslots, empty);
+    m_mask = nslots - 1;
+}
+
+// mshr_table: Destructor
+mshr_table::~mshr_table (void)
+{
+    delete m_table;
+}
+
+
+unsigned mshr_table::home (paddr_t line_addr) const
+{
+    //fibonacci hashing; the low bits of line addresses are all 0.
+    return (unsigned)((line_addr * 0x9E3779B97F4A7C15ULL) >> 32) & m_mask;
+}
+
+
+int mshr_table::find (paddr_t line_addr) const
+{
+    unsigned i = home(line_addr);
+    while (m_slots[i].idx != -1) {
+        if (m_slots[i].line_addr == line_addr)
+            return i;
+        i = (i + 1) & m_mask;
+    }
+    return -1;
+}
+
+
+hash_entry* mshr_table::get_entry (paddr_t addr)
+{
+    int s = find(get_line_addr(addr));
+    if (s == -1)
+        return 0;
+    hash_entry* entry = m_entries[m_slots[s].idx];
+    assert(!entry->free);
+    return entry;
+}
+
+
+hash_entry* mshr_table::reserve_block_for (paddr_t addr)
+{
+    if (m_free.empty())
+        return 0;
+
+    paddr_t line_addr = get_line_addr(addr);
+    assert(find(line_addr) == -1);
+
+    hash_entry* entry = m_entries[m_free.back()];
+    m_free.pop_back();
+
+    assert(entry->free);
+    entry->free = false;
+    entry->tag = m_table->get_tag(addr);
+    m_table->increase_occupancy();
+
+    unsigned i = home(line_addr);
+    while (m_slots[i].idx != -1)
+        i = (i + 1) & m_mask;
+    m_slots[i].line_addr = line_addr;
+    m_slots[i].idx = entry->get_idx();
+
+    return entry;
+}
+
+
+void mshr_table::release (hash_entry* entry)
+{
+    assert(!entry->free);
+
+    int s = find(entry->get_line_addr());
+    assert(s != -1 && m_slots[s].idx == (int)entry->get_idx());
+
+    //Backward-shift deletion so lookups never need tombstones.
+    unsigned hole = s;
+    unsigned j = hole;
+    while (true) {
+        j = (j + 1) & m_mask;
+        if (m_slots[j].idx == -1)
+            break;
+        unsigned h = home(m_slots[j].line_addr);
+        //move j into the hole unless its home lies cyclically in (hole, j]
+        bool stays = (hole <= j) ? (hole < h && h <= j) : (hole < h || h <= j);
+        if (!stays) {
+            m_slots[hole] = m_slots[j];
+            hole = j;
+        }
+    }
+    m_slots[hole].idx = -1;
+
+    entry->invalidate();
+    m_free.push_back(entry->get_idx());
+}
+
+
+void mshr_table :: dbg_print(ostream& out)
+{
+    for (unsigned i = 0; i < m_entries.size(); i++) {
+	if(m_entries[i]->free)
+	    out << i << "  " << m_entries[i] << "  " << "free\n";
+	else
+	    out << i << "  " << m_entries[i] << "  " <<hex<< m_entries[i]->get_line_addr() <<dec<< "\n";
+    }
+}
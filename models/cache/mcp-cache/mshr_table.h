@@ -0,0 +1,68 @@
+#ifndef MANIFOLD_MCP_CACHE_MSHR_TABLE_H
+#define MANIFOLD_MCP_CACHE_MSHR_TABLE_H
+
+#include <vector>
+#include <iostream>
+#include <assert.h>
+
+#include "cache_types.h"
+#include "cache_req.h"
+#include "hash_table.h"
+
+namespace manifold {
+namespace mcp_cache_namespace {
+
+
+//! The MSHR. Entries are hash_entry objects, same as in the hash table, so they
+//! can be passed to the cache algorithms and indexed with get_idx(). Lookup is by
+//! line address through an open-addressed (linear probing) index instead of a
+//! search of a fully associative set, and free entries are kept on a stack, so
+//! has_match(), get_entry(), reserve_block_for() and release() are O(1).
+//!
+//! An entry must be freed with release(); calling invalidate() on it directly
+//! would leave it in the index.
+class mshr_table {
+   public:
+      mshr_table (const cache_settings& parameters, unsigned num_entries);
+      ~mshr_table (void);
+
+      int get_num_entries() const { return m_entries.size(); }
+      unsigned get_occupancy() { return m_table->get_occupancy(); }
+      paddr_t get_line_addr (paddr_t addr) { return m_table->get_line_addr(addr); }
+
+      bool has_match(paddr_t addr) { return find(get_line_addr(addr)) != -1; }
+      hash_entry* get_entry (paddr_t addr);
+      hash_entry* get_entry_by_idx (unsigned idx) { return m_entries[idx]; }
+
+      //! Allocate an entry for the line of addr; return 0 if all entries are in use.
+      //! There must not already be an entry for the line.
+      hash_entry* reserve_block_for (paddr_t addr);
+      void release (hash_entry* entry);
+
+      //debug
+      void dbg_print(std::ostream&);
+
+#ifndef MCP_CACHE_UTEST
+   private:
+#endif
+      unsigned home (paddr_t line_addr) const;
+      int find (paddr_t line_addr) const; //index slot holding line_addr; -1 if none
+
+      hash_table* m_table; //one fully associative set; only used to hold the entries
+      std::vector<hash_entry*> m_entries; //entry idx -> entry
+      std::vector<unsigned> m_free; //stack of idx of free entries
+
+      struct Slot {
+          paddr_t line_addr;
+          int idx; //entry idx; -1 if slot is empty
+      };
+      std::vector<Slot> m_slots; //index: line address -> entry idx
+      unsigned m_mask;
+};
+
+
+
+} //namespace mcp_cache_namespace
+} //namespace manifold
+
+#endif // MANIFOLD_MCP_CACHE_MSHR_TABLE_H
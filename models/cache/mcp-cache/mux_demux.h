@@ -3,7 +3,7 @@
 #include "kernel/component-decl.h"
 #include "kernel/clock.h"
 #include "uarch/networkPacket.h"
-#include <list>
+#include "ring_buffer.h"
 
 #include "LLP_cache.h"
 #include "LLS_cache.h"
@@ -56,7 +56,7 @@ private:
 
     #ifdef FORECAST_NULL
     //std::list<manifold::kernel::Ticks_t> m_output_ticks;
-    std::list<manifold::kernel::Ticks_t> m_input_msg_ticks;
+    Ring_buffer<manifold::kernel::Ticks_t> m_input_msg_ticks;
     #endif
 
     //stats
@@ -0,0 +1,90 @@
+#ifndef MANIFOLD_MCP_CACHE_RING_BUFFER_H
+#define MANIFOLD_MCP_CACHE_RING_BUFFER_H
+
+#include <assert.h>
+#include <vector>
+
+namespace manifold {
+namespace mcp_cache_namespace {
+
+//! FIFO on a circular array, used instead of std::list for the message and
+//! tick queues of the caches and the mux, so queuing a message does not
+//! allocate. The capacity is set from the credits and MSHR size of the owner;
+//! since the number of messages a request generates is not bounded by those
+//! (e.g., invalidations to all sharers), a full buffer doubles its capacity
+//! rather than dropping or stalling.
+template<typename T>
+class Ring_buffer {
+public:
+    Ring_buffer(unsigned capacity = 16) : m_head(0), m_size(0)
+    {
+        m_buf.resize(round_up(capacity));
+    }
+
+    bool empty() const { return m_size == 0; }
+    unsigned size() const { return m_size; }
+    unsigned capacity() const { return m_buf.size(); }
+
+    T& front()
+    {
+        assert(m_size > 0);
+        return m_buf[m_head];
+    }
+    T& back()
+    {
+        assert(m_size > 0);
+        return m_buf[(m_head + m_size - 1) & (m_buf.size() - 1)];
+    }
+
+    void push_back(const T& x)
+    {
+        if(m_size == m_buf.size())
+            grow(2 * m_buf.size());
+        m_buf[(m_head + m_size) & (m_buf.size() - 1)] = x;
+        m_size++;
+    }
+
+    void pop_front()
+    {
+        assert(m_size > 0);
+        m_head = (m_head + 1) & (m_buf.size() - 1);
+        m_size--;
+    }
+
+    void clear() { m_head = 0; m_size = 0; }
+
+    //! Makes room for at least n elements.
+    void reserve(unsigned n)
+    {
+        if(n > m_buf.size())
+            grow(round_up(n));
+    }
+
+private:
+    static unsigned round_up(unsigned n)
+    {
+        unsigned c = 1;
+        while(c < n)
+            c <<= 1;
+        return c;
+    }
+
+    void grow(unsigned n)
+    {
+        std::vector<T> buf(n);
+        for(unsigned i=0; i<m_size; i++)
+            buf[i] = m_buf[(m_head + i) & (m_buf.size() - 1)];
+        m_buf.swap(buf);
+        m_head = 0;
+    }
+
+    std::vector<T> m_buf; //size is a power of 2
+    unsigned m_head; //index of the front
+    unsigned m_size;
+};
+
+
+} //namespace mcp_cache_namespace
+} //namespace manifold
+
+#endif //MANIFOLD_MCP_CACHE_RING_BUFFER_H
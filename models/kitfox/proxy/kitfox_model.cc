@@ -0,0 +1,208 @@
+#ifdef USE_KITFOX
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "kitfox_model.h"
+
+using namespace std;
+using namespace manifold;
+using namespace manifold::kernel;
+using namespace manifold::uarch;
+using namespace manifold::kitfox_proxy;
+
+/* Counters with a KitFox component of the same name under a node. The
+   in-order components (latch_id2iq, lsq, latch_lsq2dcache, latch_lsq2reg) and
+   the pipeline aggregates are not part of the configuration. */
+struct pipeline_field_t { const char *name; manifold::uarch::counter_t pipeline_counter_t::*counter; };
+#define PIPELINE_FIELD(f) { #f, &pipeline_counter_t::f }
+static const pipeline_field_t pipeline_fields[] = {
+    PIPELINE_FIELD(l1_btb), PIPELINE_FIELD(l2_btb), PIPELINE_FIELD(predictor_chooser),
+    PIPELINE_FIELD(global_predictor), PIPELINE_FIELD(l1_local_predictor),
+    PIPELINE_FIELD(l2_local_predictor), PIPELINE_FIELD(ras), PIPELINE_FIELD(inst_cache),
+    PIPELINE_FIELD(inst_cache_miss_buffer), PIPELINE_FIELD(inst_tlb), PIPELINE_FIELD(latch_ic2ib),
+    PIPELINE_FIELD(pc), PIPELINE_FIELD(inst_buffer), PIPELINE_FIELD(latch_ib2id),
+    PIPELINE_FIELD(inst_decoder), PIPELINE_FIELD(operand_decoder), PIPELINE_FIELD(uop_sequencer),
+    PIPELINE_FIELD(latch_id2uq), PIPELINE_FIELD(uop_queue), PIPELINE_FIELD(latch_uq2rr),
+    PIPELINE_FIELD(rat), PIPELINE_FIELD(freelist), PIPELINE_FIELD(dependency_check),
+    PIPELINE_FIELD(latch_rr2rs), PIPELINE_FIELD(rs), PIPELINE_FIELD(issue_select),
+    PIPELINE_FIELD(latch_rs2ex), PIPELINE_FIELD(reg_int), PIPELINE_FIELD(reg_fp),
+    PIPELINE_FIELD(rob), PIPELINE_FIELD(latch_rob2rs), PIPELINE_FIELD(latch_rob2reg),
+    PIPELINE_FIELD(alu), PIPELINE_FIELD(mul), PIPELINE_FIELD(int_bypass),
+    PIPELINE_FIELD(latch_ex_int2rob), PIPELINE_FIELD(fpu), PIPELINE_FIELD(fp_bypass),
+    PIPELINE_FIELD(latch_ex_fp2rob), PIPELINE_FIELD(stq), PIPELINE_FIELD(latch_stq2dcache),
+    PIPELINE_FIELD(latch_stq2ldq), PIPELINE_FIELD(ldq), PIPELINE_FIELD(latch_ldq2dcache),
+    PIPELINE_FIELD(latch_ldq2rs), PIPELINE_FIELD(data_cache),
+    PIPELINE_FIELD(data_cache_miss_buffer), PIPELINE_FIELD(data_cache_prefetch_buffer),
+    PIPELINE_FIELD(data_cache_writeback_buffer), PIPELINE_FIELD(data_tlb), PIPELINE_FIELD(l2_tlb),
+    PIPELINE_FIELD(undiff),
+};
+#undef PIPELINE_FIELD
+
+struct cache_field_t { const char *name; manifold::uarch::counter_t cache_counter_t::*counter; };
+static const cache_field_t cache_fields[] = {
+    { "cache", &cache_counter_t::cache },
+    { "tlb", &cache_counter_t::cache }, // the tlb is charged the cache bank accesses
+    { "prefetch", &cache_counter_t::prefetch },
+    { "missbuf", &cache_counter_t::missbuf },
+    { "linefill", &cache_counter_t::linefill },
+    { "writeback", &cache_counter_t::writeback },
+    { "undiff", &cache_counter_t::undiff },
+};
+
+#define NUM_FIELDS(a) (sizeof(a) / sizeof(a[0]))
+
+
+#ifndef KITFOX_STUB
+kitfox_lib_model_t::kitfox_lib_model_t(const char *ConfigFile)
+{
+    kitfox = new libKitFox::kitfox_t(/* Intra (local) MPI Comm */ NULL,
+                                     /* Inter MPI Comm */ NULL);
+
+    cout << "Initializing KitFox ..." << endl;
+    kitfox->configure(ConfigFile);
+}
+
+kitfox_lib_model_t::~kitfox_lib_model_t()
+{
+    delete kitfox;
+}
+
+kitfox_power_t kitfox_lib_model_t::calculate_power(const string &prefix, const pipeline_counter_t &c, Time_t t, Time_t period)
+{
+    for(unsigned i = 0; i < NUM_FIELDS(pipeline_fields); i++) {
+        libKitFox::Comp_ID comp_id = kitfox->get_component_id(prefix + "." + pipeline_fields[i].name);
+        assert(comp_id != INVALID_COMP_ID);
+        libKitFox::counter_t counter = c.*pipeline_fields[i].counter;
+        kitfox->calculate_power(comp_id, t, period, counter);
+    }
+    return synchronize_power(prefix, t, period);
+}
+
+kitfox_power_t kitfox_lib_model_t::calculate_power(const string &prefix, const cache_counter_t &c, Time_t t, Time_t period)
+{
+    for(unsigned i = 0; i < NUM_FIELDS(cache_fields); i++) {
+        libKitFox::Comp_ID comp_id = kitfox->get_component_id(prefix + "." + cache_fields[i].name);
+        assert(comp_id != INVALID_COMP_ID);
+        libKitFox::counter_t counter = c.*cache_fields[i].counter;
+        kitfox->calculate_power(comp_id, t, period, counter);
+    }
+    return synchronize_power(prefix, t, period);
+}
+
+/* Sums the power of the components under a node. */
+kitfox_power_t kitfox_lib_model_t::synchronize_power(const string &prefix, Time_t t, Time_t period)
+{
+    libKitFox::Comp_ID comp_id = kitfox->get_component_id(prefix);
+    kitfox->synchronize_data(comp_id, t, period, libKitFox::KITFOX_DATA_POWER);
+
+    libKitFox::power_t power;
+    if(kitfox->pull_data(comp_id, t, period, libKitFox::KITFOX_DATA_POWER, &power) != libKitFox::KITFOX_QUEUE_ERROR_NONE) {
+        cerr << "KitFox: cannot get the power of " << prefix << endl;
+        exit(1);
+    }
+
+    kitfox_power_t p;
+    p.dynamic = power.dynamic;
+    p.leakage = power.leakage;
+    return p;
+}
+
+void kitfox_lib_model_t::calculate_temperature(Time_t t, Time_t period)
+{
+    libKitFox::Comp_ID package_id = kitfox->get_component_id("package");
+    assert(package_id != INVALID_COMP_ID);
+    kitfox->calculate_temperature(package_id, t, period);
+}
+
+double kitfox_lib_model_t::get_temperature(const string &partition, Time_t t, Time_t period)
+{
+    libKitFox::Kelvin temp;
+    libKitFox::Comp_ID par_id = kitfox->get_component_id(partition);
+    if(kitfox->pull_data(par_id, t, period, libKitFox::KITFOX_DATA_TEMPERATURE, &temp) != libKitFox::KITFOX_QUEUE_ERROR_NONE) {
+        cerr << "KitFox: cannot get the temperature of " << partition << endl;
+        exit(1);
+    }
+    return temp;
+}
+#endif // KITFOX_STUB
+
+
+/* Energy per access (J), leakage per node (W), and the thermal model */
+#define STUB_ENERGY_SWITCHING 0.5e-12
+#define STUB_ENERGY_READ      5.0e-12
+#define STUB_ENERGY_TAG       1.0e-12
+#define STUB_ENERGY_WRITE     6.0e-12
+#define STUB_ENERGY_SEARCH    3.0e-12
+#define STUB_LEAKAGE          0.05
+#define STUB_AMBIENT          318.15 // Kelvin
+#define STUB_R                2.0    // Kelvin/W
+#define STUB_RC               0.01   // seconds
+
+static double stub_energy(const libKitFox::counter_t &c)
+{
+    return c.switching*STUB_ENERGY_SWITCHING
+         + c.read*STUB_ENERGY_READ + c.write*STUB_ENERGY_WRITE
+         + (c.read_tag + c.write_tag)*STUB_ENERGY_TAG
+         + c.search*STUB_ENERGY_SEARCH;
+}
+
+kitfox_stub_model_t::kitfox_stub_model_t()
+{
+    cout << "Using the stub KitFox energy model" << endl;
+}
+
+kitfox_power_t kitfox_stub_model_t::calculate_power(const string &prefix, const pipeline_counter_t &c, Time_t t, Time_t period)
+{
+    double energy = 0;
+    for(unsigned i = 0; i < NUM_FIELDS(pipeline_fields); i++) {
+        energy += stub_energy(c.*pipeline_fields[i].counter);
+    }
+    return record_power(prefix, energy, t, period);
+}
+
+kitfox_power_t kitfox_stub_model_t::calculate_power(const string &prefix, const cache_counter_t &c, Time_t t, Time_t period)
+{
+    double energy = 0;
+    for(unsigned i = 0; i < NUM_FIELDS(cache_fields); i++) {
+        energy += stub_energy(c.*cache_fields[i].counter);
+    }
+    return record_power(prefix, energy, t, period);
+}
+
+kitfox_power_t kitfox_stub_model_t::record_power(const string &prefix, double energy, Time_t t, Time_t period)
+{
+    kitfox_power_t p;
+    p.dynamic = energy / period;
+    p.leakage = STUB_LEAKAGE;
+
+    std::lock_guard<std::mutex> l(lock);
+    power[make_pair(t, prefix)] = p.get_total();
+    return p;
+}
+
+void kitfox_stub_model_t::calculate_temperature(Time_t t, Time_t period)
+{
+    std::lock_guard<std::mutex> l(lock);
+    const double decay = exp(-period / STUB_RC);
+
+    map<pair<Time_t, string>, double>::iterator it = power.lower_bound(make_pair(t, string()));
+    while(it != power.end() && it->first.first == t) {
+        map<string, double>::iterator temp = temperature.find(it->first.second);
+        if(temp == temperature.end()) {
+            temp = temperature.insert(make_pair(it->first.second, (double)STUB_AMBIENT)).first;
+        }
+        double steady = STUB_AMBIENT + it->second * STUB_R;
+        temp->second = steady + (temp->second - steady) * decay;
+        power.erase(it++);
+    }
+}
+
+double kitfox_stub_model_t::get_temperature(const string &partition, Time_t t, Time_t period)
+{
+    std::lock_guard<std::mutex> l(lock);
+    map<string, double>::iterator temp = temperature.find(partition);
+    return temp == temperature.end() ? STUB_AMBIENT : temp->second;
+}
+
+#endif // USE_KITFOX
@@ -0,0 +1,107 @@
+#ifndef __KITFOX_MODEL_H__
+#define __KITFOX_MODEL_H__
+#ifdef USE_KITFOX
+
+#include <string>
+#include <map>
+#include <mutex>
+#ifndef KITFOX_STUB
+#include "kitfox.h"
+#endif
+#include "kernel/common-defs.h"
+#include "uarch/kitfoxCounter.h"
+
+namespace manifold {
+namespace kitfox_proxy {
+
+struct kitfox_power_t
+{
+    kitfox_power_t() : dynamic(0), leakage(0) {}
+    double get_total() const { return dynamic + leakage; }
+
+    double dynamic; // W
+    double leakage; // W
+};
+
+
+/* The energy and thermal library behind kitfox_proxy_t. Nodes and partitions
+   are named as in the KitFox configuration, e.g. package.core_die.core0. */
+class kitfox_model_t
+{
+public:
+    virtual ~kitfox_model_t() {}
+
+    /* True if the power of different nodes, or of the same node at different
+       times, can be calculated at the same time. */
+    virtual bool is_thread_safe() const = 0;
+
+    /* Power of a node over the period ending at time t. */
+    virtual kitfox_power_t calculate_power(const std::string &prefix, const manifold::uarch::pipeline_counter_t &c,
+                                           manifold::kernel::Time_t t, manifold::kernel::Time_t period) = 0;
+    virtual kitfox_power_t calculate_power(const std::string &prefix, const manifold::uarch::cache_counter_t &c,
+                                           manifold::kernel::Time_t t, manifold::kernel::Time_t period) = 0;
+
+    /* Steps the thermal model over the period ending at time t. Called in time
+       order, once the power of every node at t has been calculated. */
+    virtual void calculate_temperature(manifold::kernel::Time_t t, manifold::kernel::Time_t period) = 0;
+    virtual double get_temperature(const std::string &partition, manifold::kernel::Time_t t,
+                                   manifold::kernel::Time_t period) = 0;
+};
+
+
+#ifndef KITFOX_STUB
+/* libKitFox, configured from a KitFox config file. */
+class kitfox_lib_model_t : public kitfox_model_t
+{
+public:
+    kitfox_lib_model_t(const char *ConfigFile);
+    ~kitfox_lib_model_t();
+
+    bool is_thread_safe() const { return false; }
+
+    kitfox_power_t calculate_power(const std::string &prefix, const manifold::uarch::pipeline_counter_t &c,
+                                   manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+    kitfox_power_t calculate_power(const std::string &prefix, const manifold::uarch::cache_counter_t &c,
+                                   manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+    void calculate_temperature(manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+    double get_temperature(const std::string &partition, manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+
+private:
+    kitfox_power_t synchronize_power(const std::string &prefix, manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+
+    libKitFox::kitfox_t *kitfox;
+};
+#endif
+
+
+/* A fixed energy per access and a fixed leakage per node, feeding a lumped
+   RC thermal model per node. Used when libKitFox is not available, and for
+   testing. */
+class kitfox_stub_model_t : public kitfox_model_t
+{
+public:
+    kitfox_stub_model_t();
+
+    bool is_thread_safe() const { return true; }
+
+    kitfox_power_t calculate_power(const std::string &prefix, const manifold::uarch::pipeline_counter_t &c,
+                                   manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+    kitfox_power_t calculate_power(const std::string &prefix, const manifold::uarch::cache_counter_t &c,
+                                   manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+    void calculate_temperature(manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+    double get_temperature(const std::string &partition, manifold::kernel::Time_t t, manifold::kernel::Time_t period);
+
+private:
+    kitfox_power_t record_power(const std::string &prefix, double energy, manifold::kernel::Time_t t,
+                                manifold::kernel::Time_t period);
+
+    std::mutex lock;
+    std::map<std::pair<manifold::kernel::Time_t, std::string>, double> power; // W, until its thermal step
+    std::map<std::string, double> temperature; // Kelvin
+};
+
+} // namespace kitfox_proxy
+} // namespace manifold
+
+#endif // USE_KITFOX
+#endif
@@ -1,50 +1,41 @@
 #ifdef USE_KITFOX
+#include <algorithm>
 #include "kitfox_proxy.h"
 
 using namespace std;
-using namespace libKitFox;
 using namespace manifold;
 using namespace manifold::kernel;
 using namespace manifold::kitfox_proxy;
 using namespace manifold::uarch;
 
 kitfox_proxy_t::kitfox_proxy_t(const char *ConfigFile,
-                               uint64_t SamplingFreq) :
-    comp_num(0)
+                               uint64_t SamplingFreq,
+                               unsigned EvalThreads,
+                               unsigned Lag) :
+    num_samples(0),
+    lag(Lag),
+    next_thermal(0),
+    thermal_busy(false),
+    next_apply(0),
+    exiting(false)
 {
-    kitfox = new kitfox_t(/* Intra (local) MPI Comm */ NULL,
-                          /* Inter MPI Comm */ NULL);
-
     cout << "Initializing KitFox ..." << endl;
-    kitfox->configure(ConfigFile);
+#ifdef KITFOX_STUB
+    model = new kitfox_stub_model_t();
+#else
+    model = new kitfox_lib_model_t(ConfigFile);
+#endif
 
     cout << "Registering clock ( " << SamplingFreq / 1e6  << " MHz) to KitFox Proxy ..." << endl;
     Clock* clk = new Clock(SamplingFreq);
     manifold::kernel::Clock :: Register(*clk, (kitfox_proxy_t*)this, &kitfox_proxy_t::tick, (void(kitfox_proxy_t::*)(void))0);
 
-    /* Get the pair of <first ID, last ID> of KitFox pseudo components */
-    pair<Comp_ID, Comp_ID> kitfox_component_id =
-    kitfox->component_id_range;
-
-#if 0
-    /* Check which components are associated with which libraries. */
-    for(Comp_ID pseudo_component_id = kitfox_component_id.first;
-        pseudo_component_id <= kitfox_component_id.second;
-        pseudo_component_id++) {
-        /* Pseudo component is associated with energy library. */
-        if(kitfox->get_energy_library(pseudo_component_id)) {
-            add_kitfox_power_component(pseudo_component_id);
-        }
-        /* Pseudo component is associated with thermal library. */
-        if(kitfox->get_thermal_library(pseudo_component_id)) {
-            add_kitfox_thermal_component(pseudo_component_id);
-        }
-        /* Pseudo component is associated with reliability library. */
-        if(kitfox->get_reliability_library(pseudo_component_id)) {
-            add_kitfox_reliability_component(pseudo_component_id);
-        }
+    if (EvalThreads > 1 && !model->is_thread_safe()) {
+        cerr << "KitFox model is not thread-safe; evaluating on 1 thread instead of " << EvalThreads << endl;
+        EvalThreads = 1;
     }
-#endif
+    for (unsigned i = 0; i < EvalThreads; i++)
+        workers.push_back(std::thread(&kitfox_proxy_t::worker, this));
 
     cout << "Finished initializing KitFox" << endl;
 }
@@ -52,8 +43,14 @@ kitfox_proxy_t::kitfox_proxy_t(const char *ConfigFile,
 
 kitfox_proxy_t::~kitfox_proxy_t()
 {
+    drain();
+
+    /* Samples that never received all their counters */
+    for (auto s: collecting)
+        delete s.second;
+
     cout << "Terminating KitFox" << endl;
-    delete kitfox;
+    delete model;
     delete m_clk;
 }
 
@@ -63,31 +60,34 @@ void kitfox_proxy_t::tick()
     if (m_clk->NowTicks() == 0)
         return ;
 
+    /* Results of earlier samples are due now. */
+    apply_ready();
+
+    Time_t t = m_clk->NowTicks() * m_clk->period;
+    collecting[t] = new kitfox_sample_t(num_samples++, t, m_clk->period, manifold_node.size());
+
     int core_id = 0;
     int l1cache_id = 0;
     int l2cache_id = 0;
     for (auto id: manifold_node) {
-        // core_model only, FIXME add test function for other models here
-        // difference between manifold_node id and core_id???
-
         switch (id.second) {
             case KitFoxType::core_type: {
                 kitfox_proxy_request_t<pipeline_counter_t> *req;
-                req = new kitfox_proxy_request_t<pipeline_counter_t> (core_id, id.second, m_clk->NowTicks() * m_clk->period);
+                req = new kitfox_proxy_request_t<pipeline_counter_t> (core_id, id.second, t);
                 Send(id.first, req);
                 core_id++;
                 break;
             }
             case KitFoxType::l1cache_type: {
                 kitfox_proxy_request_t<cache_counter_t> *req;
-                req = new kitfox_proxy_request_t<cache_counter_t> (l1cache_id, id.second, m_clk->NowTicks() * m_clk->period);
+                req = new kitfox_proxy_request_t<cache_counter_t> (l1cache_id, id.second, t);
                 Send(id.first, req);
                 l1cache_id++;
                 break;
             }
             case KitFoxType::l2cache_type: {
                 kitfox_proxy_request_t<cache_counter_t> *req;
-                req = new kitfox_proxy_request_t<cache_counter_t> (l2cache_id, id.second, m_clk->NowTicks() * m_clk->period);
+                req = new kitfox_proxy_request_t<cache_counter_t> (l2cache_id, id.second, t);
                 Send(id.first, req);
                 l2cache_id++;
                 break;
@@ -96,36 +96,7 @@ void kitfox_proxy_t::tick()
                 cerr << "error manifold_node type!" << endl;
                 exit(1);
         }
-
     }
-#if 0
-    uint64_t clock_cycle = m_clk->NowTicks();
-
-    /* Invoke KitFox calculations */
-    if(clock_cycle % sampling_interval == 0) {
-        /* Collect counters from Manifold nodes. */
-        for(vector<pair<libKitFox::Comp_ID, libKitFox::counter_t*> >::iterator it
-                = kitfox_power_component.begin();
-            it != kitfox_power_component.end(); it++) {
-        }
-
-        /* Invoke calculate_power() */
-        for(vector<pair<libKitFox::Comp_ID, libKitFox::counter_t*> >::iterator it
-                = kitfox_power_component.begin();
-            it != kitfox_power_component.end(); it++) {
-        }
-
-        /* Invoke calculate_temperature() */
-        for(vector<Comp_ID>::iterator it = kitfox_thermal_component.begin();
-            it != kitfox_thermal_component.end(); it++) {
-        }
-
-        /* Invoke calculate_failure_rate() */
-        for(vector<Comp_ID>::iterator it = kitfox_reliability_component.begin();
-            it != kitfox_reliability_component.end(); it++) {
-        }
-    }
-#endif
 }
 
 
@@ -142,538 +113,246 @@ void kitfox_proxy_t::add_manifold_node(CompId_t CompId, KitFoxType t)
         if(comp.first == CompId) { return; }
     }
 
+    /* Nodes of each type are numbered in the order they are added. */
+    size_t n = 0;
+    for(auto comp: manifold_node) {
+        if(comp.second == t) { n++; }
+    }
+
+    string name;
+    switch (t) {
+        case KitFoxType::core_type:
+            name = "package.core_die.core" + std::to_string(n);
+            break;
+        case KitFoxType::l1cache_type:
+            name = "package.core_die.l1cache" + std::to_string(n);
+            break;
+        case KitFoxType::l2cache_type:
+            name = "package.llc_die.cache" + std::to_string(n);
+            break;
+        default:
+            cerr << "error manifold_node type!" << endl;
+            exit(1);
+    }
+
+    node_index[name] = manifold_node.size();
+    node_name.push_back(name);
     manifold_node.push_back(make_pair(CompId, t));
 }
 
-#if 0
-/* Add KitFox components to calculate power. */
-void kitfox_proxy_t::add_kitfox_power_component(Comp_ID ComponentID)
+
+/* All counters of a sample have arrived. */
+void kitfox_proxy_t::submit(kitfox_sample_t *s)
+{
+    if (workers.empty()) {
+        evaluate_power(s);
+        evaluate_temperature(s);
+        apply(s);
+        delete s;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        /* Counters of different samples may complete out of order. */
+        auto pos = std::upper_bound(in_flight.begin(), in_flight.end(), s,
+                                    [](const kitfox_sample_t *a, const kitfox_sample_t *b) { return a->seq < b->seq; });
+        in_flight.insert(pos, s);
+        pending.push_back(s);
+    }
+    work_cv.notify_one();
+}
+
+
+void kitfox_proxy_t::evaluate_power(kitfox_sample_t *s)
 {
-    /* Check if there already exists the same component ID. */
-    for(vector<pair<libKitFox::Comp_ID, libKitFox::counter_t*> >::iterator it =
-            kitfox_power_component.begin();
-        it != kitfox_power_component.end(); it++) {
-        if(it->first == ComponentID) { return; }
+    s->result.time = s->time;
+    s->result.nodes.resize(manifold_node.size());
+
+    for (size_t i = 0; i < manifold_node.size(); i++) {
+        kitfox_node_result_t &r = s->result.nodes[i];
+        r.comp_id = manifold_node[i].first;
+        r.type = manifold_node[i].second;
+        r.name = node_name[i];
+        r.temperature = 0;
+
+        if (r.type == KitFoxType::core_type)
+            r.power = model->calculate_power(r.name, s->pipeline[i], s->time, s->period);
+        else
+            r.power = model->calculate_power(r.name, s->cache[i], s->time, s->period);
     }
+}
+
+
+/* Must be called in time order. */
+void kitfox_proxy_t::evaluate_temperature(kitfox_sample_t *s)
+{
+    model->calculate_temperature(s->time, s->period);
 
-    kitfox_power_component.push_back(make_pair(ComponentID, (libKitFox::counter_t*)NULL));
+    for (auto &r: s->result.nodes)
+        r.temperature = model->get_temperature(r.name, s->time, s->period);
 }
 
-/* Add KitFox components to calculate thermal. */
-void kitfox_proxy_t::add_kitfox_thermal_component(Comp_ID ComponentID)
+
+void kitfox_proxy_t::apply(kitfox_sample_t *s)
 {
-    /* Check if there already exists the same component ID. */
-    for(vector<Comp_ID>::iterator it = kitfox_thermal_component.begin();
-        it != kitfox_thermal_component.end(); it++) {
-        if((*it) == ComponentID) { return; }
+    for (auto &r: s->result.nodes) {
+        cerr << r.name + ".power = " << r.power.get_total() << "W (dynamic = " << r.power.dynamic
+             << "W, leakage = " << r.power.leakage << "W) @" << s->time << endl;
     }
+    for (auto &r: s->result.nodes)
+        cerr << r.name + ".temperature = " << r.temperature << "Kelvin @" << s->time << endl;
 
-    kitfox_thermal_component.push_back(ComponentID);
+    for (auto l: listeners)
+        l->apply(s->result);
 }
 
-/* Add KitFox components to calculate reliability. */
 
-void kitfox_proxy_t::add_kitfox_reliability_component(Comp_ID ComponentID)
+/* Apply, in time order, the samples taken at least lag samples ago, waiting
+   for their evaluation if needed. A sample still waiting for counters holds
+   back the ones after it. */
+void kitfox_proxy_t::apply_ready()
 {
-    /* Check if there already exists the same component ID. */
-    for(vector<Comp_ID>::iterator it = kitfox_reliability_component.begin();
-        it != kitfox_reliability_component.end(); it++) {
-        if((*it) == ComponentID) { return; }
+    std::unique_lock<std::mutex> guard(lock);
+    while (!in_flight.empty()) {
+        kitfox_sample_t *s = in_flight.front();
+        if (s->seq != next_apply || s->seq + lag > num_samples)
+            break;
+
+        done_cv.wait(guard, [s] { return s->done; });
+        in_flight.pop_front();
+        next_apply++;
+
+        guard.unlock();
+        apply(s);
+        delete s;
+        guard.lock();
     }
+}
 
-    kitfox_reliability_component.push_back(ComponentID);
+
+/* The workers are stopped first, so from here on the model is only used by
+   this thread and the evaluation falls back to submit()'s inline path. */
+void kitfox_proxy_t::drain()
+{
+    stop_workers();
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (!in_flight.empty()) {
+        kitfox_sample_t *s = in_flight.front();
+        /* A missing sample will never complete now. */
+        if (s->seq != next_apply) {
+            next_apply = s->seq;
+            next_thermal = std::max(next_thermal, s->seq);
+        }
+        run_thermal_steps(guard);
+        assert(s->done);
+
+        in_flight.pop_front();
+        next_apply++;
+
+        guard.unlock();
+        apply(s);
+        delete s;
+        guard.lock();
+    }
 }
-#endif
 
-void kitfox_proxy_t::calculate_power(manifold::uarch::pipeline_counter_t c, manifold::kernel::Time_t t, const string prefix)
+
+/* Lets the workers finish the queued samples and exit. */
+void kitfox_proxy_t::stop_workers()
 {
-        string comp;
-        libKitFox::Comp_ID comp_id;
-
-        // l1_btb
-        comp = prefix + ".l1_btb";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.l1_btb);
-
-        // l2_btb
-        comp = prefix + ".l2_btb";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.l2_btb);
-
-        // predictor_chooser
-        comp = prefix + ".predictor_chooser";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.predictor_chooser);
-
-        // global_predictor
-        comp = prefix + ".global_predictor";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.global_predictor);
-
-        // l1_local_predictor
-        comp = prefix + ".l1_local_predictor";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.l1_local_predictor);
-
-        // l2_local_predictor
-        comp = prefix + ".l2_local_predictor";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.l2_local_predictor);
-
-        // ras
-        comp = prefix + ".ras";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.ras);
-
-        // inst_cache
-        comp = prefix + ".inst_cache";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.inst_cache);
-
-        // inst_cache_miss_buffer
-        comp = prefix + ".inst_cache_miss_buffer";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.inst_cache_miss_buffer);
-
-        // inst_tlb
-        comp = prefix + ".inst_tlb";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.inst_tlb);
-
-        // latch_ic2ib
-        comp = prefix + ".latch_ic2ib";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_ic2ib);
-
-        // pc
-        comp = prefix + ".pc";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.pc);
-
-        // inst_buffer
-        comp = prefix + ".inst_buffer";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.inst_buffer);
-
-        // latch_ib2id
-        comp = prefix + ".latch_ib2id";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_ib2id);
-
-        // inst_decoder
-        comp = prefix + ".inst_decoder";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.inst_decoder);
-
-        // operand_decoder
-        comp = prefix + ".operand_decoder";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.operand_decoder);
-
-        // uop_sequencer
-        comp = prefix + ".uop_sequencer";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.uop_sequencer);
-
-        // latch_id2uq
-        comp = prefix + ".latch_id2uq";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_id2uq);
-
-        // uop_queue
-        comp = prefix + ".uop_queue";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.uop_queue);
-
-        // latch_uq2rr
-        comp = prefix + ".latch_uq2rr";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_uq2rr);
-
-        // rat
-        comp = prefix + ".rat";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.rat);
-
-        // freelist
-        comp = prefix + ".freelist";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.freelist);
-
-        // dependency_check
-        comp = prefix + ".dependency_check";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.dependency_check);
-
-        // latch_id2iq (in-order)
-        // comp = prefix + ".latch_id2iq";
-        // comp_id = kitfox->get_component_id(comp);
-        // assert(comp_id != INVALID_COMP_ID);
-        // kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_id2iq);
-
-        // latch_rr2rs
-        comp = prefix + ".latch_rr2rs";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_rr2rs);
-
-        // rs
-        comp = prefix + ".rs";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.rs);
-
-        // issue_select
-        comp = prefix + ".issue_select";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.issue_select);
-
-        // latch_rs2ex
-        comp = prefix + ".latch_rs2ex";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_rs2ex);
-
-        // reg_int
-        comp = prefix + ".reg_int";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.reg_int);
-
-        // reg_fp
-        comp = prefix + ".reg_fp";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.reg_fp);
-
-        // rob
-        comp = prefix + ".rob";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.rob);
-
-        // latch_rob2rs
-        comp = prefix + ".latch_rob2rs";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_rob2rs);
-
-        // latch_rob2reg
-        comp = prefix + ".latch_rob2reg";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_rob2reg);
-
-        // alu
-        comp = prefix + ".alu";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.alu);
-
-        // mul
-        comp = prefix + ".mul";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.mul);
-
-        // int_bypass
-        comp = prefix + ".int_bypass";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.int_bypass);
-
-        // latch_ex_int2rob
-        comp = prefix + ".latch_ex_int2rob";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_ex_int2rob);
-
-        // fpu
-        comp = prefix + ".fpu";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.fpu);
-
-        // fp_bypass
-        comp = prefix + ".fp_bypass";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.fp_bypass);
-
-        // latch_ex_fp2rob
-        comp = prefix + ".latch_ex_fp2rob";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_ex_fp2rob);
-
-        // stq
-        comp = prefix + ".stq";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.stq);
-
-        // latch_stq2dcache
-        comp = prefix + ".latch_stq2dcache";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_stq2dcache);
-
-        // latch_stq2ldq
-        comp = prefix + ".latch_stq2ldq";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_stq2ldq);
-
-        // ldq
-        comp = prefix + ".ldq";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.ldq);
-
-        // latch_ldq2dcache
-        comp = prefix + ".latch_ldq2dcache";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_ldq2dcache);
-
-        // latch_ldq2rs
-        comp = prefix + ".latch_ldq2rs";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_ldq2rs);
-
-        // lsq (in-order)
-        // comp = prefix + ".lsq";
-        // comp_id = kitfox->get_component_id(comp);
-        // assert(comp_id != INVALID_COMP_ID);
-        // kitfox->calculate_power(comp_id, t, m_clk->period, c.lsq);
-
-        // latch_lsq2dcache (in-order)
-        // comp = prefix + ".latch_lsq2dcache";
-        // comp_id = kitfox->get_component_id(comp);
-        // assert(comp_id != INVALID_COMP_ID);
-        // kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_lsq2dcache);
-
-        // latch_lsq2reg (in-order)
-        // comp = prefix + ".latch_lsq2reg";
-        // comp_id = kitfox->get_component_id(comp);
-        // assert(comp_id != INVALID_COMP_ID);
-        // kitfox->calculate_power(comp_id, t, m_clk->period, c.latch_lsq2reg);
-
-        // data_cache
-        comp = prefix + ".data_cache";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.data_cache);
-
-        // data_cache_miss_buffer
-        comp = prefix + ".data_cache_miss_buffer";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.data_cache_miss_buffer);
-
-        // data_cache_prefetch_buffer
-        comp = prefix + ".data_cache_prefetch_buffer";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.data_cache_prefetch_buffer);
-
-        // data_cache_writeback_buffer
-        comp = prefix + ".data_cache_writeback_buffer";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.data_cache_writeback_buffer);
-
-        // data_tlb
-        comp = prefix + ".data_tlb";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.data_tlb);
-
-        // l2_tlb
-        comp = prefix + ".l2_tlb";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.l2_tlb);
-
-        // undiff
-        comp = prefix + ".undiff";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.undiff);
-
-#if 0
-        // frontend_undiff
-        comp = prefix + "frontend_undiff";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.frontend_undiff);
-
-        // scheduler_undiff
-        comp = prefix + "scheduler_undiff";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.scheduler_undiff);
-
-        // ex_int_undiff
-        comp = prefix + "ex_int_undiff";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.ex_int_undiff);
-
-        // ex_fp_undiff
-        comp = prefix + "ex_fp_undiff";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.ex_fp_undiff);
-
-        // lsu_undiff
-        comp = prefix + "lsu_undiff";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.lsu_undiff);
-
-        // package
-        comp = prefix + "package";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.package);
-
-        // core
-        comp = prefix + "core";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.core);
-
-        // frontend
-        comp = prefix + "frontend";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.frontend);
-
-        // lsu
-        comp = prefix + "lsu";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.lsu);
-
-        // scheduler
-        comp = prefix + "scheduler";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.scheduler);
-
-        // ex_int
-        comp = prefix + "ex_int";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.ex_int);
-
-        // ex_fp
-        comp = prefix + "ex_fp";
-        comp_id = kitfox->get_component_id(comp);
-        assert(comp_id != INVALID_COMP_ID);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.ex_fp);
-
-        // execute
-        comp = prefix + "execute";
-        assert(comp_id != INVALID_COMP_ID);
-        comp_id = kitfox->get_component_id(comp);
-        kitfox->calculate_power(comp_id, t, m_clk->period, c.execute);
-#endif
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        exiting = true;
+    }
+    work_cv.notify_all();
+    for (auto &w: workers)
+        w.join();
+    workers.clear();
+}
+
+
+/* Calculates the power of queued samples. The thermal step of each sample is
+   run by whichever worker finds it next in time order with its power done,
+   so no worker ever waits for another. */
+void kitfox_proxy_t::worker()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        work_cv.wait(guard, [this] { return exiting || !pending.empty(); });
+        if (pending.empty())
+            break;
+
+        kitfox_sample_t *s = pending.front();
+        pending.pop_front();
+
+        guard.unlock();
+        evaluate_power(s);
+        guard.lock();
+        s->powered = true;
+        run_thermal_steps(guard);
+    }
+}
 
-        // synchronize core power
-        comp = prefix;
-        comp_id = kitfox->get_component_id(comp);
-        kitfox->synchronize_data(comp_id, t, m_clk->period, libKitFox::KITFOX_DATA_POWER);
 
-        // print core power
-        libKitFox::power_t power;
-        assert(kitfox->pull_data(comp_id, t, m_clk->period, libKitFox::KITFOX_DATA_POWER, &power) == libKitFox::KITFOX_QUEUE_ERROR_NONE);
-        cerr << prefix + ".power = " << power.get_total() << "W (dynamic = " << power.dynamic << "W, leakage = " << power.leakage << "W) @" << t << endl;
+/* Runs the thermal steps that are ready, in time order. Called with the lock
+   held. */
+void kitfox_proxy_t::run_thermal_steps(std::unique_lock<std::mutex> &guard)
+{
+    while (!thermal_busy) {
+        kitfox_sample_t *next = NULL;
+        for (auto f: in_flight) {
+            if (f->seq == next_thermal) { next = f; break; }
+        }
+        if (next == NULL || !next->powered)
+            break;
+
+        thermal_busy = true;
+        guard.unlock();
+        evaluate_temperature(next);
+        guard.lock();
+        thermal_busy = false;
+        next->done = true;
+        next_thermal++;
+        done_cv.notify_all();
+    }
+}
+
 
+kitfox_dvfs_governor_t::kitfox_dvfs_governor_t(CompId_t Node, DVFSClock *Clk,
+                                               double HotTemp, double CoolTemp, double LowFreq, double HighFreq) :
+    node(Node),
+    clk(Clk),
+    hot_temp(HotTemp),
+    cool_temp(CoolTemp),
+    low_freq(LowFreq),
+    high_freq(HighFreq),
+    throttled(false)
+{
+    assert(CoolTemp <= HotTemp);
 }
 
-void kitfox_proxy_t::calculate_power(manifold::uarch::cache_counter_t c, manifold::kernel::Time_t t, const string prefix)
+
+void kitfox_dvfs_governor_t::apply(const kitfox_result_t &Result)
 {
-    string comp;
-    libKitFox::Comp_ID comp_id;
-
-    // cache
-    comp = prefix + ".cache";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.cache);
-
-    // tlb
-    comp = prefix + ".tlb";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.cache);
-
-    // prefetch
-    comp = prefix + ".prefetch";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.prefetch);
-
-    // missbuf
-    comp = prefix + ".missbuf";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.missbuf);
-
-    // linefill
-    comp = prefix + ".linefill";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.linefill);
-
-    // writeback
-    comp = prefix + ".writeback";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.writeback);
-
-    // undiff
-    comp = prefix + ".undiff";
-    comp_id = kitfox->get_component_id(comp);
-    assert(comp_id != INVALID_COMP_ID);
-    kitfox->calculate_power(comp_id, t, m_clk->period, c.undiff);
-
-    // synchronize core power
-    comp = prefix;
-    comp_id = kitfox->get_component_id(comp);
-    kitfox->synchronize_data(comp_id, t, m_clk->period, libKitFox::KITFOX_DATA_POWER);
-
-    // print core power
-    libKitFox::power_t power;
-    assert(kitfox->pull_data(comp_id, t, m_clk->period, libKitFox::KITFOX_DATA_POWER, &power) == libKitFox::KITFOX_QUEUE_ERROR_NONE);
-    cerr << prefix + ".power = " << power.get_total() << "W (dynamic = " << power.dynamic << "W, leakage = " << power.leakage << "W) @" << t << endl;
+    for (auto &r: Result.nodes) {
+        if (r.comp_id != node)
+            continue;
+
+        try {
+            if (!throttled && r.temperature > hot_temp) {
+                clk->set_frequency(low_freq);
+                throttled = true;
+            } else if (throttled && r.temperature < cool_temp) {
+                clk->set_frequency(high_freq);
+                throttled = false;
+            }
+        } catch (MultipleFreqChangeException &) {
+            /* Already changed in this cycle; try again on the next sample. */
+        }
+        return;
+    }
 }
 
 #endif //USE_KITFOX
@@ -4,10 +4,15 @@
 
 #include <assert.h>
 #include <string>
-#include "kitfox.h"
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "kernel/component.h"
 #include "kernel/clock.h"
 #include "uarch/kitfoxCounter.h"
+#include "kitfox_model.h"
 
 namespace manifold {
 namespace kitfox_proxy {
@@ -42,11 +47,84 @@ private:
     T counter;
 };
 
+/* Power and temperature of every node over one sampling period, in the
+   order the nodes were added to the proxy. */
+struct kitfox_node_result_t
+{
+    manifold::kernel::CompId_t comp_id;
+    manifold::uarch::KitFoxType type;
+    std::string name; // KitFox partition, e.g. package.core_die.core0
+    kitfox_power_t power;
+    double temperature; // Kelvin
+};
+
+struct kitfox_result_t
+{
+    manifold::kernel::Time_t time; // end of the sampling period
+    std::vector<kitfox_node_result_t> nodes;
+};
+
+
+/* Acts on the results of each sampling period, e.g. to change a clock
+   frequency. Called on the simulation thread, in time order. */
+class kitfox_listener_t
+{
+public:
+    virtual ~kitfox_listener_t() {}
+    virtual void apply(const kitfox_result_t &Result) = 0;
+};
+
+
+/* Lowers the frequency of a DVFSClock while a node is hotter than HotTemp,
+   and restores it once the node has cooled below CoolTemp. */
+class kitfox_dvfs_governor_t : public kitfox_listener_t
+{
+public:
+    kitfox_dvfs_governor_t(manifold::kernel::CompId_t Node, manifold::kernel::DVFSClock *Clk,
+                           double HotTemp, double CoolTemp, double LowFreq, double HighFreq);
+
+    void apply(const kitfox_result_t &Result);
+
+private:
+    manifold::kernel::CompId_t node;
+    manifold::kernel::DVFSClock *clk;
+    double hot_temp, cool_temp;
+    double low_freq, high_freq;
+    bool throttled;
+};
+
+
+/* Counter snapshots of every node for one sampling period */
+struct kitfox_sample_t
+{
+    kitfox_sample_t(uint64_t Seq, manifold::kernel::Time_t t, manifold::kernel::Time_t p, size_t n) :
+        seq(Seq), time(t), period(p), received(0), powered(false), done(false), pipeline(n), cache(n) {}
+
+    uint64_t seq;
+    manifold::kernel::Time_t time;
+    manifold::kernel::Time_t period;
+    size_t received; // number of nodes that have sent their counters
+    bool powered; // power of every node is calculated
+    bool done; // temperatures are calculated too
+    std::vector<manifold::uarch::pipeline_counter_t> pipeline; // by node index, for cores
+    std::vector<manifold::uarch::cache_counter_t> cache; // by node index, for caches
+    kitfox_result_t result;
+};
+
+
+/* Collects the counters of the Manifold nodes at every tick of its own clock
+   and has the energy model evaluate them. With EvalThreads > 0, the model
+   runs on that many worker threads while the simulation goes on, and the
+   results of a sample are applied Lag samples later; the simulation thread
+   only waits if they are not ready by then. With EvalThreads == 0, a sample
+   is evaluated and applied as soon as its last counters arrive. */
 class kitfox_proxy_t : public manifold::kernel::Component
 {
 public:
     kitfox_proxy_t(const char *ConfigFile,
-                   uint64_t SamplingFreq);
+                   uint64_t SamplingFreq,
+                   unsigned EvalThreads = 0,
+                   unsigned Lag = 1);
     ~kitfox_proxy_t();
 
     void tick();
@@ -54,28 +132,48 @@ public:
 
     /* Add Manifold components to calculate power. */
     void add_manifold_node(manifold::kernel::CompId_t, manifold::uarch::KitFoxType);
-#if 0
-    void pair_counter_to_power_component(manifold::kernel::CompId_t);
-    /* Add KitFox components to invoke calculations. */
-    void add_kitfox_power_component(libKitFox::Comp_ID);
-    void add_kitfox_thermal_component(libKitFox::Comp_ID);
-    void add_kitfox_reliability_component(libKitFox::Comp_ID);
-#endif
+    /* Add an object to act on the results. */
+    void add_listener(kitfox_listener_t *Listener) { listeners.push_back(Listener); }
+
+    /* Wait for every sample being evaluated and apply the results. */
+    void drain();
 
-    void calculate_power(manifold::uarch::pipeline_counter_t c, manifold::kernel::Time_t t, const string prefix);
-    void calculate_power(manifold::uarch::cache_counter_t c, manifold::kernel::Time_t t, const string prefix);
     template <typename T> void handle_kitfox_proxy_response(int temp, kitfox_proxy_request_t<T> *Req);
 
 private:
-    libKitFox::kitfox_t *kitfox;
-    size_t comp_num;
+    void store_counter(kitfox_sample_t *s, size_t idx, const manifold::uarch::pipeline_counter_t &c) { s->pipeline[idx] = c; }
+    void store_counter(kitfox_sample_t *s, size_t idx, const manifold::uarch::cache_counter_t &c) { s->cache[idx] = c; }
+    void submit(kitfox_sample_t *s);
+    void evaluate_power(kitfox_sample_t *s);
+    void evaluate_temperature(kitfox_sample_t *s);
+    void apply(kitfox_sample_t *s);
+    void apply_ready();
+    void worker();
+    void stop_workers();
+    void run_thermal_steps(std::unique_lock<std::mutex> &guard);
+
+    kitfox_model_t *model;
 
     std::vector<std::pair<manifold::kernel::CompId_t, manifold::uarch::KitFoxType>> manifold_node;
-#if 0
-    std::vector<std::pair<libKitFox::Comp_ID, libKitFox::counter_t*> > kitfox_power_component;
-    std::vector<libKitFox::Comp_ID> kitfox_thermal_component;
-    std::vector<libKitFox::Comp_ID> kitfox_reliability_component;
-#endif
+    std::vector<std::string> node_name; // KitFox partition of each node
+    std::map<std::string, size_t> node_index;
+    std::vector<kitfox_listener_t*> listeners;
+
+    uint64_t num_samples; // samples started
+    std::map<manifold::kernel::Time_t, kitfox_sample_t*> collecting; // waiting for counters
+    unsigned lag;
+
+    /* Evaluation off the simulation thread */
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable work_cv; // signaled when a sample is queued, or on exit
+    std::condition_variable done_cv; // signaled when a sample's thermal step is done
+    std::deque<kitfox_sample_t*> pending; // waiting for a worker
+    std::deque<kitfox_sample_t*> in_flight; // submitted but not applied, in time order
+    uint64_t next_thermal; // sample whose thermal step is next
+    bool thermal_busy; // a worker is running a thermal step
+    uint64_t next_apply; // sample whose results are applied next
+    bool exiting;
 };
 
 
@@ -83,7 +181,6 @@ template <typename T>
 void kitfox_proxy_t::handle_kitfox_proxy_response(int temp, kitfox_proxy_request_t<T> *Req)
 {
     assert(Req != NULL);
-    T c = Req->get_counter();
     string prefix;
 
     if (Req->get_type() == manifold::uarch::KitFoxType::core_type) {
@@ -96,66 +193,22 @@ void kitfox_proxy_t::handle_kitfox_proxy_response(int temp, kitfox_proxy_request
         cerr << "unknown counter type!" << endl;
         exit(1);
     }
-    calculate_power(c, Req->get_time(), prefix);
-
-    comp_num += 1;
-    if (comp_num == manifold_node.size()) {
-        libKitFox::Comp_ID package_id = kitfox->get_component_id("package");
-        assert(package_id != INVALID_COMP_ID);
-        kitfox->calculate_temperature(package_id, Req->get_time(), m_clk->period);
-
-        for(unsigned int i = 0, core_id = 0, l1_id = 0, l2_id = 0; i < manifold_node.size(); i++){
-            libKitFox::Kelvin t;
-            string partition;
-            libKitFox::Comp_ID par_id;
-
-            switch (manifold_node[i].second) {
-            case manifold::uarch::KitFoxType::core_type: {
-                partition = "package.core_die.core" + std::to_string(core_id++);
-                break;
-            }
-            case manifold::uarch::KitFoxType::l1cache_type: {
-                partition = "package.core_die.l1cache" + std::to_string(l1_id++);
-                break;
-            }
-            case manifold::uarch::KitFoxType::l2cache_type: {
-                partition = "package.llc_die.cache" + std::to_string(l2_id++);
-                break;
-            }
-            default:
-                cerr << "error manifold_node type!" << endl;
-                exit(1);
-            }
-
-            par_id = kitfox->get_component_id(partition);
-            assert(kitfox->pull_data(par_id, Req->get_time(), m_clk->period, libKitFox::KITFOX_DATA_TEMPERATURE, &t) == libKitFox::KITFOX_QUEUE_ERROR_NONE);
-
-            cerr << partition + ".temperature = " << t << "Kelvin @" << Req->get_time() << endl;
-        }
-
-        // Print thermal grid
-#if 0
-        libKitFox::grid_t<libKitFox::Kelvin> thermal_grid;
-        assert(kitfox->pull_data(package_id, Req->get_time(), m_clk->period, libKitFox::KITFOX_DATA_THERMAL_GRID, &thermal_grid) == libKitFox::KITFOX_QUEUE_ERROR_NONE);
-
-        for(unsigned z = 0; z < thermal_grid.dies(); z++) {
-            printf("die %d:\n", z);
-            for(unsigned x = 0; x < thermal_grid.rows(); x++) {
-                for(unsigned y = 0; y < thermal_grid.cols(); y++) {
-                    printf("%3.2lf ", thermal_grid(x, y, z));
-                }
-                printf("\n");
-            }
-            printf("\n");
-        }
-        printf("\n");
-#endif
 
-        // reset kitfox component counter
-        comp_num = 0;
-    }
+    std::map<manifold::kernel::Time_t, kitfox_sample_t*>::iterator it = collecting.find(Req->get_time());
+    assert(it != collecting.end());
+    kitfox_sample_t *s = it->second;
+
+    std::map<std::string, size_t>::iterator idx = node_index.find(prefix);
+    assert(idx != node_index.end());
 
+    /* Only the snapshot is taken here; the model runs in submit(). */
+    store_counter(s, idx->second, Req->get_counter());
     delete Req;
+
+    if (++s->received == manifold_node.size()) {
+        collecting.erase(it);
+        submit(s);
+    }
 }
 
 
@@ -7,6 +7,8 @@
 
 #include "Bank.h"
 #include "kernel/manifold.h"
+#include "kernel/stat_report.h"
+#include "kernel/stat_sampler.h"
 
 
 using namespace std;
@@ -54,18 +56,18 @@ cout << "request originTime= " << dRequest->get_originTime() << "  Bank availabl
 	//info.old_avail = bankAvailableAtTime;
 	//info.orig = dRequest->get_originTime();
 
-        pair<uint64_t, uint64_t> busy;
+        uint64_t busy_start;
 
 	unsigned long int returnLatency = 0;
 	//bool org_less_than_avail = false;
 	if (dRequest->get_originTime() <= this->bankAvailableAtTime)
 	{
 		//org_less_than_avail = true;
-		busy.first = bankAvailableAtTime; //become busy starting at bankAvailableAtTime
+		busy_start = bankAvailableAtTime; //become busy starting at bankAvailableAtTime
 	}
 	else
 	{
-		busy.first = dRequest->get_originTime(); //become busy starting at origin time
+		busy_start = dRequest->get_originTime(); //become busy starting at origin time
 		this->bankAvailableAtTime = dRequest->get_originTime();
 	}
 
@@ -81,17 +83,9 @@ cout << "request originTime= " << dRequest->get_originTime() << "  Bank availabl
 	//info.new_avail = bankAvailableAtTime;
 	//reqs.push_back(info);
 
-	busy.second = bankAvailableAtTime; //bankAvailableAtTime has been updated
-
-	busy.first = bankAvailableAtTime - busy.first; //busy for this number of cycles due to this request
-
-	if(stats_busy_cycles.size() > 0)
-	    busy.first += stats_busy_cycles.back().first; //accumulate
-	assert(busy.first <= busy.second);
-
-        stats_busy_cycles.push_back(busy);
-	if(stats_busy_cycles.size() > 100) //only keep 100 pairs
-	    stats_busy_cycles.pop_front();
+	//bankAvailableAtTime has been updated; the bank is busy in [busy_start, bankAvailableAtTime)
+	stats_busy_cycles.add(busy_start, bankAvailableAtTime);
+	stats_busy_series.add_span(busy_start, bankAvailableAtTime);
 
         stats->num_requests++;
 	stats->latencies.collect(returnLatency - dRequest->get_originTime());
@@ -143,35 +137,13 @@ void Bank::print_stats (ostream & out)
 {
     stats->print_stats(out);
     uint64_t endTick = manifold::kernel::Manifold::NowTicks();
-#if 0
-for(list<req_info>::iterator it=reqs.begin(); it != reqs.end(); ++it) {
-out << "(" << it->old_avail << ", " << it->orig << ", " << it->new_avail << ") ";
-}
-out<<endl;
-for(list<pair<uint64_t, uint64_t> >::iterator it=stats_busy_cycles.begin(); it != stats_busy_cycles.end(); ++it) {
-out << "(" << it->first << ", " << it->second << ") ";
-}
-out<<endl;
-#endif
-    if(stats_busy_cycles.size() > 0) {
-        if(stats_busy_cycles.back().second > endTick) {
-	    list<pair<uint64_t, uint64_t> >::iterator it = stats_busy_cycles.begin();
-	    for(; it != stats_busy_cycles.end(); ++it) {
-	        if(it->second > endTick)
-		    break;
-	    }
-	    out << "busy cycles= " << it->first << "(" << (it->first) / ((double)endTick) * 100 << "%)";
-	    if(it == stats_busy_cycles.begin())
-	        out << " **";
-	}
-	else {
-	    out << "busy cycles= " << stats_busy_cycles.back().first << "(" << (stats_busy_cycles.back().first)/((double)endTick) * 100 << "%)";
-	}
-	out << endl;
-    }
-    else {
-        out << "busy cycles= 0\n";
-    }
+    bool exact;
+    uint64_t busy = stats_busy_cycles.busy_until(endTick, exact);
+    out << "busy cycles= " << busy << "(" << busy / ((double)endTick) * 100 << "%)";
+    if(!exact)
+        out << " **";
+    out << endl;
+    stats_busy_series.print(out, "busy cycles", endTick);
 }
 
 
@@ -192,6 +164,12 @@ void Bank_stat_engine::global_stat_merge(Stat_engine * e)
     global_engine->latencies.merge(&latencies);
 }
 
+void Bank::register_stats(const std::string& name)
+{
+    manifold::kernel::Stat_report::Register(name, stats);
+    manifold::kernel::Stat_sampler::Add(name + ".requests", &stats->num_requests);
+}
+
 void Bank_stat_engine::print_stats (ostream & out)
 {
     num_requests.print(out);
@@ -199,6 +177,12 @@ void Bank_stat_engine::print_stats (ostream & out)
     //out << latencies.get_average() << endl;
 }
 
+void Bank_stat_engine::report_stats (manifold::kernel::Stat_report & r)
+{
+    r.add(num_requests);
+    r.add(latencies);
+}
+
 void Bank_stat_engine::clear_stats()
 {
     num_requests.clear();
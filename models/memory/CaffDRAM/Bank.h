@@ -10,12 +10,11 @@
 
 #include "Dsettings.h"
 #include "Dreq.h"
+#include "Dstats.h"
 #include "kernel/stat_engine.h"
 #include "kernel/stat.h"
 
 #include <iostream>
-#include <list>
-#include <utility>
 #include <stdint.h>
 
 /*
@@ -39,6 +38,7 @@ public:
         Bank_stat_engine* get_stats() { return stats; }
 
         void print_stats(ostream& out);
+        void register_stats(const std::string& name);
 
 #ifdef CAFFDRAM_TEST
 public:
@@ -60,15 +60,13 @@ private:
 	friend class Bank_stat_engine;
 	Bank_stat_engine *stats;
 
-        //stats on number of cycles the bank is busy; here a pair (x, y) is used: meaning between cycles 0 and y
-	//there are x cycles the bank is busy.
-	//The reason for using a list is as follows: CaffDRAM doesn't register with a clock, so there is not a
-	//function that is called every cycle. The simulation end time E is likely different from the last pair's
-	//y value. To find out the num of busy cycles between 0 and E, we simply find the first pair whose y value
-	// is greater than or equal to E. Another case is that the y value of the last pair is < E.
-	//The size of the list could be big, so we limit the size to 100. Therefore, if the y value of the very
-	//first pair is greater than E, the computed number of busy cycles is only an approximate.
-	std::list<std::pair<uint64_t, uint64_t> > stats_busy_cycles;
+        //stats on number of cycles the bank is busy.
+	//CaffDRAM doesn't register with a clock, so there is not a function that is called every cycle, and
+	//the bank may already be booked beyond the simulation end time E. The tracker keeps a running total
+	//plus the most recent busy intervals, so the busy cycles up to E can be computed in constant memory.
+	//If more requests than the history holds are queued beyond E, the number is only an approximate.
+	Busy_tracker stats_busy_cycles;
+	Windowed_series stats_busy_series; //busy cycles over time
 
 	#if 0
 	struct req_info {
@@ -96,6 +94,7 @@ class Bank_stat_engine : public manifold::kernel::Stat_engine
         void global_stat_merge(Stat_engine * e);
         void clear_stats();
         void print_stats (ostream & out);
+        void report_stats (manifold::kernel::Stat_report & r);
 
         void start_warmup ();
         void end_warmup ();	
@@ -7,6 +7,8 @@
 
 #include "Channel.h"
 
+#include <sstream>
+
 using namespace std;
 
 
@@ -60,6 +62,16 @@ void Channel::print_stats (ostream & out)
 }
 
 
+void Channel::register_stats (const std::string& prefix)
+{
+    for (int i = 0; i < dramSetting->numRanks; i++) {
+	ostringstream name;
+	name << prefix << ".rank" << i;
+	myRank[i]->register_stats(name.str());
+    }
+}
+
+
 
 
 } //namespace caffdram
@@ -30,6 +30,7 @@ public:
 
 
         void print_stats(ostream& out);
+        void register_stats(const std::string& prefix);
 
 #ifdef CAFFDRAM_TEST
 public:
@@ -0,0 +1,88 @@
+/*
+ * ChannelController.cpp
+ *
+ */
+
+#include "ChannelController.h"
+#include "Dreq.h"
+#include "kernel/component.h"
+#include "kernel/manifold.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace manifold::kernel;
+
+
+namespace manifold {
+namespace caffdram {
+
+
+ChannelController::ChannelController(int nid, int ch, const Dsettings& s, Ticks_t link_latency) :
+    m_link_latency(link_latency)
+{
+    assert(link_latency > 0);
+
+    m_nid = nid;
+    m_ch = ch;
+
+    this->dramSetting = new Dsettings (s);
+    this->dramSetting->update();
+    assert(ch >= 0 && ch < this->dramSetting->numChannels);
+
+    this->myChannel = new Channel (this->dramSetting);
+
+    ostringstream name;
+    name << "caffdram" << nid << ".ch" << ch;
+    this->myChannel->register_stats(name.str());
+
+    //stats
+    stats_requests = 0;
+    stats_late_responses = 0;
+}
+
+ChannelController::~ChannelController()
+{
+    delete this->myChannel;
+    delete this->dramSetting;
+}
+
+
+//! Event handler for requests forwarded by the front end. The response is
+//! sent back so that it arrives at the front end when the request completes,
+//! i.e., the same time it would have completed had the channel been serviced
+//! by the front end itself.
+void ChannelController :: handle_request(int, ChannelReq* creq)
+{
+    stats_requests++;
+
+    Dreq* dRequest = new Dreq (creq->local_addr, creq->arrival, this->dramSetting);
+    assert(dRequest->get_chId() == (unsigned)m_ch);
+    Ticks_t done = this->myChannel->processRequest(dRequest);
+    delete dRequest;
+
+    //SendTick() uses the given delay in place of the link latency, but it must
+    //not be smaller than the link latency, which is the lookahead across LPs.
+    Ticks_t now = Manifold::NowTicks();
+    Ticks_t delay = m_link_latency;
+    if(done >= now + m_link_latency)
+        delay = done - now;
+    else
+        stats_late_responses++;
+
+    SendTick(PORT0, creq, delay);
+}
+
+
+void ChannelController :: print_stats(ostream& out)
+{
+    out << "CaffDRAM " << m_nid << " channel " << m_ch << ":" << endl;
+    out << "  requests= " << stats_requests << endl;
+    out << "  late responses= " << stats_late_responses << endl;
+    myChannel->print_stats(out);
+}
+
+
+
+} //namespace caffdram
+} //namespace manifold
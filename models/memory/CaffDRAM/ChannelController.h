@@ -0,0 +1,72 @@
+/*
+ * ChannelController.h
+ *
+ * A channel of a CaffDRAM controller as a component of its own. The front end
+ * (Controller) interleaves requests across its channels and forwards each one
+ * over a link, so channels can be placed on LPs other than the front end's.
+ */
+
+#ifndef MANIFOLD_CAFFDRAM_CHANNELCONTROLLER_H_
+#define MANIFOLD_CAFFDRAM_CHANNELCONTROLLER_H_
+
+#include "Channel.h"
+#include "Dsettings.h"
+
+#include "kernel/component-decl.h"
+#include "kernel/manifold-decl.h"
+#include "uarch/networkPacket.h"
+
+#include <iostream>
+#include <stdint.h>
+
+namespace manifold {
+namespace caffdram {
+
+
+//! Request forwarded between the front end and a channel. The network packet is
+//! carried by value so the message can be serialized across LPs.
+struct ChannelReq {
+    uint64_t local_addr; //address as seen by the controller
+    manifold::kernel::Ticks_t arrival; //when the request arrived at the front end
+    bool read;
+    uarch::NetworkPacket pkt;
+};
+
+
+class ChannelController : public manifold::kernel::Component {
+public:
+	enum {PORT0=0}; //to/from the front end
+
+	//! @arg \c link_latency  Latency of the links to and from the front end.
+	ChannelController(int nid, int ch, const Dsettings&, manifold::kernel::Ticks_t link_latency);
+	~ChannelController();
+
+	int get_nid() { return m_nid; }
+	int get_channel() { return m_ch; }
+
+	void handle_request(int, ChannelReq*);
+
+	void print_stats(std::ostream&);
+
+#ifdef CAFFDRAM_TEST
+public:
+#else
+private:
+#endif
+	int m_nid; //node id of the front end
+	int m_ch; //channel index
+	Dsettings* dramSetting;
+	Channel* myChannel;
+	const manifold::kernel::Ticks_t m_link_latency;
+
+	//stats
+	unsigned stats_requests;
+	unsigned stats_late_responses; //responses that could not be sent early enough to hide the link latency
+};
+
+
+
+} //namespace caffdram
+} //namespace manifold
+
+#endif // MANIFOLD_CAFFDRAM_CHANNELCONTROLLER_H_
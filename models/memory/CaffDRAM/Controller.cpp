@@ -10,6 +10,7 @@
 #include "kernel/manifold.h"
 
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 using namespace manifold::kernel;
@@ -25,7 +26,8 @@ bool Controller :: Msg_type_set = false;
 
 
 Controller::Controller(int nid, const Dsettings& s, int credits, bool resp) :
-    m_send_st_response(resp), m_DOWNSTREAM_FULL_CREDITS(credits)
+    m_send_st_response(resp), m_DOWNSTREAM_FULL_CREDITS(credits),
+    stats_latency("Request latency", "", 50, 20, 0)
 {
         assert(Msg_type_set);
         assert(MEM_MSG_TYPE != CREDIT_MSG_TYPE);
@@ -37,11 +39,16 @@ Controller::Controller(int nid, const Dsettings& s, int credits, bool resp) :
     this->dramSetting->update(); //call update in case fileds of s were changed after construction.
 
     this->mc_map = NULL;
+    m_ch_link_latency = 0;
 
     this->myChannel = new Channel*[this->dramSetting->numChannels];
     for (int i = 0; i < this->dramSetting->numChannels; i++)
     {
         this->myChannel[i] = new Channel (this->dramSetting);
+
+        ostringstream name;
+        name << "caffdram" << nid << ".ch" << i;
+        this->myChannel[i]->register_stats(name.str());
     }
 
     //stats
@@ -51,6 +58,8 @@ Controller::Controller(int nid, const Dsettings& s, int credits, bool resp) :
     stats_last_requests_count_change_tick = 0;
     stats_requests_count_integration = 0;
     stats_non_zero_requests_ticks = 0;
+
+    m_req_log = 0;
 }
 
 Controller::~Controller() {
@@ -62,6 +71,7 @@ Controller::~Controller() {
     }
     delete [] this->myChannel;
     delete this->dramSetting;
+    delete m_req_log;
 }
 
 unsigned long int Controller::processRequest(unsigned long int reqAddr, unsigned long int currentTime)
@@ -76,6 +86,41 @@ cout << "ch-rank-bank = " << dRequest->get_chId() << "-" << dRequest->get_rankId
 }
 
 
+void Controller :: dispatch(NetworkPacket* pkt, uint64_t addr, bool read)
+{
+    Ticks_t now = manifold::kernel::Manifold::NowTicks();
+
+    if(m_ch_link_latency == 0) {
+	Ticks_t latency = processRequest(addr, now); //????????????? using default clock here.
+	stats_latency.collect(latency - now);
+	//The return value of processRequest() is the actual (or absolute) time of when the request
+	//is completed, but Schedule requires time relative to now. So we must pass to Schedule
+	//the return value - now.
+	manifold::kernel::Manifold::Schedule(latency - now, &Controller::request_complete, this, pkt, read);
+    }
+    else {
+	ChannelReq* creq = new ChannelReq;
+	creq->local_addr = addr;
+	creq->arrival = now;
+	creq->read = read;
+	creq->pkt = *pkt;
+	delete pkt;
+	Send(PORT_CH0 + mc_map->get_channel(addr), creq);
+    }
+}
+
+
+//! Event handler for requests completed by a ChannelController.
+void Controller :: handle_channel_response(int, ChannelReq* creq)
+{
+    stats_latency.collect(manifold::kernel::Manifold::NowTicks() - creq->arrival);
+    NetworkPacket* pkt = new NetworkPacket(creq->pkt);
+    bool read = creq->read;
+    delete creq;
+    request_complete(pkt, read);
+}
+
+
 /*
 //! Event handler for memory requests.
 void Controller :: handle_request(int, mem_req* req)
@@ -190,7 +235,8 @@ void Controller :: print_config(ostream& out)
 {
     out << "***** CaffDRAM " << m_nid << " config *****" << endl;
     out << "  send store response: " << (m_send_st_response ? "yes" : "no") << endl;
-    out << "  num of channels = " << dramSetting->numChannels << endl
+    out << "  num of channels = " << dramSetting->numChannels
+        << (m_ch_link_latency > 0 ? " (channel components)" : "") << endl
         << "  num of ranks = " << dramSetting->numRanks << endl
         << "  num of banks = " << dramSetting->numBanks << endl
         << "  num of rows = " << dramSetting->numRows << endl
@@ -230,10 +276,12 @@ void Controller :: print_stats(ostream& out)
         out << "    " << (*it).first << ": " << (*it).second << endl;
     }
 
-    for(multimap<Ticks_t, Req_info>::iterator it = m_req_info.begin(); it != m_req_info.end(); ++it) {
-        Req_info& req = (*it).second;
-        out << "MC received: " << (*it).first << " " << ((req.type == 0) ? "LD" : "ST")
-        << " N_" << req.org_id << "(" << req.src_id << ") " << hex << "0x" << req.addr << dec << endl;
+    stats_ld_series.print(out, "LD received", manifold::kernel::Manifold::NowTicks());
+    stats_st_series.print(out, "ST received", manifold::kernel::Manifold::NowTicks());
+    stats_latency.print(out);
+    if(m_req_log) {
+        m_req_log->flush();
+        out << "Request log: " << m_req_log->get_fname() << " (" << m_req_log->get_count() << " records)" << endl;
     }
     out << "Avg requests: " << (double)stats_requests_count_integration / manifold::kernel::Manifold::NowTicks() << endl;
     out << "Avg requests(excluding 0-requests periods): " << (double)stats_requests_count_integration / stats_non_zero_requests_ticks << endl; //average requests calculated over the periods when there was 1 or more request
@@ -244,6 +292,8 @@ void Controller :: print_stats(ostream& out)
     }
     out << "Idle cycles: " << (manifold::kernel::Manifold::NowTicks() - stats_non_zero_requests_ticks) - non_idle_cycles_at_end << endl;
 
+    if(m_ch_link_latency > 0) //channel stats are printed by the ChannelControllers
+        return;
     for (int i = 0; i < this->dramSetting->numChannels; i++) {
     out << "Channel " << i << ":" << endl;
     myChannel[i]->print_stats(out);
@@ -320,6 +370,30 @@ void Controller :: set_mc_map(CaffDramMcMap *m)
     this->mc_map = m;
 }
 
+void Controller :: set_channel_components(Ticks_t link_latency)
+{
+    assert(link_latency > 0);
+    m_ch_link_latency = link_latency;
+}
+
+void Controller :: set_req_log(const char* fname)
+{
+    delete m_req_log;
+    m_req_log = new Req_log(fname);
+}
+
+void Controller :: record_request(int type, int src_id, uint64_t addr)
+{
+    Ticks_t now = manifold::kernel::Manifold::NowTicks();
+    if(type == 0)
+        stats_ld_series.add(now);
+    else
+        stats_st_series.add(now);
+
+    if(m_req_log)
+        m_req_log->record(now, addr, src_id, type);
+}
+
 
 } //namespace caffdram
 } //namespace manifold
@@ -9,13 +9,16 @@
 #define MANIFOLD_CAFFDRAM_CONTROLLER_H_
 
 #include "Channel.h"
+#include "ChannelController.h"
 #include "Dsettings.h"
 #include "Dreq.h"
+#include "Dstats.h"
 
 #include "McMap.h"
 
 #include "kernel/component-decl.h"
 #include "kernel/manifold-decl.h"
+#include "kernel/stat.h"
 #include "uarch/networkPacket.h"
 
 #include <map>
@@ -27,7 +30,7 @@ namespace caffdram {
 
 class Controller : public manifold::kernel::Component {
 public:
-	enum {PORT0=0};
+	enum {PORT0=0, PORT_CH0}; //channel i, if serviced by a ChannelController, is connected to PORT_CH0 + i
 
 	//! @arg \c st_resp whether responses are sent for stores
 	Controller(int nid, const Dsettings&, int out_credits, bool st_resp=false);
@@ -37,6 +40,17 @@ public:
 
     void set_mc_map (CaffDramMcMap *m);
 
+    //! Write a binary record (Req_record) of every request to the given file.
+    void set_req_log (const char* fname);
+
+    //! Service the channels in ChannelController components instead of in
+    //! this component. Channel i must be connected to port PORT_CH0 + i with
+    //! links of the given latency in both directions.
+    void set_channel_components(manifold::kernel::Ticks_t link_latency);
+    bool has_channel_components() const { return m_ch_link_latency > 0; }
+
+    void handle_channel_response(int, ChannelReq*);
+
 	template<typename T>
 	void handle_request(int, uarch::NetworkPacket* pkt);
 
@@ -58,6 +72,9 @@ private:
 #endif
 	unsigned long int processRequest (unsigned long int reqAddr, unsigned long int currentTime);
 
+	//Start servicing a request, either here or in its ChannelController.
+	void dispatch(uarch::NetworkPacket* pkt, uint64_t addr, bool read);
+
 	//Called when a request is complete.
 	void request_complete(uarch::NetworkPacket*, bool read);
 	void credit_received(uarch::NetworkPacket*);
@@ -67,6 +84,7 @@ private:
 	const bool m_send_st_response; //send response for stores
 	Dsettings* dramSetting;
 	Channel** myChannel;
+	manifold::kernel::Ticks_t m_ch_link_latency; //0 if channels are serviced by this component
 
     static int MEM_MSG_TYPE;
     static int CREDIT_MSG_TYPE;
@@ -79,17 +97,14 @@ private:
     CaffDramMcMap *mc_map;
 
 	//for stats
-	struct Req_info {
-	    Req_info(int t, int oid, int sid, uint64_t a) : type(t), org_id(oid), src_id(sid), addr(a) {}
-	    int type; //ld or st: 0 for load, 1 for store
-	    int org_id; //originator id
-	    int src_id; //source id; could be different from originator id, e.g., when it's from an LLS cache
-	    uint64_t addr;
-	};
+	void record_request(int type, int src_id, uint64_t addr);
 
 	std::map<int, int> m_ld_misses; //number of ld misses per source
 	std::map<int, int> m_stores;
-	std::multimap<manifold::kernel::Ticks_t, Req_info> m_req_info; //request info in time order
+	Windowed_series stats_ld_series; //loads received over time
+	Windowed_series stats_st_series; //stores received over time
+	manifold::kernel::Persistent_histogram_stat<manifold::kernel::counter_t> stats_latency;
+	Req_log* m_req_log; //optional per-request log; 0 if disabled
 
 	//for calculating average accepted requests
 	unsigned stats_requests_count; //number of accepted requests currently
@@ -138,10 +153,6 @@ cerr << "@ " << dec << manifold::kernel::Manifold::NowTicks() << " mc [" << m_ni
 #endif
 	//stats
 	m_ld_misses[pkt->get_src()]++;
-	/*
-	m_req_info.insert(pair<Ticks_t, Req_info>(Manifold::NowTicks(),
-	                                          Req_info(OpMemLd, req->u.mem.originator_id, req->u.mem.source_id, req->u.mem.addr)));
-						  */
 
 	//req->u.mem.msg = LD_RESPONSE;
 
@@ -154,17 +165,15 @@ cerr << "@ " << dec << manifold::kernel::Manifold::NowTicks() << " mc [" << m_ni
     req->set_src_port(0);
 
     assert(mc_map);
-    manifold::kernel::Ticks_t latency = processRequest(mc_map->get_local_addr(req->get_addr()), manifold::kernel::Manifold::NowTicks()); //????????????? using default clock here.
-	//The return value of processRequest() is the actual (or absolute) time of when the request
-	//is completed, but Schedule requires time relative to now. So we must pass to Schedule
-	//the return value - now.
+	record_request(0, pkt->get_src(), req->get_addr());
+	uint64_t local_addr = mc_map->get_local_addr(req->get_addr());
 
 	//reuse the network packet object.
 	pkt->set_dst(pkt->get_src());
 	pkt->set_dst_port(pkt->get_src_port());
 	pkt->set_src(m_nid);
 	pkt->set_src_port(0);
-	manifold::kernel::Manifold::Schedule(latency - manifold::kernel::Manifold::NowTicks(), &Controller::request_complete, this, pkt, true);
+	dispatch(pkt, local_addr, true);
     }
     else { //write request
 #ifdef DBG_CAFFDRAM
@@ -172,11 +181,8 @@ cerr << "@ " << dec << manifold::kernel::Manifold::NowTicks() << " mc [" << m_ni
 #endif
 	//stats
 	m_stores[req->get_src()]++;
-	/*
-	m_req_info.insert(pair<Ticks_t, Req_info>(Manifold::NowTicks(),
-	                                          Req_info(OpMemSt, req->u.mem.originator_id, req->u.mem.source_id, req->u.mem.addr)));
-						  */
-	manifold::kernel::Ticks_t latency = processRequest(req->get_addr(), manifold::kernel::Manifold::NowTicks()); //????????????? using default clock here.
+	record_request(1, pkt->get_src(), req->get_addr());
+	uint64_t addr = req->get_addr();
         if(m_send_st_response) {
 	    req->set_dst(pkt->get_src());
 	    req->set_dst_port(pkt->get_src_port());
@@ -188,7 +194,7 @@ cerr << "@ " << dec << manifold::kernel::Manifold::NowTicks() << " mc [" << m_ni
 	    pkt->set_src(m_nid);
 	    pkt->set_src_port(0);
 	}
-	manifold::kernel::Manifold::Schedule(latency - manifold::kernel::Manifold::NowTicks(), &Controller::request_complete, this, pkt, false);
+	dispatch(pkt, addr, false);
     }
 }
 
@@ -3,6 +3,7 @@
 #include "kernel/manifold.h"
 
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 using namespace manifold::kernel;
@@ -24,6 +25,10 @@ ControllerSimple::ControllerSimple(int nid, const Dsettings& s, bool resp) :
 	for (int i = 0; i < this->dramSetting->numChannels; i++)
 	{
 		this->myChannel[i] = new Channel (this->dramSetting);
+
+		ostringstream name;
+		name << "caffdram" << nid << ".ch" << i;
+		this->myChannel[i]->register_stats(name.str());
 	}
 
 	//stats
@@ -0,0 +1,181 @@
+/*
+ * Dstats.cpp
+ *
+ */
+
+#include "Dstats.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+using namespace std;
+
+namespace manifold {
+namespace caffdram {
+
+
+//####################################################################
+// Windowed_series
+//####################################################################
+
+Windowed_series::Windowed_series(unsigned num_windows, uint64_t window) :
+    m_bins(num_windows, 0), m_window(window), m_total(0)
+{
+    assert(num_windows > 1 && num_windows % 2 == 0);
+    assert(window > 0);
+}
+
+
+void Windowed_series::coarsen()
+{
+    const unsigned half = m_bins.size() / 2;
+    for (unsigned i = 0; i < half; i++)
+        m_bins[i] = m_bins[2*i] + m_bins[2*i + 1];
+    for (unsigned i = half; i < m_bins.size(); i++)
+        m_bins[i] = 0;
+    m_window *= 2;
+}
+
+
+void Windowed_series::add(uint64_t tick, uint64_t value)
+{
+    while (tick / m_window >= m_bins.size())
+        coarsen();
+    m_bins[tick / m_window] += value;
+    m_total += value;
+}
+
+
+void Windowed_series::add_span(uint64_t start, uint64_t end)
+{
+    if (end <= start)
+        return;
+    while ((end - 1) / m_window >= m_bins.size())
+        coarsen();
+
+    while (start < end) {
+        uint64_t idx = start / m_window;
+        uint64_t win_end = (idx + 1) * m_window;
+        uint64_t stop = (end < win_end) ? end : win_end;
+        m_bins[idx] += stop - start;
+        m_total += stop - start;
+        start = stop;
+    }
+}
+
+
+void Windowed_series::print(ostream& out, const char* name, uint64_t end_tick) const
+{
+    uint64_t last = end_tick / m_window;
+    if (last >= m_bins.size())
+        last = m_bins.size() - 1;
+
+    out << name << " (window= " << m_window << " ticks): ";
+    for (uint64_t i = 0; i <= last; i++) {
+        out << m_bins[i];
+        if (i != last)
+            out << ",";
+    }
+    out << endl;
+}
+
+
+
+//####################################################################
+// Busy_tracker
+//####################################################################
+
+Busy_tracker::Busy_tracker(unsigned history) :
+    m_recent(history), m_head(0), m_count(0), m_total(0)
+{
+    assert(history > 0);
+}
+
+
+void Busy_tracker::add(uint64_t start, uint64_t end)
+{
+    assert(start <= end);
+    m_total += end - start;
+
+    if (m_count < m_recent.size()) {
+        m_recent[(m_head + m_count) % m_recent.size()] = make_pair(start, end);
+        m_count++;
+    }
+    else { //overwrite the oldest
+        m_recent[m_head] = make_pair(start, end);
+        m_head = (m_head + 1) % m_recent.size();
+    }
+}
+
+
+uint64_t Busy_tracker::busy_until(uint64_t end_tick, bool& exact) const
+{
+    uint64_t after = 0; //busy cycles at or after end_tick
+    for (unsigned i = 0; i < m_count; i++) {
+        const pair<uint64_t, uint64_t>& iv = m_recent[(m_head + i) % m_recent.size()];
+        if (iv.second > end_tick)
+            after += iv.second - ((iv.first > end_tick) ? iv.first : end_tick);
+    }
+
+    //Intervals are in time order; if even the oldest one we still have ends after
+    //end_tick, older intervals that were dropped may have as well.
+    exact = !(m_count == m_recent.size() && m_recent[m_head].second > end_tick);
+    return m_total - after;
+}
+
+
+
+//####################################################################
+// Req_log
+//####################################################################
+
+Req_log::Req_log(const char* fname, unsigned buf_records) :
+    m_fname(fname), m_buf(buf_records), m_buf_count(0), m_count(0)
+{
+    assert(buf_records > 0);
+    m_file = fopen(fname, "wb");
+    if (m_file == 0) {
+        cerr << "CaffDRAM: cannot open request log " << fname << endl;
+        exit(1);
+    }
+}
+
+
+Req_log::~Req_log()
+{
+    flush();
+    fclose(m_file);
+}
+
+
+void Req_log::record(uint64_t tick, uint64_t addr, int src_id, int type)
+{
+    Req_record& r = m_buf[m_buf_count++];
+    r.tick = tick;
+    r.addr = addr;
+    r.src_id = src_id;
+    r.type = type;
+    m_count++;
+
+    if (m_buf_count == m_buf.size())
+        flush();
+}
+
+
+void Req_log::flush()
+{
+    if (m_buf_count > 0) {
+        size_t n = fwrite(&m_buf[0], sizeof(Req_record), m_buf_count, m_file);
+        if (n != m_buf_count) {
+            cerr << "CaffDRAM: error writing request log " << m_fname << endl;
+            exit(1);
+        }
+        m_buf_count = 0;
+    }
+    fflush(m_file);
+}
+
+
+
+} //namespace caffdram
+} //namespace manifold
@@ -0,0 +1,118 @@
+/*
+ * Dstats.h
+ *
+ * Fixed-size statistics used by the CaffDRAM controller and banks. Memory use
+ * does not depend on the number of requests or the length of the simulation.
+ */
+
+#ifndef MANIFOLD_CAFFDRAM_DSTATS_H_
+#define MANIFOLD_CAFFDRAM_DSTATS_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdio.h>
+#include <stdint.h>
+
+namespace manifold {
+namespace caffdram {
+
+
+//! Time series with a fixed number of windows. When a sample falls beyond the
+//! last window, adjacent windows are merged and the window width doubles, so the
+//! whole run is always covered.
+class Windowed_series {
+public:
+    Windowed_series(unsigned num_windows = 256, uint64_t window = 1024);
+
+    //! Add value to the window containing tick.
+    void add(uint64_t tick, uint64_t value = 1);
+
+    //! Add 1 for every tick in [start, end).
+    void add_span(uint64_t start, uint64_t end);
+
+    uint64_t get_window() const { return m_window; }
+    uint64_t get_total() const { return m_total; }
+
+    //! Print the windows up to (and including) the one containing end_tick.
+    void print(std::ostream& out, const char* name, uint64_t end_tick) const;
+
+#ifdef CAFFDRAM_TEST
+public:
+#else
+private:
+#endif
+    void coarsen();
+
+    std::vector<uint64_t> m_bins;
+    uint64_t m_window; //width of a window in ticks
+    uint64_t m_total;
+};
+
+
+
+//! Busy cycles of a resource whose busy intervals are reported in time order.
+//! The total is kept as a running sum; only the most recent intervals are kept
+//! so the busy cycles up to a given tick can be computed even when some
+//! intervals extend beyond it.
+class Busy_tracker {
+public:
+    Busy_tracker(unsigned history = 128);
+
+    //! Record that the resource is busy in [start, end).
+    void add(uint64_t start, uint64_t end);
+
+    //! Busy cycles in [0, end_tick). exact is set to false if intervals extending
+    //! beyond end_tick may have been dropped from the history.
+    uint64_t busy_until(uint64_t end_tick, bool& exact) const;
+
+#ifdef CAFFDRAM_TEST
+public:
+#else
+private:
+#endif
+    std::vector<std::pair<uint64_t, uint64_t> > m_recent; //ring of recent intervals
+    unsigned m_head; //index of the oldest interval
+    unsigned m_count;
+    uint64_t m_total;
+};
+
+
+
+//! Record of a request written by Req_log.
+struct Req_record {
+    uint64_t tick;
+    uint64_t addr;
+    int32_t src_id;
+    int32_t type; //0 for load, 1 for store
+};
+
+
+//! Binary request log. Records are buffered and written out when the buffer is
+//! full, so only the buffer is held in memory.
+class Req_log {
+public:
+    Req_log(const char* fname, unsigned buf_records = 4096);
+    ~Req_log();
+
+    void record(uint64_t tick, uint64_t addr, int src_id, int type);
+    void flush();
+
+    const char* get_fname() const { return m_fname.c_str(); }
+    uint64_t get_count() const { return m_count; }
+
+private:
+    std::string m_fname;
+    FILE* m_file;
+    std::vector<Req_record> m_buf;
+    unsigned m_buf_count;
+    uint64_t m_count; //total records
+};
+
+
+
+} //namespace caffdram
+} //namespace manifold
+
+#endif // MANIFOLD_CAFFDRAM_DSTATS_H_
@@ -13,6 +13,8 @@ CaffDramMcMap :: CaffDramMcMap(std::vector<int>& nodeIds, const Dsettings& sett)
     assert(nodeIds.size() > 0);
 
     mc_selector_bits = 0;
+    m_num_channels = sett.numChannels;
+    m_ch_shift_bits = sett.channelShiftBits;
 
     if(nodeIds.size() > 1) {
 	//Determine the number of bits required to select the MC nodes.
@@ -55,12 +57,20 @@ uint64_t CaffDramMcMap :: get_local_addr(uint64_t addr)
         return addr;
     } else {
         uint64_t up_addr = addr >> (m_mc_shift_bits + mc_selector_bits);
-        uint64_t lo_addr = addr & m_mc_shift_bits;
+        uint64_t lo_addr = addr & ((uint64_t(1) << m_mc_shift_bits) - 1);
 
         return (up_addr << m_mc_shift_bits) | lo_addr;
     }
 }
 
+//! Same channel selection as Dreq.
+int CaffDramMcMap :: get_channel(uint64_t local_addr)
+{
+    if(m_num_channels == 1)
+        return 0;
+    return (local_addr >> m_ch_shift_bits) % m_num_channels;
+}
+
 
 
 } //namespace caffdram
@@ -17,6 +17,8 @@ public:
     int lookup(uint64_t addr);
 
     uint64_t get_local_addr(uint64_t);
+    //! Return the channel, within its MC, of a local address.
+    int get_channel(uint64_t local_addr);
     uint64_t get_global_addr(uint64_t addr, uint64_t idx) { return addr; }
     int get_page_offset_bits(void) {return 0; }
 
@@ -30,6 +32,8 @@ private:
     int m_mc_shift_bits;
     int mc_selector_bits;
     uint64_t  m_mc_selector_mask;
+    int m_num_channels;
+    int m_ch_shift_bits;
 };
 
 
@@ -7,6 +7,8 @@
 
 #include "Rank.h"
 
+#include <sstream>
+
 using namespace std;
 
 
@@ -61,6 +63,16 @@ void Rank::print_stats (ostream & out)
 }
 
 
+void Rank::register_stats (const std::string& prefix)
+{
+    for (int i = 0; i < dramSetting->numBanks; i++) {
+	ostringstream name;
+	name << prefix << ".bank" << i;
+	myBank[i]->register_stats(name.str());
+    }
+}
+
+
 } //namespace caffdram
 } //namespace manifold
 
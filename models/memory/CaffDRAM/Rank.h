@@ -27,6 +27,7 @@ public:
 	~Rank();
 
         void print_stats(ostream& out);
+        void register_stats(const std::string& prefix);
 
 #ifdef CAFFDRAM_TEST
 public:
@@ -87,6 +87,32 @@ namespace ClockDomain
 		}
 	}
 
+	// Equivalent to n calls to update() except that the callback is not
+	// invoked; returns the number of times it would have been invoked.
+	uint64_t ClockDomainCrosser::advance(uint64_t n)
+	{
+		if (clock1 == clock2)
+		{
+			return n;
+		}
+
+		counter1 += n * clock1;
+
+		uint64_t calls = 0;
+		if (counter2 < counter1)
+		{
+			calls = (counter1 - counter2 + clock2 - 1) / clock2;
+			counter2 += calls * clock2;
+		}
+
+		if (counter1 == counter2)
+		{
+			counter1 = 0;
+			counter2 = 0;
+		}
+		return calls;
+	}
+
 
 
 	void TestObj::cb()
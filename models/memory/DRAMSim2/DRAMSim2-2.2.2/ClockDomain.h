@@ -48,6 +48,7 @@ namespace ClockDomain
 		ClockDomainCrosser(uint64_t _clock1, uint64_t _clock2, ClockUpdateCB *_callback);
 		ClockDomainCrosser(double ratio, ClockUpdateCB *_callback);
 		void update();
+		uint64_t advance(uint64_t n);
 	};
 
 
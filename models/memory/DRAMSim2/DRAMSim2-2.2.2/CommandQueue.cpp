@@ -711,6 +711,24 @@ bool CommandQueue::isEmpty(unsigned rank)
 	}
 }
 
+//true if pop() would neither issue a command nor change any state,
+//	i.e., no queued commands, no pending refresh and no tFAW windows open
+bool CommandQueue::isIdle()
+{
+	if (refreshWaiting)
+	{
+		return false;
+	}
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		if (!isEmpty(i) || tFAWCountdown[i].size() > 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 //tells the command queue that a particular rank is in need of a refresh
 void CommandQueue::needRefresh(unsigned rank)
 {
@@ -70,6 +70,7 @@ public:
 	bool hasRoomFor(unsigned numberToEnqueue, unsigned rank, unsigned bank);
 	bool isIssuable(BusPacket *busPacket);
 	bool isEmpty(unsigned rank);
+	bool isIdle();
 	void needRefresh(unsigned rank);
 	void print();
 	void update(); //SimulatorObject requirement
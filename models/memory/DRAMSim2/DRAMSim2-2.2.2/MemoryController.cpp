@@ -764,6 +764,91 @@ bool MemoryController::WillAcceptTransaction()
 	return transactionQueue.size() < TRANS_QUEUE_DEPTH;
 }
 
+//true if update() would do nothing but accumulate background energy and
+//	count down the refresh timers: no transactions or commands in flight,
+//	no bank changing state and every rank settled in its low-power state
+bool MemoryController::isIdle()
+{
+	if (transactionQueue.size() > 0 || pendingReadTransactions.size() > 0 ||
+	        returnTransaction.size() > 0 || writeDataToSend.size() > 0 ||
+	        outgoingCmdPacket != NULL || outgoingDataPacket != NULL ||
+	        !commandQueue.isIdle())
+	{
+		return false;
+	}
+
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		Rank *rank = (*ranks)[i];
+		if (rank->refreshWaiting || rank->outgoingDataPacket != NULL ||
+		        rank->readReturnCountdown.size() > 0)
+		{
+			return false;
+		}
+
+		//with low power enabled, an idle rank is powered down on the first
+		//	idle cycle, so it is not settled until that has happened
+		if (USE_LOW_POWER && !powerDown[i])
+		{
+			return false;
+		}
+
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			if (bankStates[i][j].stateChangeCountdown > 0 ||
+			        (bankStates[i][j].currentBankState != Idle &&
+			         bankStates[i][j].currentBankState != PowerDown))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//number of cycles that can be skipped with skipIdleCycles() before a
+//	refresh (or the power-up ahead of one) has to be simulated
+uint64_t MemoryController::idleCycles()
+{
+	if (!isIdle())
+	{
+		return 0;
+	}
+
+	uint64_t cycles = (uint64_t)-1;
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		uint64_t deadline = refreshCountdown[i];
+		if (powerDown[i])
+		{
+			deadline = (deadline > tXP) ? deadline - tXP : 0;
+		}
+		cycles = min(cycles, deadline);
+	}
+	return cycles;
+}
+
+//equivalent to calling update() the given number of times while idle;
+//	caller must make sure cycles <= idleCycles()
+void MemoryController::skipIdleCycles(uint64_t cycles)
+{
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		if (powerDown[i])
+		{
+			backgroundEnergy[i] += cycles * IDD2P * NUM_DEVICES;
+		}
+		else
+		{
+			backgroundEnergy[i] += cycles * IDD2N * NUM_DEVICES;
+		}
+		refreshCountdown[i] -= cycles;
+	}
+
+	currentClockCycle += cycles;
+	commandQueue.currentClockCycle += cycles;
+}
+
 //allows outside source to make request of memory system
 bool MemoryController::addTransaction(Transaction *trans)
 {
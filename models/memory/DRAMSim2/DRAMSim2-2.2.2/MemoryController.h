@@ -66,6 +66,9 @@ public:
 	void receiveFromBus(BusPacket *bpacket);
 	void attachRanks(vector<Rank *> *ranks);
 	void update();
+	bool isIdle();
+	uint64_t idleCycles();
+	void skipIdleCycles(uint64_t cycles);
 	void printStats(bool finalStats = false);
 	void resetStats(); 
 
@@ -236,6 +236,32 @@ void MemorySystem::update()
 	//PRINT("\n"); // two new lines
 }
 
+bool MemorySystem::isIdle()
+{
+	return pendingTransactions.size() == 0 && memoryController->isIdle();
+}
+
+//number of update() calls that can be replaced by skipIdleCycles()
+uint64_t MemorySystem::idleCycles()
+{
+	if (pendingTransactions.size() > 0)
+	{
+		return 0;
+	}
+	return memoryController->idleCycles();
+}
+
+void MemorySystem::skipIdleCycles(uint64_t cycles)
+{
+	memoryController->skipIdleCycles(cycles);
+
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		(*ranks)[i]->currentClockCycle += cycles;
+	}
+	this->currentClockCycle += cycles;
+}
+
 void MemorySystem::RegisterCallbacks( Callback_t* readCB, Callback_t* writeCB,
                                       void (*reportPower)(double bgpower, double burstpower,
                                                           double refreshpower, double actprepower))
@@ -58,6 +58,9 @@ public:
 	MemorySystem(unsigned id, unsigned megsOfMemory, CSVWriter &csvOut_, ostream &dramsim_log_);
 	virtual ~MemorySystem();
 	void update();
+	bool isIdle();
+	uint64_t idleCycles();
+	void skipIdleCycles(uint64_t cycles);
 	bool addTransaction(Transaction *trans);
 	bool addTransaction(bool isWrite, uint64_t addr);
 	void printStats(bool finalStats);
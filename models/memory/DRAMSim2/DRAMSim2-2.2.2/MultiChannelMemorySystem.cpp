@@ -397,6 +397,65 @@ void MultiChannelMemorySystem::actual_update()
 
 	currentClockCycle++; 
 }
+/* True if no channel has any work outstanding */
+bool MultiChannelMemorySystem::isIdle()
+{
+	for (size_t i=0; i<NUM_CHANS; i++)
+	{
+		if (!channels[i]->isIdle())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Number of DRAM cycles that can be skipped in bulk: every channel must be
+	idle, and the skip must stop short of the next epoch boundary (where the
+	epoch stats are printed and reset) and of the next refresh.
+	*/
+uint64_t MultiChannelMemorySystem::idleCycles()
+{
+	if (currentClockCycle == 0 || currentClockCycle % EPOCH_LENGTH == 0)
+	{
+		return 0;
+	}
+
+	uint64_t cycles = EPOCH_LENGTH - currentClockCycle % EPOCH_LENGTH;
+	for (size_t i=0; i<NUM_CHANS && cycles > 0; i++)
+	{
+		cycles = min(cycles, channels[i]->idleCycles());
+	}
+	return cycles;
+}
+
+/* Equivalent to calling update() the given number of times, for callers
+	that stop calling update() while they have nothing outstanding. Idle
+	stretches are skipped in bulk; refreshes and epoch boundaries that fall
+	in between are simulated cycle by cycle as usual.
+	*/
+void MultiChannelMemorySystem::fastForward(uint64_t cycles)
+{
+	uint64_t dramCycles = clockDomainCrosser.advance(cycles);
+
+	while (dramCycles > 0)
+	{
+		uint64_t skip = min(idleCycles(), dramCycles);
+		if (skip == 0)
+		{
+			actual_update();
+			dramCycles--;
+			continue;
+		}
+
+		for (size_t i=0; i<NUM_CHANS; i++)
+		{
+			channels[i]->skipIdleCycles(skip);
+		}
+		currentClockCycle += skip;
+		dramCycles -= skip;
+	}
+}
 unsigned MultiChannelMemorySystem::findChannelNumber(uint64_t addr)
 {
 	// Single channel case is a trivial shortcut case 
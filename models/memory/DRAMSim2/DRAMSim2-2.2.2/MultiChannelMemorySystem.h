@@ -51,6 +51,8 @@ class MultiChannelMemorySystem : public SimulatorObject
 			bool willAcceptTransaction(); 
 			bool willAcceptTransaction(uint64_t addr); 
 			void update();
+			bool isIdle();
+			void fastForward(uint64_t cycles);
 			void printStats(bool finalStats=false);
 			ostream &getLogFile();
 			void RegisterCallbacks( 
@@ -68,6 +70,7 @@ class MultiChannelMemorySystem : public SimulatorObject
 	private:
 		unsigned findChannelNumber(uint64_t addr);
 		void actual_update(); 
+		uint64_t idleCycles();
 		vector<MemorySystem*> channels; 
 		unsigned megsOfMemory; 
 		string deviceIniFilename;
@@ -36,13 +36,17 @@ Dram_sim::Dram_sim (int nid, const Dram_sim_settings& dram_settings, Clock& clk)
     mem->RegisterCallbacks(read_cb, write_cb, NULL);
 
     //register with clock
-    Clock :: Register(clk, this, &Dram_sim::tick, (void(Dram_sim::*)(void)) 0 );
+    m_tick_obj = Clock :: Register(clk, this, &Dram_sim::tick, (void(Dram_sim::*)(void)) 0 );
+    m_skip_idle = dram_settings.skip_idle;
+    m_sleeping = false;
+    m_next_update = 0;
 
     //stats
     stats_n_reads = 0;
     stats_n_writes = 0;
     stats_n_reads_sent = 0;
     stats_totalMemLat = 0;
+    stats_skipped_cycles = 0;
 
 #ifdef DRAMSIM_UTEST
     completed_writes = 0;
@@ -53,13 +57,7 @@ Dram_sim::Dram_sim (int nid, const Dram_sim_settings& dram_settings, Clock& clk)
 void Dram_sim::read_complete(unsigned id, uint64_t address, uint64_t done_cycle)
 {
     //cout << "@ " << m_clk->NowTicks() << " (local) " << Manifold::NowTicks() << " (default), read complete\n";
-    map<uint64_t, list<Request> >::iterator it = m_pending_reqs.find(address);
-    assert (it != m_pending_reqs.end());
-
-    Request req = m_pending_reqs[address].front();
-    m_pending_reqs[address].pop_front();
-    if (it->second.size() == 0)
-    m_pending_reqs.erase(it);
+    Request req = m_pending_reqs.remove(address);
 
     assert(req.read);
     assert(req.addr == address);
@@ -70,13 +68,7 @@ void Dram_sim::read_complete(unsigned id, uint64_t address, uint64_t done_cycle)
 
 void Dram_sim::write_complete(unsigned id, uint64_t address, uint64_t done_cycle)
 {
-    map<uint64_t, list<Request> >::iterator it = m_pending_reqs.find(address);
-    assert (it != m_pending_reqs.end());
-
-    Request req = m_pending_reqs[address].front();
-    m_pending_reqs[address].pop_front();
-    if (it->second.size() == 0)
-    m_pending_reqs.erase(it);
+    Request req = m_pending_reqs.remove(address);
 
     assert(req.read == false);
     assert(req.addr == address);
@@ -148,13 +140,45 @@ void Dram_sim::tick()
     cout << "@ " << m_clk->NowTicks() << " MC " << m_nid << ": transaction of address " << hex << req.gaddr << dec << " is pushed to memory" << endl;
 #endif
     //move from input buffer to pending buffer
-        m_pending_reqs[req.addr].push_back(req);
+        m_pending_reqs.insert(req.addr, req);
         send_credit();
     }
 
     mem->update();
     try_send_reply();
+    m_next_update = m_clk->NowTicks() + 1;
+
+    if (m_skip_idle && is_idle()) {
+        //nothing to do until the next request arrives
+        m_tick_obj->Disable();
+        m_sleeping = true;
+    }
+}
+
+
+bool Dram_sim :: is_idle()
+{
+    return m_incoming_reqs.empty() && m_pending_reqs.empty() && m_completed_reqs.empty() &&
+           mem->isIdle();
+}
 
+
+void Dram_sim :: wake_up()
+{
+    //If the rising edge of the current tick has passed, its update() was skipped too;
+    //otherwise tick() is still going to be called for it.
+    Ticks_t now = m_clk->NowTicks();
+    if (m_clk->nextRising == false)
+        now++;
+
+    if (now > m_next_update) {
+        mem->fastForward(now - m_next_update);
+        stats_skipped_cycles += now - m_next_update;
+        m_next_update = now;
+    }
+
+    m_tick_obj->Enable();
+    m_sleeping = false;
 }
 
 void Dram_sim :: set_mc_map(manifold::uarch::DestMap *m)
@@ -164,11 +188,15 @@ void Dram_sim :: set_mc_map(manifold::uarch::DestMap *m)
 
 void Dram_sim :: print_stats(ostream& out)
 {
+    if (m_sleeping)
+        wake_up(); //bring DRAMSim2's own stats up to date
+
     out << "***** DRAMSim2 " << m_nid << " *****" << endl;
     out << "  Total Reads Received= " << stats_n_reads << endl;
     out << "  Total Writes Received= " << stats_n_writes << endl;
     out << "  Total Reads Sent Back= " << stats_n_reads_sent << endl;
     out << "  Avg Memory Latency= " << (double)stats_totalMemLat / stats_n_reads_sent << endl;
+    out << "  Idle Cycles Skipped= " << stats_skipped_cycles << endl;
     out << "  Reads per source:" << endl;
     for(map<int, unsigned>::iterator it=stats_n_reads_per_source.begin(); it != stats_n_reads_per_source.end();
            ++it) {
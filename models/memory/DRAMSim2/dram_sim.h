@@ -10,6 +10,7 @@
 //#include "DRAMSim2-2.2.2/MemorySystem.h"
 #include "DRAMSim2-2.2.2/MultiChannelMemorySystem.h"
 #include "DRAMSim2-2.2.2/Transaction.h"
+#include "pending_table.h"
 #include <list>
 #include <map>
 #include <iostream>
@@ -23,9 +24,9 @@ namespace dramsim {
 
 
 struct Dram_sim_settings {
-    Dram_sim_settings(const char* dev, const char* sys, int sz, bool st_resp, int credits) :
+    Dram_sim_settings(const char* dev, const char* sys, int sz, bool st_resp, int credits, bool skip=true) :
         dev_filename(dev), mem_sys_filename(sys), size(sz), send_st_resp(st_resp),
-    downstream_credits(credits)
+    downstream_credits(credits), skip_idle(skip)
     {}
     const char* dev_filename;           // contains settings of the DRAM device
     const char* mem_sys_filename;       // Contains settings of the whole memory
@@ -33,6 +34,7 @@ struct Dram_sim_settings {
     //unsigned local_map;                   // Type of local address mapping
     bool send_st_resp;                  // whether responses are sent for stores
     int downstream_credits;
+    bool skip_idle;                     // stop ticking DRAMSim2 while there is no request
     //    manifold::uarch::DestMap* mc_map;
 };
 
@@ -71,6 +73,7 @@ public:
 private:
 #endif
     struct Request {
+        Request() : r_cycle(0), addr(0), gaddr(0), read(true), extra(0) {}
         Request(uint64_t c, uint64_t a, uint64_t g, bool r, void* e) : r_cycle(c), addr(a), gaddr(g), read(r), extra(e) {}
         uint64_t r_cycle; //cycle when the request is first received
         uint64_t addr; //local address
@@ -95,8 +98,15 @@ private:
 
     std::list<Request> m_incoming_reqs;         // input buffer
     std::list<Request> m_completed_reqs;  // output buffer
-    std::map<uint64_t, std::list<Request> > m_pending_reqs;    // buffer holding active requests,
-                                                               // i.e., requests being processed
+    Pending_table<Request> m_pending_reqs;    // buffer holding active requests,
+                                              // i.e., requests being processed
+
+    // Idle skipping: when nothing is outstanding the tick handler is disabled and
+    // DRAMSim2 is fast-forwarded over the skipped cycles when the next request arrives.
+    bool m_skip_idle;
+    manifold::kernel::tickObjBase* m_tick_obj;
+    bool m_sleeping;
+    manifold::kernel::Ticks_t m_next_update; // first tick whose update() has not been done
 
     /* create and register our callback functions */
     Callback_t *read_cb;
@@ -110,12 +120,15 @@ private:
     bool limitExceeds();        // check if input has to be stopped because the output is full
     void try_send_reply();     // send reply if there's any and there's credit
     void send_credit();
+    bool is_idle();            // true if the tick handler can be disabled
+    void wake_up();            // catch DRAMSim2 up and re-enable the tick handler
 
     //stat
     unsigned stats_n_reads;
     unsigned stats_n_writes;
     unsigned stats_n_reads_sent;
     uint64_t stats_totalMemLat;
+    uint64_t stats_skipped_cycles;
     std::map<int, unsigned> stats_n_reads_per_source;
     std::map<int, unsigned> stats_n_writes_per_source;
 
@@ -163,6 +176,9 @@ cout << "@ " << m_clk->NowTicks() << " >>> mc " << m_nid << " received ST, src=
     pkt->type = 9;
 
     assert(mc_map);
+    if (m_sleeping)
+        wake_up();
+
     //put the request in the input buffer
     m_incoming_reqs.push_back(Request(m_clk->NowTicks(), mc_map->get_local_addr(req->get_addr()), req->get_addr(), req->is_read(), pkt));
 
@@ -0,0 +1,131 @@
+#ifndef MANIFOLD_DRAMSIM_PENDING_TABLE_H
+#define MANIFOLD_DRAMSIM_PENDING_TABLE_H
+
+#include <vector>
+#include <assert.h>
+#include <stdint.h>
+
+
+namespace manifold {
+namespace dramsim {
+
+
+//! Open-addressed (linear probing) table of in-flight requests keyed by address.
+//! Several requests may share an address; they are returned in the order they
+//! were inserted. Slots are recycled in place, so no allocation is done once
+//! the table has grown to the number of outstanding requests.
+template<typename T>
+class Pending_table {
+public:
+    Pending_table(unsigned initial_size = 64) : m_slots(round_up(initial_size)), m_size(0) {}
+
+    unsigned size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    //! Add a request for address addr.
+    void insert(uint64_t addr, const T& t)
+    {
+        if ((m_size + 1) * 2 > m_slots.size()) //keep load factor at or below 1/2
+            grow();
+        place(addr, t);
+    }
+
+    //! Remove and return the oldest request for address addr, which must exist.
+    T remove(uint64_t addr)
+    {
+        const unsigned mask = m_slots.size() - 1;
+        unsigned i = home(addr);
+        //Entries with the same address sit in insertion order along the probe
+        //sequence, so the first match is the oldest.
+        while (!(m_slots[i].used && m_slots[i].addr == addr)) {
+            assert(m_slots[i].used);
+            i = (i + 1) & mask;
+        }
+        T t = m_slots[i].data;
+        erase_at(i);
+        return t;
+    }
+
+private:
+    struct Slot {
+        Slot() : used(false), addr(0) {}
+        bool used;
+        uint64_t addr;
+        T data;
+    };
+
+    static unsigned round_up(unsigned n)
+    {
+        unsigned sz = 2;
+        while (sz < n)
+            sz <<= 1;
+        return sz;
+    }
+
+    unsigned home(uint64_t addr) const
+    {
+        //fibonacci hashing; low address bits are mostly the same (line offset)
+        return (unsigned)((addr * 0x9E3779B97F4A7C15ULL) >> 32) & (m_slots.size() - 1);
+    }
+
+    void place(uint64_t addr, const T& t)
+    {
+        const unsigned mask = m_slots.size() - 1;
+        unsigned i = home(addr);
+        while (m_slots[i].used)
+            i = (i + 1) & mask;
+        m_slots[i].used = true;
+        m_slots[i].addr = addr;
+        m_slots[i].data = t;
+        m_size++;
+    }
+
+    //! Backward-shift deletion: no tombstones, and entries keep their relative
+    //! order along each probe sequence.
+    void erase_at(unsigned hole)
+    {
+        const unsigned mask = m_slots.size() - 1;
+        unsigned j = hole;
+        while (true) {
+            j = (j + 1) & mask;
+            if (!m_slots[j].used)
+                break;
+            unsigned h = home(m_slots[j].addr);
+            //move j into the hole unless its home lies cyclically in (hole, j]
+            bool stays = (hole <= j) ? (hole < h && h <= j) : (hole < h || h <= j);
+            if (!stays) {
+                m_slots[hole] = m_slots[j];
+                hole = j;
+            }
+        }
+        m_slots[hole].used = false;
+        m_size--;
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(m_slots.size() * 2);
+        old.swap(m_slots);
+        m_size = 0;
+        //Walk each cluster from its start so same-address entries are
+        //re-inserted in their original order.
+        const unsigned mask = old.size() - 1;
+        unsigned start = 0;
+        while (start < old.size() && old[start].used)
+            start++;
+        for (unsigned k = 1; k <= old.size(); k++) {
+            unsigned i = (start + k) & mask;
+            if (old[i].used)
+                place(old[i].addr, old[i].data);
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    unsigned m_size;
+};
+
+
+} // namespace dramsim
+} // namespace manifold
+
+#endif
@@ -1,6 +1,9 @@
 #include	"simpleRouter.h"
 
 #include "kernel/component.h"
+#include "kernel/stat_sampler.h"
+
+#include <sstream>
 
 using namespace std;
 using namespace manifold::kernel;
@@ -88,6 +91,13 @@ SimpleRouter::SimpleRouter(uint id, router_init_params* i_p) : in_buffers(i_p->n
     avg_router_latency = 0;
     stat_last_flit_out_cycle= 0;
 
+    std::ostringstream name;
+    name << "router" << id << ".";
+    Stat_sampler :: Add(name.str() + "packets_in", &stat_packets_in);
+    Stat_sampler :: Add(name.str() + "packets_out", &stat_packets_out);
+    Stat_sampler :: Add(name.str() + "flits_in", &stat_flits_in);
+    Stat_sampler :: Add(name.str() + "flits_out", &stat_flits_out);
+
     ib_cycles = 0;
     vca_cycles = 0;
     sa_cycles = 0;
@@ -0,0 +1,164 @@
+#include	"mem-replay.h"
+#include	"kernel/component.h"
+#include	"kernel/stat_report.h"
+#include	<stdlib.h>
+#include	<assert.h>
+#include	<sstream>
+
+using namespace std;
+
+namespace manifold {
+namespace simple_proc {
+
+//! @param \c mlp    max number of outstanding requests
+//! @param \c width  max number of requests issued per cycle
+MemReplay_Settings :: MemReplay_Settings(int mlp, int width) :
+mlp(mlp), issue_width(width)
+{
+}
+
+
+//! @param \c id  Node ID of the processor.
+//! @param \c fname  File name of the trace file.
+MemReplayProcessor::MemReplayProcessor (int id, string fname, const MemReplay_Settings& settings) :
+	PROCESSOR_ID(id),
+	MLP(settings.mlp),
+	ISSUE_WIDTH(settings.issue_width)
+{
+	assert(MLP > 0 && ISSUE_WIDTH > 0);
+
+	m_trace_file.open(fname.c_str());
+	if(!m_trace_file.is_open()) {
+	    cerr << "Error: Could no open trace file " << fname << endl;
+	    exit(1);
+	}
+	m_refs.reserve(BUF_SIZE);
+	m_next_ref = 0;
+
+	m_outstanding = 0;
+	m_exited = false;
+	m_cur_cycle = 0;
+
+	//stats
+	stats_num_loads = 0;
+	stats_num_stores = 0;
+	stats_completed = 0;
+	stats_total_latency = 0;
+	stats_mlp_full_cycles = 0;
+
+	stats = new MemReplay_stat_engine(this);
+	std::ostringstream stats_name;
+	stats_name << "proc" << id;
+	manifold::kernel::Stat_report::Register(stats_name.str(), stats);
+}
+
+
+MemReplayProcessor::~MemReplayProcessor ()
+{
+	delete stats;
+	if(m_trace_file.is_open())
+	    m_trace_file.close();
+}
+
+
+//! Returns true if m_refs[m_next_ref] is a reference; reads the next
+//! BUF_SIZE references from the file when the buffer has been used up.
+bool MemReplayProcessor::have_ref()
+{
+	if(m_next_ref < m_refs.size())
+	    return true;
+
+	m_refs.clear();
+	m_next_ref = 0;
+	if(!m_trace_file.is_open()) //file closed, meaning no more to read.
+	    return false;
+
+	string line;
+	while(m_refs.size() < BUF_SIZE && getline(m_trace_file, line)) {
+	    const char* s = line.c_str();
+	    char* end;
+	    unsigned long c = strtoul(s, &end, 16);
+	    if(end == s || c > 1)
+		continue; //not a memory reference
+	    Ref ref;
+	    ref.addr = strtoull(end, 0, 16);
+	    ref.read = (c == 0);
+	    m_refs.push_back(ref);
+	}
+
+	if(m_trace_file.eof())
+	    m_trace_file.close();
+
+	return m_refs.size() > 0;
+}
+
+
+//! Called every cycle: issues up to ISSUE_WIDTH references while fewer than
+//! MLP requests are outstanding.
+void MemReplayProcessor::tick ( void )
+{
+	if(m_exited)
+	    return;
+	m_cur_cycle++;
+
+	for(int i=0; i<ISSUE_WIDTH; i++) {
+	    if(!have_ref()) {
+		if(m_outstanding == 0)
+		    m_exited = true;
+		return;
+	    }
+	    if(m_outstanding >= MLP) {
+		stats_mlp_full_cycles++;
+		return;
+	    }
+
+	    const Ref& ref = m_refs[m_next_ref++];
+	    if(ref.read)
+		stats_num_loads++;
+	    else
+		stats_num_stores++;
+	    m_outstanding++;
+	    Send(PORT_CACHE, new MemReplayReq(ref.addr, ref.read, m_cur_cycle));
+	}
+}
+
+
+//! Event handler for cache response.
+void MemReplayProcessor::handle_cache_response (int, MemReplayReq* request )
+{
+	assert(m_outstanding > 0);
+	m_outstanding--;
+	stats_completed++;
+	stats_total_latency += m_cur_cycle - request->get_issue_cycle();
+	delete request;
+}
+
+
+
+void MemReplayProcessor :: print_stats(ostream& out)
+{
+    out << "********** MemReplayProcessor " << PROCESSOR_ID << " stats **********" << endl;
+    out << std::dec << "Total cycles: " << m_cur_cycle << endl;
+    out << "    total issued LOADs: " << stats_num_loads << endl;
+    out << "    total issued STOREs: " << stats_num_stores << endl;
+    out << "    cycles at max MLP: " << stats_mlp_full_cycles << endl;
+    if(stats_completed > 0)
+	out << "    avg latency: " << (double)stats_total_latency / stats_completed << endl;
+}
+
+
+void MemReplay_stat_engine :: report_stats(manifold::kernel::Stat_report& r)
+{
+    r.add("cycles", proc->m_cur_cycle);
+    r.add("commit_insn", proc->stats_completed);
+    r.add("loads", proc->stats_num_loads);
+    r.add("stores", proc->stats_num_stores);
+    r.add("mlp_full_cycles", proc->stats_mlp_full_cycles);
+    r.add("total_latency", proc->stats_total_latency);
+}
+
+
+
+} //namespace simple_proc
+} //namespace manifold
+
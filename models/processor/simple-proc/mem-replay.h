@@ -0,0 +1,129 @@
+#ifndef  MANIFOLD_SIMPLE_PROC_MEM_REPLAY_H
+#define  MANIFOLD_SIMPLE_PROC_MEM_REPLAY_H
+
+#include	"kernel/component-decl.h"
+#include	"kernel/stat_engine.h"
+#include	<stdint.h>
+#include	<fstream>
+#include	<string>
+#include	<vector>
+
+
+namespace manifold {
+namespace simple_proc {
+
+struct MemReplay_Settings {
+    MemReplay_Settings(int mlp=16, int width=1);
+
+    int mlp; //max number of outstanding requests
+    int issue_width; //max number of requests issued per cycle
+};
+
+
+//! Request sent to the cache; the cache sends the same object back.
+class MemReplayReq
+{
+public:
+    MemReplayReq() {} //for deserialization
+    MemReplayReq(uint64_t addr, bool read, uint64_t cycle) : m_addr(addr), m_read(read), m_issue_cycle(cycle) {}
+
+    uint64_t get_addr() { return m_addr; }
+    bool is_read() { return m_read; }
+    uint64_t get_issue_cycle() { return m_issue_cycle; }
+private:
+    uint64_t m_addr;
+    bool m_read; //true for read; false for write
+    uint64_t m_issue_cycle;
+};
+
+
+
+class MemReplayProcessor;
+
+class MemReplay_stat_engine : public manifold::kernel::Stat_engine
+{
+public:
+    MemReplay_stat_engine(MemReplayProcessor* p) : proc(p) {}
+
+    void global_stat_merge(manifold::kernel::Stat_engine*) {}
+    void print_stats(std::ostream&) {}
+    void report_stats(manifold::kernel::Stat_report& r);
+    void clear_stats() {}
+
+    void start_warmup() {}
+    void end_warmup() {}
+    void save_samples() {}
+
+private:
+    MemReplayProcessor* proc;
+};
+
+
+//! @brief Replays a memory-reference trace into the cache, with no core
+//! model: each cycle up to issue_width references are sent, as long as fewer
+//! than mlp requests are outstanding. Loads and stores both count against the
+//! mlp, since the cache replies to both.
+//!
+//! The trace has the format of TraceProcessor: "0 <hex addr>" for a load,
+//! "1 <hex addr>" for a store. Other lines are skipped, so the references of a
+//! core trace are replayed back to back.
+class MemReplayProcessor: public manifold::kernel::Component
+{
+    friend class MemReplay_stat_engine;
+
+    public:
+        enum {PORT_CACHE=0};
+
+        MemReplayProcessor (int id, std::string fname, const MemReplay_Settings&);
+        ~MemReplayProcessor ();
+
+        void tick();    // function registered to clock invoked every cycle
+        void handle_cache_response(int, MemReplayReq* );
+
+        bool is_exited() { return m_exited; }
+        unsigned long get_cur_cycle() { return m_cur_cycle; }
+
+        void print_stats(std::ostream&);
+
+#ifdef SIMPLE_PROC_UTEST
+    public:
+#else
+    private:
+#endif
+        struct Ref {
+            uint64_t addr;
+            bool read;
+        };
+
+        bool have_ref();
+
+        const int PROCESSOR_ID;
+        const int MLP;
+        const int ISSUE_WIDTH;
+
+        std::ifstream m_trace_file;
+        std::vector<Ref> m_refs; //buffer of references read from the trace file
+        unsigned m_next_ref;
+        static const unsigned BUF_SIZE = 4096;
+
+        int m_outstanding;
+        bool m_exited;
+        unsigned long m_cur_cycle;
+
+	//stats
+        uint64_t stats_num_loads;
+        uint64_t stats_num_stores;
+        uint64_t stats_completed;
+        uint64_t stats_total_latency;
+        uint64_t stats_mlp_full_cycles; //cycles with a reference held back by the mlp
+
+        MemReplay_stat_engine* stats;
+};
+
+
+
+} //namespace simple_proc
+} //namespace manifold
+
+
+#endif // MANIFOLD_SIMPLE_PROC_MEM_REPLAY_H
@@ -1,7 +1,9 @@
 #include	"simple-proc.h"
 #include	"kernel/component.h"
+#include	"kernel/stat_report.h"
 #include	<stdlib.h>
 #include	<assert.h>
+#include	<sstream>
 
 #ifdef DBG_SIMPLE_PROC
 #include "kernel/manifold.h"
@@ -47,11 +49,17 @@ SimpleProcessor::SimpleProcessor (int id, const SimpleProc_Settings& settings) :
 	stats_num_loads = 0;
 	stats_num_stores = 0;
 	stats_total_issued_insn = 0;
+
+	stats = new SimpleProc_stat_engine(this);
+	std::ostringstream stats_name;
+	stats_name << "proc" << id;
+	manifold::kernel::Stat_report::Register(stats_name.str(), stats);
 }
 
 
 SimpleProcessor::~SimpleProcessor ()
 {
+	delete stats;
 	list<CacheReq*>::iterator it;
 
 	for ( it = outstanding_requests.begin(); it != outstanding_requests.end() ; ++it ) {
@@ -259,6 +267,16 @@ void SimpleProcessor :: print_stats(ostream& out)
 }
 
 
+void SimpleProc_stat_engine :: report_stats(manifold::kernel::Stat_report& r)
+{
+    r.add("cycles", proc->m_cur_cycle);
+    r.add("commit_insn", proc->stats_total_issued_insn);
+    r.add("stalled_cycles", proc->stats_stalled_cycles);
+    r.add("loads", proc->stats_num_loads);
+    r.add("stores", proc->stats_num_stores);
+}
+
+
 
 
 
@@ -26,6 +26,7 @@
 
 #include	"instruction.h"
 #include	"kernel/component-decl.h"
+#include	"kernel/stat_engine.h"
 #include	<iostream>
 #include	<list>
 
@@ -63,10 +64,33 @@ private:
 
 
 
+class SimpleProcessor;
+
+class SimpleProc_stat_engine : public manifold::kernel::Stat_engine
+{
+public:
+    SimpleProc_stat_engine(SimpleProcessor* p) : proc(p) {}
+
+    void global_stat_merge(manifold::kernel::Stat_engine*) {}
+    void print_stats(std::ostream&) {}
+    void report_stats(manifold::kernel::Stat_report& r);
+    void clear_stats() {}
+
+    void start_warmup() {}
+    void end_warmup() {}
+    void save_samples() {}
+
+private:
+    SimpleProcessor* proc;
+};
+
+
 //! @brief Base class. Subclasses differ in how instructions are fetched.
 //!
 class SimpleProcessor: public manifold::kernel::Component
 {
+    friend class SimpleProc_stat_engine;
+
     public:
         enum {PORT_CACHE=0};
 
@@ -119,6 +143,7 @@ class SimpleProcessor: public manifold::kernel::Component
         uint64_t stats_num_stores;
         uint64_t stats_total_issued_insn;
 
+        SimpleProc_stat_engine* stats;
 };
 
 
@@ -4,11 +4,13 @@
 #include <libconfig.h++>
 #include <sys/time.h>
 #include <sstream>
+#include <stdarg.h>
 
 #include "core.h"
 #include "pipeline.h"
 #include "outorder.h"
 #include "inorder.h"
+#include "kernel/tick_pool.h"
 
 using namespace std;
 using namespace libconfig;
@@ -16,6 +18,33 @@ using namespace manifold;
 using namespace manifold::kernel;
 using namespace manifold::spx;
 
+/* Output of a core stepped in parallel, written by the simulation thread
+   after the batch, so the lines of the cores come out in core order. */
+class spx_deferred_print_t : public DeferredAction
+{
+public:
+    spx_deferred_print_t(FILE *File, const char *Text) : file(File), text(Text) {}
+    void Run() { fputs(text.c_str(), file); }
+
+private:
+    FILE *file;
+    std::string text;
+};
+
+static void spx_printf(FILE *File, const char *Format, ...)
+{
+    char buf[1024];
+    va_list args;
+    va_start(args, Format);
+    vsnprintf(buf, sizeof(buf), Format, args);
+    va_end(args);
+
+    if(DeferredActionVec_t *d = Deferred_actions())
+        d->push_back(new spx_deferred_print_t(File, buf));
+    else
+        fputs(buf, File);
+}
+
 spx_core_t::spx_core_t(const int nodeID, const char *configFileName, const int coreID) :
     node_id(nodeID),
     core_id(coreID),
@@ -106,7 +135,7 @@ void spx_core_t::tick()
 #endif
 
     if (get_qsim_osd_state() == QSIM_OSD_TERMINATED) {
-        fprintf(stdout, "SPX core %d out of insn", core_id);
+        spx_printf(stdout, "SPX core %d out of insn", core_id);
         manifold::kernel::Manifold::Terminate();
     }
 }
@@ -114,7 +143,7 @@ void spx_core_t::tick()
 void spx_core_t::print_stats(uint64_t sampling_period, FILE *LogFile)
 {
     if(clock_cycle&&((clock_cycle%sampling_period) == 0)) {
-        fprintf(LogFile,"clk_cycle= %3.1lfM | core%d | \
+        spx_printf(LogFile,"clk_cycle= %3.1lfM | core%d | \
                          IPC= %lf ( %lu / %lu ), \
                          avgIPC= %lf ( %lu / %lu )\n",
                          (double)clock_cycle/1e6, core_id,
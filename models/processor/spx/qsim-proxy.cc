@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include "qsim-proxy.h"
 #include "core.h"
@@ -8,16 +9,18 @@ using namespace spx;
 using namespace Qsim;
 
 spx_qsim_proxy_t::spx_qsim_proxy_t(pipeline_t *Pipeline) :
-    pipeline(Pipeline)
+    pipeline(Pipeline),
+    pos(0),
+    num_items(0)
 {
-    /* Reserve fixed queue length. */
-    queue.reserve(QSIM_PROXY_QUEUE_SIZE);
-    queue.clear();
 }
 
 spx_qsim_proxy_t::~spx_qsim_proxy_t()
 {
-    queue.clear();
+    for(unsigned i = 0; i < segments.size(); i++) {
+        if(segments[i].copied) { delete [] segments[i].items; }
+    }
+    segments.clear();
 }
 
 void spx_qsim_proxy_t::handle_qsim_response(qsim_proxy_request_t *QsimProxyRequest)
@@ -25,16 +28,15 @@ void spx_qsim_proxy_t::handle_qsim_response(qsim_proxy_request_t *QsimProxyReque
 #ifdef DEBUG_NEW_QSIM_1
     std::cerr << "******************" << std::endl << std::flush;
     std::cerr << std::dec << pipeline->core->core_id << " recv: " << QsimProxyRequest->get_queue_size() << " @ " << pipeline->core->clock_cycle << std::endl << std::flush;
-    std::vector<Qsim::QueueItem>::size_type sz = queue.size();
     //QsimProxyRequest->dump_queue();
 #endif
-    QsimProxyRequest->append_to(queue);
-#ifdef DEBUG_NEW_QSIM_1
-    std::cerr << "copied: " << queue.size() - sz << std::endl << std::flush;
-#endif
+    /* Only the segment descriptors are copied; the items stay with the proxy,
+       or in the request's own copy if it came from another LP. */
+    QsimProxyRequest->append_to(segments);
+    num_items += QsimProxyRequest->get_queue_size();
     delete QsimProxyRequest;
 #ifdef DEBUG_NEW_QSIM_1
-    std::cerr << "remain: " << queue.size() << std::endl << std::flush;
+    std::cerr << "remain: " << num_items << std::endl << std::flush;
     std::cerr << "******************" << std::endl << std::flush;
 #endif
 }
@@ -42,11 +44,9 @@ void spx_qsim_proxy_t::handle_qsim_response(qsim_proxy_request_t *QsimProxyReque
 int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
 {
     unsigned inst_count = InstCount;
-    std::vector<QueueItem>::iterator it;
 
-
-    for(it = queue.begin(); it != queue.end(); it++) {
-        QueueItem queue_item = *it;
+    while(!segments.empty()) {
+        const QueueItem &queue_item = segments.front().items[pos];
 
         assert (CoreID == queue_item.id);
 
@@ -64,6 +64,7 @@ int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
                                    (const uint8_t*)&queue_item.data.inst.bytes,
                                    (enum inst_type)queue_item.data.inst.type);
             inst_count--;
+            advance();
         }
         else if(queue_item.cb_type == QueueItem::MEM) {
             pipeline->Qsim_osd_state = QSIM_OSD_ACTIVE; /* Qsim core is active */
@@ -77,6 +78,7 @@ int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
                                   queue_item.data.mem.paddr,
                                   queue_item.data.mem.size,
                                   queue_item.data.mem.type);
+            advance();
         }
         else if(queue_item.cb_type == QueueItem::REG) {
             pipeline->Qsim_osd_state = QSIM_OSD_ACTIVE; /* Qsim core is active */
@@ -88,6 +90,7 @@ int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
                                   queue_item.data.reg.reg,
                                   queue_item.data.reg.size,
                                   queue_item.data.reg.type);
+            advance();
         }
         else if(queue_item.cb_type == QueueItem::IDLE) {
             if(inst_count != InstCount) { break; } /* loop exit */
@@ -95,7 +98,7 @@ int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
     std::cerr << "*( core " << std::dec << queue_item.id << " ): IDLE" << std::endl << std::flush;
 #endif
             pipeline->Qsim_osd_state = QSIM_OSD_IDLE;
-            it++;
+            advance();
             break;
         }
         else if(queue_item.cb_type == QueueItem::TERMINATED) {
@@ -104,7 +107,7 @@ int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
     std::cerr << "*( core " << std::dec << queue_item.id << " ): TERMINATED" << std::endl << std::flush;
 #endif
             pipeline->Qsim_osd_state = QSIM_OSD_TERMINATED;
-            it++;
+            advance();
             break;
         }
         else { /* Unknown callback type. Something's wrong. */
@@ -115,12 +118,87 @@ int spx_qsim_proxy_t::run(int CoreID, unsigned InstCount)
 
     }
 
-    queue.erase(queue.begin(), it);
-
-    //if(queue.size() < SPX_QSIM_PROXY_QUEUE_SIZE*0.2) {
-    if(queue.size() < 5) {
+    //if(num_items < SPX_QSIM_PROXY_QUEUE_SIZE*0.2) {
+    if(num_items < 5) {
         pipeline->core->send_qsim_proxy_request();
     }
 
     return (InstCount-inst_count); /* Return the number of processed instructions. */
 }
+
+/* Step past the current item, handing its segment back to the proxy once it
+   has been drained. */
+void spx_qsim_proxy_t::advance()
+{
+    qsim_proxy_segment_desc_t &seg = segments.front();
+
+    num_items--;
+    if(++pos == seg.size) {
+        if(seg.in_use) { *seg.in_use = false; }
+        if(seg.copied) { delete [] seg.items; }
+        segments.pop_front();
+        pos = 0;
+    }
+}
+
+
+namespace manifold {
+namespace kernel {
+
+template<>
+size_t Get_serialize_size<qsim_proxy_request_t>(const qsim_proxy_request_t *p)
+{
+    return sizeof(int) * 2 + sizeof(bool) + sizeof(unsigned) + p->get_queue_size() * sizeof(QueueItem);
+}
+
+/* Copy the items of every segment, which also hands the segments back to the
+   proxy right away. */
+template<>
+size_t Serialize<qsim_proxy_request_t>(qsim_proxy_request_t *p, unsigned char *buf)
+{
+    int core_id = p->get_core_id();
+    int port_id = p->get_port_id();
+    bool extended = p->is_extended();
+    unsigned num_items = p->get_queue_size();
+    size_t pos = 0;
+
+    memcpy(buf+pos, &core_id, sizeof(int)); pos += sizeof(int);
+    memcpy(buf+pos, &port_id, sizeof(int)); pos += sizeof(int);
+    memcpy(buf+pos, &extended, sizeof(bool)); pos += sizeof(bool);
+    memcpy(buf+pos, &num_items, sizeof(unsigned)); pos += sizeof(unsigned);
+
+    for(unsigned i = 0; i < p->get_num_segments(); i++) {
+        const qsim_proxy_segment_desc_t &seg = p->get_segment(i);
+        memcpy(buf+pos, seg.items, seg.size * sizeof(QueueItem)); pos += seg.size * sizeof(QueueItem);
+        if(seg.in_use) { *seg.in_use = false; }
+        if(seg.copied) { delete [] seg.items; }
+    }
+
+    delete p;
+    return pos;
+}
+
+template<>
+qsim_proxy_request_t *Deserialize<qsim_proxy_request_t>(unsigned char *buf)
+{
+    int core_id, port_id;
+    bool extended;
+    unsigned num_items;
+    size_t pos = 0;
+
+    memcpy(&core_id, buf+pos, sizeof(int)); pos += sizeof(int);
+    memcpy(&port_id, buf+pos, sizeof(int)); pos += sizeof(int);
+    memcpy(&extended, buf+pos, sizeof(bool)); pos += sizeof(bool);
+    memcpy(&num_items, buf+pos, sizeof(unsigned)); pos += sizeof(unsigned);
+
+    qsim_proxy_request_t *p = new qsim_proxy_request_t(core_id, port_id, extended);
+    if(num_items) {
+        QueueItem *items = new QueueItem[num_items];
+        memcpy(items, buf+pos, num_items * sizeof(QueueItem));
+        p->push_segment(items, num_items, NULL, true);
+    }
+    return p;
+}
+
+} // namespace kernel
+} // namespace manifold
@@ -1,9 +1,12 @@
 #ifndef __SPX_QSIM_PROXY_H__
 #define __SPX_QSIM_PROXY_H__
 
+#include <deque>
+#include <assert.h>
 #include "qsim.h"
 #include "qsim-regs.h"
 #include "pipeline.h"
+#include "kernel/serialize.h"
 
 /* Refer to ../../qsim/proxy/proxy.h:QSIM_PROXY_QUEUE_SIZE */
 //#define SPX_QSIM_PROXY_QUEUE_SIZE 256
@@ -12,6 +15,7 @@
 #define QSIM_RUN_GRANULARITY   200
 #define QSIM_OVERHEAD   0.2
 #define QSIM_PROXY_QUEUE_SIZE (int)(5 * QSIM_RUN_GRANULARITY * (1 + QSIM_OVERHEAD))
+#define QSIM_PROXY_MAX_SEGMENTS 4
 
 //#define DEBUG_NEW_QSIM 1
 //#define DEBUG_NEW_QSIM_1 1
@@ -19,6 +23,19 @@
 namespace manifold {
 namespace spx {
 
+/* A run of QueueItems lent by the Qsim proxy. The items stay in the proxy's
+   segment; the core clears *in_use once it has consumed all of them so the
+   proxy can fill the segment again. in_use is NULL for segments the proxy
+   never refills. A request sent to a core on another LP carries a copy of
+   the items instead (see Serialize() below), which the core frees. */
+struct qsim_proxy_segment_desc_t
+{
+    const Qsim::QueueItem *items;
+    unsigned size;
+    bool *in_use;
+    bool copied;
+};
+
 
 class qsim_proxy_request_t
 {
@@ -26,25 +43,34 @@ public:
     qsim_proxy_request_t() {}
     qsim_proxy_request_t(int CoreID, int PortID, bool ex = false) : core_id(CoreID),
                                                    port_id(PortID),
-                                                   extended (ex),
-                                                   num_queue_items(0) {}
+                                                   num_segments(0),
+                                                   extended (ex) {}
     ~qsim_proxy_request_t() {}
 
     int get_core_id() const { return core_id; }
     int get_port_id() const { return port_id; }
     bool is_extended() const { return extended; }
-    Qsim::QueueItem get_queue_item(unsigned idx) const { return queue[idx]; }
-    void push_back(Qsim::QueueItem queue_item) { queue[num_queue_items++] = queue_item; }
-    void reset() { num_queue_items = 0; }
-    unsigned get_queue_size() const { return num_queue_items; }
-    void append_to (std::vector<Qsim::QueueItem> &q) { 
-#ifdef DEBUG_NEW_QSIM
-        std::cerr << "in append_to -> q: " << q.size() << " queue: " << get_queue_size() << std::endl << std::flush; 
-#endif
-        q.insert(q.end(), std::begin(queue), std::begin(queue) + get_queue_size()); 
+    void push_segment(const Qsim::QueueItem *items, unsigned size, bool *in_use, bool copied = false) {
+        assert(num_segments < QSIM_PROXY_MAX_SEGMENTS && size > 0);
+        segments[num_segments].items = items;
+        segments[num_segments].size = size;
+        segments[num_segments].in_use = in_use;
+        segments[num_segments].copied = copied;
+        num_segments++;
+    }
+    void reset() { num_segments = 0; }
+    unsigned get_num_segments() const { return num_segments; }
+    const qsim_proxy_segment_desc_t &get_segment(unsigned idx) const { return segments[idx]; }
+    unsigned get_queue_size() const {
+        unsigned sz = 0;
+        for(unsigned i = 0; i < num_segments; i++) { sz += segments[i].size; }
+        return sz;
+    }
+    void append_to (std::deque<qsim_proxy_segment_desc_t> &q) {
 #ifdef DEBUG_NEW_QSIM
-        std::cerr << "in append_to[af] -> q: " << q.size() << " queue: " << get_queue_size() << std::endl << std::flush; 
+        std::cerr << "in append_to -> q: " << q.size() << " segments: " << get_num_segments() << std::endl << std::flush; 
 #endif
+        q.insert(q.end(), segments, segments + num_segments);
     }
     //void dump_queue () {
         //for(std::vector<Qsim::QueueItem>::iterator it = queue.begin(); it != queue.end(); it++) {
@@ -84,9 +110,8 @@ public:
 private:
     int core_id;
     int port_id;
-    Qsim::QueueItem queue[QSIM_PROXY_QUEUE_SIZE];
-    //std::vector<Qsim::QueueItem> queue;
-    unsigned num_queue_items;
+    qsim_proxy_segment_desc_t segments[QSIM_PROXY_MAX_SEGMENTS];
+    unsigned num_segments;
     bool extended;
 };
 
@@ -100,11 +125,33 @@ public:
     void handle_qsim_response(qsim_proxy_request_t *QsimProxyRequest);
 
 private:
+    void advance();
+
     pipeline_t *pipeline;
-    std::vector<Qsim::QueueItem> queue;
+    std::deque<qsim_proxy_segment_desc_t> segments; /* items are read in place */
+    unsigned pos; /* next item in segments.front() */
+    unsigned num_items; /* items not yet consumed */
 };
 
 } // namespace spx
 } // namespace manifold
 
+
+/* The segment pointers of a request are only valid on the proxy's LP, so a
+   request crossing LPs is sent with the items copied in. */
+namespace manifold {
+namespace kernel {
+
+template<>
+size_t Get_serialize_size<manifold::spx::qsim_proxy_request_t>(const manifold::spx::qsim_proxy_request_t *p);
+
+template<>
+size_t Serialize<manifold::spx::qsim_proxy_request_t>(manifold::spx::qsim_proxy_request_t *p, unsigned char *buf);
+
+template<>
+manifold::spx::qsim_proxy_request_t *Deserialize<manifold::spx::qsim_proxy_request_t>(unsigned char *buf);
+
+} // namespace kernel
+} // namespace manifold
+
 #endif
@@ -33,6 +33,7 @@ class bpred_pathneural_t:public bpred_dir_t
     qword_t lookup_bhr;
     md_addr_t lookup_path[MAX_PATHNEURAL_PATH];
     md_addr_t lookup_PC;
+    int lookup_row[MAX_PATHNEURAL_PATH]; /* perceptron used for each history position */
     int sum;
   };
 
@@ -43,7 +44,7 @@ class bpred_pathneural_t:public bpred_dir_t
   qword_t * bht;
   int top_size;
   int top_mask;
-  short **top; /* table of pathneurals */
+  signed char **top; /* table of pathneurals (weights are weight_width = 8 bits) */
   int weight_width;
   int weight_max;
   int weight_min;
@@ -105,12 +106,12 @@ class bpred_pathneural_t:public bpred_dir_t
     bht = (qword_t*) calloc(bht_size,sizeof(*bht));
     if(!bht)
       fatal("couldn't malloc pathneural BHT");
-    top = (short**) calloc(top_size,sizeof(*top));
+    top = (signed char**) calloc(top_size,sizeof(*top));
     if(!top)
       fatal("couldn't malloc pathneural ToP");
     for(int i=0;i<top_size;i++)
     {
-      top[i] = (short*) calloc(1+history_length,sizeof(*top[i]));
+      top[i] = (signed char*) calloc(1+history_length,sizeof(*top[i]));
       if(!top[i])
         fatal("couldn't malloc pathneural ToP entry");
     }
@@ -145,21 +146,21 @@ class bpred_pathneural_t:public bpred_dir_t
     int i;
 
     sc->bhr = &bht[l1index];
+    sc->lookup_PC = PC;
+    sc->lookup_bhr = *sc->bhr;
     sc->sum = top[(PC&top_mask)%top_size][0];
+    /* MAX_PATHNEURAL_PATH is a power of two, so the path wraps with a mask */
     for(i=0;i<history_length;i++)
     {
-      int hist_dir = ((*sc->bhr >> i) & 1) ? 1:-1;
-      md_addr_t addr = path[(path_head - i + MAX_PATHNEURAL_PATH) % MAX_PATHNEURAL_PATH];
-      sc->sum += hist_dir * top[(addr&top_mask)%top_size][i+1];
+      md_addr_t addr = path[(path_head - i) & (MAX_PATHNEURAL_PATH-1)];
+      int row = (addr&top_mask)%top_size;
+      int weight = top[row][i+1];
+      sc->lookup_path[history_length-i-1] = addr;
+      sc->lookup_row[i] = row;
+      sc->sum += ((sc->lookup_bhr >> i) & 1) ? weight : -weight;
     }
 
     pred = (sc->sum >= 0);
-    sc->lookup_PC = PC;
-    sc->lookup_bhr = *sc->bhr;
-    for(i=0;i<history_length;i++)
-    {
-      sc->lookup_path[history_length-i-1] = path[(path_head - i + MAX_PATHNEURAL_PATH)%MAX_PATHNEURAL_PATH];
-    }
 
     weights_read += 1 + history_length;
 
@@ -183,7 +184,7 @@ class bpred_pathneural_t:public bpred_dir_t
 
     if(((sc->sum >= 0) != outcome) || ((sc->sum > -theta) && (sc->sum <theta)))
     {
-      short * weight;
+      signed char * weight;
       weight = &top[(PC&top_mask)%top_size][0];
       if(outcome) {
           if(*weight < weight_max) ++*weight;
@@ -193,8 +194,7 @@ class bpred_pathneural_t:public bpred_dir_t
 
       for(int i=0;i<history_length;i++)
       {
-        md_addr_t addr = sc->lookup_path[history_length-1-i];
-        weight = &top[(addr&top_mask)%top_size][i+1];
+        weight = &top[sc->lookup_row[i]][i+1];
         if( ((sc->lookup_bhr>>i)&1) == (unsigned)outcome ) {
             if(*weight < weight_max) ++*weight;
         } else {
@@ -63,6 +63,8 @@ class bpred_perceptron_t:public bpred_dir_t
     /* verify arguments are valid */
     CHECK_NNEG(arg_history_length);
     CHECK_PPOW2(arg_top_size);
+    if(arg_history_length > 128)
+      fatal("perceptron history length %d is more than the 128 bits of history kept",arg_history_length);
 
     name = strdup(arg_name);
     if(!name)
@@ -124,15 +126,8 @@ class bpred_perceptron_t:public bpred_dir_t
     int top_index = PC&top_mask;
 
     sc->top_entry = top[top_index];
-    sc->sum = sc->top_entry[0];
-
-    for(int i=0;i<history_length;i++)
-    {
-      int hist_dir;
-      if(i<64) hist_dir = BIPOLAR((bhr>>i)&1);
-      else     hist_dir = BIPOLAR((bhr_old>>(i-64))&1);
-      sc->sum += sc->top_entry[i+1]*hist_dir;
-    }
+    const qword_t hist[2] = {bhr,bhr_old};
+    sc->sum = sc->top_entry[0] + bpred_perceptron_dot(&sc->top_entry[1],hist,history_length);
 
     pred = sc->sum >= 0;
     sc->lookup_bhr_old = bhr_old;
@@ -157,17 +152,8 @@ class bpred_perceptron_t:public bpred_dir_t
       } else {
           if(sc->top_entry[0] > weight_min) sc->top_entry[0]--;
       }
-      for(int i=0;i<history_length;i++)
-      {
-        int hist_bit;
-        if(i<64) hist_bit = (sc->lookup_bhr>>i)&1;
-        else     hist_bit = (sc->lookup_bhr_old>>(i-64))&1;
-        if(hist_bit == outcome) {
-          if(sc->top_entry[i+1] < weight_max) sc->top_entry[i+1]++;
-        } else {
-          if(sc->top_entry[i+1] > weight_min) sc->top_entry[i+1]--;
-        }
-      }
+      const qword_t hist[2] = {sc->lookup_bhr,sc->lookup_bhr_old};
+      bpred_perceptron_train(&sc->top_entry[1],hist,history_length,outcome,weight_min,weight_max);
     }
 
     if(!sc->updated)
@@ -35,6 +35,7 @@ class bpred_pwl_t:public bpred_dir_t
     qword_t lookup_bhr;
     md_addr_t lookup_path[MAX_PATHNEURAL_PATH];
     md_addr_t lookup_PC;
+    int lookup_row[MAX_PATHNEURAL_PATH]; /* perceptron used for each history position */
     int sum;
   };
 
@@ -48,7 +49,7 @@ class bpred_pwl_t:public bpred_dir_t
   qword_t * bht;
   int top_size;
   int top_mask;
-  short **top; /* table of pwls */
+  signed char **top; /* table of pwls (weights are weight_width = 8 bits) */
   int weight_width;
   int weight_max;
   int weight_min;
@@ -111,12 +112,12 @@ class bpred_pwl_t:public bpred_dir_t
     bht = (qword_t*) calloc(bht_size,sizeof(*bht));
     if(!bht)
       fatal("couldn't malloc pwl BHT");
-    top = (short**) calloc(top_size,sizeof(*top));
+    top = (signed char**) calloc(top_size,sizeof(*top));
     if(!top)
       fatal("couldn't malloc pwl ToP");
     for(int i=0;i<top_size;i++)
     {
-      top[i] = (short*) calloc(1+history_length,sizeof(*top[i]));
+      top[i] = (signed char*) calloc(1+history_length,sizeof(*top[i]));
       if(!top[i])
         fatal("couldn't malloc pwl ToP entry");
     }
@@ -148,21 +149,22 @@ class bpred_pwl_t:public bpred_dir_t
     int i;
 
     sc->bhr = &bht[l1index];
+    sc->lookup_PC = PC;
+    sc->lookup_bhr = *sc->bhr;
     sc->sum = top[(PC&top_mask)%top_size][0];
+    /* MAX_PATHNEURAL_PATH is a power of two, so the path wraps with a mask */
+    const int pc_part = PC&pc_mask;
     for(i=0;i<history_length;i++)
     {
-        int hist_dir = ((*sc->bhr >> i) & 1) ? 1:-1;
-        md_addr_t addr = path[(path_head - i + MAX_PATHNEURAL_PATH) % MAX_PATHNEURAL_PATH];
-        sc->sum += hist_dir * top[(((addr&top_mask)<<pc_bits)^(PC&pc_mask))%top_size][i+1];
+        md_addr_t addr = path[(path_head - i) & (MAX_PATHNEURAL_PATH-1)];
+        int row = (((addr&top_mask)<<pc_bits)^pc_part)%top_size;
+        int weight = top[row][i+1];
+        sc->lookup_path[history_length-i-1] = addr;
+        sc->lookup_row[i] = row;
+        sc->sum += ((sc->lookup_bhr >> i) & 1) ? weight : -weight;
     }
 
     pred = (sc->sum >= 0);
-    sc->lookup_PC = PC;
-    sc->lookup_bhr = *sc->bhr;
-    for(i=0;i<history_length;i++)
-    {
-        sc->lookup_path[history_length-i-1] = path[(path_head - i + MAX_PATHNEURAL_PATH)%MAX_PATHNEURAL_PATH];
-    }
 
     BPRED_STAT(lookups++;)
     sc->updated = false;
@@ -185,7 +187,7 @@ class bpred_pwl_t:public bpred_dir_t
 
     if(((sc->sum >= 0) != outcome) || ((sc->sum > -theta) && (sc->sum <theta)))
     {
-        short * weight;
+        signed char * weight;
         weight = &top[(PC&top_mask)%top_size][0];
         if(outcome) {
             if(*weight < weight_max) ++*weight;
@@ -195,8 +197,7 @@ class bpred_pwl_t:public bpred_dir_t
 
         for(i=0;i<history_length;i++)
         {
-          md_addr_t addr = sc->lookup_path[history_length-1-i];
-          weight = &top[(((addr&top_mask)<<pc_bits)^(PC&pc_mask))%top_size][i+1];
+          weight = &top[sc->lookup_row[i]][i+1];
           if( ((sc->lookup_bhr>>i)&1) == (unsigned)outcome ) {
               if(*weight < weight_max) ++*weight;
           } else {
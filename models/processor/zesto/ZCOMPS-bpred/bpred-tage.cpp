@@ -43,6 +43,7 @@ class bpred_tage_t:public bpred_dir_t
     public:
     my2bc_t * current_ctr;
     bpred_tage_hist_t lookup_bhr;
+    int lookup_folded[TAGE_MAX_TABLES];
     int index[TAGE_MAX_TABLES];
     int provider;
     int provpred;
@@ -78,6 +79,8 @@ class bpred_tage_t:public bpred_dir_t
     D[7] = S[7];
   }
 
+  /* XOR of the hist_length/hash_length whole hash_length-bit chunks of H;
+     only used to check the folded histories below */
   int bpred_tage_hist_hash(bpred_tage_hist_t H, int hist_length, int hash_length)
   {
     int result = 0;
@@ -107,6 +110,23 @@ class bpred_tage_t:public bpred_dir_t
     return result;
   }
 
+  /* Shift outcome into bhr and bring the folded histories along: when a
+     bit enters, each chunk's bits move up one place, so the fold rotates
+     left by one, takes the new bit into bit 0, and drops the bit that
+     just left the last whole chunk (also bit 0 after the rotate). */
+  inline void bpred_tage_push(int outcome)
+  {
+    for(int i=1;i<num_tables;i++)
+    {
+      if(!fold_len[i])
+        continue;
+      const int out = (bhr[(fold_len[i]-1)>>6]>>((fold_len[i]-1)&63))&1;
+      folded[i] = ((folded[i]<<1) | (folded[i]>>(log_size-1))) & table_mask;
+      folded[i] ^= (outcome&1) ^ out;
+    }
+    bpred_tage_hist_update(bhr,outcome);
+  }
+
   protected:
 
   int num_tables;
@@ -127,6 +147,8 @@ class bpred_tage_t:public bpred_dir_t
   zcounter_t * Tuses;
 
   bpred_tage_hist_t bhr;
+  int folded[TAGE_MAX_TABLES]; /* bpred_tage_hist_hash(bhr,Hlen[i],log_size), kept incrementally */
+  int fold_len[TAGE_MAX_TABLES]; /* bits of bhr covered by folded[i] */
 
   public:
 
@@ -184,6 +206,12 @@ class bpred_tage_t:public bpred_dir_t
       Hlen[i] = (int)floor(arg_first_length * pow(alpha,i-1) + 0.5);
     Hlen[i] = arg_last_length;
 
+    for(i=0;i<num_tables;i++)
+    {
+      folded[i] = 0;
+      fold_len[i] = log_size ? (Hlen[i]/log_size)*log_size : 0;
+    }
+
     T = (struct bpred_tage_ent_t**) calloc(num_tables,sizeof(*T));
     if(!T)
       fatal("couldn't calloc tage T array");
@@ -240,12 +268,14 @@ class bpred_tage_t:public bpred_dir_t
   {
     class bpred_tage_sc_t * sc = (class bpred_tage_sc_t*) scvp;
 
-    for(int i=0;i<num_tables;i++)
+    sc->index[0] = PC;
+    for(int i=1;i<num_tables;i++)
     {
-      if(i==0)
-        sc->index[i] = PC;
-      else
-        sc->index[i] = PC^bpred_tage_hist_hash(bhr,Hlen[i],log_size);
+#ifdef DEBUG
+      assert(folded[i] == bpred_tage_hist_hash(bhr,Hlen[i],log_size));
+#endif
+      sc->index[i] = PC^folded[i];
+      sc->lookup_folded[i] = folded[i];
     }
     sc->provider = 0;
     sc->provpred = 0;
@@ -437,7 +467,7 @@ class bpred_tage_t:public bpred_dir_t
   BPRED_SPEC_UPDATE_HEADER
   {
     BPRED_STAT(spec_updates++;)
-    bpred_tage_hist_update(bhr,our_pred);
+    bpred_tage_push(our_pred);
   }
 
   BPRED_RECOVER_HEADER
@@ -445,7 +475,9 @@ class bpred_tage_t:public bpred_dir_t
     class bpred_tage_sc_t * sc = (class bpred_tage_sc_t*) scvp;
 
     bpred_tage_hist_copy(bhr,sc->lookup_bhr);
-    bpred_tage_hist_update(bhr,outcome);
+    for(int i=1;i<num_tables;i++)
+      folded[i] = sc->lookup_folded[i];
+    bpred_tage_push(outcome);
   }
 
   BPRED_FLUSH_HEADER
@@ -453,6 +485,8 @@ class bpred_tage_t:public bpred_dir_t
     class bpred_tage_sc_t * sc = (class bpred_tage_sc_t*) scvp;
 
     bpred_tage_hist_copy(bhr,sc->lookup_bhr);
+    for(int i=1;i<num_tables;i++)
+      folded[i] = sc->lookup_folded[i];
   }
 
   /* REG_STATS */
@@ -33,6 +33,7 @@ class core_commit_DPM_t:public core_commit_t
   virtual bool ROB_empty(void);
   virtual void ROB_insert(struct uop_t * const uop);
   virtual void ROB_fuse_insert(struct uop_t * const uop);
+  virtual int ROB_head_index(void);
 
   protected:
 
@@ -1032,4 +1033,9 @@ void core_commit_DPM_t::ROB_fuse_insert(struct uop_t * const uop)
   #endif
 }
 
+int core_commit_DPM_t::ROB_head_index(void)
+{
+  return ROB_head;
+}
+
 #endif
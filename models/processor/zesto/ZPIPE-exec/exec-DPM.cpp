@@ -13,15 +13,6 @@
 
 class core_exec_DPM_t:public core_exec_t
 {
-  /* readyQ for scheduling */
-  struct readyQ_node_t {
-    struct uop_t * uop;
-    seq_t uop_seq; /* seq id of uop when inserted - for proper sorting even after uop recycled */
-    seq_t action_id;
-    tick_t when_assigned;
-    struct readyQ_node_t * next;
-  };
-
   /* struct for a squashable in-flight uop (for example, a uop making its way
      down an ALU pipeline).  Changing the original uop's tag will make the tags
      no longer match, thereby invalidating the in-flight action. */
@@ -84,10 +75,7 @@ class core_exec_DPM_t:public core_exec_t
   virtual unsigned long long int get_load_latency(int LDQ_index);
 
   protected:
-  struct readyQ_node_t * readyQ_free_pool; /* for scheduling readyQ's */
-#ifdef DEBUG
-  int readyQ_free_pool_debt; /* for debugging memory leaks */
-#endif
+  class readyQ_t * readyQ; /* one scheduling readyQ per exec port */
 
   struct uop_t ** RS;
   int RS_num;
@@ -144,11 +132,15 @@ class core_exec_DPM_t:public core_exec_t
   int STQ_senior_head;
   bool partial_forward_throttle; /* used to control load-issuing in the presence of partial-matching stores */
 
+  /* address index over the STQ, and scratch space for searching it */
+  class STQ_index_t * STQ_index;
+  qword_t * STQ_cands;
+  int * STQ_order;
+
   struct exec_port_t {
     struct uop_action_t * payload_pipe;
     int occupancy;
     struct ALU_t * FU[NUM_FU_CLASSES];
-    struct readyQ_node_t * readyQ;
     struct ALU_t * STQ; /* store-queue lookup/search pipeline for load execution */
     tick_t when_bypass_used; /* to make sure only one inst writes back per cycle, which
                                 could happen due to insts with different latencies */
@@ -162,8 +154,6 @@ class core_exec_DPM_t:public core_exec_t
 
   /* various exec utility functions */
 
-  struct readyQ_node_t * get_readyQ_node(void);
-  void return_readyQ_node(struct readyQ_node_t * const p);
   bool check_load_issue_conditions(const struct uop_t * const uop);
   void snatch_back(struct uop_t * const replayed_uop);
 
@@ -191,10 +181,6 @@ class core_exec_DPM_t:public core_exec_t
 /*******************/
 
 core_exec_DPM_t::core_exec_DPM_t(struct core_t * const arg_core):
-  readyQ_free_pool(NULL),
-#ifdef DEBUG
-  readyQ_free_pool_debt(0),
-#endif
   RS_num(0), RS_eff_num(0), LDQ_head(0), LDQ_tail(0), LDQ_num(0),
   STQ_head(0), STQ_tail(0), STQ_num(0), STQ_senior_num(0),
   STQ_senior_head(0), partial_forward_throttle(false)
@@ -220,12 +206,19 @@ core_exec_DPM_t::core_exec_DPM_t(struct core_t * const arg_core):
   for(i=0;i<knobs->exec.STQ_size;i++)
     STQ[i].sta = NULL;
 
+  STQ_index = new STQ_index_t(knobs->exec.STQ_size);
+  STQ_cands = (qword_t*) calloc(STQ_index->num_words,sizeof(*STQ_cands));
+  STQ_order = (int*) calloc(knobs->exec.STQ_size,sizeof(*STQ_order));
+  if(!STQ_cands || !STQ_order)
+    fatal("couldn't calloc STQ search space");
+
   /************************************/
   /* execution port payload pipelines */
   /************************************/
   port = (core_exec_DPM_t::exec_port_t*) calloc(knobs->exec.num_exec_ports,sizeof(*port));
   if(!port)
     fatal("couldn't calloc exec ports");
+  readyQ = new readyQ_t(knobs->exec.num_exec_ports,knobs->commit.ROB_size,knobs->exec.RS_size);
   for(i=0;i<knobs->exec.num_exec_ports;i++)
   {
     port[i].payload_pipe = (struct uop_action_t*) calloc(knobs->exec.payload_depth,sizeof(*port->payload_pipe));
@@ -438,41 +431,6 @@ void core_exec_DPM_t::update_occupancy(void)
    necessarily executed).  However, that doesn't necessarily mean that the
    corresponding input *values* are "ready" due to non-zero schedule-to-
    execute latencies. */
-core_exec_DPM_t::readyQ_node_t * core_exec_DPM_t::get_readyQ_node(void)
-{
-  struct readyQ_node_t * p = NULL;
-  if(readyQ_free_pool)
-  {
-    p = readyQ_free_pool;
-    readyQ_free_pool = p->next;
-  }
-  else
-  {
-    p = (struct readyQ_node_t*) calloc(1,sizeof(*p));
-    if(!p)
-      fatal("couldn't calloc a readyQ node");
-  }
-  assert(p);
-  p->next = NULL;
-  p->when_assigned = core->sim_cycle;
-#ifdef DEBUG
-  readyQ_free_pool_debt++;
-#endif
-  return p;
-}
-
-void core_exec_DPM_t::return_readyQ_node(struct readyQ_node_t * const p)
-{
-  assert(p);
-  assert(p->uop);
-  p->next = readyQ_free_pool;
-  readyQ_free_pool = p;
-  p->uop = NULL;
-  p->when_assigned = -1;
-#ifdef DEBUG
-  readyQ_free_pool_debt--;
-#endif
-}
 
 /* Add the uop to the corresponding readyQ (based on port binding - we maintain
    one readyQ per execution port) */
@@ -491,39 +449,9 @@ void core_exec_DPM_t::insert_ready_uop(struct uop_t * const uop)
   zesto_assert(uop->timing.when_issued == TICK_T_MAX,(void)0);
   zesto_assert(!uop->exec.in_readyQ,(void)0);
 
-  struct readyQ_node_t ** RQ = &port[uop->alloc.port_assignment].readyQ;
-  struct readyQ_node_t * new_node = get_readyQ_node();
-  new_node->uop = uop;
-  new_node->uop_seq = uop->decode.uop_seq;
   uop->exec.in_readyQ = true;
   uop->exec.action_id = core->new_action_id();
-  new_node->action_id = uop->exec.action_id;
-
-  if(!*RQ) /* empty ready queue */
-  {
-    *RQ = new_node;
-    return;
-  }
-
-  struct readyQ_node_t * current = *RQ, * prev = NULL;
-
-  /* insert in age order: first find insertion point */
-  while(current && (current->uop_seq < uop->decode.uop_seq))
-  {
-    prev = current;
-    current = current->next;
-  }
-
-  if(!prev) /* uop is oldest */
-  {
-    new_node->next = *RQ;
-    *RQ = new_node;
-  }
-  else
-  {
-    new_node->next = current;
-    prev->next = new_node;
-  }
+  readyQ->insert(uop->alloc.port_assignment,uop,core->sim_cycle);
 }
 
 /*****************************/
@@ -538,14 +466,18 @@ void core_exec_DPM_t::RS_schedule(void) /* for uops in the RS */
   /* select/pick from ready instructions and send to exec ports */
   for(i=0;i<knobs->exec.num_exec_ports;i++)
   {
-    struct readyQ_node_t * rq = port[i].readyQ;
-    struct readyQ_node_t * prev = NULL;
-    int issued = false;
-
     if(port[i].payload_pipe[0].uop == NULL) /* port is free */
-      while(rq) /* if anyone's waiting to issue to this port */
+    {
+      /* pick the oldest ready uop waiting on this port; only one uop
+         schedules from an issue port per cycle */
+      const int ROB_head = core->commit->ROB_head_index();
+      int pick = -1;
+      int slot, next;
+      for(slot=readyQ->first(i,ROB_head);slot>=0;slot=next)
       {
+        struct readyQ_t::node_t * rq = readyQ->get(slot);
         struct uop_t * uop = rq->uop;
+        next = readyQ->next(i,slot,ROB_head);
 
 #ifdef ZTRACE
         if(uop->timing.when_ready == core->sim_cycle)
@@ -553,107 +485,90 @@ void core_exec_DPM_t::RS_schedule(void) /* for uops in the RS */
 #endif
 
         if(uop->exec.action_id != rq->action_id) /* RQ entry has been squashed */
-        {
-          struct readyQ_node_t * next = rq->next;
-          /* remove from readyQ */
-          if(prev)
-            prev->next = next;
-          else
-            port[i].readyQ = next;
-          return_readyQ_node(rq);
-          /* and go on to next node */
-          rq = next;
-        }
+          readyQ->remove(i,slot);
         else if((uop->timing.when_ready <= core->sim_cycle) &&
-                !issued &&
                 (port[i].FU[uop->decode.FU_class]->when_scheduleable <= core->sim_cycle) &&
                 ((!uop->decode.in_fusion) || uop->decode.fusion_head->alloc.full_fusion_allocated))
         {
-          zesto_assert(uop->alloc.port_assignment == i,(void)0);
-          port[i].payload_pipe[0].uop = uop;
-          port[i].payload_pipe[0].action_id = uop->exec.action_id;
-          port[i].occupancy++;
-          zesto_assert(port[i].occupancy <= knobs->exec.payload_depth,(void)0);
-          uop->timing.when_issued = core->sim_cycle;
-          check_for_work = true;
+          pick = slot;
+          break;
+        }
+      }
 
-          #ifdef ZESTO_COUNTERS
-          core->counters->payload.write++;
-          core->counters->RS.read++;
-          core->counters->issue_select.read++;
-          core->counters->latch.RS2PR.read++;
-          #endif
+      if(pick >= 0)
+      {
+        struct uop_t * uop = readyQ->get(pick)->uop;
+        /* remove from readyQ (before the tag broadcast below refills it) */
+        readyQ->remove(i,pick);
+
+        zesto_assert(uop->alloc.port_assignment == i,(void)0);
+        port[i].payload_pipe[0].uop = uop;
+        port[i].payload_pipe[0].action_id = uop->exec.action_id;
+        port[i].occupancy++;
+        zesto_assert(port[i].occupancy <= knobs->exec.payload_depth,(void)0);
+        uop->timing.when_issued = core->sim_cycle;
+        check_for_work = true;
+
+        #ifdef ZESTO_COUNTERS
+        core->counters->payload.write++;
+        core->counters->RS.read++;
+        core->counters->issue_select.read++;
+        core->counters->latch.RS2PR.read++;
+        #endif
 
 #ifdef ZDEBUG
 	fprintf(stdout,"\n[%lld][Core%d]EXEC MOP=%d UOP=%d in RS issued to payload RAM port %d in_fusion %d ",core->sim_cycle,core->id,uop->decode.Mop_seq,uop->decode.uop_seq,uop->alloc.port_assignment,uop->decode.in_fusion);
 #endif
 #ifdef ZTRACE
-          ztrace_print(uop,"e|RS-issue|uop issued to payload RAM");
+        ztrace_print(uop,"e|RS-issue|uop issued to payload RAM");
 #endif
 
-          if(uop->decode.is_load)
-          {
-            int fp_penalty = REG_IS_FPR(uop->decode.odep_name)?knobs->exec.fp_penalty:0;
-           //TODO cacffein-sim add memlatency uop->timing.when_otag_ready = core->sim_cycle + port[i].FU[uop->decode.FU_class]->latency + core->memory.DL1->latency + fp_penalty;
-           // uop->timing.when_otag_ready = core->sim_cycle + port[i].FU[uop->decode.FU_class]->latency + 2 + fp_penalty;
-           uop->timing.when_otag_ready = TICK_T_MAX;
-          }
-          else
-          {
-            int fp_penalty = ((REG_IS_FPR(uop->decode.odep_name) && !(uop->decode.opflags & F_FCOMP)) ||
-                             (!REG_IS_FPR(uop->decode.odep_name) && (uop->decode.opflags & F_FCOMP)))?knobs->exec.fp_penalty:0;
-            uop->timing.when_otag_ready = core->sim_cycle + port[i].FU[uop->decode.FU_class]->latency + fp_penalty;
-          }
+        if(uop->decode.is_load)
+        {
+          int fp_penalty = REG_IS_FPR(uop->decode.odep_name)?knobs->exec.fp_penalty:0;
+         //TODO cacffein-sim add memlatency uop->timing.when_otag_ready = core->sim_cycle + port[i].FU[uop->decode.FU_class]->latency + core->memory.DL1->latency + fp_penalty;
+         // uop->timing.when_otag_ready = core->sim_cycle + port[i].FU[uop->decode.FU_class]->latency + 2 + fp_penalty;
+         uop->timing.when_otag_ready = TICK_T_MAX;
+        }
+        else
+        {
+          int fp_penalty = ((REG_IS_FPR(uop->decode.odep_name) && !(uop->decode.opflags & F_FCOMP)) ||
+                           (!REG_IS_FPR(uop->decode.odep_name) && (uop->decode.opflags & F_FCOMP)))?knobs->exec.fp_penalty:0;
+          uop->timing.when_otag_ready = core->sim_cycle + port[i].FU[uop->decode.FU_class]->latency + fp_penalty;
+        }
 
-          port[i].FU[uop->decode.FU_class]->when_scheduleable = core->sim_cycle + port[i].FU[uop->decode.FU_class]->issue_rate;
+        port[i].FU[uop->decode.FU_class]->when_scheduleable = core->sim_cycle + port[i].FU[uop->decode.FU_class]->issue_rate;
 
-          /* tag broadcast to dependents */
-          struct odep_t * odep = uop->exec.odep_uop;
-          while(odep)
+        /* tag broadcast to dependents */
+        struct odep_t * odep = uop->exec.odep_uop;
+        while(odep)
+        {
+          int j;
+          tick_t when_ready = 0;
+          odep->uop->timing.when_itag_ready[odep->op_num] = uop->timing.when_otag_ready;
+          for(j=0;j<MAX_IDEPS;j++)
           {
-            int j;
-            tick_t when_ready = 0;
-            odep->uop->timing.when_itag_ready[odep->op_num] = uop->timing.when_otag_ready;
-            for(j=0;j<MAX_IDEPS;j++)
-            {
-              if(when_ready < odep->uop->timing.when_itag_ready[j])
-                when_ready = odep->uop->timing.when_itag_ready[j];
-            }
-            odep->uop->timing.when_ready = when_ready;
-
-            if(when_ready < TICK_T_MAX)
-              insert_ready_uop(odep->uop);
-
-            odep = odep->next;
+            if(when_ready < odep->uop->timing.when_itag_ready[j])
+              when_ready = odep->uop->timing.when_itag_ready[j];
           }
+          odep->uop->timing.when_ready = when_ready;
 
-          if(uop->decode.is_load)
-          {
-            zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
-            //LDQ[uop->alloc.LDQ_index].speculative_broadcast = true;
-          }
+          if(when_ready < TICK_T_MAX)
+            insert_ready_uop(odep->uop);
 
-          struct readyQ_node_t * next = rq->next;
-          /* remove from readyQ */
-          if(prev)
-            prev->next = next;
-          else
-            port[i].readyQ = next;
-          return_readyQ_node(rq);
-          uop->exec.in_readyQ = false;
-          ZESTO_STAT(core->stat.exec_uops_issued++;)
-
-          /* only one uop schedules from an issue port per cycle */
-          issued = true;
-          rq = next;
+          odep = odep->next;
         }
-        else
+
+        if(uop->decode.is_load)
         {
-          /* node valid, but not ready; skip over it */
-          prev = rq;
-          rq = rq->next;
+          zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+          //LDQ[uop->alloc.LDQ_index].speculative_broadcast = true;
         }
+
+        uop->exec.in_readyQ = false;
+        ZESTO_STAT(core->stat.exec_uops_issued++;)
       }
+    }
   }
 }
 
@@ -670,7 +585,6 @@ bool core_exec_DPM_t::check_load_issue_conditions(const struct uop_t * const uop
   int i;
   int match_index = -1;
   int oracle_index = -1;
-  int num_stores = 0; /* need this extra condition because STQ could be full with all stores older than the load we're considering */
 
   /* don't reissue someone who's already issued */
   zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),false);
@@ -680,11 +594,26 @@ bool core_exec_DPM_t::check_load_issue_conditions(const struct uop_t * const uop
   md_addr_t ld_addr1 = LDQ[uop->alloc.LDQ_index].uop->oracle.virt_addr;
   md_addr_t ld_addr2 = LDQ[uop->alloc.LDQ_index].virt_addr + uop->decode.mem_size - 1;
 
-  /* this searches the senior STQ as well. */
-  for(i=LDQ[uop->alloc.LDQ_index].store_color;
-      ((modinc(i,knobs->exec.STQ_size)) != STQ_senior_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
-      i=moddec(i,knobs->exec.STQ_size) )
+  /* this searches the senior STQ as well: everything from the load's
+     store color back to the senior head.  The STQ is allocated in
+     program order, so all of those stores are older than the load. */
+  const int store_color = LDQ[uop->alloc.LDQ_index].store_color;
+  int window = (store_color - moddec(STQ_senior_head,knobs->exec.STQ_size) + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  if(window > STQ_senior_num)
+    window = STQ_senior_num;
+  if(window && (STQ[store_color].uop_seq >= uop->decode.uop_seq))
+    window = 0;
+
+  sta_unknown = STQ_index->window(STQ_index->get_unknown(),store_color,window,true,NULL) > 0;
+
+  /* only the stores that can overlap the load need to be checked, youngest first */
+  STQ_index->lookup(ld_addr1,ld_addr2,STQ_cands);
+  int num_cands = STQ_index->window(STQ_cands,store_color,window,true,STQ_order);
+
+  for(int k=0; (k < num_cands) && ((match_index == -1) || (oracle_index == -1)); k++)
   {
+    i = STQ_order[k];
+
     /* check addr match */
     int st_mem_size = STQ[i].mem_size;
     int ld_mem_size = uop->decode.mem_size;
@@ -696,7 +625,6 @@ bool core_exec_DPM_t::check_load_issue_conditions(const struct uop_t * const uop
     {
       zesto_assert(STQ[i].sta,false);
       st_addr1 = STQ[i].sta->oracle.virt_addr; /* addr of first byte */
-      sta_unknown = true;
     }
     st_addr2 = st_addr1 + st_mem_size - 1; /* addr of last byte */
 
@@ -741,7 +669,6 @@ bool core_exec_DPM_t::check_load_issue_conditions(const struct uop_t * const uop
         oracle_partial_match = true;
       }
     }
-    num_stores++;
   }
 
   if(partial_match)
@@ -1164,35 +1091,42 @@ void core_exec_DPM_t::LDST_exec(void)
 #ifdef ZTRACE
       ztrace_print(uop,"e|STQ|load searches STQ for addr match");
 #endif
-      int num_stores = 0;
       zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
 
       j=LDQ[uop->alloc.LDQ_index].store_color;
-
-      int cond1 = STQ[j].sta != NULL;
-      seq_t seq1 = (seq_t)-1, seq2 = (seq_t)-1;
       zesto_assert(j >= 0,(void)0);
       zesto_assert(j < knobs->exec.STQ_size,(void)0);
-      if(j)
-      {
-        seq1 = (seq_t)-2;
-      }
-      if(cond1)
-      {
-        seq1 = STQ[j].sta->decode.uop_seq;
-        seq2 = uop->decode.uop_seq;
-      }
-      int cond2 = cond1 && (seq1 < seq2);
-      int cond3 = (num_stores < STQ_senior_num);
 
-      while(cond1 && cond2 && cond3)
+      /* The search covers the non-senior stores from the load's store
+         color back to the STQ head (whose STA may already have been
+         deallocated by commit); they're all older than the load since
+         the STQ is allocated in program order. */
+      const int store_color = j;
+      int window = (store_color - STQ_head + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+      window = (window < STQ_num) ? window + 1 : 0;
+      if(window && (STQ[STQ_head].sta == NULL))
+        window--;
+      if(window > STQ_senior_num)
+        window = STQ_senior_num;
+      if(window && (STQ[store_color].sta->decode.uop_seq >= uop->decode.uop_seq))
+        window = 0;
+
+      int ld_mem_size = uop->decode.mem_size;
+      md_addr_t ld_addr1 = LDQ[uop->alloc.LDQ_index].virt_addr;
+      md_addr_t ld_addr2 = LDQ[uop->alloc.LDQ_index].virt_addr + ld_mem_size - 1;
+
+      /* only the stores that can overlap the load need to be checked, youngest first */
+      STQ_index->lookup(ld_addr1,ld_addr2,STQ_cands);
+      int num_cands = STQ_index->window(STQ_cands,store_color,window,true,STQ_order);
+      int k;
+
+      for(k=0;k<num_cands;k++)
       {
+        j = STQ_order[k];
+
         int st_mem_size = STQ[j].mem_size;
-        int ld_mem_size = uop->decode.mem_size;
         md_addr_t st_addr1 = STQ[j].virt_addr; /* addr of first byte */
         md_addr_t st_addr2 = STQ[j].virt_addr + st_mem_size - 1; /* addr of last byte */
-        md_addr_t ld_addr1 = LDQ[uop->alloc.LDQ_index].virt_addr;
-        md_addr_t ld_addr2 = LDQ[uop->alloc.LDQ_index].virt_addr + ld_mem_size - 1;
 
         if(STQ[j].addr_valid)
         {
@@ -1362,10 +1296,7 @@ void core_exec_DPM_t::LDST_exec(void)
           }
           else if((st_addr2 < ld_addr1) || (st_addr1 > ld_addr2)) /* no overlap */
           {
-            /* nothing to do */
-            #ifdef ZESTO_COUNTERS
-            core->counters->storeQ.read_tag++;
-            #endif
+            /* nothing to do (counted below) */
           }
           else /* partial match */
           {
@@ -1440,15 +1371,13 @@ void core_exec_DPM_t::LDST_exec(void)
             break;
           }
         }
-
-        num_stores++;
-
-        j=moddec(j,knobs->exec.STQ_size); //(j-1+knobs->exec.STQ_size) % knobs->exec.STQ_size;
-
-        cond1 = STQ[j].sta != NULL;
-        cond2 = cond1 && (STQ[j].sta->decode.uop_seq < uop->decode.uop_seq);
-        cond3 = (num_stores < STQ_senior_num);
       }
+
+      #ifdef ZESTO_COUNTERS
+      /* tag reads for the known, non-overlapping stores searched before stopping */
+      int searched = (k < num_cands) ? (store_color - STQ_order[k] + knobs->exec.STQ_size) % knobs->exec.STQ_size : window;
+      core->counters->storeQ.read_tag += searched - STQ_index->window(STQ_index->get_unknown(),store_color,searched,true,NULL);
+      #endif
     }
   }
 }
@@ -1747,6 +1676,7 @@ void core_exec_DPM_t::ALU_exec(void)
                 zesto_assert(!STQ[uop->alloc.STQ_index].addr_valid,(void)0);
                 STQ[uop->alloc.STQ_index].virt_addr = uop->oracle.virt_addr;
                 STQ[uop->alloc.STQ_index].addr_valid = true;
+                STQ_index->insert(uop->alloc.STQ_index,STQ[uop->alloc.STQ_index].virt_addr,STQ[uop->alloc.STQ_index].mem_size);
 
                 #ifdef ZESTO_COUNTERS
                 core->counters->storeQ.write_tag++; // addr tag
@@ -2303,6 +2233,9 @@ void core_exec_DPM_t::STQ_insert_sta(struct uop_t * const uop)
   STQ[STQ_tail].uop_seq = uop->decode.uop_seq;
   STQ[STQ_tail].next_load = LDQ_tail;
   uop->alloc.STQ_index = STQ_tail;
+  /* until the STA executes, disambiguation goes by the oracle address */
+  STQ_index->insert(STQ_tail,uop->oracle.virt_addr,uop->decode.mem_size);
+  STQ_index->set_unknown(STQ_tail,true);
   STQ_num++;
   STQ_senior_num++;
   STQ_tail = modinc(STQ_tail,knobs->exec.STQ_size); //(STQ_tail+1) % knobs->exec.STQ_size;
@@ -2420,6 +2353,7 @@ void core_exec_DPM_t::STQ_deallocate_senior(void)
   {
     STQ[STQ_senior_head].write_complete = false;
     STQ[STQ_senior_head].translation_complete = false;
+    STQ_index->remove(STQ_senior_head);
     STQ_senior_head = modinc(STQ_senior_head,knobs->exec.STQ_size); //(STQ_senior_head + 1) % knobs->exec.STQ_size;
     STQ_senior_num--;
     zesto_assert(STQ_senior_num >= 0,(void)0);
@@ -2434,6 +2368,7 @@ void core_exec_DPM_t::STQ_squash_sta(struct uop_t * const dead_uop)
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == NULL,(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].sta == dead_uop,(void)0);
   memzero(&STQ[dead_uop->alloc.STQ_index],sizeof(STQ[0]));
+  STQ_index->remove(dead_uop->alloc.STQ_index);
   STQ_num --;
   STQ_senior_num --;
   STQ_tail = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
@@ -2463,6 +2398,7 @@ void core_exec_DPM_t::STQ_squash_senior(void)
   {
     memzero(&STQ[STQ_senior_head],sizeof(*STQ));
     STQ[STQ_senior_head].action_id = core->new_action_id();
+    STQ_index->remove(STQ_senior_head);
 
     if((STQ_senior_head == STQ_head) && (STQ_num>0))
     {
@@ -12,15 +12,6 @@
 
 class core_exec_atom_t : public core_exec_t
 {
-  /* readyQ for scheduling */
-  struct readyQ_node_t {
-    struct uop_t * uop;
-    seq_t uop_seq; /* seq id of uop when inserted - for proper sorting even after uop recycled */
-    seq_t action_id;
-    tick_t when_assigned;
-    struct readyQ_node_t * next;
-  };
-
   /* struct for a squashable in-flight uop (for example, a uop making its way
      down an ALU pipeline).  Changing the original uop's tag will make the tags
      no longer match, thereby invalidating the in-flight action. */
@@ -86,10 +77,7 @@ class core_exec_atom_t : public core_exec_t
   virtual unsigned long long int get_load_latency(int LDQ_index);
 
   protected:
-  struct readyQ_node_t * readyQ_free_pool; /* for scheduling readyQ's */
-#ifdef DEBUG
-  int readyQ_free_pool_debt; /* for debugging memory leaks */
-#endif
+  class readyQ_t * readyQ; /* one readyQ per exec port */
 
   struct uop_t ** RS;
   int RS_num;
@@ -146,11 +134,15 @@ class core_exec_atom_t : public core_exec_t
   int STQ_senior_head;
   bool partial_forward_throttle; /* used to control load-issuing in the presence of partial-matching stores */
 
+  /* address index over the STQ, and scratch space for searching it */
+  class STQ_index_t * STQ_index;
+  qword_t * STQ_cands;
+  int * STQ_order;
+
   struct exec_port_t {
     struct uop_action_t * payload_pipe;
     int occupancy;
     struct ALU_t * FU[NUM_FU_CLASSES];
-    struct readyQ_node_t * readyQ;
     struct ALU_t * STQ; /* store-queue lookup/search pipeline for load execution */
     tick_t when_bypass_used; /* to make sure only one inst writes back per cycle, which
                                 could happen due to insts with different latencies */
@@ -162,8 +154,6 @@ class core_exec_atom_t : public core_exec_t
   struct memdep_t * memdep;
 
   /* various exec utility functions */
-  struct readyQ_node_t * get_readyQ_node(void);
-  void return_readyQ_node(struct readyQ_node_t * const p);
   bool check_load_issue_conditions(const struct uop_t * const uop);
   void snatch_back(struct uop_t * const replayed_uop);
 
@@ -191,10 +181,6 @@ class core_exec_atom_t : public core_exec_t
 /*******************/
 
 core_exec_atom_t::core_exec_atom_t(struct core_t * const arg_core):
-  readyQ_free_pool(NULL),
-#ifdef DEBUG
-  readyQ_free_pool_debt(0),
-#endif
   RS_num(0), RS_eff_num(0)
 {
   struct core_knobs_t * knobs = arg_core->knobs;
@@ -218,12 +204,19 @@ core_exec_atom_t::core_exec_atom_t(struct core_t * const arg_core):
   for(i=0;i<knobs->exec.STQ_size;i++)
     STQ[i].sta = NULL;
 
+  STQ_index = new STQ_index_t(knobs->exec.STQ_size);
+  STQ_cands = (qword_t*) calloc(STQ_index->num_words,sizeof(*STQ_cands));
+  STQ_order = (int*) calloc(knobs->exec.STQ_size,sizeof(*STQ_order));
+  if(!STQ_cands || !STQ_order)
+    fatal("couldn't calloc STQ search space");
+
   /************************************/
   /* execution port payload pipelines */
   /************************************/
   port = (core_exec_atom_t::exec_port_t*) calloc(knobs->exec.num_exec_ports,sizeof(*port));
   if(!port)
     fatal("couldn't calloc exec ports");
+  readyQ = new readyQ_t(knobs->exec.num_exec_ports,knobs->commit.ROB_size,knobs->exec.RS_size);
   for(i=0;i<knobs->exec.num_exec_ports;i++)
   {
     port[i].payload_pipe = (struct uop_action_t*) calloc(knobs->exec.payload_depth,sizeof(*port->payload_pipe));
@@ -438,41 +431,6 @@ void core_exec_atom_t::update_occupancy(void)
    necessarily executed).  However, that doesn't necessarily mean that the
    corresponding input *values* are "ready" due to non-zero schedule-to-
    execute latencies. */
-core_exec_atom_t::readyQ_node_t * core_exec_atom_t::get_readyQ_node(void)
-{
-  struct readyQ_node_t * p = NULL;
-  if(readyQ_free_pool)
-  {
-    p = readyQ_free_pool;
-    readyQ_free_pool = p->next;
-  }
-  else
-  {
-    p = (struct readyQ_node_t*) calloc(1,sizeof(*p));
-    if(!p)
-      fatal("couldn't calloc a readyQ node");
-  }
-  assert(p);
-  p->next = NULL;
-  p->when_assigned = core->sim_cycle;
-#ifdef DEBUG
-  readyQ_free_pool_debt++;
-#endif
-  return p;
-}
-
-void core_exec_atom_t::return_readyQ_node(struct readyQ_node_t * const p)
-{
-  assert(p);
-  assert(p->uop);
-  p->next = readyQ_free_pool;
-  readyQ_free_pool = p;
-  p->uop = NULL;
-  p->when_assigned = -1;
-#ifdef DEBUG
-  readyQ_free_pool_debt--;
-#endif
-}
 
 /* Add the uop to the corresponding readyQ (based on port binding - we maintain
    one readyQ per execution port) */
@@ -485,39 +443,9 @@ void core_exec_atom_t::insert_ready_uop(struct uop_t * const uop)
   zesto_assert(uop->timing.when_issued == TICK_T_MAX,(void)0);
   zesto_assert(!uop->exec.in_readyQ,(void)0);
 
-  struct readyQ_node_t ** RQ = &port[uop->alloc.port_assignment].readyQ;
-  struct readyQ_node_t * new_node = get_readyQ_node();
-  new_node->uop = uop;
-  new_node->uop_seq = uop->decode.uop_seq;
   uop->exec.in_readyQ = true;
   uop->exec.action_id = core->new_action_id();
-  new_node->action_id = uop->exec.action_id;
-
-  if(!*RQ) /* empty ready queue */
-  {
-    *RQ = new_node;
-    return;
-  }
-
-  struct readyQ_node_t * current = *RQ, * prev = NULL;
-
-  /* insert in age order: first find insertion point */
-  while(current && (current->uop_seq < uop->decode.uop_seq))
-  {
-    prev = current;
-    current = current->next;
-  }
-
-  if(!prev) /* uop is oldest */
-  {
-    new_node->next = *RQ;
-    *RQ = new_node;
-  }
-  else
-  {
-    new_node->next = current;
-    prev->next = new_node;
-  }
+  readyQ->insert(uop->alloc.port_assignment,uop,core->sim_cycle);
 }
 
 /*****************************/
@@ -1045,15 +973,21 @@ void core_exec_atom_t::ALU_exec(void)
             if(uop->decode.is_load) /* loads need to be processed differently */ 
             {
               /*Check the store buffer for a matching store. If found the uop completes else it waits for load_writeback() function to get completed*/
-              int j=STQ_head;
-              while(j!=STQ_tail && STQ[j].sta!=NULL )
+              /* The store buffer is searched oldest first, but only the
+                 stores that can overlap the load need to be looked at. */
+              int ld_mem_size = uop->decode.mem_size;
+              md_addr_t ld_addr1 = uop->oracle.virt_addr;
+              md_addr_t ld_addr2 = uop->oracle.virt_addr + ld_mem_size - 1;
+              int window = (STQ_num && (STQ[STQ_head].sta != NULL)) ? STQ_num : 0;
+
+              STQ_index->lookup(ld_addr1,ld_addr2,STQ_cands);
+              int num_cands = STQ_index->window(STQ_cands,STQ_head,window,false,STQ_order);
+              for(int k=0;k<num_cands;k++)
               {
+                int j = STQ_order[k];
                 int st_mem_size = STQ[j].mem_size;
-                int ld_mem_size = uop->decode.mem_size;
                 md_addr_t st_addr1 = STQ[j].virt_addr; /* addr of first byte */
                 md_addr_t st_addr2 = STQ[j].virt_addr + st_mem_size - 1; /* addr of last byte */
-                md_addr_t ld_addr1 = uop->oracle.virt_addr;
-                md_addr_t ld_addr2 = uop->oracle.virt_addr + ld_mem_size - 1;
            
                 if((st_addr1 <= ld_addr1) && (st_addr2 >= ld_addr2)) /* match */ 
                 {
@@ -1160,7 +1094,6 @@ void core_exec_atom_t::ALU_exec(void)
                     uop->exec.exec_complete =true;
                   }
                 }
-                j=modinc(j,knobs->exec.STQ_size);
               }/* End of the loop that searches the Store buffer for possible hits */  
               /* update load queue entry */
               if(FU->pipe[stage].load_received==true)
@@ -1215,6 +1148,7 @@ void core_exec_atom_t::ALU_exec(void)
                   zesto_assert(!STQ[uop->alloc.STQ_index].addr_valid,(void)0);
                   STQ[uop->alloc.STQ_index].virt_addr = uop->oracle.virt_addr;
                   STQ[uop->alloc.STQ_index].addr_valid = true;
+                  STQ_index->insert(uop->alloc.STQ_index,STQ[uop->alloc.STQ_index].virt_addr,STQ[uop->alloc.STQ_index].mem_size);
                   uop->exec.exec_complete =true;
 
                   #ifdef ZESTO_COUNTERS
@@ -1712,6 +1646,7 @@ void core_exec_atom_t::STQ_deallocate_senior(void)
     STQ[STQ_head].sta=NULL;
     STQ[STQ_head].std=NULL;
     STQ[STQ_head].value_valid = false;
+    STQ_index->remove(STQ_head);
     STQ_num --;
     STQ_head = modinc(STQ_head,knobs->exec.STQ_size); //(STQ_head+1) % knobs->exec.STQ_size;
 
@@ -1728,6 +1663,7 @@ void core_exec_atom_t::STQ_squash_sta(struct uop_t * const dead_uop)
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == NULL,(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].sta == dead_uop,(void)0);
   memzero(&STQ[dead_uop->alloc.STQ_index],sizeof(STQ[0]));
+  STQ_index->remove(dead_uop->alloc.STQ_index);
   STQ_num --;
   STQ_senior_num --;
   STQ_tail = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
@@ -1757,6 +1693,7 @@ void core_exec_atom_t::STQ_squash_senior(void)
   {
     memzero(&STQ[STQ_senior_head],sizeof(*STQ));
     STQ[STQ_senior_head].action_id = core->new_action_id();
+    STQ_index->remove(STQ_senior_head);
 
     if((STQ_senior_head == STQ_head) && (STQ_num>0))
     {
@@ -140,6 +140,7 @@ core_fetch_DPM_t::core_fetch_DPM_t(struct core_t * const arg_core):
       knobs->fetch.ras_opt_str,
       core
     );
+  open_bpred_trace();
 
   if(knobs->fetch.jeclear_delay)
   {
@@ -623,6 +624,7 @@ void core_fetch_DPM_t::step(void)
     byteQ[byteQ_index].num_Mop++;
 
     core->oracle->consume(Mop);
+    count_fetched(Mop);
 
     /* figure out where to fetch from next */
     if(Mop->decode.is_ctrl || Mop->fetch.inst.rep)  /* XXX: illegal use of decode information */
@@ -637,6 +639,7 @@ void core_fetch_DPM_t::step(void)
 
       bpred->spec_update(Mop->fetch.bpred_update,Mop->decode.opflags,
           Mop->fetch.PC,Mop->decode.targetPC,Mop->oracle.NextPC,Mop->fetch.bpred_update->our_pred);
+      trace_branch(Mop);
 
       /* Instructions that are unconditional branches can be evaluated at decode stage, 
          thus jeclears need to be sent back at decode stage (e.g. sysenter/sysexit).
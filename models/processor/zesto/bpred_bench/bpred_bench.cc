@@ -0,0 +1,185 @@
+/* bpred_bench.cc - replay a branch trace through a Zesto branch predictor
+ *
+ * Drives a bpred_t (direction predictors, fusion, BTBs and RAS) directly
+ * from a trace written with the core option -bpred:trace, so predictor
+ * configurations can be compared and tuned without running the whole
+ * core.  The configuration strings are the same as the core's.
+ *
+ * usage: bpred_bench [options] <trace>
+ *   -bpred <cfg>   direction predictor (repeat for hybrids; default 2bc:2bc:4096)
+ *   -fusion <cfg>  meta-predictor (default none)
+ *   -btb <cfg>     direct target predictor (default btac:BTB:512:4:8:l)
+ *   -ibtb <cfg>    indirect target predictor (default 2levbtac:iBTB:1:8:1:128:4:8:l)
+ *   -ras <cfg>     return address stack (default stack:RAS:16)
+ *   -delay <n>     branches between a lookup and its update (default 32)
+ *   -repeat <n>    replay the trace n times (default 1)
+ *
+ * The trace is read into memory first, so only the replay is timed.  A
+ * mispredicted branch is recovered right away, since the trace has no
+ * wrong-path branches; updates happen -delay branches later, standing in
+ * for the fetch-to-commit distance.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <vector>
+
+#include "zesto-core.h"
+#include "zesto-bpred.h"
+
+using namespace std;
+
+static void usage(const char * const prog)
+{
+  fprintf(stderr,"usage: %s [-bpred <cfg>]... [-fusion <cfg>] [-btb <cfg>] [-ibtb <cfg>] [-ras <cfg>] [-delay <n>] [-repeat <n>] <trace>\n",prog);
+  exit(1);
+}
+
+static double now_sec(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv,NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+struct inflight_t
+{
+  class bpred_state_cache_t * sc;
+  const struct bpred_trace_rec_t * rec;
+};
+
+int main(int argc, char ** argv)
+{
+  char * bpred_opts[MAX_HYBRID_BPRED];
+  int num_bpred = 0;
+  char * fusion_opt = (char*)"none";
+  char * btb_opt = (char*)"btac:BTB:512:4:8:l";
+  char * ibtb_opt = (char*)"2levbtac:iBTB:1:8:1:128:4:8:l";
+  char * ras_opt = (char*)"stack:RAS:16";
+  int delay = 32;
+  int repeat = 1;
+  const char * trace_name = NULL;
+
+  for(int i=1;i<argc;i++)
+  {
+    if(!strcmp(argv[i],"-bpred") && (i+1 < argc))
+    {
+      if(num_bpred == MAX_HYBRID_BPRED)
+        fatal("at most %d -bpred predictors",MAX_HYBRID_BPRED);
+      bpred_opts[num_bpred++] = argv[++i];
+    }
+    else if(!strcmp(argv[i],"-fusion") && (i+1 < argc))
+      fusion_opt = argv[++i];
+    else if(!strcmp(argv[i],"-btb") && (i+1 < argc))
+      btb_opt = argv[++i];
+    else if(!strcmp(argv[i],"-ibtb") && (i+1 < argc))
+      ibtb_opt = argv[++i];
+    else if(!strcmp(argv[i],"-ras") && (i+1 < argc))
+      ras_opt = argv[++i];
+    else if(!strcmp(argv[i],"-delay") && (i+1 < argc))
+      delay = atoi(argv[++i]);
+    else if(!strcmp(argv[i],"-repeat") && (i+1 < argc))
+      repeat = atoi(argv[++i]);
+    else if((argv[i][0] != '-') && !trace_name)
+      trace_name = argv[i];
+    else
+      usage(argv[0]);
+  }
+  if(!trace_name || (delay < 0) || (repeat < 1))
+    usage(argv[0]);
+  if(!num_bpred)
+    bpred_opts[num_bpred++] = (char*)"2bc:2bc:4096";
+
+  /* load the trace */
+  vector<struct bpred_trace_rec_t> trace;
+  zcounter_t insts = 0;
+  {
+    bpred_trace_t reader(trace_name,false);
+    struct bpred_trace_rec_t rec;
+    while(reader.read(&rec))
+    {
+      trace.push_back(rec);
+      insts += rec.insts;
+    }
+  }
+  if(trace.empty())
+    fatal("branch trace %s is empty",trace_name);
+
+  /* no core: the predictors skip the per-core power counters */
+  class bpred_t * bpred = new bpred_t(num_bpred,bpred_opts,fusion_opt,btb_opt,ibtb_opt,ras_opt,NULL);
+
+  /* ring of branches waiting for their update */
+  vector<struct inflight_t> window(delay+1);
+  int head = 0;
+  int num = 0;
+  zcounter_t lookups = 0;
+  zcounter_t cond = 0;
+  zcounter_t dir_misses = 0;
+  zcounter_t target_misses = 0;
+
+  double start = now_sec();
+  for(int r=0;r<repeat;r++)
+  {
+    for(size_t i=0;i<trace.size();i++)
+    {
+      const struct bpred_trace_rec_t * rec = &trace[i];
+      const md_addr_t fallthruPC = rec->PC + rec->len;
+      const bool taken = (rec->oraclePC != fallthruPC);
+
+      class bpred_state_cache_t * sc = bpred->get_state_cache();
+      const md_addr_t predPC = bpred->lookup(sc,rec->opflags,rec->PC,fallthruPC,rec->targetPC,rec->oraclePC,taken);
+      bpred->spec_update(sc,rec->opflags,rec->PC,rec->targetPC,rec->oraclePC,sc->our_pred);
+      lookups++;
+
+      if(rec->opflags & F_COND)
+      {
+        cond++;
+        if(sc->our_pred != taken)
+          dir_misses++;
+      }
+      if(predPC != rec->oraclePC)
+      {
+        target_misses++;
+        bpred->recover(sc,taken);
+      }
+
+      if(num == delay+1)
+      {
+        /* as in the core, updates see the actual next PC as the target */
+        struct inflight_t * old = &window[head];
+        bpred->update(old->sc,old->rec->opflags,old->rec->PC,old->rec->oraclePC,old->rec->oraclePC,
+                      old->rec->oraclePC != (old->rec->PC + old->rec->len));
+        bpred->return_state_cache(old->sc);
+        head = (head + 1) % (delay+1);
+        num--;
+      }
+      window[(head + num) % (delay+1)].sc = sc;
+      window[(head + num) % (delay+1)].rec = rec;
+      num++;
+    }
+  }
+  double elapsed = now_sec() - start;
+
+  while(num)
+  {
+    struct inflight_t * old = &window[head];
+    bpred->return_state_cache(old->sc);
+    head = (head + 1) % (delay+1);
+    num--;
+  }
+  delete bpred;
+
+  const double kinsts = (double)insts * repeat / 1000.0;
+  printf("trace             %s\n",trace_name);
+  printf("branches          %lld\n",(long long)lookups);
+  printf("conditional       %lld\n",(long long)cond);
+  printf("instructions      %.0f\n",kinsts*1000.0);
+  printf("direction misses  %lld (%.4f MPKI)\n",(long long)dir_misses,kinsts ? dir_misses/kinsts : 0.0);
+  printf("target misses     %lld (%.4f MPKI)\n",(long long)target_misses,kinsts ? target_misses/kinsts : 0.0);
+  printf("seconds           %.3f\n",elapsed);
+  printf("lookups/second    %.0f\n",elapsed > 0 ? lookups/elapsed : 0.0);
+
+  return 0;
+}
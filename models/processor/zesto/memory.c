@@ -120,6 +120,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 #include "host.h"
 #include "misc.h"
@@ -150,6 +153,12 @@ MEM_QWRITE(struct mem_t *mem, md_addr_t addr, qword_t val)
 }
 #endif /* TARGET_HAS_UNALIGNED_QWORD */
 
+bool mem_huge_pages = false;
+long long mem_max_core_pages = 0;
+
+/* size of the simulated (32-bit) virtual address space */
+#define MEM_ARENA_SIZE (1ULL << 32)
+
 /* create a flat memory space */
   struct mem_t *
 mem_create(char *name)			/* name of the memory space */
@@ -161,9 +170,50 @@ mem_create(char *name)			/* name of the memory space */
     fatal("out of virtual memory");
 
   mem->name = mystrdup(name);
+
+  if(!mem_max_core_pages)
+  {
+    /* reserve the whole address space up front; nothing is committed
+       until a page is first touched, and the host hands us zeroed pages */
+    void * arena = mmap(NULL, MEM_ARENA_SIZE, PROT_READ|PROT_WRITE,
+                        MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+    if(arena == MAP_FAILED)
+      warn("couldn't reserve sparse memory for %s; allocating pages individually",name);
+    else
+    {
+      mem->arena = (byte_t*) arena;
+#ifdef MADV_HUGEPAGE
+      if(mem_huge_pages && madvise(arena, MEM_ARENA_SIZE, MADV_HUGEPAGE))
+        warnonce("huge pages not available for simulated memory");
+#endif
+    }
+  }
   return mem;
 }
 
+/* return the pte for ADDR, allocating its leaf table if necessary */
+static inline struct mem_pte_t * mem_get_pte(struct mem_t * mem, md_addr_t addr)
+{
+  struct mem_pte_t * leaf = mem->ptab[MEM_PTAB_L1(addr)];
+  if(!leaf)
+  {
+    leaf = (struct mem_pte_t*) calloc(MEM_PTAB_L2_SIZE, sizeof(struct mem_pte_t));
+    if(!leaf)
+      fatal("out of virtual memory");
+    mem->ptab[MEM_PTAB_L1(addr)] = leaf;
+  }
+  return &leaf[MEM_PTAB_L2(addr)];
+}
+
+/* return the pte for ADDR, or NULL if the page is not mapped */
+static inline struct mem_pte_t * mem_find_pte(struct mem_t * mem, md_addr_t addr)
+{
+  struct mem_pte_t * leaf = mem->ptab[MEM_PTAB_L1(addr)];
+  if(leaf && leaf[MEM_PTAB_L2(addr)].valid)
+    return &leaf[MEM_PTAB_L2(addr)];
+  return NULL;
+}
+
 static inline void recency_list_insert(struct mem_t * mem, struct mem_pte_t * pte)
 {
 
@@ -191,19 +241,14 @@ static inline void recency_list_remove(struct mem_t * mem, struct mem_pte_t * pt
 
 /*************************************************************/
 /* The following code is for supporting the simulation of
-   multiple, large virtual memory spaces.  Since the simulator
-   itself is only operating out of a 32-bit space, emulating
-   multiple 32-bit spaces can obviously run out of room.  So we
-   manually page the emulated virtual memory spaces to disk. */
+   multiple, large virtual memory spaces on a host that cannot
+   hold them all in core.  By default every memory space is a
+   sparse arena and the host's own virtual memory does the work;
+   setting mem_max_core_pages caps the number of pages in core
+   (for all simulated memory) and manually pages the emulated
+   virtual memory spaces to disk. */
 /*************************************************************/
-static qword_t num_core_pages = 0;
-/* assume a max of 1.5GB for all simulated memory (this is real memory
-   used by the simulator to simulate *all* of the virtual memory for
-   all processes/threads.  We manually page stuff to disk to keep
-   this under control.  Otherwise there's no way we can simulate 16
-   (or more?) processes' worth of virtual memory in our own measly
-   32-bit address sapce. */
-static const qword_t max_core_pages = ((1<<30)+(1<<29))/MD_PAGE_SIZE; /* use 1.5GB for memory pages */
+static long long num_core_pages = 0;
 static int num_locked_pages = 0; /* num mmaped pages that we don't write to backing file */
 static struct mem_page_link_t * page_free_list = NULL;
 static struct mem_page_link_t * link_free_list = NULL;
@@ -343,21 +388,31 @@ static void read_core_from_backing_file(struct mem_t * mem, struct mem_pte_t * p
    backing file information. */
 void wipe_memory(struct mem_t * mem)
 {
-  int i;
-  for(i=0; i< MEM_PTAB_SIZE; i++)
+  int i, j;
+
+  /* drop the arena's pages; the host zero-fills them again on next touch */
+  if(mem->arena && madvise(mem->arena, MEM_ARENA_SIZE, MADV_DONTNEED))
+    fatal("couldn't reset simulated memory for %s",mem->name);
+
+  for(i=0; i< MEM_PTAB_L1_SIZE; i++)
   {
-    struct mem_pte_t * pte = mem->ptab[i];
+    struct mem_pte_t * leaf = mem->ptab[i];
+    if(!leaf)
+      continue;
 
-    while(pte)
+    for(j=0; j< MEM_PTAB_L2_SIZE; j++)
     {
-      if(pte->page)
+      struct mem_pte_t * pte = &leaf[j];
+      if(!pte->valid)
+        continue;
+
+      if(pte->page && !(mem->arena && !pte->no_dealloc))
         //memset(pte->page,0,MD_PAGE_SIZE);
         clear_page(pte->page);
       pte->backing_offset = -1;
       pte->dirty = TRUE; /* need to mark dirty to ensure that this
                             zero'd page gets written back to disk
                             (same as mem_newpage). */
-      pte = pte->next;
     }
   }
   if(mem->backing_file)
@@ -373,98 +428,120 @@ void wipe_memory(struct mem_t * mem)
    different cores/processes will be a little more distributed (more
    realistic), which also helps to reduce pathological aliasing
    effects (e.g., having all N cores' stacks map to the same exact
-   cache sets). */
-static md_paddr_t next_ppn_to_allocate = 0x00000100; /* arbitrary starting point; NOTE: this is a page number, not a page starting address */
-#define V2P_HASH_SIZE 65536
-#define V2P_HASH_MASK (V2P_HASH_SIZE-1)
-struct v2p_node_t {
-  int thread_id;
-  md_addr_t vpn; /* virtual page number */
-  md_paddr_t ppn; /* physical page number */
-  struct v2p_node_t * next;
-  struct v2p_node_t * p2v_next; /* for linking the p2v table */
-};
-
-static struct v2p_node_t *v2p_hash_table[V2P_HASH_SIZE];
-static struct v2p_node_t *p2v_list_head = NULL;
+   cache sets).
+
+   Each thread has its own radix table (same shape as the page
+   table) mapping virtual page numbers to physical page numbers.
+   Since physical pages are handed out sequentially, the owner of a
+   physical page is kept in a directly-indexed table of chunks.
+   Lookups don't lock; a miss allocates under v2p_lock and publishes
+   the owner before the translation, so any physical page number
+   that can be seen has its owner filled in.  Tables are never
+   freed or moved, so cores running on different host threads can
+   call these concurrently. */
+#define V2P_FIRST_PPN 0x00000100 /* arbitrary starting point; NOTE: this is a page number, not a page starting address */
+#define V2P_MAX_THREADS 4096
+#define P2V_LOG_CHUNK_SIZE 16
+#define P2V_CHUNK_SIZE (1 << P2V_LOG_CHUNK_SIZE)
+#define P2V_MAX_CHUNKS 4096 /* 2^28 physical pages */
+
+static pthread_mutex_t v2p_lock = PTHREAD_MUTEX_INITIALIZER;
+static md_paddr_t next_ppn_to_allocate = V2P_FIRST_PPN;
+
+/* per-thread tables: L1 entries point to leaves of MEM_PTAB_L2_SIZE
+   physical page numbers (0 if not yet allocated) */
+static md_paddr_t ** v2p_tables[V2P_MAX_THREADS];
+
+/* owner thread id + 1 of each physical page (0 if not allocated) */
+static int * p2v_owner[P2V_MAX_CHUNKS];
 
 md_paddr_t v2p_translate(int thread_id, md_addr_t virt_addr)
 {
-  md_addr_t VPN = virt_addr >> PAGE_SHIFT;
-  int index = VPN & (V2P_HASH_SIZE-1);
-  struct v2p_node_t * p = v2p_hash_table[index], * prev = NULL;
+  md_paddr_t ** table, * leaf, ppn = 0;
 
-  while(p)
-  {
-    if((p->thread_id == thread_id) && (p->vpn == VPN))
-    {
-      /* hit! */
-      break;
-    }
-    prev = p;
-    p = p->next;
-  }
+  if((thread_id < 0) || (thread_id >= V2P_MAX_THREADS))
+    fatal("v2p_translate: thread id %d out of range (max %d)",thread_id,V2P_MAX_THREADS-1);
 
-  if(!p) /* page miss: allocate a new physical page */
+  table = __atomic_load_n(&v2p_tables[thread_id], __ATOMIC_ACQUIRE);
+  if(table)
   {
-    p = (struct v2p_node_t*) calloc(1,sizeof(*p));
-    if(!p)
-      fatal("couldn't calloc a new page table entry");
-    p->thread_id = thread_id;
-    p->vpn = VPN;
-    p->ppn = next_ppn_to_allocate++;
-    p->next = v2p_hash_table[index];
-
-    p->p2v_next = p2v_list_head;
-    p2v_list_head = p;
-
-    v2p_hash_table[index] = p;
+    leaf = __atomic_load_n(&table[MEM_PTAB_L1(virt_addr)], __ATOMIC_ACQUIRE);
+    if(leaf)
+      ppn = __atomic_load_n(&leaf[MEM_PTAB_L2(virt_addr)], __ATOMIC_ACQUIRE);
   }
-  else if(prev)
+
+  if(!ppn) /* page miss: allocate a new physical page */
   {
-    /* move p to the front of the list (MRU) */
-    prev->next = p->next;
-    p->next = v2p_hash_table[index];
-    v2p_hash_table[index] = p;
+    pthread_mutex_lock(&v2p_lock);
+
+    table = v2p_tables[thread_id];
+    if(!table)
+    {
+      table = (md_paddr_t**) calloc(MEM_PTAB_L1_SIZE, sizeof(*table));
+      if(!table)
+        fatal("couldn't calloc a new page table");
+      __atomic_store_n(&v2p_tables[thread_id], table, __ATOMIC_RELEASE);
+    }
+    leaf = table[MEM_PTAB_L1(virt_addr)];
+    if(!leaf)
+    {
+      leaf = (md_paddr_t*) calloc(MEM_PTAB_L2_SIZE, sizeof(*leaf));
+      if(!leaf)
+        fatal("couldn't calloc a new page table entry");
+      __atomic_store_n(&table[MEM_PTAB_L1(virt_addr)], leaf, __ATOMIC_RELEASE);
+    }
+
+    ppn = leaf[MEM_PTAB_L2(virt_addr)];
+    if(!ppn) /* still a miss now that we hold the lock */
+    {
+      md_paddr_t idx = next_ppn_to_allocate - V2P_FIRST_PPN;
+      int * chunk;
+
+      if((idx >> P2V_LOG_CHUNK_SIZE) >= P2V_MAX_CHUNKS)
+        fatal("v2p_translate: out of simulated physical pages");
+      chunk = p2v_owner[idx >> P2V_LOG_CHUNK_SIZE];
+      if(!chunk)
+      {
+        chunk = (int*) calloc(P2V_CHUNK_SIZE, sizeof(*chunk));
+        if(!chunk)
+          fatal("couldn't calloc a new physical page owner table");
+        __atomic_store_n(&p2v_owner[idx >> P2V_LOG_CHUNK_SIZE], chunk, __ATOMIC_RELEASE);
+      }
+      __atomic_store_n(&chunk[idx & (P2V_CHUNK_SIZE-1)], thread_id + 1, __ATOMIC_RELEASE);
+
+      ppn = next_ppn_to_allocate++;
+      __atomic_store_n(&leaf[MEM_PTAB_L2(virt_addr)], ppn, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&v2p_lock);
   }
 
   /* construct the final physical page number */
-  return (p->ppn << PAGE_SHIFT) + (virt_addr & (PAGE_SIZE-1));
+  return (ppn << PAGE_SHIFT) + (virt_addr & (PAGE_SIZE-1));
 }
 
 /* Inverse lookup: given a physical page, returns the core-id of
-   the owner.  TODO: put into separate hash table. */
+   the owner. */
 int page_owner(md_paddr_t paddr)
 {
   md_paddr_t PPN = paddr >> PAGE_SHIFT;
-  int tid = -1, hit = 0;
-  struct v2p_node_t * p = p2v_list_head, * prev = NULL;
+  md_paddr_t idx;
+  int * chunk;
+  int owner;
 
-  while(p)
-  {
-    if(p->ppn == PPN)
-    {
-      tid = p->thread_id;
-      hit = 1;
-      break;
-    }
-    prev = p;
-    p = p->p2v_next;
-  }
-
-  /* hit, move to front of list */
-  if(hit && prev)
-  {
-    /* move p to the front of the list (MRU) */
-    prev->p2v_next = p->p2v_next;
-    p->p2v_next = p2v_list_head;
-    p2v_list_head = p;
-  }
+  if(PPN < V2P_FIRST_PPN)
+    return DO_NOT_TRANSLATE;
+  idx = PPN - V2P_FIRST_PPN;
+  if((idx >> P2V_LOG_CHUNK_SIZE) >= P2V_MAX_CHUNKS)
+    return DO_NOT_TRANSLATE;
 
-  if(hit)
-    return tid;
-  else
+  chunk = __atomic_load_n(&p2v_owner[idx >> P2V_LOG_CHUNK_SIZE], __ATOMIC_ACQUIRE);
+  if(!chunk)
     return DO_NOT_TRANSLATE;
+  owner = __atomic_load_n(&chunk[idx & (P2V_CHUNK_SIZE-1)], __ATOMIC_ACQUIRE);
+  if(!owner)
+    return DO_NOT_TRANSLATE;
+  return owner - 1;
 }
 
 
@@ -477,52 +554,40 @@ mem_translate(struct mem_t *mem,	/* memory space to access */
     md_addr_t addr,		/* virtual address to translate */
     int dirty) /* mark this page as dirty */
 {
-  struct mem_pte_t *pte, *prev;
-
   /* locate accessed PTE */
-  for (prev=NULL, pte=mem->ptab[MEM_PTAB_SET(addr)];
-      pte != NULL;
-      prev=pte, pte=pte->next)
-  {
-    if (pte->tag == MEM_PTAB_TAG(addr))
-    {
-      /* move this PTE to head of the bucket list */
-      if (prev)
-      {
-        prev->next = pte->next;
-        pte->next = mem->ptab[MEM_PTAB_SET(addr)];
-        mem->ptab[MEM_PTAB_SET(addr)] = pte;
-      }
+  struct mem_pte_t *pte = mem_find_pte(mem,addr);
 
-      if(!pte->page)
-      {
-        /* make room if necessary */
-        if(max_core_pages && (num_core_pages >= max_core_pages))
-          write_core_to_backing_file(mem,pte->addr);
-        /* page in from disk */
-        read_core_from_backing_file(mem,pte);
-      }
-      else
-      {
-        /* update recency list */
-        assert(pte->lru_prev || (mem->recency_mru == pte));
-        assert(pte->lru_next || (mem->recency_lru == pte));
-      }
-
-      if(mem->recency_mru != pte) /* don't need to move if alreayd in mru position */
-      {
-        recency_list_remove(mem,pte);
-        recency_list_insert(mem,pte);
-      }
+  /* no translation found, return NULL */
+  if(!pte)
+    return NULL;
 
-      pte->dirty |= dirty;
+  if(mem_max_core_pages)
+  {
+    if(!pte->page)
+    {
+      /* make room if necessary */
+      if(num_core_pages >= mem_max_core_pages)
+        write_core_to_backing_file(mem,pte->addr);
+      /* page in from disk */
+      read_core_from_backing_file(mem,pte);
+    }
+    else
+    {
+      /* update recency list */
+      assert(pte->lru_prev || (mem->recency_mru == pte));
+      assert(pte->lru_next || (mem->recency_lru == pte));
+    }
 
-      return pte->page;
+    if(mem->recency_mru != pte) /* don't need to move if alreayd in mru position */
+    {
+      recency_list_remove(mem,pte);
+      recency_list_insert(mem,pte);
     }
   }
 
-  /* no translation found, return NULL */
-  return NULL;
+  pte->dirty |= dirty;
+
+  return pte->page;
 }
 
 /* allocate a memory page */
@@ -533,43 +598,80 @@ mem_newpage(struct mem_t *mem,		/* memory space to allocate in */
   byte_t *page = NULL;
   struct mem_pte_t *pte;
 
-  if(max_core_pages && (num_core_pages >= max_core_pages))
-    write_core_to_backing_file(mem,addr);
-
-  /* see if we have any spare pages lying around */
-  struct mem_page_link_t * pl = page_free_list;
-  if(pl)
+  if(mem->arena)
   {
-    page_free_list = pl->next;
-    page = pl->page;
-    pl->page = NULL;
-    pl->next = link_free_list;
-    link_free_list = pl;
+    /* the page already exists in the arena (and reads as zero) */
+    page = mem->arena + (addr & ~(MD_PAGE_SIZE-1));
   }
-  else /* if not, alloc a new one */
+  else
   {
-    posix_memalign((void**)&page,MD_PAGE_SIZE,MD_PAGE_SIZE);
-    if(!page)
-      fatal("failed to calloc memory page");
-    clear_page(page);
+    if(mem_max_core_pages && (num_core_pages >= mem_max_core_pages))
+      write_core_to_backing_file(mem,addr);
+
+    /* see if we have any spare pages lying around */
+    struct mem_page_link_t * pl = page_free_list;
+    if(pl)
+    {
+      page_free_list = pl->next;
+      page = pl->page;
+      pl->page = NULL;
+      pl->next = link_free_list;
+      link_free_list = pl;
+    }
+    else /* if not, alloc a new one */
+    {
+      posix_memalign((void**)&page,MD_PAGE_SIZE,MD_PAGE_SIZE);
+      if(!page)
+        fatal("failed to calloc memory page");
+      clear_page(page);
+    }
+    *page = 0; /* touch the page */
   }
-  *page = 0; /* touch the page */
 
-  /* generate a new PTE */
-  pte = (struct mem_pte_t*) calloc(1, sizeof(struct mem_pte_t));
-  if (!pte)
-    fatal("out of virtual memory");
-  pte->tag = MEM_PTAB_TAG(addr);
+  /* fill in the PTE */
+  pte = mem_get_pte(mem,addr);
+  assert(!pte->valid);
+  pte->valid = TRUE;
   pte->addr = addr;
   pte->page = page;
   pte->backing_offset = -1;
   pte->dirty = TRUE;
 
-  /* insert PTE into inverted hash table */
-  pte->next = mem->ptab[MEM_PTAB_SET(addr)];
-  mem->ptab[MEM_PTAB_SET(addr)] = pte;
+  if(mem_max_core_pages)
+    recency_list_insert(mem,pte);
 
-  recency_list_insert(mem,pte);
+  /* one more page allocated */
+  mem->page_count++;
+  num_core_pages++;
+}
+
+/* map the page at virtual address ADDR onto host memory PAGE, which is
+   never paged out or reclaimed */
+static void
+mem_map_locked_page(struct mem_t *mem,
+    md_addr_t addr,
+    byte_t *page,
+    int mmap)
+{
+  struct mem_pte_t *pte;
+
+  /* make room if necessary */
+  if(mem_max_core_pages && (num_core_pages >= mem_max_core_pages))
+    write_core_to_backing_file(mem,addr);
+
+  /* fill in the PTE */
+  pte = mem_get_pte(mem,addr);
+  assert(!pte->valid);
+  pte->valid = TRUE;
+  pte->addr = addr;
+  pte->page = page;
+  pte->from_mmap_syscall = mmap;
+  pte->backing_offset = -1;
+  pte->no_dealloc = TRUE;
+  num_locked_pages++;
+
+  if(mem_max_core_pages)
+    recency_list_insert(mem,pte);
 
   /* one more page allocated */
   mem->page_count++;
@@ -590,7 +692,6 @@ mem_newmap(struct mem_t *mem,            /* memory space to access */
   int num_pages;
   int i;
   md_addr_t comp_addr;
-  struct mem_pte_t *pte;
   /* first check alignment */
   if((addr & (MD_PAGE_SIZE-1))!=0) {
     fprintf(stderr, "mem_newmap address %x, not page aligned\n", addr);
@@ -610,31 +711,7 @@ mem_newmap(struct mem_t *mem,            /* memory space to access */
       continue;
     }
 
-    /* make room if necessary */
-    if(max_core_pages && (num_core_pages >= max_core_pages))
-      write_core_to_backing_file(mem,comp_addr);
-
-    /* generate a new PTE */
-    pte = (struct mem_pte_t*) calloc(1, sizeof(struct mem_pte_t));
-    if (!pte)
-      fatal("out of virtual memory");
-    pte->tag = MEM_PTAB_TAG(comp_addr);
-    pte->addr = addr;
-    pte->page = (byte_t*) comp_addr;
-    pte->from_mmap_syscall = mmap;
-    pte->backing_offset = -1;
-    pte->no_dealloc = TRUE;
-    num_locked_pages++;
-
-    /* insert PTE into inverted hash table */
-    pte->next = mem->ptab[MEM_PTAB_SET(comp_addr)];
-    mem->ptab[MEM_PTAB_SET(comp_addr)] = pte;
-
-    recency_list_insert(mem,pte);
-
-    /* one more page allocated */
-    mem->page_count++;
-    num_core_pages++;
+    mem_map_locked_page(mem, comp_addr, (byte_t*) comp_addr, mmap);
   }
   return addr;
 
@@ -653,7 +730,6 @@ mem_newmap2(struct mem_t *mem,            /* memory space to access */
   int num_pages;
   int i;
   md_addr_t comp_addr;
-  struct mem_pte_t *pte;
   /* first check alignment */
   if((addr & (MD_PAGE_SIZE-1))!=0) {
     fprintf(stderr, "mem_newmap address %x, not page aligned\n", addr);
@@ -676,31 +752,7 @@ mem_newmap2(struct mem_t *mem,            /* memory space to access */
       continue;
     }
 
-    /* make room if necessary */
-    if(max_core_pages && (num_core_pages >= max_core_pages))
-      write_core_to_backing_file(mem,comp_addr);
-
-    /* generate a new PTE */
-    pte = (struct mem_pte_t*) calloc(1, sizeof(struct mem_pte_t));
-    if (!pte)
-      fatal("out of virtual memory");
-    pte->tag = MEM_PTAB_TAG(comp_addr);
-    pte->addr = addr;
-    pte->page = (byte_t*) our_addr + i * MD_PAGE_SIZE;
-    pte->from_mmap_syscall = mmap;
-    pte->backing_offset = -1;
-    pte->no_dealloc = TRUE;
-    num_locked_pages++;
-
-    /* insert PTE into inverted hash table */
-    pte->next = mem->ptab[MEM_PTAB_SET(comp_addr)];
-    mem->ptab[MEM_PTAB_SET(comp_addr)] = pte;
-
-    recency_list_insert(mem,pte);
-
-    /* one more page allocated */
-    mem->page_count++;
-    num_core_pages++;
+    mem_map_locked_page(mem, comp_addr, (byte_t*) our_addr + i * MD_PAGE_SIZE, mmap);
   }
   return addr;
 
@@ -719,7 +771,7 @@ mem_delmap(struct mem_t *mem,            /* memory space to access */
   int num_pages;
   int i;
   md_addr_t comp_addr = addr;
-  struct mem_pte_t *temp, *before_temp = NULL;
+  struct mem_pte_t *pte;
 
   /* first check alignment */
   if((addr & (MD_PAGE_SIZE-1))!=0) {
@@ -729,45 +781,24 @@ mem_delmap(struct mem_t *mem,            /* memory space to access */
 
   num_pages = length / MD_PAGE_SIZE + ((length % MD_PAGE_SIZE>0)? 1 : 0);
   for(i=0;i<num_pages;i++) {
-    /* check if pages already allocated */
     comp_addr = addr+i*MD_PAGE_SIZE;
-    int set = MEM_PTAB_SET(comp_addr);
+    pte = mem_find_pte(mem, comp_addr);
 
-    if(!MEM_PAGE(mem, comp_addr, 0)) {
+    if(!pte || !pte->from_mmap_syscall) {
       // this is OK -- pin does this all the time.
       continue;
     }
 
-    for (temp = mem->ptab[set] ; temp ; before_temp = temp, temp = temp->next)
-    {
-      if ((temp->tag == MEM_PTAB_TAG(comp_addr) && temp->from_mmap_syscall))
-      {
-        if (before_temp)
-        {
-          before_temp->next = temp->next;
-        }
-        else
-        {
-          mem->ptab[set] = temp->next;
-        }
-
-        recency_list_remove(mem,temp);
-
-        temp->page = NULL;
-        temp->next = NULL;
-        temp->from_mmap_syscall = FALSE;
-        assert(temp->no_dealloc);
-        temp->no_dealloc = FALSE;
-        temp->tag = (md_addr_t)NULL;
-        num_locked_pages--;
-        free( temp );
-
-        /* one less page allocated */
-        mem->page_count--;
-
-        break;
-      }
-    }
+    if(mem_max_core_pages)
+      recency_list_remove(mem,pte);
+
+    assert(pte->no_dealloc);
+    memset(pte, 0, sizeof(*pte));
+    num_locked_pages--;
+    num_core_pages--;
+
+    /* one less page allocated */
+    mem->page_count--;
   }
 }
 // <--- 
@@ -861,7 +892,7 @@ mem_init(struct mem_t *mem)	/* memory space to initialize */
   int i;
 
   /* initialize the first level page table to all empty */
-  for (i=0; i < MEM_PTAB_SIZE; i++)
+  for (i=0; i < MEM_PTAB_L1_SIZE; i++)
     mem->ptab[i] = NULL;
 
   mem->page_count = 0;
@@ -134,9 +134,12 @@ extern "C" {
 #include "options.h"
 #include "stats.h"
 
-/* number of entries in page translation hash table (must be power-of-two) */
-#define MEM_PTAB_SIZE    (256*1024)
-#define MEM_LOG_PTAB_SIZE  18
+/* two-level radix page table indexed by the virtual page number; the
+   leaf level covers 4MB of the (32-bit) simulated address space */
+#define MEM_LOG_PTAB_L2_SIZE  10
+#define MEM_LOG_PTAB_L1_SIZE  (32 - MD_LOG_PAGE_SIZE - MEM_LOG_PTAB_L2_SIZE)
+#define MEM_PTAB_L1_SIZE      (1 << MEM_LOG_PTAB_L1_SIZE)
+#define MEM_PTAB_L2_SIZE      (1 << MEM_LOG_PTAB_L2_SIZE)
 #define MAX_LEV                 3
 
 
@@ -165,8 +168,7 @@ enum mem_cmd {
 
 /* page table entry */
 struct mem_pte_t {
-  struct mem_pte_t *next;  /* next translation in this bucket */
-  md_addr_t tag;    /* virtual page number tag */
+  int valid;        /* is this virtual page mapped? */
   md_addr_t addr;   /* virtual address */
   int dirty;         /* has this page been modified? */
   byte_t *page;      /* page pointer */
@@ -189,7 +191,12 @@ struct mem_page_link_t {
 struct mem_t {
   /* memory object state */
   char *name;        /* name of this memory space */
-  struct mem_pte_t *ptab[MEM_PTAB_SIZE];/* inverted page table */
+  struct mem_pte_t *ptab[MEM_PTAB_L1_SIZE];/* radix page table; each entry is
+                                               NULL or an array of
+                                               MEM_PTAB_L2_SIZE pte's */
+  byte_t * arena; /* sparse reservation of the whole address space; pages are
+                     zero-filled by the host on first touch (NULL when
+                     paging to a backing file) */
   FILE * backing_file; /* disk file for storing memory image */
   off_t backing_file_tail; /* offset to allocate next page to */
   struct mem_pte_t * recency_lru; /* oldest (LRU) */
@@ -213,18 +220,16 @@ typedef enum md_fault_type
  * virtual to host page translation macros
  */
 
-/* compute page table set */
-#define MEM_PTAB_SET(ADDR)            \
-  (((ADDR) >> MD_LOG_PAGE_SIZE) & (MEM_PTAB_SIZE - 1))
+/* compute first-level page table index */
+#define MEM_PTAB_L1(ADDR)            \
+  ((ADDR) >> (MD_LOG_PAGE_SIZE + MEM_LOG_PTAB_L2_SIZE))
 
-/* compute page table tag */
-#define MEM_PTAB_TAG(ADDR)            \
-  ((ADDR) >> (MD_LOG_PAGE_SIZE + MEM_LOG_PTAB_SIZE))
+/* compute second-level page table index */
+#define MEM_PTAB_L2(ADDR)            \
+  (((ADDR) >> MD_LOG_PAGE_SIZE) & (MEM_PTAB_L2_SIZE - 1))
 
-/* convert a pte entry at idx to a block address */
-#define MEM_PTE_ADDR(PTE, IDX)            \
-  (((PTE)->tag << (MD_LOG_PAGE_SIZE + MEM_LOG_PTAB_SIZE))    \
-   | ((IDX) << MD_LOG_PAGE_SIZE))
+/* convert a pte entry to a block address */
+#define MEM_PTE_ADDR(PTE)  ((PTE)->addr & ~(MD_PAGE_SIZE - 1))
 
 /* locate host page for virtual address ADDR, returns NULL if unallocated */
 #define MEM_PAGE(MEM, ADDR, DIRTY)  mem_translate((MEM), (ADDR), (DIRTY))
@@ -241,10 +246,12 @@ typedef enum md_fault_type
       mem_newpage(MEM, ADDR))            \
     : (/* nada... */ (void)0)))            
 
-/* memory page iterator */
+/* memory page iterator (ITER runs over all virtual page numbers) */
 #define MEM_FORALL(MEM, ITER, PTE)          \
-  for ((ITER)=0; (ITER) < MEM_PTAB_SIZE; (ITER)++)      \
-    for ((PTE)=(MEM)->ptab[(ITER)]; (PTE) != NULL; (PTE)=(PTE)->next)
+  for ((ITER)=0; (ITER) < MEM_PTAB_L1_SIZE * MEM_PTAB_L2_SIZE; (ITER)++)      \
+    if (((PTE)=((MEM)->ptab[(ITER) >> MEM_LOG_PTAB_L2_SIZE]      \
+            ? &(MEM)->ptab[(ITER) >> MEM_LOG_PTAB_L2_SIZE][(ITER) & (MEM_PTAB_L2_SIZE-1)] \
+            : NULL)) == NULL || !(PTE)->valid) ; else
 
 
 /*
@@ -327,6 +334,13 @@ void MEM_QWRITE(struct mem_t *mem, md_addr_t addr, qword_t val);
 #endif
 #endif /* HOST_HAS_QWORD */
 
+/* simulated memory backing, set by the core options before mem_create:
+   mem_huge_pages asks the host to back the arena with huge pages, and a
+   non-zero mem_max_core_pages disables the arena and instead keeps at most
+   that many pages in core, paging the rest out to a backing file */
+extern bool mem_huge_pages;
+extern long long mem_max_core_pages;
+
 /* create a flat memory space */
 struct mem_t *
 mem_create(char *name);      /* name of the memory space */
@@ -433,7 +447,8 @@ mem_bcopy(
     int nbytes);      /* number of bytes to access */
 
 
-/* maps each (core-id,virtual-address) pair to a simulated physical address */
+/* maps each (core-id,virtual-address) pair to a simulated physical address;
+   this and page_owner may be called concurrently from different threads */
 md_paddr_t v2p_translate(int core_id, md_addr_t virt_addr);
 /* given a physical address, return the corresponding core-id */
 int page_owner(md_paddr_t paddr);
@@ -82,6 +82,13 @@ qsimproxy:: ~qsimproxy()
 }
 
 
+void qsimproxy::set_writer_done()
+{
+    for (int i = 0; i < shm_buffers.size(); i++)
+        shm_buffers[i]->set_writer_done();
+}
+
+
 void qsimproxy::get_inst()
 {
     inst_count = 0;
@@ -96,6 +103,7 @@ cerr << "... filling up shm\n";
 	        int rc = m_Qsim_client[i]->run(cpu_id[i], RUN_COUNT);
 	        if(rc == 0 && m_Qsim_client[i]->booted(cpu_id[i]) == false) {//no more instructions
                     cerr << "cpu " << cpu_id[i] << " out of insn fetching next pc\n";
+                    set_writer_done();
                     return;
 	        }
 	        if (cpu_id[i] == 0) {
@@ -108,10 +116,7 @@ cerr << "... filling up shm\n";
 	        }	
 		
 	        //write the content in m_Qsim_queue to shared memory buffers
-	        while (!m_Qsim_queue[i]->empty() && !shm_buffers[i]->is_full()) {
-		    shm_buffers[i]->write( m_Qsim_queue[i]->front() );
-		    m_Qsim_queue[i]->pop();
-	        }
+	        shm_buffers[i]->write_from(*m_Qsim_queue[i]);
 		if (shm_buffers[i]->is_full()) {
 cout << "shm for cpu " << cpu_id[i] << " is full = " << shm_buffers[i]->get_buf_num_entries() << "\n";
                     full_count++;
@@ -144,7 +149,7 @@ cout << "shm for cpu " << cpu_id[i] << " is full = " << shm_buffers[i]->get_buf_
 
 		if(rc == 0 && m_Qsim_client[i]->booted(cpu_id[i]) == false) {//no more instructions
                     cerr << "cpu " << cpu_id[i] << " out of insn fetching next pc\n";
-                    //???????????????? need to be changed to writer_done to all buffer
+                    set_writer_done();
                     return;
 		}
 		if (cpu_id[i] == 0) {
@@ -159,12 +164,7 @@ cout << "shm for cpu " << cpu_id[i] << " is full = " << shm_buffers[i]->get_buf_
 	    }
 
 	    //write the content in m_Qsim_queue to shared memory buffers
-	    while ( !m_Qsim_queue[i]->empty() && !shm_buffers[i]->is_full()) {
-		//cout<<"writing inst to shm buffer!!"<<endl;
-		shm_buffers[i]->write( m_Qsim_queue[i]->front() );
-		m_Qsim_queue[i]->pop();
-                //shm_buffers[i]->dbg_print();
-	    }    
+	    shm_buffers[i]->write_from(*m_Qsim_queue[i]);
 	}	
 
 	if (need_a_rest) {
@@ -39,6 +39,7 @@ public:
 #ifndef PROXY_TEST
 protected:
 #endif
+    void set_writer_done(); //tell all cores no more instructions are coming
  
 #ifndef PROXY_TEST
 private:
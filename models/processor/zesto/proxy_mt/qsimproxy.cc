@@ -130,6 +130,7 @@ cerr << "... thread " << idx << " filling up shm\n";
 	int rc = m_Qsim_client[idx]->run(cpu_id[idx], RUN_COUNT);
 	if(rc == 0 && m_Qsim_client[idx]->booted(cpu_id[idx]) == false) {//no more instructions
 	    cerr << "cpu " << cpu_id[idx] << " out of insn fetching next pc\n";
+	    shm_buffers[idx]->set_writer_done();
 	    return;
 	}
 	if (cpu_id[idx] == 0) {
@@ -142,10 +143,7 @@ cerr << "... thread " << idx << " filling up shm\n";
 	}
 
 	//write the content in m_Qsim_queue to shared memory buffers
-	while (!m_Qsim_queue[idx]->empty() && !shm_buffers[idx]->is_full()) {
-	    shm_buffers[idx]->write( m_Qsim_queue[idx]->front() );
-	    m_Qsim_queue[idx]->pop();
-	}
+	shm_buffers[idx]->write_from(*m_Qsim_queue[idx]);
 	if (shm_buffers[idx]->is_full()) {
             cout << "shm for cpu " << cpu_id[idx] << " is full = " << shm_buffers[idx]->get_buf_num_entries() << "\n";
 	}
@@ -166,7 +164,7 @@ cerr << "... thread " << idx << " filling up shm\n";
 
 	    if(rc == 0 && m_Qsim_client[idx]->booted(cpu_id[idx]) == false) {//no more instructions
                 cerr << "cpu " << cpu_id[idx] << " out of insn fetching next pc\n";
-                //???????????????? need to be changed to writer_done to all buffer
+                shm_buffers[idx]->set_writer_done();
                 return;
 	    }
 
@@ -182,16 +180,10 @@ cerr << "... thread " << idx << " filling up shm\n";
 	}
 
 	//write the content in m_Qsim_queue to shared memory buffers
-	while ( !m_Qsim_queue[idx]->empty() && !shm_buffers[idx]->is_full()) {
-	    //cout<<"writing inst to shm buffer!!"<<endl;
-	    shm_buffers[idx]->write( m_Qsim_queue[idx]->front() );
-	    m_Qsim_queue[idx]->pop();
-            //shm_buffers[i]->dbg_print();
-	}    
-
-    usleep(1);
-	if (need_a_rest) {
-	    usleep(10);
+	shm_buffers[idx]->write_from(*m_Qsim_queue[idx]);
+
+	if (need_a_rest) { //sleep until the core has used up half of the buffer
+	    shm_buffers[idx]->wait_writable(shm_buffers[idx]->get_buf_max_entries()/2, 1000);
         }
     }//end of while 
 #if 0
@@ -30,10 +30,12 @@ qsimproxy_core_t::qsimproxy_core_t(const int core_id, char * config, int cpuid,
 
 qsimproxy_core_t:: ~qsimproxy_core_t()
 {
+    delete m_shm;
 }
 
 
 #define RUN_COUNT 1
+#define RUN_TIMEOUT_US 50000 //how long run() waits for the proxy
 
 //! @return  True if interrupt is seen.
 bool qsimproxy_core_t::fetch_next_pc(md_addr_t *nextPC, struct core_t * tcore)
@@ -42,26 +44,27 @@ bool qsimproxy_core_t::fetch_next_pc(md_addr_t *nextPC, struct core_t * tcore)
     qsimproxy_core_t* core = dynamic_cast<qsimproxy_core_t*>(tcore);
     assert(core != 0);
 
-    list<Qsim::QueueItem> *q_ptr = &(core->m_q); 
+    SharedMemBuffer* shm = core->m_shm;
     bool interrupt=false;
 
     while(true) {
-	if(!q_ptr->empty()) {
-	    if (q_ptr->front().cb_type == Qsim::QueueItem::INST_CB) {
-		*nextPC = q_ptr->front().data.inst_cb.vaddr;
+	const Qsim::QueueItem* item = shm->peek(); //read in place
+	if(item) {
+	    if (item->cb_type == Qsim::QueueItem::INST_CB) {
+		*nextPC = item->data.inst_cb.vaddr;
 		break;
 	    }
-	    else if(q_ptr->front().cb_type == Qsim::QueueItem::INT_CB) {
+	    else if(item->cb_type == Qsim::QueueItem::INT_CB) {
 #ifdef ZDEBUG
 if(sim_cycle> PRINT_CYCLE)
 fprintf(stdout,"\n[%lld][Core%d]Interrupt seen in md_fetch_next_PC",core->sim_cycle,core->id);
 #endif
 		interrupt=true;
-		q_ptr->pop_front();
+		shm->pop();
 	    }
-	    else if(q_ptr->front().cb_type == Qsim::QueueItem::MEM_CB) {	
+	    else if(item->cb_type == Qsim::QueueItem::MEM_CB) {	
 		//should this happen?
-	        q_ptr->pop_front();
+	        shm->pop();
 	    }
 	}
         else { //queue empty
@@ -90,10 +93,12 @@ void qsimproxy_core_t::fetch_inst(md_inst_t *inst, struct mem_t *mem, const md_a
     qsimproxy_core_t* core = dynamic_cast<qsimproxy_core_t*>(tcore);
     assert(core != 0);
 
-    list<Qsim::QueueItem> *q_ptr = &(core->m_q); 
+    SharedMemBuffer* shm = core->m_shm;
+    const Qsim::QueueItem* item;
 
     while(true) {
-	if(q_ptr->empty()) {
+	item = shm->peek(); //read in place
+	if(item == 0) {
 	    int rc = run(RUN_COUNT);
 	    if(rc == 0 && m_shm->is_writer_done() == true) {//no more instructions
 	        cerr << "cpu " << core->m_Qsim_cpuid << " out of insn\n";
@@ -103,38 +108,38 @@ void qsimproxy_core_t::fetch_inst(md_inst_t *inst, struct mem_t *mem, const md_a
 	    }
         }
 	else  {
-	    if (q_ptr->front().cb_type == Qsim::QueueItem::INST_CB) {
+	    if (item->cb_type == Qsim::QueueItem::INST_CB) {
 #ifdef ZDEBUG
-fprintf(stdout,"\n[%lld][Core%d]Trace DequeuedPC: 0x%llx   ",core->sim_cycle,core->id,q_ptr->front().data.inst_cb.vaddr);
+fprintf(stdout,"\n[%lld][Core%d]Trace DequeuedPC: 0x%llx   ",core->sim_cycle,core->id,item->data.inst_cb.vaddr);
 #endif
 		core->current_thread->insn_count++;
-		assert(q_ptr->front().data.inst_cb.len <= MD_MAX_ILEN); //size of inst->code[] is MD_MAX_ILEN
+		assert(item->data.inst_cb.len <= MD_MAX_ILEN); //size of inst->code[] is MD_MAX_ILEN
 
-	        for (unsigned i = 0; i < q_ptr->front().data.inst_cb.len; i++) {
-		    inst->code[i] = q_ptr->front().data.inst_cb.bytes[i]; 
+	        for (unsigned i = 0; i < item->data.inst_cb.len; i++) {
+		    inst->code[i] = item->data.inst_cb.bytes[i]; 
 	        }
-	        inst->vaddr=q_ptr->front().data.inst_cb.vaddr;
-	        inst->paddr=q_ptr->front().data.inst_cb.paddr;
-	        inst->qemu_len=q_ptr->front().data.inst_cb.len;
+	        inst->vaddr=item->data.inst_cb.vaddr;
+	        inst->paddr=item->data.inst_cb.paddr;
+	        inst->qemu_len=item->data.inst_cb.len;
 	        inst->mem_ops.mem_vaddr_ld[0]=0;
 	        inst->mem_ops.mem_vaddr_ld[1]=0;
 	        inst->mem_ops.mem_vaddr_str[0]=0;
 	        inst->mem_ops.mem_vaddr_str[1]=0;
 	        inst->mem_ops.memops=0;
 	    }
-	    else if (q_ptr->front().cb_type == Qsim::QueueItem::INT_CB) { //interrupt
-		q_ptr->pop_front(); //ignore interrupt
+	    else if (item->cb_type == Qsim::QueueItem::INT_CB) { //interrupt
+		shm->pop(); //ignore interrupt
 		continue;
 	    }
 	    else {
 		fprintf(stdout, "Memory Op found while looking for an instruction!\n");
-		q_ptr->pop_front(); //ignore this
+		shm->pop(); //ignore this
 		continue;
 	    }
 
-	    q_ptr->pop_front();
+	    shm->pop();
 
-	    if(q_ptr->empty()) {
+	    if(shm->peek() == 0) {
 	        int rc = run(RUN_COUNT);
 		if(rc == 0 && m_shm->is_writer_done() == true) {//no more instructions
 		    cerr << "cpu " << core->m_Qsim_cpuid << " out of insn getting mem op\n";
@@ -145,46 +150,46 @@ fprintf(stdout,"\n[%lld][Core%d]Trace DequeuedPC: 0x%llx   ",core->sim_cycle,cor
 	    }
 
 	    //Process the memory ops following the instruction.
-	    while (q_ptr->front().cb_type == Qsim::QueueItem::MEM_CB) {
+	    while ((item = shm->peek()) != 0 && item->cb_type == Qsim::QueueItem::MEM_CB) {
     
-	        if(q_ptr->front().data.mem_cb.type==MEM_RD) { //read
+	        if(item->data.mem_cb.type==MEM_RD) { //read
 		    if(inst->mem_ops.mem_vaddr_ld[0]==0) {
-			inst->mem_ops.mem_vaddr_ld[0]=q_ptr->front().data.mem_cb.vaddr;
-			inst->mem_ops.mem_paddr_ld[0]=q_ptr->front().data.mem_cb.paddr;
+			inst->mem_ops.mem_vaddr_ld[0]=item->data.mem_cb.vaddr;
+			inst->mem_ops.mem_paddr_ld[0]=item->data.mem_cb.paddr;
 			inst->mem_ops.ld_dequeued[0]=false;
-			inst->mem_ops.ld_size[0]=q_ptr->front().data.mem_cb.size;
+			inst->mem_ops.ld_size[0]=item->data.mem_cb.size;
 			inst->mem_ops.memops++;
 		    }
 		    else if(inst->mem_ops.mem_vaddr_ld[1]==0) {
-		      inst->mem_ops.mem_vaddr_ld[1]=q_ptr->front().data.mem_cb.vaddr;
-		      inst->mem_ops.mem_paddr_ld[1]=q_ptr->front().data.mem_cb.paddr;
+		      inst->mem_ops.mem_vaddr_ld[1]=item->data.mem_cb.vaddr;
+		      inst->mem_ops.mem_paddr_ld[1]=item->data.mem_cb.paddr;
 		      inst->mem_ops.ld_dequeued[1]=false;
-		      inst->mem_ops.ld_size[1]=q_ptr->front().data.mem_cb.size;
+		      inst->mem_ops.ld_size[1]=item->data.mem_cb.size;
 		      inst->mem_ops.memops++;
 		    }
 		}
-	        else if(q_ptr->front().data.mem_cb.type==MEM_WR) {
+	        else if(item->data.mem_cb.type==MEM_WR) {
 		    if(inst->mem_ops.mem_vaddr_str[0]==0) {
-		        inst->mem_ops.mem_vaddr_str[0]=q_ptr->front().data.mem_cb.vaddr;
-		        inst->mem_ops.mem_paddr_str[0]=q_ptr->front().data.mem_cb.paddr;
+		        inst->mem_ops.mem_vaddr_str[0]=item->data.mem_cb.vaddr;
+		        inst->mem_ops.mem_paddr_str[0]=item->data.mem_cb.paddr;
 		        inst->mem_ops.str_dequeued[0]=false;
-		        inst->mem_ops.str_size[0]=q_ptr->front().data.mem_cb.size;
+		        inst->mem_ops.str_size[0]=item->data.mem_cb.size;
 		        inst->mem_ops.memops++;
 		    }
 		    else if(inst->mem_ops.mem_vaddr_str[1]==0) {
-		        inst->mem_ops.mem_vaddr_str[1]=q_ptr->front().data.mem_cb.vaddr;
-		        inst->mem_ops.mem_paddr_str[1]=q_ptr->front().data.mem_cb.paddr;
+		        inst->mem_ops.mem_vaddr_str[1]=item->data.mem_cb.vaddr;
+		        inst->mem_ops.mem_paddr_str[1]=item->data.mem_cb.paddr;
 		        inst->mem_ops.str_dequeued[1]=false;
-		        inst->mem_ops.str_size[1]=q_ptr->front().data.mem_cb.size;
+		        inst->mem_ops.str_size[1]=item->data.mem_cb.size;
 		        inst->mem_ops.memops++;
 		    }
 	        }
 		else
 		    assert(0);
 
-	        q_ptr->pop_front();
+	        shm->pop();
 
-	        if(q_ptr->empty())
+	        if(shm->peek() == 0)
 		    run(RUN_COUNT);
 	    }//while MEM ops
 	    break; //got one complete instruction
@@ -194,27 +199,15 @@ fprintf(stdout,"\n[%lld][Core%d]Trace DequeuedPC: 0x%llx   ",core->sim_cycle,cor
 }
 
 
-//return actual number of instructions read
+//! Wait for the proxy to make at least count items available; the wait
+//! spins briefly, then sleeps until the proxy writes.
+//! @return  Number of items available; 0 if none arrived in time.
 int qsimproxy_core_t :: run(int count)
 {
-//cout << "run() called, count= " << count << endl;
-    Qsim::QueueItem item(0);
-
-    int cnt = 0;
-    while(cnt < count) {
-        if(m_shm->is_empty()) {
-	    cout << "buffer is empty\n";
-	    usleep(50000); //0.05s
-	    break;
-	}
-	item = m_shm->read();
-	//cout << "run() got an item\n";
-	//item.print();
-	cnt++;
-	m_q.push_back(item);
-    }
-
-    return cnt;
+    unsigned avail = m_shm->wait_readable(count, RUN_TIMEOUT_US);
+    if(avail == 0 && !m_shm->is_writer_done())
+        cout << "buffer is empty\n";
+    return avail;
 }
 
 
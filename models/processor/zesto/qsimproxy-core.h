@@ -33,8 +33,7 @@ protected:
  
 private:
     const int m_Qsim_cpuid; //QSim cpu ID. In general this is different from core_id.
-    SharedMemBuffer* m_shm;
-    std::list<Qsim::QueueItem> m_q; //instruction queue
+    SharedMemBuffer* m_shm; //instruction queue; items are used in place
 };
 
 
@@ -6,10 +6,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <assert.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 #include "shm.h"
 
@@ -17,16 +23,25 @@ using namespace std;
 using namespace Qsim;
 
 
+//number of times a waiting side checks the other side's index before it sleeps
+#define SHM_SPIN_COUNT 4096
+
+static inline void cpu_relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+}
+
+
 //#########################################################################
 //#########################################################################
 //! First 2 parameters are used to create the shared mem segment.
 //! size is the size of the segment in bytes.
 SharedMemBuffer :: SharedMemBuffer(char* fn, char id, unsigned size)
 {
-    const unsigned SHARED_VAR_BYTES = 12; //number of bytes reserved for shared variables; must be multiple of 4
-
     assert(id != 0);
-    assert(size > SHARED_VAR_BYTES);
+    assert(size > sizeof(Control));
 
     //ensure size is power of 2.
     int i = 0;
@@ -38,9 +53,14 @@ SharedMemBuffer :: SharedMemBuffer(char* fn, char id, unsigned size)
 	exit(1);
     }
 
-
-    m_MAX_ENTRIES = (size - SHARED_VAR_BYTES) / sizeof(QueueItem);
+    //the number of entries is rounded down to a power of 2 so an index can be
+    //turned into a slot with a mask
+    unsigned entries = (size - sizeof(Control)) / sizeof(QueueItem);
+    m_MAX_ENTRIES = 1;
+    while ((unsigned)m_MAX_ENTRIES * 2 <= entries)
+        m_MAX_ENTRIES *= 2;
     assert(m_MAX_ENTRIES > 1);
+    m_mask = m_MAX_ENTRIES - 1;
 
 
     //create the shared mem segment
@@ -62,50 +82,34 @@ SharedMemBuffer :: SharedMemBuffer(char* fn, char id, unsigned size)
         exit(1);
     }
 
-    //shared mem layout
+    //shared mem layout (the segment is page aligned)
     //   ------------------------------
-    //   |                            |
-    //   |         data entries       |
-    //   |                            |
-    //   ------------------------------
-    //   |       head (4 bytes)       |
+    //   | head, head_seq,            |
+    //   | reader_waiting (64 bytes)  |
     //   ------------------------------
-    //   |       tail (4 bytes)       |
+    //   | tail, tail_seq,            |
+    //   | writer_waiting (64 bytes)  |
     //   ------------------------------
-    //   |  head wrap count (1 byte)  |
+    //   | termination flag (64 bytes)|
     //   ------------------------------
-    //   |  tail wrap count (1 byte)  |
-    //   ------------------------------
-    //   |  termination flag (1 byte) |
-    //   ------------------------------
-    //   |      unused (1 byte)       |
+    //   |                            |
+    //   |  data entries (power of 2) |
+    //   |                            |
     //   ------------------------------
     //
-    //set up the pointers
-    int position = size - SHARED_VAR_BYTES;
-    m_head_ptr = (int32_t*)(&m_shm[position]);
-    position += sizeof(int32_t);
-
-    m_tail_ptr = (int32_t*)(&m_shm[position]);
-    position += sizeof(int32_t);
-
-    m_head_wrap_count_ptr = (int8_t*)&m_shm[position];
-    position += sizeof(int8_t);
-
-    m_tail_wrap_count_ptr = (int8_t*)&m_shm[position];
-    position += sizeof(int8_t);
-
-    m_term_flag_ptr = (uint8_t*)&m_shm[position];
-    position += sizeof(uint8_t);
-
-    //m_item_array = (QueueItem*)m_shm;
+    m_ctrl = (Control*)m_shm;
+    m_item_array = (QueueItem*)&m_shm[sizeof(Control)];
 
-    cout << "m_shm= " << m_shm << endl;
+    m_head = m_tail_cache = 0;
+    m_tail = m_head_cache = m_published_tail = 0;
+    m_writer = m_reader = false;
 }
 
 
 SharedMemBuffer :: ~SharedMemBuffer()
 {
+    if(m_reader)
+        publish_tail(m_tail);
     if(shmdt(m_shm) == -1) {
         perror("shmdt()");
         exit(1);
@@ -117,117 +121,349 @@ SharedMemBuffer :: ~SharedMemBuffer()
 //=========================================================================
 void SharedMemBuffer :: writer_init()
 {
-    *m_head_ptr = 0;
-    *m_tail_ptr = 0;
-    *m_head_wrap_count_ptr = 0;
-    *m_tail_wrap_count_ptr = 0;
-    *m_term_flag_ptr = 0;
+    memset(m_ctrl, 0, sizeof(Control));
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    m_head = m_tail_cache = 0;
+    m_writer = true;
 }
 
 //=========================================================================
 //=========================================================================
 void SharedMemBuffer :: reader_init()
 {
-    *m_tail_ptr = 0;
-    *m_tail_wrap_count_ptr = 0;
+    m_tail = m_head_cache = m_published_tail = 0;
+    m_reader = true;
+    publish_tail(0);
 }
 
+
 //=========================================================================
 //=========================================================================
+//! Index of the next item to be written. The writer knows its own value; any
+//! other user sees what the writer has published.
+uint64_t SharedMemBuffer :: get_head()
+{
+    if(m_writer)
+        return m_head;
+    return __atomic_load_n(&m_ctrl->head, __ATOMIC_ACQUIRE);
+}
+
+//! Index of the next item to be read.
+uint64_t SharedMemBuffer :: get_tail()
+{
+    if(m_reader)
+        return m_tail;
+    return __atomic_load_n(&m_ctrl->tail, __ATOMIC_ACQUIRE);
+}
+
+
 bool SharedMemBuffer :: is_full()
 {
-    return (get_head() == get_tail() && get_head_wrap_count() != get_tail_wrap_count());
+    return get_head() - get_tail() == (uint64_t)m_MAX_ENTRIES;
 }
 
 
-//=========================================================================
-//=========================================================================
 bool SharedMemBuffer :: is_empty()
 {
-    return (get_head() == get_tail() && get_head_wrap_count() == get_tail_wrap_count());
+    return get_head() == get_tail();
+}
+
+
+int SharedMemBuffer :: get_buf_num_entries()
+{
+    return (int)(get_head() - get_tail());
+}
+
+
+bool SharedMemBuffer :: is_writer_done()
+{
+    return __atomic_load_n(&m_ctrl->term_flag, __ATOMIC_ACQUIRE) != 0;
+}
+
+
+void SharedMemBuffer :: set_writer_done()
+{
+    __atomic_store_n(&m_ctrl->term_flag, 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    wake(&m_ctrl->head_seq, &m_ctrl->reader_waiting);
 }
 
 
 //=========================================================================
+// Sleeping and waking
 //=========================================================================
-int SharedMemBuffer :: get_buf_num_entries()
+
+//! Sleep until *word no longer holds val, the other side wakes us, or the
+//! timeout (in microseconds; negative for none) expires. The caller must have
+//! set *waiting and re-checked its condition after a full fence.
+void SharedMemBuffer :: sleep_on(volatile uint32_t* word, uint32_t val, volatile uint32_t* waiting, int timeout_us)
 {
-    int num = get_head() - get_tail();
-    if(num < 0)
-        num += m_MAX_ENTRIES;
-    else if(num == 0) {
-        if(is_full())
-	    num = m_MAX_ENTRIES;
+#ifdef __linux__
+    struct timespec ts;
+    struct timespec* tsp = 0;
+    if(timeout_us >= 0) {
+        ts.tv_sec = timeout_us / 1000000;
+        ts.tv_nsec = (timeout_us % 1000000) * 1000;
+        tsp = &ts;
+    }
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, val, tsp, 0, 0);
+#else
+    usleep(timeout_us >= 0 && timeout_us < 50 ? timeout_us : 50);
+#endif
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+}
+
+void SharedMemBuffer :: wake(volatile uint32_t* word, volatile uint32_t* waiting)
+{
+    if(__atomic_load_n(waiting, __ATOMIC_SEQ_CST)) {
+        __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+#ifdef __linux__
+        syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, 1, 0, 0, 0);
+#endif
     }
-    return num;
 }
 
 
 //=========================================================================
+// Writer
 //=========================================================================
+void SharedMemBuffer :: publish_head(uint64_t head)
+{
+    __atomic_store_n(&m_ctrl->head, head, __ATOMIC_RELEASE);
+    //the exchange orders this store before the load of the waiting flag
+    __atomic_exchange_n(&m_ctrl->head_seq, (uint32_t)head, __ATOMIC_SEQ_CST);
+    wake(&m_ctrl->head_seq, &m_ctrl->reader_waiting);
+}
+
+
+//! Returns the first free slot in place; n is set to the number of free slots
+//! that follow it without wrapping around.
+QueueItem* SharedMemBuffer :: write_span(unsigned* n)
+{
+    uint64_t free = m_MAX_ENTRIES - (m_head - m_tail_cache);
+    if(free == 0) {
+        m_tail_cache = __atomic_load_n(&m_ctrl->tail, __ATOMIC_ACQUIRE);
+        free = m_MAX_ENTRIES - (m_head - m_tail_cache);
+    }
+    uint64_t slot = m_head & m_mask;
+    uint64_t contiguous = m_MAX_ENTRIES - slot;
+    *n = (unsigned)(free < contiguous ? free : contiguous);
+    return &m_item_array[slot];
+}
+
+
+//! Make the next n slots, filled in place, visible to the reader.
+void SharedMemBuffer :: commit(unsigned n)
+{
+    assert(m_head + n - m_tail_cache <= (uint64_t)m_MAX_ENTRIES);
+    m_head += n;
+    publish_head(m_head);
+}
+
+
 void SharedMemBuffer :: write(QueueItem& item)
 {
-    if(is_full()) {
+    unsigned n;
+    QueueItem* slot = write_span(&n);
+    if(n == 0) {
         cerr << "Attemp to write when SHM is full!\n";
 	exit(1);
     }
+    memcpy(slot, &item, sizeof(QueueItem));
+    commit(1);
+}
+
 
-    int pos = get_head() * sizeof(QueueItem);
-    memcpy(&m_shm[pos], &item, sizeof(QueueItem));
-    head_inc();
+//! Copy up to n items into the buffer.
+//! @return  Number of items written.
+unsigned SharedMemBuffer :: write_n(const QueueItem* items, unsigned n)
+{
+    unsigned done = 0;
+    while(done < n) {
+        unsigned avail;
+        QueueItem* slot = write_span(&avail);
+        if(avail == 0)
+            break;
+        if(avail > n - done)
+            avail = n - done;
+        memcpy(slot, &items[done], avail * sizeof(QueueItem));
+        done += avail;
+        m_head += avail;
+    }
+    if(done > 0)
+        publish_head(m_head);
+    return done;
 }
 
 
-//=========================================================================
-//=========================================================================
-void SharedMemBuffer :: head_inc()
-{
-    int head = *m_head_ptr;
-    head++;
-    if(head >= m_MAX_ENTRIES) {
-        head = 0;
-	//toggle head wrap count
-	if(*m_head_wrap_count_ptr == 0)
-	    *m_head_wrap_count_ptr = 1;
-	else
-	    *m_head_wrap_count_ptr = 0;
+//! Wait until at least min slots are free or the timeout (microseconds;
+//! negative for none) expires.
+//! @return  Number of free slots.
+unsigned SharedMemBuffer :: wait_writable(unsigned min, int timeout_us)
+{
+    assert(min <= (unsigned)m_MAX_ENTRIES);
+    for(int spin = 0; ; spin++) {
+        m_tail_cache = __atomic_load_n(&m_ctrl->tail, __ATOMIC_ACQUIRE);
+        unsigned free = m_MAX_ENTRIES - (unsigned)(m_head - m_tail_cache);
+        if(free >= min)
+            return free;
+
+        if(spin < SHM_SPIN_COUNT) {
+            cpu_relax();
+            continue;
+        }
+        if(timeout_us == 0)
+            return free;
+
+        uint32_t seq = __atomic_load_n(&m_ctrl->tail_seq, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&m_ctrl->writer_waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        m_tail_cache = __atomic_load_n(&m_ctrl->tail, __ATOMIC_ACQUIRE);
+        free = m_MAX_ENTRIES - (unsigned)(m_head - m_tail_cache);
+        if(free >= min) {
+            __atomic_store_n(&m_ctrl->writer_waiting, 0, __ATOMIC_RELAXED);
+            return free;
+        }
+        sleep_on(&m_ctrl->tail_seq, seq, &m_ctrl->writer_waiting, timeout_us);
+        if(timeout_us > 0) { //one sleep only
+            m_tail_cache = __atomic_load_n(&m_ctrl->tail, __ATOMIC_ACQUIRE);
+            return m_MAX_ENTRIES - (unsigned)(m_head - m_tail_cache);
+        }
     }
-    *m_head_ptr = head;
 }
 
 
 //=========================================================================
+// Reader
 //=========================================================================
+void SharedMemBuffer :: publish_tail(uint64_t tail)
+{
+    m_published_tail = tail;
+    __atomic_store_n(&m_ctrl->tail, tail, __ATOMIC_RELEASE);
+    //the exchange orders this store before the load of the waiting flag
+    __atomic_exchange_n(&m_ctrl->tail_seq, (uint32_t)tail, __ATOMIC_SEQ_CST);
+    wake(&m_ctrl->tail_seq, &m_ctrl->writer_waiting);
+}
+
+
+//! Returns the next unread item in place; n is set to the number of unread
+//! items that follow it without wrapping around.
+const QueueItem* SharedMemBuffer :: read_span(unsigned* n)
+{
+    uint64_t avail = m_head_cache - m_tail;
+    if(avail == 0) {
+        m_head_cache = __atomic_load_n(&m_ctrl->head, __ATOMIC_ACQUIRE);
+        avail = m_head_cache - m_tail;
+    }
+    uint64_t slot = m_tail & m_mask;
+    uint64_t contiguous = m_MAX_ENTRIES - slot;
+    *n = (unsigned)(avail < contiguous ? avail : contiguous);
+    return &m_item_array[slot];
+}
+
+
+//! Release the next n items. Their slots are handed back to the writer in
+//! batches: once an eighth of the buffer has been consumed, or when the reader
+//! has used up all the items it knows of.
+void SharedMemBuffer :: consume(unsigned n)
+{
+    assert(m_tail + n <= m_head_cache);
+    m_tail += n;
+    if(m_tail - m_published_tail >= (uint64_t)(m_MAX_ENTRIES >> 3) || m_tail == m_head_cache)
+        publish_tail(m_tail);
+}
+
+
+const QueueItem* SharedMemBuffer :: peek()
+{
+    unsigned n;
+    const QueueItem* item = read_span(&n);
+    return n > 0 ? item : 0;
+}
+
+
+void SharedMemBuffer :: pop()
+{
+    consume(1);
+}
+
+
 QueueItem SharedMemBuffer :: read()
 {
-    if(is_empty()) {
+    unsigned n;
+    const QueueItem* slot = read_span(&n);
+    if(n == 0) {
         cerr << "Attemp to read when SHM is empty!\n";
 	exit(1);
     }
 
-    int pos = get_tail() * sizeof(QueueItem);
     QueueItem item(0);
-    memcpy(&item, &m_shm[pos], sizeof(QueueItem));
-    tail_inc();
+    memcpy(&item, slot, sizeof(QueueItem));
+    consume(1);
     return item;
 }
 
 
-//=========================================================================
-//=========================================================================
-void SharedMemBuffer :: tail_inc()
-{
-    int tail = *m_tail_ptr;
-    tail++;
-    if(tail >= m_MAX_ENTRIES) {
-        tail = 0;
-	//toggle tail wrap count
-	if(*m_tail_wrap_count_ptr == 0)
-	    *m_tail_wrap_count_ptr = 1;
-	else
-	    *m_tail_wrap_count_ptr = 0;
+//! Copy up to n items out of the buffer.
+//! @return  Number of items read.
+unsigned SharedMemBuffer :: read_n(QueueItem* items, unsigned n)
+{
+    unsigned done = 0;
+    while(done < n) {
+        unsigned avail;
+        const QueueItem* slot = read_span(&avail);
+        if(avail == 0)
+            break;
+        if(avail > n - done)
+            avail = n - done;
+        memcpy(&items[done], slot, avail * sizeof(QueueItem));
+        done += avail;
+        m_tail += avail;
+    }
+    if(done > 0)
+        publish_tail(m_tail);
+    return done;
+}
+
+
+//! Wait until at least min items can be read, the writer is done, or the
+//! timeout (microseconds; negative for none) expires.
+//! @return  Number of items that can be read.
+unsigned SharedMemBuffer :: wait_readable(unsigned min, int timeout_us)
+{
+    assert(min <= (unsigned)m_MAX_ENTRIES);
+    //let the writer have everything consumed so far before waiting on it
+    if(m_published_tail != m_tail)
+        publish_tail(m_tail);
+
+    for(int spin = 0; ; spin++) {
+        m_head_cache = __atomic_load_n(&m_ctrl->head, __ATOMIC_ACQUIRE);
+        unsigned avail = (unsigned)(m_head_cache - m_tail);
+        if(avail >= min || is_writer_done())
+            return avail;
+
+        if(spin < SHM_SPIN_COUNT) {
+            cpu_relax();
+            continue;
+        }
+        if(timeout_us == 0)
+            return avail;
+
+        uint32_t seq = __atomic_load_n(&m_ctrl->head_seq, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&m_ctrl->reader_waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        m_head_cache = __atomic_load_n(&m_ctrl->head, __ATOMIC_ACQUIRE);
+        avail = (unsigned)(m_head_cache - m_tail);
+        if(avail >= min || is_writer_done()) {
+            __atomic_store_n(&m_ctrl->reader_waiting, 0, __ATOMIC_RELAXED);
+            return avail;
+        }
+        sleep_on(&m_ctrl->head_seq, seq, &m_ctrl->reader_waiting, timeout_us);
+        if(timeout_us > 0) { //one sleep only
+            m_head_cache = __atomic_load_n(&m_ctrl->head, __ATOMIC_ACQUIRE);
+            return (unsigned)(m_head_cache - m_tail);
+        }
     }
-    *m_tail_ptr = tail;
 }
 
 
@@ -237,12 +473,10 @@ void SharedMemBuffer :: dbg_print()
 {
 
     cout << "head= " << get_head() << " tail= " << get_tail()
-         << " head_wrap= " << (int)get_head_wrap_count() << " tail_wrap= " << (int)get_tail_wrap_count()
+         << " max= " << m_MAX_ENTRIES << " done= " << is_writer_done()
          << endl;
 
 }
 
 
 #endif //#ifdef USE_QSIM
-
-
@@ -3,10 +3,16 @@
 
 #ifdef USE_QSIM
 
+#include <stdint.h>
 #include "qsim.h"
 
 
-
+//! Single-producer single-consumer ring of QueueItems in a SysV shared memory
+//! segment. The writer (a qsim proxy process) and the reader (a core) each own
+//! one index; the other side reads it with acquire semantics, so an item is
+//! fully written before it can be seen. Items can be copied in and out in
+//! bulk, or accessed in place through write_span()/read_span(), and either
+//! side can sleep (adaptive spin, then futex) instead of polling.
 class SharedMemBuffer {
 public:
     SharedMemBuffer(char* fn, char id, unsigned size);
@@ -19,35 +25,99 @@ public:
     bool is_empty();
     int get_buf_max_entries() { return m_MAX_ENTRIES; } //how many data entries it can hold
     int get_buf_num_entries();
-    bool is_writer_done() { return *m_term_flag_ptr != 0; }
+    bool is_writer_done();
+
+    //! Tells the reader no more items will be written.
+    void set_writer_done();
 
+    //writer side
     void write(Qsim::QueueItem& item);
+    unsigned write_n(const Qsim::QueueItem* items, unsigned n);
+    Qsim::QueueItem* write_span(unsigned* n);
+    void commit(unsigned n);
+    unsigned wait_writable(unsigned min, int timeout_us);
+    template <typename Q> unsigned write_from(Q& q);
+
+    //reader side
     Qsim::QueueItem read();
+    unsigned read_n(Qsim::QueueItem* items, unsigned n);
+    const Qsim::QueueItem* read_span(unsigned* n);
+    void consume(unsigned n);
+    const Qsim::QueueItem* peek();
+    void pop();
+    unsigned wait_readable(unsigned min, int timeout_us);
 
 void dbg_print();
 
 protected:
-    int32_t get_head() { return *m_head_ptr; }
-    int32_t get_tail() { return *m_tail_ptr; }
-    int8_t get_head_wrap_count() { return *m_head_wrap_count_ptr; }
-    int8_t get_tail_wrap_count() { return *m_tail_wrap_count_ptr; }
+    uint64_t get_head();
+    uint64_t get_tail();
 
 private:
-    void head_inc();
-    void tail_inc();
+    //shared variables, one cache line per side so the two processes do not
+    //write to the same line
+    struct Control {
+        volatile uint64_t head; //items ever written
+        volatile uint32_t head_seq; //low 32 bits of head; futex word for the reader
+        volatile uint32_t reader_waiting;
+        char pad0[64 - 16];
+
+        volatile uint64_t tail; //items ever read
+        volatile uint32_t tail_seq; //low 32 bits of tail; futex word for the writer
+        volatile uint32_t writer_waiting;
+        char pad1[64 - 16];
+
+        volatile uint32_t term_flag; //termination flag
+        char pad2[64 - 4];
+    };
+
+    void publish_head(uint64_t head);
+    void publish_tail(uint64_t tail);
+    void sleep_on(volatile uint32_t* word, uint32_t val, volatile uint32_t* waiting, int timeout_us);
+    void wake(volatile uint32_t* word, volatile uint32_t* waiting);
 
     char* m_shm; //shared mem segment
-    int m_MAX_ENTRIES; //how many entries the buffer can hold
+    int m_MAX_ENTRIES; //how many entries the buffer can hold; a power of 2
+    uint64_t m_mask;
 
+    Control* m_ctrl;
     Qsim::QueueItem* m_item_array; //interprete the shared mem as a QueueItem array.
-    int32_t* m_head_ptr;
-    int32_t* m_tail_ptr;
-    int8_t* m_head_wrap_count_ptr;
-    int8_t* m_tail_wrap_count_ptr;
-    uint8_t* m_term_flag_ptr; //termination flag
+
+    //private copies of the indices, refreshed only when they run out
+    uint64_t m_head; //writer: next slot to write
+    uint64_t m_tail_cache; //writer: last seen tail
+    uint64_t m_tail; //reader: next slot to read
+    uint64_t m_head_cache; //reader: last seen head
+    uint64_t m_published_tail; //reader: tail last made visible to the writer
+    bool m_writer; //set by writer_init()
+    bool m_reader; //set by reader_init()
 };
 
 
+//! Move items from a queue with empty()/front()/pop(), such as a
+//! Qsim::ClientQueue, into the free slots, and publish them all at once.
+//! @return  Number of items moved.
+template <typename Q>
+unsigned SharedMemBuffer :: write_from(Q& q)
+{
+    unsigned total = 0;
+    while(!q.empty()) {
+        unsigned n;
+        Qsim::QueueItem* slot = write_span(&n);
+        if(n == 0)
+            break;
+        unsigned i = 0;
+        for(; i < n && !q.empty(); i++) {
+            slot[i] = q.front();
+            q.pop();
+        }
+        m_head += i; //commit() would publish each span
+        total += i;
+    }
+    if(total > 0)
+        publish_head(m_head);
+    return total;
+}
 
 
 
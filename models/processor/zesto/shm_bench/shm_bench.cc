@@ -0,0 +1,247 @@
+/* shm_bench.cc - measure the shared-memory instruction stream
+ *
+ * Forks a producer that writes a synthetic stream of QueueItems, one
+ * instruction followed by a memory operation every third instruction,
+ * into a SharedMemBuffer, and a consumer that reads it back the way a
+ * core does.  Reports items per second for the chosen access mode, and
+ * checks that every item arrives once and in order.
+ *
+ * usage: shm_bench [options]
+ *   -size <bytes>   size of the shared mem segment, a power of 2 (default 1048576)
+ *   -items <n>      items to send (default 10000000)
+ *   -mode <m>       item: write()/peek()+pop()
+ *                   bulk: write_n()/read_n() in batches of -batch items
+ *                   span: write_span()+commit()/read_span()+consume() (default)
+ *   -batch <n>      batch size for the bulk mode (default 64)
+ *   -key <file>     file used to create the segment key (default /tmp)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include "../shm.h"
+
+using Qsim::QueueItem;
+
+enum { MODE_ITEM, MODE_BULK, MODE_SPAN };
+
+static void usage(const char * const prog)
+{
+  fprintf(stderr,"usage: %s [-size <bytes>] [-items <n>] [-mode item|bulk|span] [-batch <n>] [-key <file>]\n",prog);
+  exit(1);
+}
+
+static double now_sec(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv,NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* item number i of the synthetic stream */
+static void make_item(QueueItem * item, unsigned long long i)
+{
+  if(i % 4 == 3)
+  {
+    item->cb_type = QueueItem::MEM_CB;
+    item->data.mem_cb.vaddr = i;
+    item->data.mem_cb.paddr = i;
+    item->data.mem_cb.size = 8;
+    item->data.mem_cb.type = (i & 4) ? 1 : 0; /* write : read */
+  }
+  else
+  {
+    item->cb_type = QueueItem::INST_CB;
+    item->data.inst_cb.vaddr = i;
+    item->data.inst_cb.paddr = i;
+    item->data.inst_cb.len = 1;
+    item->data.inst_cb.bytes[0] = 0x90;
+  }
+}
+
+static unsigned long long item_seq(const QueueItem * item)
+{
+  if(item->cb_type == QueueItem::MEM_CB)
+    return item->data.mem_cb.vaddr;
+  return item->data.inst_cb.vaddr;
+}
+
+static void producer(SharedMemBuffer * shm, unsigned long long items, int mode, unsigned batch)
+{
+  /* QueueItem has no default constructor */
+  QueueItem * buf = (QueueItem*)malloc(batch * sizeof(QueueItem));
+  unsigned long long i = 0;
+
+  while(i < items)
+  {
+    if(shm->is_full())
+    {
+      shm->wait_writable(1,-1);
+      continue;
+    }
+
+    if(mode == MODE_ITEM)
+    {
+      make_item(&buf[0],i++);
+      shm->write(buf[0]);
+    }
+    else if(mode == MODE_BULK)
+    {
+      unsigned n = 0;
+      for(;n < batch && i + n < items;n++)
+        make_item(&buf[n],i + n);
+      unsigned done = 0;
+      while(done < n)
+      {
+        done += shm->write_n(&buf[done],n - done);
+        if(done < n)
+          shm->wait_writable(1,-1);
+      }
+      i += n;
+    }
+    else
+    {
+      unsigned n;
+      QueueItem * slot = shm->write_span(&n);
+      if(n > items - i)
+        n = items - i;
+      for(unsigned k=0;k<n;k++)
+        make_item(&slot[k],i + k);
+      shm->commit(n);
+      i += n;
+    }
+  }
+  shm->set_writer_done();
+  free(buf);
+}
+
+/* returns the number of items that were out of sequence */
+static unsigned long long consumer(SharedMemBuffer * shm, unsigned long long items, int mode, unsigned batch)
+{
+  QueueItem * buf = (QueueItem*)malloc(batch * sizeof(QueueItem));
+  unsigned long long expect = 0;
+  unsigned long long errors = 0;
+
+  while(expect < items)
+  {
+    /* as a core does, only wait once everything seen so far is used up */
+    const QueueItem * item = shm->peek();
+    if(!item)
+    {
+      if(shm->wait_readable(1,-1) == 0 && shm->is_writer_done())
+        break;
+      continue;
+    }
+
+    if(mode == MODE_ITEM)
+    {
+      if(item_seq(item) != expect)
+        errors++;
+      expect++;
+      shm->pop();
+    }
+    else if(mode == MODE_BULK)
+    {
+      unsigned n = shm->read_n(&buf[0],batch);
+      for(unsigned k=0;k<n;k++)
+        if(item_seq(&buf[k]) != expect++)
+          errors++;
+    }
+    else
+    {
+      unsigned n;
+      item = shm->read_span(&n);
+      for(unsigned k=0;k<n;k++)
+        if(item_seq(&item[k]) != expect++)
+          errors++;
+      shm->consume(n);
+    }
+  }
+  free(buf);
+  return errors + (items - expect);
+}
+
+int main(int argc, char ** argv)
+{
+  unsigned size = 1 << 20;
+  unsigned long long items = 10000000;
+  int mode = MODE_SPAN;
+  unsigned batch = 64;
+  char * key_file = (char*)"/tmp";
+
+  for(int i=1;i<argc;i++)
+  {
+    if(!strcmp(argv[i],"-size") && (i+1 < argc))
+      size = strtoul(argv[++i],NULL,0);
+    else if(!strcmp(argv[i],"-items") && (i+1 < argc))
+      items = strtoull(argv[++i],NULL,0);
+    else if(!strcmp(argv[i],"-batch") && (i+1 < argc))
+      batch = strtoul(argv[++i],NULL,0);
+    else if(!strcmp(argv[i],"-key") && (i+1 < argc))
+      key_file = argv[++i];
+    else if(!strcmp(argv[i],"-mode") && (i+1 < argc))
+    {
+      i++;
+      if(!strcmp(argv[i],"item"))
+        mode = MODE_ITEM;
+      else if(!strcmp(argv[i],"bulk"))
+        mode = MODE_BULK;
+      else if(!strcmp(argv[i],"span"))
+        mode = MODE_SPAN;
+      else
+        usage(argv[0]);
+    }
+    else
+      usage(argv[0]);
+  }
+  if(!items || !batch)
+    usage(argv[0]);
+
+  const char id = (char)(getpid() % 255 + 1);
+  SharedMemBuffer * shm = new SharedMemBuffer(key_file,id,size);
+  shm->writer_init();
+
+  double start = now_sec();
+  pid_t pid = fork();
+  if(pid < 0)
+  {
+    perror("fork()");
+    exit(1);
+  }
+  if(pid == 0)
+  {
+    producer(shm,items,mode,batch);
+    delete shm;
+    exit(0);
+  }
+
+  /* the consumer is a separate object, as a core would have */
+  SharedMemBuffer * reader = new SharedMemBuffer(key_file,id,size);
+  reader->reader_init();
+  unsigned long long errors = consumer(reader,items,mode,batch);
+  double elapsed = now_sec() - start;
+  waitpid(pid,NULL,0);
+  const int entries = reader->get_buf_max_entries();
+  delete reader;
+  delete shm;
+
+  /* remove the segment */
+  int shmid = shmget(ftok(key_file,id),0,0);
+  if(shmid != -1)
+    shmctl(shmid,IPC_RMID,NULL);
+
+  static const char * const mode_name[] = { "item", "bulk", "span" };
+  printf("mode              %s\n",mode_name[mode]);
+  printf("buffer entries    %d\n",entries);
+  printf("items             %llu\n",items);
+  printf("errors            %llu\n",errors);
+  printf("seconds           %.3f\n",elapsed);
+  printf("items/second      %.0f\n",elapsed > 0 ? items/elapsed : 0.0);
+  return errors ? 1 : 0;
+}
@@ -89,6 +89,9 @@
  */
 
 #include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "sim.h"
 #include "stats.h"
 #include "valcheck.h"
@@ -133,6 +136,71 @@ our_pred - what the branch predictor had predicted (some predictors
 #define BPRED_RET_CACHE_HEADER \
   void ret_cache(class bpred_sc_t * const scvp)
 
+/* Kernels shared by the perceptron-style predictors.  w points at n
+   weights, and input i is +1 if bit i of the history (hist[i/64], for up
+   to 128 inputs) is set and -1 otherwise.  The SSE2 versions do eight
+   16-bit weights at a time and give exactly the same results as the
+   scalar loops, which also handle whatever is left over. */
+#ifdef __SSE2__
+static inline __m128i bpred_bits_to_lanes(const int byte)
+{
+  const __m128i sel = _mm_setr_epi16(1,2,4,8,16,32,64,128);
+  return _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(byte),sel),sel);
+}
+#endif
+
+/* sum of w[i]*input[i] */
+static inline int bpred_perceptron_dot(const short * const w, const qword_t * const hist, const int n)
+{
+  int sum = 0;
+  int i = 0;
+  assert(n <= 128);
+#ifdef __SSE2__
+  __m128i acc = _mm_setzero_si128();
+  for(;i+8<=n;i+=8)
+  {
+    /* negate the weights whose input is -1: (w^m)-m with m all ones */
+    const __m128i m = _mm_xor_si128(bpred_bits_to_lanes((hist[i>>6]>>(i&63))&0xff),_mm_set1_epi16(-1));
+    const __m128i v = _mm_sub_epi16(_mm_xor_si128(_mm_loadu_si128((const __m128i*)&w[i]),m),m);
+    acc = _mm_add_epi32(acc,_mm_madd_epi16(v,_mm_set1_epi16(1)));
+  }
+  acc = _mm_add_epi32(acc,_mm_shuffle_epi32(acc,_MM_SHUFFLE(1,0,3,2)));
+  acc = _mm_add_epi32(acc,_mm_shuffle_epi32(acc,_MM_SHUFFLE(2,3,0,1)));
+  sum = _mm_cvtsi128_si32(acc);
+#endif
+  for(;i<n;i++)
+    sum += ((hist[i>>6]>>(i&63))&1) ? w[i] : -w[i];
+  return sum;
+}
+
+/* move each weight one step toward agreeing with outcome, saturating at
+   w_min/w_max */
+static inline void bpred_perceptron_train(short * const w, const qword_t * const hist, const int n,
+                                          const bool outcome, const int w_min, const int w_max)
+{
+  int i = 0;
+  assert(n <= 128);
+#ifdef __SSE2__
+  const __m128i flip = _mm_set1_epi16(outcome ? 0 : -1);
+  for(;i+8<=n;i+=8)
+  {
+    const __m128i agree = _mm_xor_si128(bpred_bits_to_lanes((hist[i>>6]>>(i&63))&0xff),flip);
+    const __m128i step = _mm_sub_epi16(_mm_and_si128(agree,_mm_set1_epi16(2)),_mm_set1_epi16(1));
+    __m128i v = _mm_adds_epi16(_mm_loadu_si128((const __m128i*)&w[i]),step);
+    v = _mm_min_epi16(_mm_max_epi16(v,_mm_set1_epi16(w_min)),_mm_set1_epi16(w_max));
+    _mm_storeu_si128((__m128i*)&w[i],v);
+  }
+#endif
+  for(;i<n;i++)
+  {
+    if((int)((hist[i>>6]>>(i&63))&1) == (int)outcome) {
+      if(w[i] < w_max) w[i]++;
+    } else {
+      if(w[i] > w_min) w[i]--;
+    }
+  }
+}
+
 #include "ZCOMPS-bpred.list"
 
 #define BPRED_PARSE_ARGS
@@ -917,7 +985,7 @@ bpred_t::lookup(
     sc->preds[i] = bpreds[i]->lookup(sc->pcache[i],PC,targetPC,oraclePC,outcome);
 
   #ifdef ZESTO_COUNTERS
-  if(bpreds)
+  if(core && bpreds)
   {
     core->counters->bpreds.read++;
   }
@@ -926,7 +994,7 @@ bpred_t::lookup(
   cond_dir = fusion->lookup(sc->fcache,sc->preds,PC,targetPC,oraclePC,outcome);
 
   #ifdef ZESTO_COUNTERS
-  if(fusion)
+  if(core && fusion)
   {
     core->counters->fusion.read++;
   }
@@ -935,7 +1003,7 @@ bpred_t::lookup(
   indirPredPC = predPC = dirjmp_BTB->lookup(sc->dirjmp,PC,targetPC,oraclePC,outcome,dir);
 
   #ifdef ZESTO_COUNTERS
-  if(dirjmp_BTB)
+  if(core && dirjmp_BTB)
   {
     core->counters->dirjmpBTB.read++;
   }
@@ -945,7 +1013,7 @@ bpred_t::lookup(
   {
     indirPredPC = indirjmp_BTB->lookup(sc->indirjmp,PC,targetPC,oraclePC,outcome,dir);
     #ifdef ZESTO_COUNTERS
-    core->counters->indirjmpBTB.read++;
+    if(core) core->counters->indirjmpBTB.read++;
     #endif
   }
 
@@ -956,7 +1024,7 @@ bpred_t::lookup(
     sc->our_pred = 1;
 
     #ifdef ZESTO_COUNTERS
-    if(ras)
+    if(core && ras)
     {
       core->counters->RAS.read++;
     }
@@ -975,7 +1043,7 @@ bpred_t::lookup(
       ras->push(PC,fallthruPC,targetPC,oraclePC);
 
       #ifdef ZESTO_COUNTERS
-      if(ras)
+      if(core && ras)
       {
         core->counters->RAS.write++;
       }
@@ -1028,7 +1096,7 @@ bpred_t::update(
         bpreds[i]->update(sc->pcache[i],PC,targetPC,oraclePC,outcome,sc->preds[i]);
 
       #ifdef ZESTO_COUNTERS
-      if(bpreds)
+      if(core && bpreds)
       {
         core->counters->bpreds.write++;
       }
@@ -1037,7 +1105,7 @@ bpred_t::update(
       fusion->update(sc->fcache,sc->preds,PC,targetPC,oraclePC,outcome,sc->our_pred);
 
       #ifdef ZESTO_COUNTERS
-      if(fusion)
+      if(core && fusion)
       {
         core->counters->fusion.write++;
       }
@@ -1049,7 +1117,7 @@ bpred_t::update(
       BPRED_STAT(num_call++;)
 
       #ifdef ZESTO_COUNTERS
-      if(ras)
+      if(core && ras)
       {
         core->counters->RAS.write++;
       }
@@ -1066,7 +1134,7 @@ bpred_t::update(
       indirjmp_BTB->update(sc->indirjmp,PC,targetPC,oraclePC,sc->our_target,outcome,sc->our_pred);
 
       #ifdef ZESTO_COUNTERS
-      core->counters->indirjmpBTB.write++;
+      if(core) core->counters->indirjmpBTB.write++;
       #endif
     }
     else /* DIRJMP or REP */
@@ -1074,7 +1142,7 @@ bpred_t::update(
       dirjmp_BTB->update(sc->dirjmp,PC,targetPC,oraclePC,sc->our_target,outcome,sc->our_pred);
  
       #ifdef ZESTO_COUNTERS
-      if(dirjmp_BTB)
+      if(core && dirjmp_BTB)
       {
         core->counters->dirjmpBTB.write++;
       }
@@ -1089,7 +1157,7 @@ bpred_t::update(
     BPRED_STAT(num_ret++;)
 
     #ifdef ZESTO_COUNTERS
-    if(ras)
+    if(core && ras)
     {
       core->counters->RAS.read++;
     }
@@ -1119,7 +1187,7 @@ bpred_t::spec_update(
       bpreds[i]->spec_update(sc->pcache[i],PC,targetPC,oraclePC,outcome,sc->our_pred);
 
     #ifdef ZESTO_COUNTERS
-    if(bpreds)
+    if(core && bpreds)
     {
       core->counters->bpreds.write++;
     }
@@ -1128,7 +1196,7 @@ bpred_t::spec_update(
     fusion->spec_update(sc->fcache,sc->preds,PC,targetPC,oraclePC,outcome,sc->our_pred);
 
     #ifdef ZESTO_COUNTERS
-    if(fusion)
+    if(core && fusion)
     {
       core->counters->fusion.write++;
     }
@@ -1137,7 +1205,7 @@ bpred_t::spec_update(
     dirjmp_BTB->spec_update(sc->dirjmp,PC,targetPC,oraclePC,sc->our_target,outcome,sc->our_pred);
 
     #ifdef ZESTO_COUNTERS
-    if(dirjmp_BTB)
+    if(core && dirjmp_BTB)
     {
       core->counters->dirjmpBTB.write++;
     }
@@ -1148,7 +1216,7 @@ bpred_t::spec_update(
       indirjmp_BTB->spec_update(sc->indirjmp,PC,targetPC,oraclePC,sc->our_target,outcome,sc->our_pred);
 
       #ifdef ZESTO_COUNTERS
-      core->counters->indirjmpBTB.write++;
+      if(core) core->counters->indirjmpBTB.write++;
       #endif
     }
   }
@@ -1169,7 +1237,7 @@ bpred_t::recover(
     bpreds[i]->recover(sc->pcache[i],outcome);
 
   #ifdef ZESTO_COUNTERS
-  if(bpreds)
+  if(core && bpreds)
   {
     core->counters->bpreds.write++;
   }
@@ -1178,7 +1246,7 @@ bpred_t::recover(
   fusion->recover(sc->fcache,outcome);
 
   #ifdef ZESTO_COUNTERS
-  if(fusion)
+  if(core && fusion)
   {
     core->counters->fusion.write++;
   }
@@ -1189,14 +1257,14 @@ bpred_t::recover(
     ras->recover(sc->ras_checkpoint);
 
     #ifdef ZESTO_COUNTERS
-    core->counters->RAS.write++;
+    if(core) core->counters->RAS.write++;
     #endif
   }
 
   dirjmp_BTB->recover(sc->dirjmp,outcome);
 
   #ifdef ZESTO_COUNTERS
-  if(dirjmp_BTB)
+  if(core && dirjmp_BTB)
   {
     core->counters->dirjmpBTB.write++;
   }
@@ -1207,7 +1275,7 @@ bpred_t::recover(
     indirjmp_BTB->recover(sc->indirjmp,outcome);
 
     #ifdef ZESTO_COUNTERS
-    core->counters->indirjmpBTB.write++;
+    if(core) core->counters->indirjmpBTB.write++;
     #endif
   }
 }
@@ -1222,7 +1290,7 @@ bpred_t::flush(class bpred_state_cache_t * const sc)
     bpreds[i]->flush(sc->pcache[i]);
 
   #ifdef ZESTO_COUNTERS
-  if(bpreds)
+  if(core && bpreds)
   {
     core->counters->bpreds.write++;
   }
@@ -1231,7 +1299,7 @@ bpred_t::flush(class bpred_state_cache_t * const sc)
   fusion->flush(sc->fcache);
 
   #ifdef ZESTO_COUNTERS
-  if(fusion)
+  if(core && fusion)
   {
     core->counters->fusion.write++;
   }
@@ -1242,14 +1310,14 @@ bpred_t::flush(class bpred_state_cache_t * const sc)
     ras->recover(sc->ras_checkpoint);
 
     #ifdef ZESTO_COUNTERS
-    core->counters->RAS.write++;
+    if(core) core->counters->RAS.write++;
     #endif
   }
 
   dirjmp_BTB->flush(sc->dirjmp);
 
   #ifdef ZESTO_COUNTERS
-  if(dirjmp_BTB)
+  if(core && dirjmp_BTB)
   {
     core->counters->dirjmpBTB.write++;
   }
@@ -1260,7 +1328,7 @@ bpred_t::flush(class bpred_state_cache_t * const sc)
     indirjmp_BTB->flush(sc->indirjmp);
 
     #ifdef ZESTO_COUNTERS
-    core->counters->indirjmpBTB.write++;
+    if(core) core->counters->indirjmpBTB.write++;
     #endif
   }
 }
@@ -1392,6 +1460,7 @@ bpred_t::init_state_cache_pool(const int start_size)
 
   bpredSCC_size = start_size;
   bpredSCC_head = 0;
+  SC_debt = 0;
 
   bpredSCC = (class bpred_state_cache_t**) calloc(start_size,sizeof(*bpredSCC));
   if(!bpredSCC)
@@ -1505,5 +1574,61 @@ bpred_t::destroy_state_cache_pool(void)
   bpredSCC_head = 0;
 }
 
+/*====================================================*/
+/* branch trace files                                 */
+/*====================================================*/
+bpred_trace_t::bpred_trace_t(const char * const fname, const bool write):
+  writing(write), last_insn(0)
+{
+  dword_t magic = BPRED_TRACE_MAGIC;
+
+  fp = fopen(fname,write?"wb":"rb");
+  if(!fp)
+    fatal("couldn't open branch trace %s",fname);
+
+  if(write)
+  {
+    if(fwrite(&magic,sizeof(magic),1,fp) != 1)
+      fatal("couldn't write branch trace %s",fname);
+  }
+  else if((fread(&magic,sizeof(magic),1,fp) != 1) || (magic != BPRED_TRACE_MAGIC))
+    fatal("%s is not a branch trace",fname);
+}
+
+bpred_trace_t::~bpred_trace_t()
+{
+  fclose(fp);
+}
+
+void bpred_trace_t::write(
+    const md_addr_t PC,
+    const int len,
+    const md_addr_t targetPC,
+    const md_addr_t oraclePC,
+    const unsigned int opflags,
+    const zcounter_t num_insn)
+{
+  struct bpred_trace_rec_t rec;
+
+  assert(writing);
+  memset(&rec,0,sizeof(rec));
+  rec.PC = PC;
+  rec.targetPC = targetPC;
+  rec.oraclePC = oraclePC;
+  rec.opflags = opflags;
+  rec.insts = (num_insn > last_insn) ? (dword_t)(num_insn - last_insn) : 0;
+  rec.len = len;
+  last_insn = num_insn;
+
+  if(fwrite(&rec,sizeof(rec),1,fp) != 1)
+    fatal("couldn't write branch trace record");
+}
+
+bool bpred_trace_t::read(struct bpred_trace_rec_t * const rec)
+{
+  assert(!writing);
+  return fread(rec,sizeof(*rec),1,fp) == 1;
+}
+
 #undef BPRED_STAT
 
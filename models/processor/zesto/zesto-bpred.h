@@ -93,7 +93,8 @@ class bpred_t
   int bpredSCC_size;
   int bpredSCC_head;
   class bpred_state_cache_t ** bpredSCC;
-  int SC_debt;
+  int SC_debt; /* state caches handed out and not yet returned; set to 0
+                  in init_state_cache_pool, checked for leaks on destroy */
 
   /* stats on branch type distributions */
   zcounter_t num_lookups;
@@ -165,6 +166,44 @@ class bpred_t
   void   destroy_state_cache_pool(void);
 };
 
+/* Branch traces: one record per correct-path branch lookup, in fetch
+   order, as written with -bpred:trace and replayed by bpred_bench. */
+#define BPRED_TRACE_MAGIC 0x5442505aU /* "ZPBT" */
+
+struct bpred_trace_rec_t
+{
+  dword_t PC;
+  dword_t targetPC;  /* decoded target */
+  dword_t oraclePC;  /* actual next PC */
+  dword_t opflags;
+  dword_t insts;     /* correct-path instructions fetched since the previous
+                        record, this one included */
+  byte_t len;        /* instruction length; fall-through is PC+len */
+  byte_t pad[3];
+};
+
+class bpred_trace_t
+{
+  public:
+  /* opens fname for writing if write is set, else for reading; exits
+     on failure */
+  bpred_trace_t(const char * const fname, const bool write);
+  ~bpred_trace_t();
+
+  /* num_insn is the running count of correct-path instructions
+     fetched; records store the difference from the previous call */
+  void write(const md_addr_t PC, const int len, const md_addr_t targetPC,
+             const md_addr_t oraclePC, const unsigned int opflags,
+             const zcounter_t num_insn);
+  /* returns false at end of trace */
+  bool read(struct bpred_trace_rec_t * const rec);
+
+  protected:
+  FILE * fp;
+  bool writing;
+  zcounter_t last_insn;
+};
+
 
 /* TODO: split dir, fusion, btb, ras into separate files */
 
@@ -103,11 +103,13 @@ class core_commit_t
      ROB_insert() inserts a uop into the ROB
      ROB_fuse_insert() adds a fused uop body to the uop head
        (and any previously fuse_inserted uops) to an already
-       allocated ROB entry (i.e., that alloc'd to the head) */
+       allocated ROB entry (i.e., that alloc'd to the head)
+     ROB_head_index() returns the ROB index of the oldest uop */
   virtual bool ROB_available(void) = 0;
   virtual bool ROB_empty(void) = 0;
   virtual void ROB_insert(struct uop_t * const uop) = 0;
   virtual void ROB_fuse_insert(struct uop_t * const uop) = 0;
+  virtual int ROB_head_index(void) = 0;
 
   protected:
 
@@ -74,10 +74,13 @@
  */
 
 #include <stddef.h>
+#include <sstream>
 
 #include <sys/time.h>
 
 #include "zesto-core.h"
+#include "kernel/stat_report.h"
+#include "kernel/stat_sampler.h"
 #include "zesto-opts.h"
 #include "zesto-fetch.h"
 #include "zesto-decode.h"
@@ -137,7 +140,18 @@ stats_mem_op_latency = 0;
   counters = new core_counters_t();
   #endif
 
-  stats = new core_stat_engine();
+  stats = new core_stat_engine(this);
+  std::ostringstream stats_name;
+  stats_name << "core" << id;
+  manifold::kernel::Stat_report::Register(stats_name.str(), stats);
+
+  std::string prefix = stats_name.str() + ".";
+  manifold::kernel::Stat_sampler::Add(prefix + "cycles", &sim_cycle);
+  manifold::kernel::Stat_sampler::Add(prefix + "commit_insn", &stat.commit_insn);
+  manifold::kernel::Stat_sampler::Add(prefix + "commit_uops", &stat.commit_uops);
+  manifold::kernel::Stat_sampler::Add(prefix + "commit_loads", &stat.commit_loads);
+  manifold::kernel::Stat_sampler::Add(prefix + "commit_branches", &stat.commit_branches);
+  manifold::kernel::Stat_sampler::Add(prefix + "mispredicts", &stat.num_jeclear);
 }
 
 core_t::~core_t()
@@ -354,6 +368,12 @@ void core_t::core_reg_options(void)
   opt_reg_double(core_odb,(char*)"-clock",(char*)"core clock frequency in MHz",
     &clock_frequency, /*default*/2000, /*print*/TRUE, NULL);
 
+  /* simulated memory backing */
+  opt_reg_flag(core_odb, (char*)"-mem:hugepages", (char*)"back simulated memory with huge pages",
+    &mem_huge_pages, /*default*/ false, /*print*/true,/*format*/NULL);
+  opt_reg_long_long(core_odb, (char*)"-mem:max_core_pages", (char*)"max simulated memory pages in core before paging to disk (0 for no limit)",
+    &mem_max_core_pages, /* default */0, /* print */true, /* format */NULL);
+
   fetch_reg_options(core_odb,knobs);
   decode_reg_options(core_odb,knobs);
   alloc_reg_options(core_odb,knobs);
@@ -901,7 +921,8 @@ void core_t::cache_response_handler(int src, ZestoCacheReq* req)
 }
 
 // core stat engine start here
-core_stat_engine::core_stat_engine () : Stat_engine(),
+core_stat_engine::core_stat_engine (core_t * c) : Stat_engine(),
+core(c),
 insn_count("Number of Committed Instructions", "")
 {
 }
@@ -922,6 +943,13 @@ void core_stat_engine::print_stats (ostream& out)
     insn_count.print(out);
 }
 
+void core_stat_engine::report_stats (manifold::kernel::Stat_report & r)
+{
+    r.add(insn_count);
+    r.add("commit_insn", core->stat.commit_insn);
+    r.add("cycles", core->sim_cycle);
+}
+
 void core_stat_engine::clear_stats()
 {
     insn_count.clear();
@@ -150,17 +150,21 @@
 #include "kernel/stat_engine.h"
 #include "kernel/stat.h"
  
+class core_t;
+
 class core_stat_engine : public manifold::kernel::Stat_engine
 {
   public:
-    core_stat_engine ();
+    core_stat_engine (core_t * c);
     ~core_stat_engine ();
 
+    core_t * core;
     manifold::kernel::Persistent_stat<manifold::kernel::counter_t> insn_count;
 
     void global_stat_merge(manifold::kernel::Stat_engine * e);
     void clear_stats();
     void print_stats (ostream & out);
+    void report_stats (manifold::kernel::Stat_report & r);
 
     void start_warmup ();
     void end_warmup ();	
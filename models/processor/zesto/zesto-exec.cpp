@@ -224,6 +224,320 @@ void core_exec_t::update_last_completed(tick_t now)
 }
 
 
+/* STQ address index */
+#define STQ_INDEX_LOG_GRANULE 3
+#define STQ_INDEX_MAX_GRANULES 4 /* stores spanning more go in the wide mask */
+
+STQ_index_t::STQ_index_t(const int STQ_size):
+  size(STQ_size)
+{
+  num_words = (STQ_size + 63) / 64;
+
+  /* about four buckets per entry */
+  int log_buckets = 2;
+  while((1 << log_buckets) < 4*STQ_size)
+    log_buckets++;
+  num_buckets = 1 << log_buckets;
+  bucket_shift = 32 - log_buckets;
+
+  buckets = (qword_t*) calloc(num_buckets*num_words,sizeof(*buckets));
+  wide = (qword_t*) calloc(num_words,sizeof(*wide));
+  unknown = (qword_t*) calloc(num_words,sizeof(*unknown));
+  first_granule = (md_addr_t*) calloc(STQ_size,sizeof(*first_granule));
+  num_granules = (int*) calloc(STQ_size,sizeof(*num_granules));
+  if(!buckets || !wide || !unknown || !first_granule || !num_granules)
+    fatal("couldn't calloc STQ index");
+}
+
+STQ_index_t::~STQ_index_t()
+{
+  free(buckets);
+  free(wide);
+  free(unknown);
+  free(first_granule);
+  free(num_granules);
+}
+
+void STQ_index_t::insert(const int index, const md_addr_t addr, const int mem_size)
+{
+  remove(index);
+
+  const md_addr_t last = addr + mem_size - 1;
+  const qword_t bit = 1ULL << (index & 63);
+  const int word = index >> 6;
+
+  if((mem_size <= 0) || (last < addr) ||
+     ((last >> STQ_INDEX_LOG_GRANULE) - (addr >> STQ_INDEX_LOG_GRANULE) >= STQ_INDEX_MAX_GRANULES))
+  {
+    wide[word] |= bit;
+    num_granules[index] = -1;
+    return;
+  }
+
+  first_granule[index] = addr >> STQ_INDEX_LOG_GRANULE;
+  num_granules[index] = (last >> STQ_INDEX_LOG_GRANULE) - first_granule[index] + 1;
+  for(int i=0;i<num_granules[index];i++)
+    buckets[bucket_of(first_granule[index]+i)*num_words + word] |= bit;
+}
+
+void STQ_index_t::remove(const int index)
+{
+  const qword_t bit = 1ULL << (index & 63);
+  const int word = index >> 6;
+
+  if(num_granules[index] < 0)
+    wide[word] &= ~bit;
+  for(int i=0;i<num_granules[index];i++)
+    buckets[bucket_of(first_granule[index]+i)*num_words + word] &= ~bit;
+  num_granules[index] = 0;
+  unknown[word] &= ~bit;
+}
+
+void STQ_index_t::set_unknown(const int index, const bool is_unknown)
+{
+  if(is_unknown)
+    unknown[index >> 6] |= 1ULL << (index & 63);
+  else
+    unknown[index >> 6] &= ~(1ULL << (index & 63));
+}
+
+void STQ_index_t::lookup(const md_addr_t addr1, const md_addr_t addr2, qword_t * const cands) const
+{
+  md_addr_t g;
+  int w;
+
+  if((addr2 < addr1) ||
+     ((addr2 >> STQ_INDEX_LOG_GRANULE) - (addr1 >> STQ_INDEX_LOG_GRANULE) >= STQ_INDEX_MAX_GRANULES))
+  {
+    for(w=0;w<num_words;w++)
+      cands[w] = ~0ULL;
+    if(size & 63)
+      cands[num_words-1] = (1ULL << (size & 63)) - 1;
+    return;
+  }
+
+  for(w=0;w<num_words;w++)
+    cands[w] = wide[w];
+  for(g=addr1 >> STQ_INDEX_LOG_GRANULE;g<=(addr2 >> STQ_INDEX_LOG_GRANULE);g++)
+  {
+    const qword_t * const b = &buckets[bucket_of(g)*num_words];
+    for(w=0;w<num_words;w++)
+      cands[w] |= b[w];
+  }
+}
+
+int STQ_index_t::window(const qword_t * const mask, const int from, const int count,
+                        const bool backward, int * const out) const
+{
+  int n = 0;
+
+  for(int w=0;w<num_words;w++)
+  {
+    qword_t bits = mask[w];
+    while(bits)
+    {
+      const int index = (w << 6) + __builtin_ctzll(bits);
+      bits &= bits - 1;
+
+      const int dist = backward ? (from - index + size) % size : (index - from + size) % size;
+      if(dist >= count)
+        continue;
+
+      if(out)
+      {
+        /* insertion sort by distance; there are only ever a few */
+        int j = n;
+        while(j > 0)
+        {
+          const int prev = out[j-1];
+          const int prev_dist = backward ? (from - prev + size) % size : (prev - from + size) % size;
+          if(prev_dist < dist)
+            break;
+          out[j] = prev;
+          j--;
+        }
+        out[j] = index;
+      }
+      n++;
+    }
+  }
+  return n;
+}
+
+
+/* scheduler ready queues */
+readyQ_t::readyQ_t(const int arg_num_ports, const int arg_ROB_size, const int initial_size):
+  num_ports(arg_num_ports), ROB_size(arg_ROB_size), ROB_words((arg_ROB_size+63)/64),
+  size(64), nodes(NULL), bits(NULL), chain(NULL), slot_port(NULL),
+  free_slots(NULL), num_free(0)
+{
+  while(size < initial_size)
+    size <<= 1;
+
+  nodes = (struct node_t*) calloc(size,sizeof(*nodes));
+  bits = (qword_t*) calloc(num_ports*ROB_words,sizeof(*bits));
+  chain = (int*) calloc(num_ports*ROB_size,sizeof(*chain));
+  slot_port = (int*) calloc(size,sizeof(*slot_port));
+  free_slots = (int*) calloc(size,sizeof(*free_slots));
+  if(!nodes || !bits || !chain || !slot_port || !free_slots)
+    fatal("couldn't calloc readyQ");
+
+  for(int i=0;i<num_ports*ROB_size;i++)
+    chain[i] = -1;
+
+  /* hand out low slots first */
+  for(int i=size-1;i>=0;i--)
+  {
+    slot_port[i] = -1;
+    free_slots[num_free++] = i;
+  }
+}
+
+readyQ_t::~readyQ_t()
+{
+  free(nodes);
+  free(bits);
+  free(chain);
+  free(slot_port);
+  free(free_slots);
+}
+
+void readyQ_t::insert(const int port, struct uop_t * const uop, const tick_t now)
+{
+  assert((port >= 0) && (port < num_ports));
+  assert((uop->alloc.ROB_index >= 0) && (uop->alloc.ROB_index < ROB_size));
+  if(!num_free)
+    sweep();
+  if(!num_free)
+    grow();
+
+  const int slot = free_slots[--num_free];
+  const int ROB_index = uop->alloc.ROB_index;
+  struct node_t * const node = &nodes[slot];
+  node->uop = uop;
+  node->uop_seq = uop->decode.uop_seq;
+  node->action_id = uop->exec.action_id;
+  node->when_assigned = now;
+  node->ROB_index = ROB_index;
+  slot_port[slot] = port;
+
+  /* keep the ROB entry's chain in age order (more than one node only for
+     fused uops, or when a stale node is still around) */
+  int * const head = &chain[port*ROB_size + ROB_index];
+  int prev = -1;
+  int next = *head;
+  while((next >= 0) && (nodes[next].uop_seq < node->uop_seq))
+  {
+    prev = next;
+    next = nodes[next].next;
+  }
+  node->prev = prev;
+  node->next = next;
+  if(prev >= 0)
+    nodes[prev].next = slot;
+  else
+    *head = slot;
+  if(next >= 0)
+    nodes[next].prev = slot;
+
+  bits[port*ROB_words + (ROB_index >> 6)] |= 1ULL << (ROB_index & 63);
+}
+
+void readyQ_t::remove(const int port, const int slot)
+{
+  assert(slot_port[slot] == port);
+  struct node_t * const node = &nodes[slot];
+  const int ROB_index = node->ROB_index;
+
+  if(node->prev >= 0)
+    nodes[node->prev].next = node->next;
+  else
+    chain[port*ROB_size + ROB_index] = node->next;
+  if(node->next >= 0)
+    nodes[node->next].prev = node->prev;
+  if(chain[port*ROB_size + ROB_index] < 0)
+    bits[port*ROB_words + (ROB_index >> 6)] &= ~(1ULL << (ROB_index & 63));
+
+  slot_port[slot] = -1;
+  node->uop = NULL;
+  node->when_assigned = -1;
+  free_slots[num_free++] = slot;
+}
+
+/* oldest node of the first ROB entry at least age entries past ROB_head
+   that has any, or -1 */
+int readyQ_t::find(const int port, const int age, const int ROB_head) const
+{
+  const qword_t * const mask = &bits[port*ROB_words];
+
+  /* the remaining entries, from ROB_head+age around to just before ROB_head,
+     as at most two ascending runs */
+  int lo = ROB_head + age;
+  int hi = ROB_size;
+  if(lo >= ROB_size)
+  {
+    lo -= ROB_size;
+    hi = ROB_head;
+  }
+
+  while(lo < hi)
+  {
+    int w = lo >> 6;
+    qword_t b = mask[w] & (~0ULL << (lo & 63));
+    while(!b && (++w << 6) < hi)
+      b = mask[w];
+    if(b)
+    {
+      const int ROB_index = (w << 6) + __builtin_ctzll(b);
+      if(ROB_index < hi)
+        return chain[port*ROB_size + ROB_index];
+    }
+    if(hi == ROB_head)
+      break;
+    lo = 0;
+    hi = ROB_head;
+  }
+  return -1;
+}
+
+int readyQ_t::first(const int port, const int ROB_head) const
+{
+  return find(port,0,ROB_head);
+}
+
+int readyQ_t::next(const int port, const int slot, const int ROB_head) const
+{
+  if(nodes[slot].next >= 0)
+    return nodes[slot].next;
+  const int age = nodes[slot].ROB_index - ROB_head + ((nodes[slot].ROB_index < ROB_head) ? ROB_size : 0);
+  return find(port,age+1,ROB_head);
+}
+
+void readyQ_t::sweep(void)
+{
+  for(int i=0;i<size;i++)
+    if((slot_port[i] >= 0) && (nodes[i].uop->exec.action_id != nodes[i].action_id))
+      remove(slot_port[i],i);
+}
+
+void readyQ_t::grow(void)
+{
+  const int new_size = size * 2;
+
+  nodes = (struct node_t*) realloc(nodes,new_size*sizeof(*nodes));
+  slot_port = (int*) realloc(slot_port,new_size*sizeof(*slot_port));
+  free_slots = (int*) realloc(free_slots,new_size*sizeof(*free_slots));
+  if(!nodes || !slot_port || !free_slots)
+    fatal("couldn't grow readyQ");
+
+  for(int i=new_size-1;i>=size;i--)
+  {
+    slot_port[i] = -1;
+    free_slots[num_free++] = i;
+  }
+  size = new_size;
+}
+
 /* load in all definitions */
 #include "ZPIPE-exec.list"
 
@@ -168,6 +168,116 @@ class core_exec_t
   struct core_t * core;
 };
 
+/* Index of in-flight STQ entries by the 8-byte granules they write, so
+   that store-to-load forwarding and memory disambiguation only have to
+   look at the stores that can overlap a load.  Granules hash into
+   buckets holding a bitmask of STQ indices; collisions only add
+   candidates, which the caller filters with its usual address
+   comparisons.  Stores touching too many granules (or wrapping around
+   the address space) are kept in a separate mask that is part of every
+   lookup. */
+class STQ_index_t
+{
+  public:
+
+  STQ_index_t(const int STQ_size);
+  ~STQ_index_t();
+
+  /* (re)index entry index as writing mem_size bytes starting at addr */
+  void insert(const int index, const md_addr_t addr, const int mem_size);
+  void remove(const int index);
+
+  /* entries whose address is not yet known (by default, none are) */
+  void set_unknown(const int index, const bool unknown);
+  const qword_t * get_unknown(void) const { return unknown; }
+
+  /* set cands (num_words qwords) to the entries that may overlap
+     [addr1,addr2]; every entry is a candidate if the range can't be
+     looked up by granule */
+  void lookup(const md_addr_t addr1, const md_addr_t addr2, qword_t * const cands) const;
+
+  /* put the entries in mask that are fewer than count steps away from
+     STQ index from (walking toward older entries if backward is set)
+     into out, in walk order; returns how many there are.  out may be
+     NULL to just count them. */
+  int window(const qword_t * const mask, const int from, const int count,
+             const bool backward, int * const out) const;
+
+  int num_words;
+
+  protected:
+  int size;
+  int num_buckets; /* power of two */
+  int bucket_shift;
+  qword_t * buckets; /* num_buckets x num_words bit masks */
+  qword_t * wide;
+  qword_t * unknown;
+
+  /* per-entry granules, for removal */
+  md_addr_t * first_granule;
+  int * num_granules; /* 0 if not indexed, -1 if in wide */
+
+  int bucket_of(const md_addr_t granule) const
+  {
+    return (int)((granule * 0x9E3779B9u) >> bucket_shift);
+  }
+};
+
+/* Per-port scheduler ready queues over one shared pool of nodes.  Each
+   port keeps a bitmap with one bit per ROB entry that has a waiting uop,
+   and the nodes of one ROB entry (a fused uop's members) are chained in
+   uop_seq order.  ROB entries are allocated in program order, so walking
+   the bitmap from the ROB head with find-first-set visits the waiting uops
+   oldest first, and select stops at the first one that can issue.  A node
+   goes stale when its uop is given a new action_id (squash, snatch-back,
+   or recycling of the uop); stale nodes are dropped by whoever runs into
+   them, and swept out before the pool is grown. */
+class readyQ_t
+{
+  public:
+
+  struct node_t {
+    struct uop_t * uop;
+    seq_t uop_seq; /* seq id of uop when inserted - for proper sorting even after uop recycled */
+    seq_t action_id;
+    tick_t when_assigned;
+    int ROB_index; /* of uop when inserted */
+    int prev; /* nodes of the same port and ROB entry, -1 at either end */
+    int next;
+  };
+
+  readyQ_t(const int num_ports, const int ROB_size, const int initial_size);
+  ~readyQ_t();
+
+  /* queue uop (with its current action_id) on port; node pointers are
+     not stable across inserts */
+  void insert(const int port, struct uop_t * const uop, const tick_t now);
+  void remove(const int port, const int slot);
+
+  /* slots of port from oldest to youngest, given the current ROB head:
+     start with first(port,ROB_head) and continue with next() until it
+     returns -1 */
+  int first(const int port, const int ROB_head) const;
+  int next(const int port, const int slot, const int ROB_head) const;
+  struct node_t * get(const int slot) { return &nodes[slot]; }
+
+  protected:
+  int num_ports;
+  int ROB_size;
+  int ROB_words;
+  int size;
+  struct node_t * nodes;
+  qword_t * bits; /* num_ports x ROB_words masks of ROB entries with nodes */
+  int * chain; /* num_ports x ROB_size oldest node of each ROB entry, -1 if none */
+  int * slot_port; /* port each slot is queued on, -1 if free */
+  int * free_slots;
+  int num_free;
+
+  int find(const int port, const int age, const int ROB_head) const;
+  void sweep(void);
+  void grow(void);
+};
+
 void exec_reg_options(struct opt_odb_t * odb, struct core_knobs_t * knobs);
 class core_exec_t * exec_create(const char * exec_opt_string, struct core_t * core);
 
@@ -103,6 +103,9 @@ void fetch_reg_options(struct opt_odb_t * odb, struct core_knobs_t * knobs)
   opt_reg_string(odb, "-bpred:ras","return address stack predictor configuration string [DS]",
       &knobs->fetch.ras_opt_str, /*default*/ "stack:RAS:16", /*print*/true,/*format*/NULL);
 
+  opt_reg_string(odb, "-bpred:trace","write correct-path branch lookups to <file>.c<core-id> for bpred_bench [DS]",
+      &knobs->fetch.bpred_trace_str, /*default*/ "none", /*print*/true,/*format*/NULL);
+
   opt_reg_int(odb, "-jeclear:delay","additional latency from branch-exec to jeclear [D]",
       &knobs->fetch.jeclear_delay, /*default*/ 1, /*print*/true,/*format*/NULL);
 
@@ -125,13 +128,43 @@ void fetch_reg_options(struct opt_odb_t * odb, struct core_knobs_t * knobs)
 
 
 /* default constructor */
-core_fetch_t::core_fetch_t(void): bogus(false)
+core_fetch_t::core_fetch_t(void): bogus(false), bpred_trace(NULL), bpred_trace_insn(0)
 {
 }
 
 /* default destructor */
 core_fetch_t::~core_fetch_t()
 {
+  if(bpred_trace)
+    delete bpred_trace;
+}
+
+/* open the -bpred:trace file for this core, if one was asked for */
+void core_fetch_t::open_bpred_trace(void)
+{
+  if(strcasecmp(core->knobs->fetch.bpred_trace_str,"none"))
+  {
+    char fname[512];
+    snprintf(fname,sizeof(fname),"%s.c%d",core->knobs->fetch.bpred_trace_str,core->id);
+    bpred_trace = new bpred_trace_t(fname,true);
+  }
+}
+
+/* count a fetched instruction for the -bpred:trace records; called for
+   every Mop fetch hands on, so refetched instructions count again, as
+   their branches are recorded again */
+void core_fetch_t::count_fetched(const struct Mop_t * const Mop)
+{
+  if(bpred_trace && !Mop->oracle.spec_mode && Mop->uop[Mop->decode.last_uop_index].decode.EOM)
+    bpred_trace_insn++;
+}
+
+/* record a branch lookup; wrong-path lookups are left out */
+void core_fetch_t::trace_branch(const struct Mop_t * const Mop)
+{
+  if(bpred_trace && !Mop->oracle.spec_mode)
+    bpred_trace->write(Mop->fetch.PC,Mop->fetch.inst.len,Mop->decode.targetPC,
+                       Mop->oracle.NextPC,Mop->decode.opflags,bpred_trace_insn);
 }
 
 /* reset bpred stats */
@@ -81,6 +81,8 @@ class core_fetch_t {
   md_addr_t PC;
   bool bogus; /* TRUE if oracle is on wrong path and encountered an invalid inst */
   class bpred_t * bpred;
+  class bpred_trace_t * bpred_trace; /* -bpred:trace output, if any */
+  zcounter_t bpred_trace_insn; /* correct-path instructions fetched, for bpred_trace */
 
   /* constructor, stats registration */
   core_fetch_t(void);
@@ -110,6 +112,10 @@ class core_fetch_t {
 
   protected:
   struct core_t * core;
+
+  void open_bpred_trace(void);
+  void count_fetched(const struct Mop_t * const Mop);
+  void trace_branch(const struct Mop_t * const Mop);
 };
 
 
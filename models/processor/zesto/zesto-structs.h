@@ -338,6 +338,7 @@ struct core_knobs_t
     char *dirjmpbtb_opt_str;
     char *indirjmpbtb_opt_str;
     char *ras_opt_str;
+    char *bpred_trace_str;
 
     bool warm_bpred;
   } fetch;
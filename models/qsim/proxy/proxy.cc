@@ -29,8 +29,27 @@ qsim_proxy_t::qsim_proxy_t(char *StateName, char *AppName, uint64_t InterruptInt
     /* to enable system callbacks */
     //qsim_osd->set_sys_cbs(true);
 
-    buffer.reserve(QSIM_PROXY_QUEUE_SIZE);
-    buffer.clear();
+    /* Allocate the segments of each core up front */
+    segments.resize(qsim_osd->get_n());
+    for(unsigned i = 0; i < segments.size(); i++) {
+        core_segments_t &cs = segments[i];
+
+        for(int j = 0; j < QSIM_PROXY_SEGMENTS_PER_CORE; j++) {
+            cs.pool.push_back(new qsim_proxy_segment_t());
+        }
+
+        QueueItem queue_item;
+        queue_item.cb_type = QueueItem::IDLE;
+        queue_item.id = i;
+        cs.idle = new qsim_proxy_segment_t();
+        for(int j = 0; j < QSIM_RUN_GRANULARITY; j++) {
+            cs.idle->items[cs.idle->size++] = queue_item;
+        }
+
+        queue_item.cb_type = QueueItem::TERMINATED;
+        cs.terminated = new qsim_proxy_segment_t();
+        cs.terminated->items[cs.terminated->size++] = queue_item;
+    }
 }
 
 
@@ -38,6 +57,50 @@ qsim_proxy_t::~qsim_proxy_t()
 {
     cout << "Terminating Qsim" << endl;
     delete qsim_osd;
+
+    for(unsigned i = 0; i < segments.size(); i++) {
+        for(unsigned j = 0; j < segments[i].pool.size(); j++) {
+            delete segments[i].pool[j];
+        }
+        delete segments[i].idle;
+        delete segments[i].terminated;
+    }
+}
+
+
+/* Take a segment the core is done with, or allocate one if the core still
+   holds all of them. */
+qsim_proxy_segment_t *qsim_proxy_t::get_free_segment(core_segments_t &cs)
+{
+    qsim_proxy_segment_t *seg = NULL;
+
+    for(unsigned i = 0; i < cs.pool.size(); i++) {
+        unsigned idx = (cs.next_free + i) % cs.pool.size();
+        if(!cs.pool[idx]->in_use) {
+            seg = cs.pool[idx];
+            cs.next_free = (idx + 1) % cs.pool.size();
+            break;
+        }
+    }
+
+    if(!seg) {
+        seg = new qsim_proxy_segment_t();
+        cs.pool.push_back(seg);
+    }
+
+    seg->size = 0;
+    seg->in_use = true;
+    return seg;
+}
+
+
+/* Drop the items filled since the last request. */
+void qsim_proxy_t::release_filled(core_segments_t &cs)
+{
+    for(unsigned i = 0; i < cs.filled.size(); i++) {
+        cs.filled[i]->in_use = false;
+    }
+    cs.filled.clear();
 }
 
 
@@ -63,7 +126,7 @@ void qsim_proxy_t::inst_cb(int core_id, uint64_t vaddr, uint64_t paddr, uint8_t
 #ifdef DEBUG_NEW_QSIM
     std::cerr << "( core " << std::dec << core_id << " ): INST" << " | v: 0x" << std::hex << vaddr <<" p: 0x" << std::hex << paddr << std::endl << std::flush;
 #endif
-    buffer.push_back(QueueItem(core_id, vaddr, paddr, len, bytes, type));
+    *next_slot(core_id) = QueueItem(core_id, vaddr, paddr, len, bytes, type);
 }
 
 
@@ -72,7 +135,7 @@ void qsim_proxy_t::mem_cb(int core_id, uint64_t vaddr, uint64_t paddr, uint8_t s
 #ifdef DEBUG_NEW_QSIM
     std::cerr << "@ " << std::dec << manifold::kernel::Manifold::NowTicks() << " ( core " << std::dec << core_id << " ): MEM" << " | v: 0x" << std::hex << vaddr <<" p: 0x" << std::hex << paddr << (type == 0 ? " RD" : " WR") << std::endl << std::flush;
 #endif
-    buffer.push_back(QueueItem(core_id, vaddr, paddr, size, type));
+    *next_slot(core_id) = QueueItem(core_id, vaddr, paddr, size, type);
 }
 
 
@@ -81,5 +144,5 @@ void qsim_proxy_t::reg_cb(int core_id, int reg, uint8_t size, int type)
 #ifdef DEBUG_NEW_QSIM
     std::cerr << "( core " << std::dec << core_id << " ): REG" << " | regid: " << std::dec << reg << " size: " << static_cast<uint16_t>(size) << (type == 0 ? " SRC" : " DST") << std::endl << std::flush;
 #endif
-    buffer.push_back(QueueItem(core_id, reg, size, type));
+    *next_slot(core_id) = QueueItem(core_id, reg, size, type);
 }
@@ -10,6 +10,12 @@
 #define QSIM_OVERHEAD   0.2
 #define QSIM_PROXY_QUEUE_SIZE (int)(5 * QSIM_RUN_GRANULARITY * (1 + QSIM_OVERHEAD))
 
+/* Items per segment, and segments allocated for each core up front */
+#define QSIM_PROXY_SEGMENT_SIZE QSIM_PROXY_QUEUE_SIZE
+#define QSIM_PROXY_SEGMENTS_PER_CORE 4
+/* Segments a single request can carry */
+#define QSIM_PROXY_MAX_SEGMENTS 4
+
 //#define DEBUG_NEW_QSIM 1
 //#define DEBUG_NEW_QSIM_1 1
 //#define DEBUG_NEW_QSIM_2 1
@@ -17,6 +23,19 @@
 namespace manifold {
 namespace qsim_proxy {
 
+/* A fixed-size block of QueueItems of one core. The Qsim callbacks fill it in
+   place, and the core is lent the items through its request instead of a
+   copy. in_use is set while the segment is being filled or is held by the
+   core; the core clears it once it has consumed every item. */
+struct qsim_proxy_segment_t
+{
+    qsim_proxy_segment_t() : size(0), in_use(false) {}
+
+    Qsim::QueueItem items[QSIM_PROXY_SEGMENT_SIZE];
+    unsigned size;
+    bool in_use;
+};
+
 class qsim_proxy_t : public manifold::kernel::Component
 {
 public:
@@ -36,79 +55,85 @@ public:
     template <typename T> void handle_core_request(int temp, T *CoreRequest);
 
 private:
+    struct core_segments_t {
+        core_segments_t() : next_free(0), idle(NULL), terminated(NULL) {}
+
+        std::vector<qsim_proxy_segment_t*> pool; /* all segments of the core */
+        std::vector<qsim_proxy_segment_t*> filled; /* filled since the last request, in order */
+        unsigned next_free; /* where to start looking for a free segment */
+        qsim_proxy_segment_t *idle; /* IDLE items; lent but never refilled */
+        qsim_proxy_segment_t *terminated; /* a TERMINATED item */
+    };
+
+    Qsim::QueueItem *next_slot(int core_id);
+    qsim_proxy_segment_t *get_free_segment(core_segments_t &cs);
+    void release_filled(core_segments_t &cs);
+
     Qsim::OSDomain *qsim_osd;
-    std::vector<Qsim::QueueItem> buffer;
+    std::vector<core_segments_t> segments; /* indexed by Qsim core id */
     uint64_t interrupt_interval;
 };
 
+
+/* Slot for the next callback item of a core, in the segment being filled. */
+inline Qsim::QueueItem *qsim_proxy_t::next_slot(int core_id)
+{
+    assert(core_id >= 0 && core_id < (int)segments.size());
+    core_segments_t &cs = segments[core_id];
+
+    if(cs.filled.empty() || (cs.filled.back()->size == QSIM_PROXY_SEGMENT_SIZE)) {
+        cs.filled.push_back(get_free_segment(cs));
+    }
+    qsim_proxy_segment_t *seg = cs.filled.back();
+    return &seg->items[seg->size++];
+}
+
 template <typename T>
 void qsim_proxy_t::handle_core_request(int temp, T *CoreRequest)
 {
     int core_id = CoreRequest->get_core_id();
+    core_segments_t &cs = segments[core_id];
 
-    /* x86 instruction length is variable.
-       Utilize only a fraction of queue space to avoid possible overflow. */
-    //while(CoreRequest->get_queue_size() < QSIM_PROXY_QUEUE_SIZE*0.8) {
     do {
-        //buffer.clear();
         // run will execute at least a translation-block in qim-0.2
+        // the callbacks fill the core's segments directly
         int rc = qsim_osd->run(core_id, QSIM_RUN_GRANULARITY);
 #if  defined(DEBUG_NEW_QSIM_2) || defined(DEBUG_NEW_QSIM_1)
-        std::cerr << "( core: " << std::dec << core_id << " ) | inst " << std::dec << rc << " tid "  << qsim_osd->get_tid(core_id) << " idle " << qsim_osd->idle(core_id) << " buffer " << buffer.size() << std::endl << std::flush;
+        std::cerr << "( core: " << std::dec << core_id << " ) | inst " << std::dec << rc << " tid "  << qsim_osd->get_tid(core_id) << " idle " << qsim_osd->idle(core_id) << " segments " << cs.filled.size() << std::endl << std::flush;
 #endif
 
         if(!rc) {
-            Qsim::QueueItem queue_item;
-            assert(buffer.size() == 0);
+            assert(cs.filled.size() == 0);
             if(!qsim_osd->booted(core_id)) {
-                queue_item.cb_type = Qsim::QueueItem::TERMINATED;
-                queue_item.id = core_id;
-
-                CoreRequest->push_back(queue_item);
+                CoreRequest->push_segment(cs.terminated->items, cs.terminated->size, 0);
             }
             else {
                 //assert(qsim_osd->idle(core_id));
                 //assert(qsim_osd.get_tid(i) != qsim_osd.get_bench_pid());
-                queue_item.cb_type = Qsim::QueueItem::IDLE;
-                queue_item.id = core_id;
-
-                for(int i = 0; i < QSIM_RUN_GRANULARITY; i++) {
-                    CoreRequest->push_back(queue_item);
-                }
+                CoreRequest->push_segment(cs.idle->items, cs.idle->size, 0);
             }
             break;
         }
         else {
-/*            while(buffer.size()) {*/
-                //CoreRequest->push_back(*(buffer.begin()));
-                //buffer.erase(buffer.begin());
-            //}
-
-            if (qsim_osd->idle(core_id) || (buffer.size() == 0)) {
-                //assert(buffer.size() == 0);
-                Qsim::QueueItem queue_item;
-                queue_item.cb_type = Qsim::QueueItem::IDLE;
-                queue_item.id = core_id;
-
-                for(int i = 0; i < QSIM_RUN_GRANULARITY; i++) {
-                    CoreRequest->push_back(queue_item);
-                }
+            if (qsim_osd->idle(core_id) || (cs.filled.size() == 0)) {
+                release_filled(cs);
+                CoreRequest->push_segment(cs.idle->items, cs.idle->size, 0);
                 break;
             } else {
 #ifdef DEBUG_NEW_QSIM
-                std::cerr << "( core: " << std::dec << core_id << " ) cbs: " << buffer.size() << " | " << std::flush;
+                std::cerr << "( core: " << std::dec << core_id << " ) segments: " << cs.filled.size() << " | " << std::flush;
 #endif
 
-                std::vector<Qsim::QueueItem>::size_type sz = buffer.size();
-                std::vector<Qsim::QueueItem>::size_type offset = 0;
-                while ( sz > QSIM_PROXY_QUEUE_SIZE ) {
+                /* Lend the segments in the order they were filled; those that
+                   do not fit in CoreRequest go ahead of it in extended requests. */
+                std::vector<qsim_proxy_segment_t*>::size_type sz = cs.filled.size();
+                std::vector<qsim_proxy_segment_t*>::size_type offset = 0;
+                while ( sz > QSIM_PROXY_MAX_SEGMENTS ) {
                     T *req = new T(CoreRequest->get_core_id(), CoreRequest->get_port_id(), true);
-                    std::vector<Qsim::QueueItem>::iterator it = buffer.begin() + offset;
 
-                    for(int i = 0; i < QSIM_PROXY_QUEUE_SIZE; i++) {
-                        Qsim::QueueItem qi = *it;
-                        req->push_back(qi);
-                        it++;
+                    for(int i = 0; i < QSIM_PROXY_MAX_SEGMENTS; i++) {
+                        qsim_proxy_segment_t *seg = cs.filled[offset + i];
+                        req->push_segment(seg->items, seg->size, &seg->in_use);
                     }
 
 #ifdef DEBUG_NEW_QSIM_1
@@ -116,15 +141,14 @@ void qsim_proxy_t::handle_core_request(int temp, T *CoreRequest)
 #endif
 
                     Send(req->get_port_id(), req);
-                    
-                    sz -= QSIM_PROXY_QUEUE_SIZE;
-                    offset += QSIM_PROXY_QUEUE_SIZE;
+
+                    sz -= QSIM_PROXY_MAX_SEGMENTS;
+                    offset += QSIM_PROXY_MAX_SEGMENTS;
                 }
 
-                //assert( buffer.size() < QSIM_PROXY_QUEUE_SIZE );
-                for(std::vector<Qsim::QueueItem>::iterator it = buffer.begin() + offset; it != buffer.end(); it++) {
-                    Qsim::QueueItem qi = *it;
-                    CoreRequest->push_back(qi);
+                for(; offset < cs.filled.size(); offset++) {
+                    qsim_proxy_segment_t *seg = cs.filled[offset];
+                    CoreRequest->push_segment(seg->items, seg->size, &seg->in_use);
                 }
 
 #ifdef DEBUG_NEW_QSIM
@@ -134,7 +158,8 @@ void qsim_proxy_t::handle_core_request(int temp, T *CoreRequest)
         }
     } while(0);
 
-    buffer.clear();
+    /* The segments now belong to the core until it drains them. */
+    cs.filled.clear();
 #ifdef DEBUG_NEW_QSIM_1
     std::cerr << "( Core " << std::dec << CoreRequest->get_core_id() << " ) [receive request from qsim] | " << std::dec << CoreRequest->get_queue_size() << " @ " << m_clk->NowTicks() << std::endl << std::flush;
 #endif
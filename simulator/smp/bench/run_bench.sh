@@ -0,0 +1,170 @@
+#!/bin/bash
+
+# Performance regression suite over the systems in ../config, driven by
+# synthetic traces (util/traceGen/synth_trace), so no QSim is needed at run
+# time. See README for what is measured.
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+SMP_DIR=$(dirname "$BENCH_DIR")
+CONFIG_DIR=$SMP_DIR/config
+TRACE_DIR=$SMP_DIR/Trace
+SYNTH=$SMP_DIR/../../util/traceGen/synth_trace
+
+CONFIGS="conf2x3_spx_torus_l1l2 conf2x3_spx_torus_llp conf2x3_zesto_torus_l1l2 conf2x3_zesto_torus_llp
+conf2x2_spx_t6p_llp conf4x4_spx_t6p_llp conf4x5_simpleproc_torus_llp conf4x5_spx_torus_llp
+conf4x5_zesto_torus_l1l2 conf4x5_zesto_torus_llp conf4x5_replay_torus_l1l2 conf4x5_replay_torus_llp"
+
+OUT=bench.csv
+BASELINE=
+THRESHOLD=5
+CYCLES=100000
+INSNS=500000
+LPS="1 2 N"
+WORK=
+KEEP=0
+MPIRUN=${MPIRUN:-mpirun}
+
+usage()
+{
+    echo "Usage: $0 [-o result.csv] [-b baseline.csv] [-t percent] [-c cycles] [-n insns]"
+    echo "       [-l \"1 2 N\"] [-w workdir] [-k] [config ...]"
+    echo "  -o  write the results to this file (default bench.csv)"
+    echo "  -b  compare the results with a baseline written by an earlier run"
+    echo "  -t  tolerance of the comparison in percent (default 5)"
+    echo "  -c  simulated cycles of each run (default 100000)"
+    echo "  -n  trace length in instructions per core (default 500000)"
+    echo "  -l  numbers of LPs to run with; N is one LP per processor plus one"
+    echo "  -w  directory for traces and logs (default: a temporary one)"
+    echo "  -k  keep the work directory"
+    echo "  config  names of files in ../config, without .cfg (default: all 12 systems)"
+    exit 1
+}
+
+while getopts "o:b:t:c:n:l:w:k" opt; do
+    case $opt in
+        o) OUT=$OPTARG ;;
+        b) BASELINE=$OPTARG ;;
+        t) THRESHOLD=$OPTARG ;;
+        c) CYCLES=$OPTARG ;;
+        n) INSNS=$OPTARG ;;
+        l) LPS=$OPTARG ;;
+        w) WORK=$OPTARG; KEEP=1 ;;
+        k) KEEP=1 ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] && CONFIGS="$*"
+
+for f in "$SYNTH" "$TRACE_DIR/smp_llp" "$TRACE_DIR/smp_l1l2"; do
+    if [ ! -x "$f" ]; then
+        echo "$f not found; build util/traceGen and simulator/smp/Trace first" >&2
+        exit 1
+    fi
+done
+if [ -n "$BASELINE" ] && [ ! -r "$BASELINE" ]; then
+    echo "cannot read $BASELINE" >&2
+    exit 1
+fi
+
+if [ -z "$WORK" ]; then
+    WORK=$(mktemp -d /tmp/smp_bench.XXXXXX) || exit 1
+fi
+mkdir -p "$WORK" || exit 1
+
+
+# Writes the bench copy of a system: SPX cores have no trace front-end, so
+# they are replaced by Zesto; paths are made absolute and the run length set.
+make_config()
+{
+    sed -e 's#\.\./config/#'"$CONFIG_DIR"'/#g' \
+        -e 's#^\( *simulation_stop *=\).*#\1 '"$CYCLES"';#' \
+        -e '/^processor/,/^}/{
+              s#type *= *"SPX"#type = "ZESTO"#
+              s#config *= *"[^"]*spx[^"]*"#config = "'"$CONFIG_DIR"'/zesto-6issue.config"#
+            }' "$1" > "$2"
+}
+
+# Number of processors in a config.
+num_procs()
+{
+    sed -n '/^processor/,/^}/s/.*node_idx *= *\[\(.*\)\].*/\1/p' "$1" | tr ',' '\n' | grep -c '[0-9]'
+}
+
+# Prints insns,seconds,events,peak_rss_kb,sync_blocked_seconds from the
+# stats report of one run (see kernel/stat_report.h).
+read_report()
+{
+    awk -F, '
+        $1 == "all" && $4 == "commit_insn" && $5 == "sum" { insns += $6 }
+        $1 == "all" && $3 ~ /Clock_stat_engine/ && $4 ~ /events$/ && $5 == "sum" { events += $6 }
+        $1 == "all" && $3 ~ /Scheduler_stat_engine/ && $4 == "run seconds" && $5 == "max" { secs = $6 }
+        $1 == "all" && $3 ~ /Scheduler_stat_engine/ && $4 == "peak rss kb" && $5 == "max" { rss = $6 }
+        $1 == "all" && $3 ~ /Scheduler_stat_engine/ && $4 == "sync blocked seconds" && $5 == "sum" { blocked = $6 }
+        END { printf "%.0f,%g,%.0f,%.0f,%g\n", insns, secs, events, rss, blocked }' "$1"
+}
+
+
+echo "config,lps,cycles,insns,seconds,kips,events,events_per_sec,peak_rss_kb,sync_overhead" > "$OUT"
+
+for conf in $CONFIGS; do
+    src=$CONFIG_DIR/$conf.cfg
+    if [ ! -r "$src" ]; then
+        echo "$src not found" >&2
+        exit 1
+    fi
+    dir=$WORK/$conf
+    mkdir -p "$dir"
+    make_config "$src" "$dir/bench.cfg"
+
+    case $conf in
+        *l1l2*) sim=$TRACE_DIR/smp_l1l2 ;;
+        *) sim=$TRACE_DIR/smp_llp ;;
+    esac
+    format=zesto
+    grep -q 'type *= *"\(SIMPLE\|REPLAY\)"' "$dir/bench.cfg" && format=simple
+    procs=$(num_procs "$dir/bench.cfg")
+    "$SYNTH" -f $format -n "$INSNS" -c "$procs" "$dir/trace" || exit 1
+
+    for lps in $LPS; do
+        [ "$lps" = N ] && lps=$((procs + 1))
+        echo "$conf: $lps LP(s)" >&2
+        rm -f "$dir"/run$lps.*
+        if ! (cd "$dir" && MANIFOLD_STATS=run$lps MANIFOLD_SYNC_LOG=run$lps MANIFOLD_SYNC_BUCKET=1 \
+                $MPIRUN -np $lps "$sim" bench.cfg trace > run$lps.log 2>&1); then
+            echo "$conf failed with $lps LP(s); see $dir/run$lps.log" >&2
+            KEEP=1
+            continue
+        fi
+        IFS=, read insns secs events rss blocked < <(read_report "$dir/run$lps.csv")
+        awk -v c=$conf -v l=$lps -v cy=$CYCLES -v i=$insns -v s=$secs -v e=$events -v r=$rss -v b=$blocked 'BEGIN {
+                printf "%s,%d,%.0f,%.0f,%.3f,%.1f,%.0f,%.0f,%.0f,%.4f\n", c, l, cy, i, s,
+                       (s > 0 ? i / s / 1000 : 0), e, (s > 0 ? e / s : 0), r, (s > 0 ? b / (s * l) : 0)
+            }' >> "$OUT"
+    done
+done
+
+[ $KEEP = 0 ] && rm -rf "$WORK"
+[ $KEEP = 1 ] && echo "traces and logs are in $WORK" >&2
+
+command -v column > /dev/null && column -s, -t < "$OUT" >&2
+[ -z "$BASELINE" ] && exit 0
+
+
+# Compare with the baseline: throughput may not drop, and memory and sync
+# overhead may not grow, by more than the tolerance.
+awk -F, -v t=$THRESHOLD '
+    FNR == 1 { next }
+    NR == FNR { kips[$1","$2] = $6; eps[$1","$2] = $8; rss[$1","$2] = $9; sync[$1","$2] = $10; next }
+    {
+        k = $1","$2
+        if (!(k in kips)) { printf "%-32s %3d LPs  not in baseline\n", $1, $2; next }
+        bad = ""
+        if ($6 < kips[k] * (1 - t / 100)) bad = bad sprintf("  KIPS %.1f -> %.1f", kips[k], $6)
+        if ($8 < eps[k] * (1 - t / 100)) bad = bad sprintf("  events/s %.0f -> %.0f", eps[k], $8)
+        if ($9 > rss[k] * (1 + t / 100)) bad = bad sprintf("  RSS %d -> %d kB", rss[k], $9)
+        if ($10 > sync[k] + t / 100) bad = bad sprintf("  sync %.1f%% -> %.1f%%", 100 * sync[k], 100 * $10)
+        if (bad != "") { printf "%-32s %3d LPs  REGRESSION%s\n", $1, $2, bad; n++ }
+        else printf "%-32s %3d LPs  ok (KIPS %+.1f%%)\n", $1, $2, (kips[k] > 0 ? 100 * ($6 / kips[k] - 1) : 0)
+    }
+    END { if (n) { printf "%d regression(s) beyond %s%%\n", n, t; exit 1 } }' "$BASELINE" "$OUT"
@@ -200,6 +200,21 @@ void MCP_lp_lls_builder :: pre_simulation()
 }
 
 
+//====================================================================
+//====================================================================
+bool MCP_lp_lls_builder :: add_to_warmup(Cache_warmup& warmup)
+{
+    for(map<int, LP_LLS_unit*>::iterator it = m_caches.begin(); it != m_caches.end(); ++it) {
+        LP_LLS_unit* unit = (*it).second;
+        if(unit->get_llp() == 0)
+            return false;
+        warmup.add_l1(unit->get_llp());
+        warmup.add_l2(unit->get_lls());
+    }
+    return true;
+}
+
+
 //====================================================================
 //====================================================================
 void MCP_lp_lls_builder :: print_config(ostream& out)
@@ -420,6 +435,27 @@ void MCP_l1l2_builder :: connect_cache_network(NetworkBuilder* net_builder)
 }
 
 
+//====================================================================
+//====================================================================
+bool MCP_l1l2_builder :: add_to_warmup(Cache_warmup& warmup)
+{
+    for(map<int, int>::iterator it = m_l1_cids.begin(); it != m_l1_cids.end(); ++it) {
+        MESI_L1_cache* l1 = manifold::kernel::Component :: GetComponent<MESI_L1_cache>((*it).second);
+        if(l1 == 0)
+            return false;
+        warmup.add_l1(l1);
+    }
+
+    for(map<int, int>::iterator it = m_l2_cids.begin(); it != m_l2_cids.end(); ++it) {
+        MESI_L2_cache* l2 = manifold::kernel::Component :: GetComponent<MESI_L2_cache>((*it).second);
+        if(l2 == 0)
+            return false;
+        warmup.add_l2(l2);
+    }
+    return true;
+}
+
+
 //====================================================================
 //====================================================================
 void MCP_l1l2_builder :: print_config(ostream& out)
@@ -4,6 +4,7 @@
 #include <libconfig.h++>
 #include <map>
 #include "mcp-cache/lp_lls_unit.h"
+#include "mcp-cache/cache_warmup.h"
 #include "network_builder.h"
 
 #ifdef LIBKITFOX
@@ -29,6 +30,8 @@ public:
     virtual void set_mc_map_obj(manifold::uarch::DestMap *mc_map) = 0;
 
     virtual void pre_simulation() {};
+    //! Adds the caches to a functional warm-up; returns false if some are on other LPs.
+    virtual bool add_to_warmup(manifold::mcp_cache_namespace::Cache_warmup&) = 0;
     virtual void print_config(std::ostream&) {}
     virtual void print_stats(std::ostream&) = 0;
 
@@ -88,6 +91,7 @@ public:
     return m_caches; }
 
     void pre_simulation();
+    bool add_to_warmup(manifold::mcp_cache_namespace::Cache_warmup&);
 
     void print_config(std::ostream&);
     void print_stats(std::ostream&);
@@ -116,6 +120,8 @@ public:
 
     int get_type() { return MCP_L1L2; }
 
+    bool add_to_warmup(manifold::mcp_cache_namespace::Cache_warmup&);
+
     void print_config(std::ostream&);
     void print_stats(std::ostream&);
 
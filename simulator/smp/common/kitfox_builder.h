@@ -10,7 +10,7 @@ class SysBuilder_llp;
 
 class KitFoxBuilder {
 public:
-    KitFoxBuilder(const char* configFile, uint64_t s);
+    KitFoxBuilder(const char* configFile, uint64_t s, unsigned threads = 0, unsigned lag = 1);
     virtual ~KitFoxBuilder();
 
     int get_component_id() const { return component_id; }
@@ -21,6 +21,8 @@ protected:
     manifold::kitfox_proxy::kitfox_proxy_t *proxy;
     const char* m_config_file;
     const uint64_t m_clock_freq;
+    const unsigned m_threads; //KitFox evaluation threads
+    const unsigned m_lag; //samples before results are applied
 
     int component_id;
 };
@@ -3,6 +3,7 @@
 #include "cache_builder.h"
 #include "mcp-cache/coh_mem_req.h"
 #include "CaffDRAM/McMap.h"
+#include <sstream>
 
 using namespace libconfig;
 using namespace manifold::kernel;
@@ -32,6 +33,28 @@ void CaffDRAM_builder :: read_config(Config& config)
 
     m_MEM_MSG_TYPE = config.lookup("network.mem_msg_type");
     m_CREDIT_MSG_TYPE = config.lookup("network.credit_msg_type");
+
+    try {
+        const char* prefix = config.lookup("mc.req_log");
+        m_REQ_LOG = prefix;
+    }
+    catch (SettingNotFoundException e) {
+        m_REQ_LOG = "";
+    }
+
+    //optional: service each channel in its own component
+    try {
+        m_CH_LINK_LATENCY = (int)config.lookup("mc.channel_link_latency");
+        assert(m_CH_LINK_LATENCY >= 0);
+    }
+    catch (SettingNotFoundException e) {
+        m_CH_LINK_LATENCY = 0;
+    }
+    if(config.exists("mc.channel_lps")) {
+        Setting& ch_lps = config.lookup("mc.channel_lps");
+        for(int i=0; i<ch_lps.getLength(); i++)
+            m_CH_LPS.push_back((int)ch_lps[i]);
+    }
     }
     catch (SettingNotFoundException e) {
     cout << e.getPath() << " not set." << endl;
@@ -55,6 +78,31 @@ void CaffDRAM_builder :: create_mcs(map<int, int>& id_lp)
     int lp = (*it).second;
     int cid = Component :: Create<Controller>(lp, node_id, m_dram_settings, m_MC_DOWNSTREAM_CREDITS);
     m_mc_id_cid_map[node_id] = cid;
+
+    Controller* mc = Component :: GetComponent<Controller>(cid);
+    if(mc && m_REQ_LOG != "") {
+        stringstream ss;
+        ss << m_REQ_LOG << "_" << node_id << ".bin";
+        mc->set_req_log(ss.str().c_str());
+    }
+
+    if(m_CH_LINK_LATENCY > 0) {
+        if(mc)
+            mc->set_channel_components(m_CH_LINK_LATENCY);
+
+        for(int ch=0; ch<m_dram_settings.numChannels; ch++) {
+            //channels are assigned round-robin to mc.channel_lps; default is the controller's LP
+            int ch_lp = lp;
+            if(m_CH_LPS.size() > 0)
+                ch_lp = m_CH_LPS[m_ch_cids.size() % m_CH_LPS.size()];
+            int ch_cid = Component :: Create<ChannelController>(ch_lp, node_id, ch, m_dram_settings, m_CH_LINK_LATENCY);
+            m_ch_cids.push_back(ch_cid);
+
+            Manifold :: Connect(cid, Controller::PORT_CH0 + ch, &Controller::handle_channel_response,
+                                ch_cid, ChannelController::PORT0, &ChannelController::handle_request,
+                                Clock::Master(), Clock::Master(), m_CH_LINK_LATENCY, m_CH_LINK_LATENCY);
+        }
+    }
     }
 
 }
@@ -133,6 +181,10 @@ void CaffDRAM_builder :: print_config(std::ostream& out)
 {
     MemControllerBuilder :: print_config(out);
     out << "  MC type: CaffDRAM\n";
+    if(m_REQ_LOG != "")
+        out << "  request log: " << m_REQ_LOG << "_<node>.bin\n";
+    if(m_CH_LINK_LATENCY > 0)
+        out << "  channel components: link latency= " << m_CH_LINK_LATENCY << endl;
 }
 
 
@@ -144,6 +196,11 @@ void CaffDRAM_builder :: print_stats(std::ostream& out)
     if(mc)
         mc->print_stats(out);
     }
+    for(unsigned i=0; i<m_ch_cids.size(); i++) {
+        ChannelController* ch = Component :: GetComponent<ChannelController>(m_ch_cids[i]);
+        if(ch)
+            ch->print_stats(out);
+    }
 }
 
 
@@ -183,6 +240,13 @@ void DramSim_builder :: read_config(Config& config)
     chars = config.lookup("mc.dramsim2.sys_file");
     m_SYS_FILE = chars;
     m_MEM_SIZE = config.lookup("mc.dramsim2.size");
+
+    try {
+        m_SKIP_IDLE = config.lookup("mc.dramsim2.skip_idle");
+    }
+    catch (SettingNotFoundException e) {
+        m_SKIP_IDLE = true;
+    }
     }
     catch (SettingNotFoundException e) {
     cout << e.getPath() << " not set." << endl;
@@ -213,7 +277,7 @@ void DramSim_builder :: create_mcs(map<int, int>& id_lp)
 
     Dram_sim :: Set_msg_types(m_MEM_MSG_TYPE, m_CREDIT_MSG_TYPE);
 
-    Dram_sim_settings settings(m_DEV_FILE.c_str(), m_SYS_FILE.c_str(), m_MEM_SIZE, false, m_MC_DOWNSTREAM_CREDITS);
+    Dram_sim_settings settings(m_DEV_FILE.c_str(), m_SYS_FILE.c_str(), m_MEM_SIZE, false, m_MC_DOWNSTREAM_CREDITS, m_SKIP_IDLE);
 
     Clock* clock = 0;
     if(m_use_default_clock)
@@ -312,7 +376,8 @@ void DramSim_builder :: print_config(std::ostream& out)
     out << "  MC type: DRAMSim2\n";
     out << "  device file: " << m_DEV_FILE << "\n"
         << "  system file: " << m_SYS_FILE << "\n"
-    << "  size: " << m_MEM_SIZE << "\n";
+    << "  size: " << m_MEM_SIZE << "\n"
+    << "  skip idle cycles: " << (m_SKIP_IDLE ? "yes" : "no") << "\n";
     out << "  clock: ";
     if(m_use_default_clock)
         out << "default\n";
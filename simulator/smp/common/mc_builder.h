@@ -2,6 +2,8 @@
 #define MC_BUILDER_H
 
 #include <map>
+#include <string>
+#include <vector>
 #include <libconfig.h++>
 #include "CaffDRAM/Controller.h"
 #include "DRAMSim2/dram_sim.h"
@@ -64,6 +66,10 @@ private:
     int m_MC_DOWNSTREAM_CREDITS; //credits for sending down to network
     int m_MEM_MSG_TYPE;
     int m_CREDIT_MSG_TYPE;
+    std::string m_REQ_LOG; //prefix of per-controller request logs; empty if disabled
+    int m_CH_LINK_LATENCY; //latency of links to channel components; 0 if channels are not separate components
+    std::vector<int> m_CH_LPS; //LPs for channel components
+    std::vector<int> m_ch_cids; //component ids of the channel components
 };
 
 
@@ -90,6 +96,7 @@ private:
     std::string m_DEV_FILE; //device file name
     std::string m_SYS_FILE; //system file name
     unsigned m_MEM_SIZE; //mem size;
+    bool m_SKIP_IDLE; //fast-forward DRAMSim2 over idle periods
 };
 
 
@@ -61,390 +61,38 @@ void ProcBuilder :: print_config(std::ostream& out)
 	        out << m_CLOCK_FREQ[i] << ", ";
 	    out << m_CLOCK_FREQ[m_NUM_PROC-1];
     }
+    if(m_tick_threads > 1)
+        out << "  tick threads: " << m_tick_threads << endl;
 }
 
-#if 0
 //####################################################################
 //####################################################################
-void Zesto_builder :: read_config(Config& config)
+void Spx_builder :: read_config(Config& config)
 {
     try {
-	    Setting& proc_nodes = config.lookup("processor.node_idx");
-	    m_NUM_PROC = proc_nodes.getLength();
-
-	    try {
-	        Setting& proc_clocks = config.lookup("processor.clocks");
-	        assert((unsigned)proc_clocks.getLength() == m_NUM_PROC);
-	        m_CLOCK_FREQ.resize(m_NUM_PROC);
-
-	        for(unsigned i=0; i<m_NUM_PROC; i++)
-		        m_CLOCK_FREQ[i] = (double)proc_clocks[i];
-
-	        m_use_default_clock = false;
-	    }
-	    catch (SettingNotFoundException e) {
-	        //clock not defined; use default
-	        m_use_default_clock = true;
-	    }
-
 	    const char* chars = config.lookup("processor.config");
 	    m_CONFIG_FILE = chars;
-    }
-    catch (SettingNotFoundException e) {
-	    cout << e.getPath() << " not set." << endl;
-	    exit(1);
-    }
-    catch (SettingTypeException e) {
-	    cout << e.getPath() << " has incorrect type." << endl;
-	    exit(1);
-    }
-}
-
-void Zesto_builder :: create_qsimclient_procs(std::map<int,int>& id_lp)
-{
-    assert(m_fe_type == QSIMCLIENT);
-    assert(m_proc_id_cid_map.size() == 0);
 
-    manifold::zesto::QsimClient_Settings proc_settings(m_server, m_port);
-    int cpuid = 0;
-    int i=0;
-    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
-        int node_id = (*it).first;
-        int lp = (*it).second;
-        int cid = manifold::kernel::Component::Create<qsimclient_core_t>(lp, node_id, (char*)m_CONFIG_FILE.c_str(), cpuid, proc_settings);
-	    cpuid++;
-        m_proc_id_cid_map[node_id] = cid;
-	    qsimclient_core_t* proc = manifold::kernel::Component :: GetComponent<qsimclient_core_t>(cid);
-	    Clock* clk = 0;
-	    if(m_use_default_clock) {
-	        clk = m_sysBuilder->get_default_clock();
-	    }
-	    else {
-	        clk = m_clocks[i++];
-	    }
-	    assert(clk);
+	    //optional: step the cores of an LP in parallel with this many threads
+	    if(config.exists("processor.tick_threads"))
+	        m_tick_threads = (int)config.lookup("processor.tick_threads");
 
-	    if(proc) {
-	        Clock :: Register(*clk, (core_t*)proc, &qsimclient_core_t::tick, (void(core_t::*)(void))0);
-	    }
-    }
-}
-
-void Zesto_builder :: create_qsimlib_procs(std::map<int,int>& id_lp)
-{
-    assert(m_fe_type == QSIMLIB);
-    assert(m_proc_id_cid_map.size() == 0);
-    assert(m_qsim_osd != 0);
-
-    int cpuid = 0;
-    int i=0;
-    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
-        int node_id = (*it).first;
-        int lp = (*it).second;
-	    assert(lp == 0);
-        int cid = manifold::kernel::Component::Create<qsimlib_core_t>(lp, node_id, (char*)m_CONFIG_FILE.c_str(), m_qsim_osd, cpuid);
-	    cpuid++;
-        m_proc_id_cid_map[node_id] = cid;
-	    qsimlib_core_t* proc = manifold::kernel::Component :: GetComponent<qsimlib_core_t>(cid);
-	    assert(proc);
-	    Clock* clk = 0;
-	    if(m_use_default_clock) {
-	        clk = m_sysBuilder->get_default_clock();
-	    }
-	    else {
-	        clk = m_clocks[i++];
-	    }
-	    assert(clk);
-	    Clock :: Register(*clk, (core_t*)proc, &qsimlib_core_t::tick, (void(core_t::*)(void))0);
-    }
-    qsimlib_core_t :: Start_qsim(m_qsim_osd);
-}
-
-void Zesto_builder :: create_qsimproxy_procs(std::map<int,int>& id_lp)
-{
-    cerr << "Zesto does not support Qsim Proxy!\n";
-    exit(1);
-}
-
-void Zesto_builder :: create_trace_procs(std::map<int,int>& id_lp)
-{
-    assert(m_fe_type == TRACE);
-    assert(m_proc_id_cid_map.size() == 0);
-
-    int cpuid = 0;
-    int i=0;
-    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
-        char buf[100];
-	    sprintf(buf, "%s%d", m_trace, cpuid);
-        int node_id = (*it).first;
-        int lp = (*it).second;
-        int cid = manifold::kernel::Component::Create<trace_core_t>(lp, node_id, (char*)m_CONFIG_FILE.c_str(), buf);
-	    cpuid++;
-        m_proc_id_cid_map[node_id] = cid;
-	    trace_core_t* proc = manifold::kernel::Component :: GetComponent<trace_core_t>(cid);
-	    Clock* clk = 0;
-	    if(m_use_default_clock) {
-	        clk = m_sysBuilder->get_default_clock();
-	    }
-	    else {
-	        clk = m_clocks[i++];
-	    }
-	    assert(clk);
-	    if(proc) {
-	        Clock :: Register(*clk, (core_t*)proc, &trace_core_t::tick, (void(core_t::*)(void))0);
-	    }
-    }
-}
-
-void Zesto_builder :: connect_proc_qsim_proxy(QsimBuilder* qsim_builder)
-{
-    assert(get_fe_type() != QSIMPROXY);
-    return;
-
-    /*
-    cerr << "Zesto doesn't support Qsim Proxy\n";
-    exit(1);
-    */
-}
-
-void Zesto_builder :: connect_proc_cache(CacheBuilder* cache_builder)
-{
-    switch(cache_builder->get_type()) {
-        case CacheBuilder::MCP_CACHE: {
-	        MCP_lp_lls_builder* mcp_builder = dynamic_cast<MCP_lp_lls_builder*>(cache_builder);
-		    assert(mcp_builder);
-
-		    map<int, LP_LLS_unit*>& mcp_caches = mcp_builder->get_cache_map();
-
-		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
-		        int node_id = (*it).first;
-		        int proc_cid = (*it).second;
-		        LP_LLS_unit* unit = mcp_caches[node_id];
-		        assert(unit);
-		        int cache_cid = unit->get_llp_cid();
-
-		        //connect proc with L1 cache
-		        //!!!!!!!!!!!!!!!!!!! todo: use proper clock!
-		        Manifold :: Connect(proc_cid, core_t::PORT0, &core_t::cache_response_handler,
-					                cache_cid, MESI_LLP_cache::PORT_PROC,
-					                &MESI_LLP_cache::handle_processor_request<ZestoCacheReq>, Clock::Master(), Clock::Master(), 1, 1);
-
-		    }//for
-	        break;
-        }
-        case CacheBuilder::MCP_L1L2: {
-	        MCP_l1l2_builder* mcp_builder = dynamic_cast<MCP_l1l2_builder*>(cache_builder);
-		    assert(mcp_builder);
-
-		    map<int, int>& l1_cids = mcp_builder->get_l1_cids();
-
-		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
-		        int node_id = (*it).first;
-		        int proc_cid = (*it).second;
-		        int cache_cid = l1_cids[node_id];
-
-		        //connect proc with L1 cache
-		        //!!!!!!!!!!!!!!!!!!! todo: use proper clock!
-		        Manifold :: Connect(proc_cid, core_t::PORT0, &core_t::cache_response_handler,
-					                cache_cid, MESI_L1_cache::PORT_PROC,
-					                &MESI_L1_cache::handle_processor_request<ZestoCacheReq>, Clock::Master(), Clock::Master(), 1, 1);
-
-		    }//for
-	        break;
-        }
-        default: { assert(0); }
-    }
-}
-
-void Zesto_builder :: print_config(std::ostream& out)
-{
-    ProcBuilder::print_config(out);
-    out << "  type: Zesto" << endl;
-    out << "  config file: " << m_CONFIG_FILE << endl;
-    if(m_fe_type == QSIMCLIENT) {
-        out << "  server= " << m_server << "  port= " << m_port << endl;
-    }
-}
-
-void Zesto_builder :: print_stats(std::ostream& out)
-{
-    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
-        int cid = (*it).second;
-	    core_t* proc = Component :: GetComponent<core_t>(cid);
-	    if(proc) {
-	        proc->print_stats();
-	        proc->print_stats(out);
-	    }
-    }
-}
-
-
-//####################################################################
-//####################################################################
-void Simple_builder :: create_qsimclient_procs(std::map<int,int>& id_lp)
-{
-    assert(m_fe_type == QSIMCLIENT);
-    assert(m_proc_id_cid_map.size() == 0);
-
-    manifold::simple_proc::QsimProc_Settings proc_settings(m_server, m_port, m_l1_line_sz);
-    int cpuid = 0;
-    int i=0;
-    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
-        int node_id = (*it).first;
-        int lp = (*it).second;
-        int cid = manifold::kernel::Component::Create<QsimProcessor>(lp, cpuid, node_id, proc_settings);
-	    cpuid++;
-        m_proc_id_cid_map[node_id] = cid;
-	    QsimProcessor* proc = manifold::kernel::Component :: GetComponent<QsimProcessor>(cid);
-	    Clock* clk = 0;
-	    if(m_use_default_clock) {
-	        clk = m_sysBuilder->get_default_clock();
-	    }
-	    else {
-	        clk = m_clocks[i++];
-	    }
-	    assert(clk);
-	    if(proc) {
-	        Clock :: Register(*clk, (SimpleProcessor*)proc, &QsimProcessor::tick, (void(SimpleProcessor::*)(void))0);
-	    }
-    }
-}
-
-
-void Simple_builder :: create_qsimlib_procs(std::map<int,int>& id_lp)
-{
-    assert(m_fe_type == QSIMLIB);
-    assert(m_proc_id_cid_map.size() == 0);
-
-    manifold::simple_proc::SimpleProc_Settings proc_settings(m_l1_line_sz);
-    int cpuid = 0;
-    int i=0;
-    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
-        int node_id = (*it).first;
-        int lp = (*it).second;
-	    assert(lp == 0);
-        int cid = manifold::kernel::Component::Create<QsimLibProcessor>(lp, m_qsim_osd, cpuid, node_id, proc_settings);
-	    cpuid++;
-        m_proc_id_cid_map[node_id] = cid;
-	    QsimLibProcessor* proc = manifold::kernel::Component :: GetComponent<QsimLibProcessor>(cid);
-	    Clock* clk = 0;
-	    if(m_use_default_clock) {
-	        clk = m_sysBuilder->get_default_clock();
-	    }
-	    else {
-	        clk = m_clocks[i++];
-	    }
-	    assert(clk);
-	    if(proc) {
-	        Clock :: Register(*clk, (SimpleProcessor*)proc, &QsimLibProcessor::tick, (void(SimpleProcessor::*)(void))0);
-	    }
-    }
-
-    QsimLibProcessor :: Start_qsim(m_qsim_osd);
-}
-
-void Simple_builder :: create_qsimproxy_procs(std::map<int,int>& id_lp)
-{
-    cerr << "SimpleProc does not support Qsim Proxy!\n";
-    exit(1);
-}
-
-void Simple_builder :: create_trace_procs(std::map<int,int>& id_lp)
-{
-    assert(m_fe_type == TRACE);
-    assert(m_proc_id_cid_map.size() == 0);
-
-    manifold::simple_proc::SimpleProc_Settings proc_settings(m_l1_line_sz);
-    int cpuid = 0;
-    int i=0;
-    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
-        char buf[100];
-    	sprintf(buf, "%s%d", m_trace, cpuid);
-        int node_id = (*it).first;
-        int lp = (*it).second;
-        int cid = manifold::kernel::Component::Create<TraceProcessor>(lp, cpuid, buf, proc_settings);
-	    cpuid++;
-        m_proc_id_cid_map[node_id] = cid;
-	    TraceProcessor* proc = manifold::kernel::Component :: GetComponent<TraceProcessor>(cid);
-	    Clock* clk = 0;
-	    if(m_use_default_clock) {
-	        clk = m_sysBuilder->get_default_clock();
-	    }
-	    else {
-	        clk = m_clocks[i++];
-	    }
-	    assert(clk);
-	    if(proc) {
-	        Clock :: Register(*clk, (SimpleProcessor*)proc, &TraceProcessor::tick, (void(SimpleProcessor::*)(void))0);
-	    }
-    }
-}
-
-void Simple_builder :: connect_proc_qsim_proxy(QsimBuilder* qsim_builder)
-{
-    assert(get_fe_type() != QSIMPROXY);
-    return;
-
-    /*
-    cerr << "SimpleProc doesn't support Qsim Proxy\n";
-    exit(1);
-    */
-}
-
-void Simple_builder :: connect_proc_cache(CacheBuilder* cache_builder)
-{
-    switch(cache_builder->get_type()) {
-        case CacheBuilder::MCP_CACHE: {
-	        MCP_lp_lls_builder* mcp_builder = dynamic_cast<MCP_lp_lls_builder*>(cache_builder);
-		    assert(mcp_builder);
-
-		    map<int, LP_LLS_unit*>& mcp_caches = mcp_builder->get_cache_map();
-
-		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
-		        int node_id = (*it).first;
-		        int proc_cid = (*it).second;
-		        LP_LLS_unit* unit = mcp_caches[node_id];
-		        assert(unit);
-		        int cache_cid = unit->get_llp_cid();
-
-		        //connect proc with L1 cache
-		        //!!!!!!!!!!!!!!!!!!! todo: use proper clock!
-		        Manifold :: Connect(proc_cid, SimpleProcessor::PORT_CACHE, &SimpleProcessor::handle_cache_response,
-					                cache_cid, MESI_LLP_cache::PORT_PROC,
-					                &MESI_LLP_cache::handle_processor_request<manifold::simple_proc::CacheReq>, Clock::Master(), Clock::Master(), 1, 1);
-
-		    }//for
-	        break;
-        }
-        default: { assert(0); }
-    }
-}
-
-void Simple_builder :: print_config(std::ostream& out)
-{
-    ProcBuilder::print_config(out);
-    out << "  type: SimpleProc" << endl;
-}
-
-void Simple_builder :: print_stats(std::ostream& out)
-{
-    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
-        int cid = (*it).second;
-	    SimpleProcessor* proc = Component :: GetComponent<SimpleProcessor>(cid);
-	    if(proc) {
-	        proc->print_stats(out);
-	    }
-    }
-}
+	    //optional: thermal DVFS driven by the KitFox proxy
+	    if(config.exists("processor.dvfs")) {
+#ifdef LIBKITFOX
+	        m_dvfs = true;
+	        m_dvfs_hot_temp = config.lookup("processor.dvfs.hot_temp");
+	        m_dvfs_cool_temp = config.lookup("processor.dvfs.cool_temp");
+	        m_dvfs_low_freq = config.lookup("processor.dvfs.low_freq");
+	        if(m_dvfs_cool_temp > m_dvfs_hot_temp || m_dvfs_low_freq <= 0) {
+	            cerr << "processor.dvfs needs cool_temp <= hot_temp and low_freq > 0\n";
+	            exit(1);
+	        }
+#else
+	        cerr << "processor.dvfs requires a simulator built with KitFox\n";
+	        exit(1);
 #endif
-
-//####################################################################
-//####################################################################
-void Spx_builder :: read_config(Config& config)
-{
-    try {
-	    const char* chars = config.lookup("processor.config");
-	    m_CONFIG_FILE = chars;
+	    }
     }
     catch (SettingNotFoundException e) {
 	    cout << e.getPath() << " not set." << endl;
@@ -480,14 +128,26 @@ void Spx_builder :: create_qsimproxy_procs(std::map<int,int>& id_lp)
 
         if(proc) {
 	        Clock* clk = 0;
-	        if(m_use_default_clock)
+	        if(m_dvfs) {
+	            //the core's own clock, starting at the default frequency
+	            DVFSClock* dvfs_clk = new DVFSClock(m_sysBuilder->get_default_clock()->freq);
+	            m_dvfs_clocks[node_id] = dvfs_clk;
+	            clk = dvfs_clk;
+	        }
+	        else if(m_use_default_clock)
 	            clk = m_sysBuilder->get_default_clock();
             else
 	            clk = m_clocks[i++];
 	        assert(clk);
-	        Clock :: Register(*clk, (spx_core_t*)proc, &spx_core_t::tick, (void(spx_core_t::*)(void))0);
+	        tickObjBase* to = Clock :: Register(*clk, (spx_core_t*)proc, &spx_core_t::tick, (void(spx_core_t::*)(void))0);
+	        //a core's tick only touches its own pipeline; it reaches the
+	        //caches and the qsim proxy through links
+	        if(m_tick_threads > 1)
+	            to->SetParallel(true);
         }
     }
+    if(m_tick_threads > 1)
+        Clock :: SetTickThreads(m_tick_threads);
 }
 
 void Spx_builder :: create_qsimclient_procs(std::map<int,int>& id_lp)
@@ -508,14 +168,28 @@ void Spx_builder :: connect_proc_kitfox_proxy(KitFoxBuilder* kitfox_builder)
     int kitfox_cid = kitfox_builder->get_component_id();
 
     for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+        int node_id = (*it).first;
         int proc_cid = (*it).second;
 
         //connect proc with kitfox proxy
         Manifold :: Connect(proc_cid, spx_core_t::OUT_TO_KITFOX, &spx_core_t::handle_kitfox_proxy_request<kitfox_proxy_request_t<manifold::uarch::pipeline_counter_t>>,
                             kitfox_cid, proc_cid, &kitfox_proxy_t::handle_kitfox_proxy_response<manifold::uarch::pipeline_counter_t>,
                             Clock::Master(), Clock::Master(), 1, 1);
-        if (kitfox_builder->get_kitfox())
+        if (kitfox_builder->get_kitfox()) {
             kitfox_builder->get_kitfox()->add_manifold_node(proc_cid, KitFoxType::core_type);
+
+            if(m_dvfs) {
+                //the proxy applies its results on its own LP
+                map<int, DVFSClock*>::iterator c = m_dvfs_clocks.find(node_id);
+                if(c == m_dvfs_clocks.end()) {
+                    cerr << "processor.dvfs requires the cores on the LP of the KitFox proxy\n";
+                    exit(1);
+                }
+                kitfox_builder->get_kitfox()->add_listener(new kitfox_dvfs_governor_t(proc_cid, (*c).second,
+                                                           m_dvfs_hot_temp, m_dvfs_cool_temp,
+                                                           m_dvfs_low_freq, (*c).second->freq));
+            }
+        }
     }
 }
 #endif
@@ -589,6 +263,9 @@ void Spx_builder :: print_config(std::ostream& out)
     ProcBuilder::print_config(out);
     out << "  type: SPX" << endl;
     out << "  config file: " << m_CONFIG_FILE << endl;
+    if(m_dvfs)
+        out << "  dvfs: hot_temp= " << m_dvfs_hot_temp << "K, cool_temp= " << m_dvfs_cool_temp
+            << "K, low_freq= " << m_dvfs_low_freq << endl;
 }
 
 void Spx_builder :: print_stats(std::ostream& out)
@@ -17,12 +17,13 @@ using namespace manifold::kitfox_proxy;
 
 class ProcBuilder {
 public:
-    enum ProcType { PROC_ZESTO, PROC_SIMPLE, PROC_SPX}; //processor model type
+    enum ProcType { PROC_ZESTO, PROC_SIMPLE, PROC_SPX, PROC_REPLAY}; //processor model type
 
     enum FEType {INVALID_FE_TYPE=0, QSIMCLIENT, QSIMLIB, QSIMPROXY, TRACE};  //front-end type
 
     ProcBuilder(SysBuilder_llp* b) : m_fe_type(INVALID_FE_TYPE),
                                      m_sysBuilder(b),
+                                     m_tick_threads(0),
                                      m_qsim_interrupt_handler_clock(0),
                                      m_qsim_interrupt_handler(0) {}
     virtual ~ProcBuilder() {
@@ -59,6 +60,7 @@ protected:
     std::vector<double> m_CLOCK_FREQ; //clock frequency for the processors
     std::vector<manifold::kernel::Clock*> m_clocks;
     bool m_use_default_clock;
+    unsigned m_tick_threads; //threads stepping the processors of an LP in parallel; 0 or 1 for sequential
 
     std::map<int, int> m_proc_id_cid_map;
 
@@ -68,111 +70,11 @@ protected:
 };
 
 
-#if 0
-//#####################################################################
-//#####################################################################
-class Zesto_builder : public ProcBuilder {
-public:
-    Zesto_builder(SysBuilder_llp* b) : ProcBuilder(b) {}
-    #if 0
-    Zesto_builder(ProcType type, char* conf, const char* server, int port) :  //qsim server
-          ProcBuilder(type), m_conf(conf), m_server(server), m_port(port) {}
-    Zesto_builder(ProcType type, SysBuilder_llp* b, char* conf, Qsim::OSDomain* osd) :  //qsim lib
-          ProcBuilder(type, b), m_conf(conf), m_qsim_osd(osd) {}
-    Zesto_builder(ProcType type, SysBuilder_llp* b, char* conf, const char* trace) :  //trace
-          ProcBuilder(type, b), m_conf(conf), m_trace(trace) {}
-#endif
-
-    ProcType get_proc_type() { return PROC_ZESTO; }
-
-    void read_config(libconfig::Config&);
-    void set_qsimclient_vals(const char* server, int port) {
-        m_server = server;
-    m_port = port;
-    }
-    void set_qsimlib_vals(Qsim::OSDomain* osd) {
-        m_qsim_osd = osd;
-    }
-    void set_trace_vals(const char* trace) {
-        m_trace = trace;
-    }
-
-    void create_qsimclient_procs(std::map<int,int>& id_lp);
-    void create_qsimlib_procs(std::map<int,int>& id_lp);
-    void create_qsimproxy_procs(std::map<int,int>& id_lp);
-    void create_trace_procs(std::map<int,int>& id_lp);
-
-    void connect_proc_cache(CacheBuilder* cache_builder);
-    void connect_proc_qsim_proxy(QsimBuilder* qsim_builder);
-
-    void print_config(std::ostream&);
-    void print_stats(std::ostream&);
-private:
-    //char* m_conf; //config file name
-    const char* m_server; //server name or IP
-    int m_port; //server port
-    Qsim::OSDomain* m_qsim_osd;
-    const char* m_trace; //trace file name
-    std::string m_CONFIG_FILE;
-};
-
-
-//#####################################################################
-//#####################################################################
-//for simple-proc
-class Simple_builder : public ProcBuilder {
-public:
-    Simple_builder(SysBuilder_llp* b) : ProcBuilder(b) {}
-#if 0
-    Simple_builder(ProcType type, SysBuilder_llp* b, int l1_line_sz, const char* server, int port) :  //qsim server
-          ProcBuilder(type, b), m_l1_line_sz(l1_line_sz), m_server(server), m_port(port) {}
-    Simple_builder(ProcType type, SysBuilder_llp* b, int l1_line_sz, Qsim::OSDomain* osd) :  //qsim lib
-          ProcBuilder(type, b), m_l1_line_sz(l1_line_sz), m_qsim_osd(osd) {}
-    Simple_builder(ProcType type, SysBuilder_llp* b, int l1_line_sz, const char* trace) :  //trace file
-          ProcBuilder(type, b), m_l1_line_sz(l1_line_sz), m_trace(trace) {}
-#endif
-    ProcType get_proc_type() { return PROC_SIMPLE; }
-
-    void read_config(libconfig::Config&) {
-    m_use_default_clock = true;
-    }
-    void set_qsimclient_vals(int l1_line_sz, const char* server, int port) {
-        m_l1_line_sz = l1_line_sz;
-        m_server = server;
-    m_port = port;
-    }
-    void set_qsimlib_vals(int l1_line_sz, Qsim::OSDomain* osd) {
-    m_l1_line_sz = l1_line_sz;
-        m_qsim_osd = osd;
-    }
-    void set_trace_vals(int l1_line_sz, const char* trace) {
-        m_l1_line_sz = l1_line_sz;
-        m_trace = trace;
-    }
-
-    void create_qsimclient_procs(std::map<int,int>& id_lp);
-    void create_qsimlib_procs(std::map<int,int>& id_lp);
-    void create_qsimproxy_procs(std::map<int,int>& id_lp);
-    void create_trace_procs(std::map<int,int>& id_lp);
-
-    void connect_proc_cache(CacheBuilder* cache_builder);
-    void connect_proc_qsim_proxy(QsimBuilder* qsim_builder);
-    void print_config(std::ostream&);
-    void print_stats(std::ostream&);
-private:
-    int m_l1_line_sz; //L1 line size
-    const char* m_server; //server name or IP
-    int m_port; //server port
-    Qsim::OSDomain* m_qsim_osd;
-    const char* m_trace; //trace file name
-};
-#endif
-
 //#####################################################################
 //#####################################################################
 class Spx_builder : public ProcBuilder {
 public:
-    Spx_builder(SysBuilder_llp* b) : ProcBuilder(b) {}
+    Spx_builder(SysBuilder_llp* b) : ProcBuilder(b), m_dvfs(false) {}
 #if 0
     Spx_builder(ProcType type, SysBuilder_llp* b, const char* conf) :  //qsim server
           ProcBuilder(type, b), m_conf(conf) {}
@@ -215,6 +117,13 @@ private:
     int m_port; //server port
     std::string m_CONFIG_FILE;
 
+    //thermal DVFS: each core runs on its own DVFSClock, which KitFox results
+    //lower to m_dvfs_low_freq above m_dvfs_hot_temp and restore below m_dvfs_cool_temp
+    bool m_dvfs;
+    double m_dvfs_hot_temp; //Kelvin
+    double m_dvfs_cool_temp; //Kelvin
+    double m_dvfs_low_freq;
+    std::map<int, manifold::kernel::DVFSClock*> m_dvfs_clocks; //clocks of this LP's cores, by node id
 };
 
 
@@ -1,4 +1,7 @@
 #include "sysBuilder_l1l2.h"
+#ifdef TRACE_PROCS
+#include "trace_proc_builder.h"
+#endif
 
 using namespace manifold::kernel;
 using namespace libconfig;
@@ -20,6 +23,9 @@ void SysBuilder_l1l2 :: config_components()
 	        m_DEFAULT_CLOCK_FREQ = -1;
 	    }
 
+	    //optional functional cache warm-up
+	    config_warmup();
+
 
     	//network
 	    try {
@@ -43,10 +49,13 @@ void SysBuilder_l1l2 :: config_components()
 	    // processor
 	    const char* proc_chars = m_config.lookup("processor.type");
 	    string proc_str = proc_chars;
-   /*     if(proc_str == "ZESTO") m_proc_builder = new Zesto_builder(this);*/
-		//else if (proc_str == "SIMPLE") m_proc_builder = new Simple_builder(this);
-        //else if(proc_str == "SPX") m_proc_builder = new Spx_builder(this);
-        if (proc_str == "SPX") m_proc_builder = new Spx_builder(this);
+        if(proc_str == "SPX") m_proc_builder = new Spx_builder(this);
+#ifdef TRACE_PROCS
+        //Zesto, SimpleProc and Replay are only built into the Trace simulators
+        else if(proc_str == "ZESTO") m_proc_builder = new Zesto_builder(this);
+        else if(proc_str == "SIMPLE") m_proc_builder = new Simple_builder(this);
+        else if(proc_str == "REPLAY") m_proc_builder = new Replay_builder(this);
+#endif
         else {
 	        cerr << "Processor type  " << proc_str << "  not supported\n";
 		    exit(1);
@@ -1,4 +1,10 @@
 #include "sysBuilder_llp.h"
+#ifdef TRACE_PROCS
+#include "trace_proc_builder.h"
+#endif
+
+#include <fstream>
+#include <stdlib.h>
 
 #include "kernel/clock.h"
 #include "kernel/component.h"
@@ -41,6 +47,8 @@ SysBuilder_llp :: SysBuilder_llp(const char* fname)
     m_qsim_osd = 0;
 
     m_default_clock = 0;
+
+    m_warmup_refs = 0;
 }
 
 SysBuilder_llp :: ~SysBuilder_llp()
@@ -84,12 +92,24 @@ void SysBuilder_llp :: config_components()
             //if default clock not defined
             m_DEFAULT_CLOCK_FREQ = -1;
         }
+
+        //optional functional cache warm-up
+        config_warmup();
+
 #ifdef LIBKITFOX
         //kitfox
         try {
             const char* kitfox_chars = m_config.lookup("kitfox_config");
             uint64_t sampling_freq = m_config.lookup("kitfox_freq");
-            m_kitfox_builder = new KitFoxBuilder(kitfox_chars, sampling_freq);
+            //threads evaluating KitFox off the simulation thread, and how many
+            //samples later their results are applied; 0 threads is synchronous
+            unsigned kitfox_threads = 0;
+            unsigned kitfox_lag = 1;
+            if(m_config.exists("kitfox_threads"))
+                kitfox_threads = (int)m_config.lookup("kitfox_threads");
+            if(m_config.exists("kitfox_lag"))
+                kitfox_lag = (int)m_config.lookup("kitfox_lag");
+            m_kitfox_builder = new KitFoxBuilder(kitfox_chars, sampling_freq, kitfox_threads, kitfox_lag);
             if(m_kitfox_builder == NULL)
             {
                     cerr << "KitFox config  " << kitfox_chars << "  contains errors\n";
@@ -124,10 +144,13 @@ void SysBuilder_llp :: config_components()
         // processor
         const char* proc_chars = m_config.lookup("processor.type");
         string proc_str = proc_chars;
-   /*     if(proc_str == "ZESTO") m_proc_builder = new Zesto_builder(this);*/
-        //else if (proc_str == "SIMPLE") m_proc_builder = new Simple_builder(this);
-        //else if (proc_str == "SPX") m_proc_builder = new Spx_builder(this);
-        if (proc_str == "SPX") m_proc_builder = new Spx_builder(this);
+        if(proc_str == "SPX") m_proc_builder = new Spx_builder(this);
+#ifdef TRACE_PROCS
+        //Zesto, SimpleProc and Replay are only built into the Trace simulators
+        else if(proc_str == "ZESTO") m_proc_builder = new Zesto_builder(this);
+        else if(proc_str == "SIMPLE") m_proc_builder = new Simple_builder(this);
+        else if(proc_str == "REPLAY") m_proc_builder = new Replay_builder(this);
+#endif
         else {
             cerr << "Processor type  " << proc_str << "  not supported\n";
             exit(1);
@@ -211,6 +234,22 @@ void SysBuilder_llp :: config_components()
 }
 
 
+//====================================================================
+// Reads the optional functional cache warm-up; shared by the llp and l1l2
+// systems. Setting exceptions are left to the caller.
+//====================================================================
+void SysBuilder_llp :: config_warmup()
+{
+    if(m_config.exists("warmup")) {
+        const char* warmup_chars = m_config.lookup("warmup.trace");
+        m_warmup_trace = warmup_chars;
+        m_warmup_refs = (uint64_t)-1;
+        if(m_config.exists("warmup.refs"))
+            m_warmup_refs = (long long)m_config.lookup("warmup.refs");
+    }
+}
+
+
 //====================================================================
 // for QsimClient and trace front-end
 //====================================================================
@@ -460,26 +499,42 @@ void SysBuilder_llp :: create_qsimproxy_nodes(vector<string>& args, const char*
 void SysBuilder_llp :: create_trace_nodes(int n_lps, vector<string>& args, int part)
 {
     switch(m_proc_builder->get_proc_type()) {
-       /* case ProcBuilder::PROC_ZESTO: {*/
-            //if(args.size() != 1) {
-                //cerr << "Usage for Zesto core:  <trace_file_basename>\n";
-                //exit(1);
-            //}
-            //Zesto_builder* z = dynamic_cast<Zesto_builder*>(m_proc_builder);
-            //assert(z);
-            //z->set_trace_vals(args[0].c_str());
-            //break;
-        //}
-        //case ProcBuilder::PROC_SIMPLE: {
-            //if(args.size() != 1) {
-                //cerr << "Usage for SimpleProc core:  <trace_file_basename>\n";
-                //exit(1);
-            //}
-            //Simple_builder* s = dynamic_cast<Simple_builder*>(m_proc_builder);
-            //assert(s);
-            //s->set_trace_vals(m_cache_builder->get_l1_block_size(), args[0].c_str());
-            //break;
-        //}
+#ifdef TRACE_PROCS
+        case ProcBuilder::PROC_ZESTO: {
+            if(args.size() != 1) {
+                cerr << "Usage for Zesto core:  <trace_file_basename>\n";
+                exit(1);
+            }
+            Zesto_builder* z = dynamic_cast<Zesto_builder*>(m_proc_builder);
+            assert(z);
+            z->set_trace_vals(args[0].c_str());
+            break;
+        }
+        case ProcBuilder::PROC_SIMPLE: {
+            if(args.size() != 1) {
+                cerr << "Usage for SimpleProc core:  <trace_file_basename>\n";
+                exit(1);
+            }
+            Simple_builder* s = dynamic_cast<Simple_builder*>(m_proc_builder);
+            assert(s);
+            s->set_trace_vals(m_cache_builder->get_l1_block_size(), args[0].c_str());
+            break;
+        }
+        case ProcBuilder::PROC_REPLAY: {
+            if(args.size() != 1) {
+                cerr << "Usage for Replay processor:  <trace_file_basename>\n";
+                exit(1);
+            }
+            Replay_builder* r = dynamic_cast<Replay_builder*>(m_proc_builder);
+            assert(r);
+            r->set_trace_vals(args[0].c_str());
+            break;
+        }
+#endif
+        case ProcBuilder::PROC_SPX: {
+            cerr << "SPX does not support trace files!\n";
+            exit(1);
+        }
 
         default: { assert(0); }
     }
@@ -678,6 +733,67 @@ void SysBuilder_llp :: pre_simulation()
 {
     m_cache_builder->pre_simulation();
     m_network_builder->pre_simulation();
+
+    if(m_warmup_trace != "")
+        warm_up_caches();
+}
+
+
+
+//====================================================================
+// Applies the references of the warm-up traces to the caches functionally,
+// one reference of each processor in turn. The trace of the i-th processor,
+// in node id order, is <basename>i, in the format of the simple-proc traces:
+// "0 <hex addr>" for a load and "1 <hex addr>" for a store; other lines are
+// skipped.
+//====================================================================
+void SysBuilder_llp :: warm_up_caches()
+{
+    manifold::mcp_cache_namespace::Cache_warmup warmup;
+    if(m_cache_builder->add_to_warmup(warmup) == false) {
+        cerr << "Cache warm-up requires all caches to be on one LP\n";
+        exit(1);
+    }
+
+    vector<int> nodes;
+    vector<ifstream*> files;
+    int cpuid = 0;
+    for(map<int,int>::iterator it = proc_id_lp_map.begin(); it != proc_id_lp_map.end(); ++it) {
+        char buf[1024];
+        snprintf(buf, sizeof(buf), "%s%d", m_warmup_trace.c_str(), cpuid++);
+        ifstream* f = new ifstream(buf);
+        if(!f->is_open()) {
+            cerr << "Cannot open warm-up trace " << buf << endl;
+            exit(1);
+        }
+        nodes.push_back((*it).first);
+        files.push_back(f);
+    }
+
+    vector<uint64_t> refs(files.size(), 0);
+    unsigned active = files.size();
+    while(active > 0) {
+        active = 0;
+        for(unsigned i=0; i<files.size(); i++) {
+            string line;
+            while(refs[i] < m_warmup_refs && getline(*files[i], line)) {
+                const char* s = line.c_str();
+                char* end;
+                unsigned long c = strtoul(s, &end, 16);
+                if(end == s || c > 1)
+                    continue; //not a memory reference
+                warmup.access(nodes[i], strtoull(end, 0, 16), c == 0);
+                refs[i]++;
+                active++;
+                break;
+            }
+        }
+    }
+
+    for(unsigned i=0; i<files.size(); i++)
+        delete files[i];
+
+    warmup.print_stats(cout);
 }
 
 
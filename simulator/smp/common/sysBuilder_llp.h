@@ -67,6 +67,7 @@ protected:
     //enum { PROC_ZESTO, PROC_SIMPLE, PROC_SPX }; //processor model type
 
     virtual void config_components();
+    void config_warmup();
     virtual void create_nodes(int type, int n_lps, int part);
 
     virtual void do_partitioning_1_part(int n_lps);
@@ -88,6 +89,9 @@ protected:
     manifold::kernel::Ticks_t STOP; //simulation stop time
     uint64_t m_DEFAULT_CLOCK_FREQ; //default clock's frequency
 
+    std::string m_warmup_trace; //basename of the cache warm-up traces; empty if none
+    uint64_t m_warmup_refs; //max references per processor in the warm-up
+
     std::vector<Node_conf_llp> m_node_conf;
 
     std::vector<int> proc_node_idx_vec;
@@ -113,6 +117,8 @@ private:
 
     void connect_components();
 
+    void warm_up_caches();
+
     void dep_injection_for_iris();
     void dep_injection_for_mcp();
 
@@ -0,0 +1,437 @@
+#include "trace_proc_builder.h"
+#include "sysBuilder_llp.h"
+#include "zesto/trace-core.h"
+#include "simple-proc/trace-proc.h"
+#include "simple-proc/mem-replay.h"
+#include "mcp-cache/MESI_LLP_cache.h"
+#include "mcp-cache/MESI_L1_cache.h"
+
+using namespace libconfig;
+using namespace manifold::kernel;
+using namespace manifold::zesto;
+using namespace manifold::simple_proc;
+using namespace std;
+using namespace manifold::mcp_cache_namespace;
+
+
+//####################################################################
+//####################################################################
+void Zesto_builder :: read_config(Config& config)
+{
+    try {
+	    Setting& proc_nodes = config.lookup("processor.node_idx");
+	    m_NUM_PROC = proc_nodes.getLength();
+
+	    try {
+	        Setting& proc_clocks = config.lookup("processor.clocks");
+	        if((unsigned)proc_clocks.getLength() != m_NUM_PROC) {
+	            cerr << "processor.clocks must have " << m_NUM_PROC << " entries, one per processor\n";
+	            exit(1);
+	        }
+	        m_CLOCK_FREQ.resize(m_NUM_PROC);
+
+	        for(unsigned i=0; i<m_NUM_PROC; i++)
+		        m_CLOCK_FREQ[i] = (double)proc_clocks[i];
+
+	        m_use_default_clock = false;
+	    }
+	    catch (SettingNotFoundException e) {
+	        //clock not defined; use default
+	        m_use_default_clock = true;
+	    }
+
+	    const char* chars = config.lookup("processor.config");
+	    m_CONFIG_FILE = chars;
+    }
+    catch (SettingNotFoundException e) {
+	    cout << e.getPath() << " not set." << endl;
+	    exit(1);
+    }
+    catch (SettingTypeException e) {
+	    cout << e.getPath() << " has incorrect type." << endl;
+	    exit(1);
+    }
+}
+
+void Zesto_builder :: create_qsimclient_procs(std::map<int,int>& id_lp)
+{
+    cerr << "Zesto in this build only supports trace files!\n";
+    exit(1);
+}
+
+void Zesto_builder :: create_qsimlib_procs(std::map<int,int>& id_lp)
+{
+    cerr << "Zesto in this build only supports trace files!\n";
+    exit(1);
+}
+
+void Zesto_builder :: create_qsimproxy_procs(std::map<int,int>& id_lp)
+{
+    cerr << "Zesto does not support Qsim Proxy!\n";
+    exit(1);
+}
+
+void Zesto_builder :: create_trace_procs(std::map<int,int>& id_lp)
+{
+    assert(m_fe_type == TRACE);
+    assert(m_proc_id_cid_map.size() == 0);
+
+    //create clocks if necessary
+    if(m_use_default_clock == false) {
+        m_clocks.resize(m_CLOCK_FREQ.size());
+        for(unsigned i=0; i<m_clocks.size(); i++)
+            m_clocks[i] = new manifold::kernel::Clock(m_CLOCK_FREQ[i]);
+    }
+
+    int cpuid = 0;
+    int i=0;
+    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
+        char buf[100];
+	    sprintf(buf, "%s%d", m_trace, cpuid);
+        int node_id = (*it).first;
+        int lp = (*it).second;
+        int cid = manifold::kernel::Component::Create<trace_core_t>(lp, node_id, (char*)m_CONFIG_FILE.c_str(), buf);
+	    cpuid++;
+        m_proc_id_cid_map[node_id] = cid;
+	    trace_core_t* proc = manifold::kernel::Component :: GetComponent<trace_core_t>(cid);
+	    Clock* clk = 0;
+	    if(m_use_default_clock) {
+	        clk = m_sysBuilder->get_default_clock();
+	    }
+	    else {
+	        clk = m_clocks[i++];
+	    }
+	    assert(clk);
+	    if(proc) {
+	        Clock :: Register(*clk, (core_t*)proc, &trace_core_t::tick, (void(core_t::*)(void))0);
+	    }
+    }
+}
+
+void Zesto_builder :: connect_proc_qsim_proxy(QsimBuilder* qsim_builder)
+{
+    assert(get_fe_type() != QSIMPROXY);
+    return;
+
+    /*
+    cerr << "Zesto doesn't support Qsim Proxy\n";
+    exit(1);
+    */
+}
+
+void Zesto_builder :: connect_proc_cache(CacheBuilder* cache_builder)
+{
+    switch(cache_builder->get_type()) {
+        case CacheBuilder::MCP_CACHE: {
+	        MCP_lp_lls_builder* mcp_builder = dynamic_cast<MCP_lp_lls_builder*>(cache_builder);
+		    assert(mcp_builder);
+
+		    map<int, LP_LLS_unit*>& mcp_caches = mcp_builder->get_cache_map();
+
+		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+		        int node_id = (*it).first;
+		        int proc_cid = (*it).second;
+		        LP_LLS_unit* unit = mcp_caches[node_id];
+		        assert(unit);
+		        int cache_cid = unit->get_llp_cid();
+
+		        //connect proc with L1 cache
+		        //!!!!!!!!!!!!!!!!!!! todo: use proper clock!
+		        Manifold :: Connect(proc_cid, core_t::PORT0, &core_t::cache_response_handler,
+					                cache_cid, MESI_LLP_cache::PORT_PROC,
+					                &MESI_LLP_cache::handle_processor_request<ZestoCacheReq>, Clock::Master(), Clock::Master(), 1, 1);
+
+		    }//for
+	        break;
+        }
+        case CacheBuilder::MCP_L1L2: {
+	        MCP_l1l2_builder* mcp_builder = dynamic_cast<MCP_l1l2_builder*>(cache_builder);
+		    assert(mcp_builder);
+
+		    map<int, int>& l1_cids = mcp_builder->get_l1_cids();
+
+		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+		        int node_id = (*it).first;
+		        int proc_cid = (*it).second;
+		        int cache_cid = l1_cids[node_id];
+
+		        //connect proc with L1 cache
+		        //!!!!!!!!!!!!!!!!!!! todo: use proper clock!
+		        Manifold :: Connect(proc_cid, core_t::PORT0, &core_t::cache_response_handler,
+					                cache_cid, MESI_L1_cache::PORT_PROC,
+					                &MESI_L1_cache::handle_processor_request<ZestoCacheReq>, Clock::Master(), Clock::Master(), 1, 1);
+
+		    }//for
+	        break;
+        }
+        default: { assert(0); }
+    }
+}
+
+void Zesto_builder :: print_config(std::ostream& out)
+{
+    ProcBuilder::print_config(out);
+    out << "  type: Zesto" << endl;
+    out << "  config file: " << m_CONFIG_FILE << endl;
+    if(m_fe_type == QSIMCLIENT) {
+        out << "  server= " << m_server << "  port= " << m_port << endl;
+    }
+}
+
+void Zesto_builder :: print_stats(std::ostream& out)
+{
+    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+        int cid = (*it).second;
+	    core_t* proc = Component :: GetComponent<core_t>(cid);
+	    if(proc) {
+	        proc->print_stats();
+	        proc->print_stats(out);
+	    }
+    }
+}
+
+
+//####################################################################
+//####################################################################
+void Simple_builder :: create_qsimclient_procs(std::map<int,int>& id_lp)
+{
+    cerr << "SimpleProc in this build only supports trace files!\n";
+    exit(1);
+}
+
+
+void Simple_builder :: create_qsimlib_procs(std::map<int,int>& id_lp)
+{
+    cerr << "SimpleProc in this build only supports trace files!\n";
+    exit(1);
+}
+
+void Simple_builder :: create_qsimproxy_procs(std::map<int,int>& id_lp)
+{
+    cerr << "SimpleProc does not support Qsim Proxy!\n";
+    exit(1);
+}
+
+void Simple_builder :: create_trace_procs(std::map<int,int>& id_lp)
+{
+    assert(m_fe_type == TRACE);
+    assert(m_proc_id_cid_map.size() == 0);
+
+    manifold::simple_proc::SimpleProc_Settings proc_settings(m_l1_line_sz);
+    int cpuid = 0;
+    int i=0;
+    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
+        char buf[100];
+    	sprintf(buf, "%s%d", m_trace, cpuid);
+        int node_id = (*it).first;
+        int lp = (*it).second;
+        int cid = manifold::kernel::Component::Create<TraceProcessor>(lp, cpuid, buf, proc_settings);
+	    cpuid++;
+        m_proc_id_cid_map[node_id] = cid;
+	    TraceProcessor* proc = manifold::kernel::Component :: GetComponent<TraceProcessor>(cid);
+	    Clock* clk = 0;
+	    if(m_use_default_clock) {
+	        clk = m_sysBuilder->get_default_clock();
+	    }
+	    else {
+	        clk = m_clocks[i++];
+	    }
+	    assert(clk);
+	    if(proc) {
+	        Clock :: Register(*clk, (SimpleProcessor*)proc, &TraceProcessor::tick, (void(SimpleProcessor::*)(void))0);
+	    }
+    }
+}
+
+void Simple_builder :: connect_proc_qsim_proxy(QsimBuilder* qsim_builder)
+{
+    assert(get_fe_type() != QSIMPROXY);
+    return;
+
+    /*
+    cerr << "SimpleProc doesn't support Qsim Proxy\n";
+    exit(1);
+    */
+}
+
+void Simple_builder :: connect_proc_cache(CacheBuilder* cache_builder)
+{
+    switch(cache_builder->get_type()) {
+        case CacheBuilder::MCP_CACHE: {
+	        MCP_lp_lls_builder* mcp_builder = dynamic_cast<MCP_lp_lls_builder*>(cache_builder);
+		    assert(mcp_builder);
+
+		    map<int, LP_LLS_unit*>& mcp_caches = mcp_builder->get_cache_map();
+
+		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+		        int node_id = (*it).first;
+		        int proc_cid = (*it).second;
+		        LP_LLS_unit* unit = mcp_caches[node_id];
+		        assert(unit);
+		        int cache_cid = unit->get_llp_cid();
+
+		        //connect proc with L1 cache
+		        //!!!!!!!!!!!!!!!!!!! todo: use proper clock!
+		        Manifold :: Connect(proc_cid, SimpleProcessor::PORT_CACHE, &SimpleProcessor::handle_cache_response,
+					                cache_cid, MESI_LLP_cache::PORT_PROC,
+					                &MESI_LLP_cache::handle_processor_request<manifold::simple_proc::CacheReq>, Clock::Master(), Clock::Master(), 1, 1);
+
+		    }//for
+	        break;
+        }
+        default: { assert(0); }
+    }
+}
+
+void Simple_builder :: print_config(std::ostream& out)
+{
+    ProcBuilder::print_config(out);
+    out << "  type: SimpleProc" << endl;
+}
+
+void Simple_builder :: print_stats(std::ostream& out)
+{
+    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+        int cid = (*it).second;
+	    SimpleProcessor* proc = Component :: GetComponent<SimpleProcessor>(cid);
+	    if(proc) {
+	        proc->print_stats(out);
+	    }
+    }
+}
+
+//####################################################################
+//####################################################################
+void Replay_builder :: read_config(Config& config)
+{
+    try {
+	    Setting& proc_nodes = config.lookup("processor.node_idx");
+	    m_NUM_PROC = proc_nodes.getLength();
+
+	    //optional
+	    if(config.exists("processor.mlp"))
+	        m_mlp = (int)config.lookup("processor.mlp");
+	    if(config.exists("processor.issue_width"))
+	        m_issue_width = (int)config.lookup("processor.issue_width");
+	    if(m_mlp < 1 || m_issue_width < 1) {
+	        cerr << "processor.mlp and processor.issue_width must be at least 1\n";
+	        exit(1);
+	    }
+    }
+    catch (SettingNotFoundException e) {
+	    cout << e.getPath() << " not set." << endl;
+	    exit(1);
+    }
+    catch (SettingTypeException e) {
+	    cout << e.getPath() << " has incorrect type." << endl;
+	    exit(1);
+    }
+    m_use_default_clock = true;
+}
+
+void Replay_builder :: create_qsimclient_procs(std::map<int,int>& id_lp)
+{
+    cerr << "Replay processors only support trace files!\n";
+    exit(1);
+}
+
+void Replay_builder :: create_qsimlib_procs(std::map<int,int>& id_lp)
+{
+    cerr << "Replay processors only support trace files!\n";
+    exit(1);
+}
+
+void Replay_builder :: create_qsimproxy_procs(std::map<int,int>& id_lp)
+{
+    cerr << "Replay processors only support trace files!\n";
+    exit(1);
+}
+
+void Replay_builder :: create_trace_procs(std::map<int,int>& id_lp)
+{
+    assert(m_fe_type == TRACE);
+    assert(m_proc_id_cid_map.size() == 0);
+
+    MemReplay_Settings proc_settings(m_mlp, m_issue_width);
+    int cpuid = 0;
+    for(map<int,int>::iterator it = id_lp.begin(); it != id_lp.end(); ++it) {
+        char buf[100];
+    	sprintf(buf, "%s%d", m_trace, cpuid);
+        int node_id = (*it).first;
+        int lp = (*it).second;
+        int cid = manifold::kernel::Component::Create<MemReplayProcessor>(lp, cpuid, buf, proc_settings);
+	    cpuid++;
+        m_proc_id_cid_map[node_id] = cid;
+	    MemReplayProcessor* proc = manifold::kernel::Component :: GetComponent<MemReplayProcessor>(cid);
+	    if(proc) {
+	        Clock :: Register(*m_sysBuilder->get_default_clock(), proc, &MemReplayProcessor::tick, (void(MemReplayProcessor::*)(void))0);
+	    }
+    }
+}
+
+void Replay_builder :: connect_proc_qsim_proxy(QsimBuilder* qsim_builder)
+{
+    assert(get_fe_type() != QSIMPROXY);
+}
+
+void Replay_builder :: connect_proc_cache(CacheBuilder* cache_builder)
+{
+    switch(cache_builder->get_type()) {
+        case CacheBuilder::MCP_CACHE: {
+	        MCP_lp_lls_builder* mcp_builder = dynamic_cast<MCP_lp_lls_builder*>(cache_builder);
+		    assert(mcp_builder);
+
+		    map<int, LP_LLS_unit*>& mcp_caches = mcp_builder->get_cache_map();
+
+		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+		        int node_id = (*it).first;
+		        int proc_cid = (*it).second;
+		        LP_LLS_unit* unit = mcp_caches[node_id];
+		        assert(unit);
+		        int cache_cid = unit->get_llp_cid();
+
+		        Manifold :: Connect(proc_cid, MemReplayProcessor::PORT_CACHE, &MemReplayProcessor::handle_cache_response,
+					                cache_cid, MESI_LLP_cache::PORT_PROC,
+					                &MESI_LLP_cache::handle_processor_request<MemReplayReq>, Clock::Master(), Clock::Master(), 1, 1);
+		    }//for
+	        break;
+        }
+        case CacheBuilder::MCP_L1L2: {
+	        MCP_l1l2_builder* mcp_builder = dynamic_cast<MCP_l1l2_builder*>(cache_builder);
+		    assert(mcp_builder);
+
+		    map<int, int>& l1_cids = mcp_builder->get_l1_cids();
+
+		    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+		        int node_id = (*it).first;
+		        int proc_cid = (*it).second;
+		        int cache_cid = l1_cids[node_id];
+
+		        Manifold :: Connect(proc_cid, MemReplayProcessor::PORT_CACHE, &MemReplayProcessor::handle_cache_response,
+					                cache_cid, MESI_L1_cache::PORT_PROC,
+					                &MESI_L1_cache::handle_processor_request<MemReplayReq>, Clock::Master(), Clock::Master(), 1, 1);
+		    }//for
+	        break;
+        }
+        default: { assert(0); }
+    }
+}
+
+void Replay_builder :: print_config(std::ostream& out)
+{
+    ProcBuilder::print_config(out);
+    out << "  type: Replay" << endl;
+    out << "  mlp: " << m_mlp << "  issue width: " << m_issue_width << endl;
+}
+
+void Replay_builder :: print_stats(std::ostream& out)
+{
+    for(map<int,int>::iterator it = m_proc_id_cid_map.begin(); it != m_proc_id_cid_map.end(); ++it) {
+        int cid = (*it).second;
+	    MemReplayProcessor* proc = Component :: GetComponent<MemReplayProcessor>(cid);
+	    if(proc) {
+	        proc->print_stats(out);
+	    }
+    }
+}
+
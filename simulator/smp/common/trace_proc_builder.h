@@ -0,0 +1,149 @@
+#ifndef TRACE_PROC_BUILDER_H
+#define TRACE_PROC_BUILDER_H
+
+//Zesto, SimpleProc and Replay builders; these are only compiled into the
+//Trace simulators, which link the Zesto and SimpleProc libraries.
+
+#include "proc_builder.h"
+
+//#####################################################################
+//#####################################################################
+class Zesto_builder : public ProcBuilder {
+public:
+    Zesto_builder(SysBuilder_llp* b) : ProcBuilder(b) {}
+    #if 0
+    Zesto_builder(ProcType type, char* conf, const char* server, int port) :  //qsim server
+          ProcBuilder(type), m_conf(conf), m_server(server), m_port(port) {}
+    Zesto_builder(ProcType type, SysBuilder_llp* b, char* conf, Qsim::OSDomain* osd) :  //qsim lib
+          ProcBuilder(type, b), m_conf(conf), m_qsim_osd(osd) {}
+    Zesto_builder(ProcType type, SysBuilder_llp* b, char* conf, const char* trace) :  //trace
+          ProcBuilder(type, b), m_conf(conf), m_trace(trace) {}
+#endif
+
+    ProcType get_proc_type() { return PROC_ZESTO; }
+
+    void read_config(libconfig::Config&);
+    void set_qsimclient_vals(const char* server, int port) {
+        m_server = server;
+    m_port = port;
+    }
+    void set_qsimlib_vals(Qsim::OSDomain* osd) {
+        m_qsim_osd = osd;
+    }
+    void set_trace_vals(const char* trace) {
+        m_trace = trace;
+    }
+
+    void create_qsimclient_procs(std::map<int,int>& id_lp);
+    void create_qsimlib_procs(std::map<int,int>& id_lp);
+    void create_qsimproxy_procs(std::map<int,int>& id_lp);
+    void create_trace_procs(std::map<int,int>& id_lp);
+
+#ifdef LIBKITFOX
+    void connect_proc_kitfox_proxy(KitFoxBuilder* kitfox_builder) {} //no power model for these cores
+#endif
+
+    void connect_proc_cache(CacheBuilder* cache_builder);
+    void connect_proc_qsim_proxy(QsimBuilder* qsim_builder);
+
+    void print_config(std::ostream&);
+    void print_stats(std::ostream&);
+private:
+    //char* m_conf; //config file name
+    const char* m_server; //server name or IP
+    int m_port; //server port
+    Qsim::OSDomain* m_qsim_osd;
+    const char* m_trace; //trace file name
+    std::string m_CONFIG_FILE;
+};
+
+
+//#####################################################################
+//#####################################################################
+//for simple-proc
+class Simple_builder : public ProcBuilder {
+public:
+    Simple_builder(SysBuilder_llp* b) : ProcBuilder(b) {}
+#if 0
+    Simple_builder(ProcType type, SysBuilder_llp* b, int l1_line_sz, const char* server, int port) :  //qsim server
+          ProcBuilder(type, b), m_l1_line_sz(l1_line_sz), m_server(server), m_port(port) {}
+    Simple_builder(ProcType type, SysBuilder_llp* b, int l1_line_sz, Qsim::OSDomain* osd) :  //qsim lib
+          ProcBuilder(type, b), m_l1_line_sz(l1_line_sz), m_qsim_osd(osd) {}
+    Simple_builder(ProcType type, SysBuilder_llp* b, int l1_line_sz, const char* trace) :  //trace file
+          ProcBuilder(type, b), m_l1_line_sz(l1_line_sz), m_trace(trace) {}
+#endif
+    ProcType get_proc_type() { return PROC_SIMPLE; }
+
+    void read_config(libconfig::Config&) {
+    m_use_default_clock = true;
+    }
+    void set_qsimclient_vals(int l1_line_sz, const char* server, int port) {
+        m_l1_line_sz = l1_line_sz;
+        m_server = server;
+    m_port = port;
+    }
+    void set_qsimlib_vals(int l1_line_sz, Qsim::OSDomain* osd) {
+    m_l1_line_sz = l1_line_sz;
+        m_qsim_osd = osd;
+    }
+    void set_trace_vals(int l1_line_sz, const char* trace) {
+        m_l1_line_sz = l1_line_sz;
+        m_trace = trace;
+    }
+
+    void create_qsimclient_procs(std::map<int,int>& id_lp);
+    void create_qsimlib_procs(std::map<int,int>& id_lp);
+    void create_qsimproxy_procs(std::map<int,int>& id_lp);
+    void create_trace_procs(std::map<int,int>& id_lp);
+
+#ifdef LIBKITFOX
+    void connect_proc_kitfox_proxy(KitFoxBuilder* kitfox_builder) {} //no power model for these cores
+#endif
+
+    void connect_proc_cache(CacheBuilder* cache_builder);
+    void connect_proc_qsim_proxy(QsimBuilder* qsim_builder);
+    void print_config(std::ostream&);
+    void print_stats(std::ostream&);
+private:
+    int m_l1_line_sz; //L1 line size
+    const char* m_server; //server name or IP
+    int m_port; //server port
+    Qsim::OSDomain* m_qsim_osd;
+    const char* m_trace; //trace file name
+};
+
+//#####################################################################
+//#####################################################################
+//replays memory-reference traces into the caches, with no core model
+class Replay_builder : public ProcBuilder {
+public:
+    Replay_builder(SysBuilder_llp* b) : ProcBuilder(b), m_mlp(16), m_issue_width(1) {}
+
+    ProcType get_proc_type() { return PROC_REPLAY; }
+
+    void read_config(libconfig::Config&);
+    void set_trace_vals(const char* trace) {
+        m_trace = trace;
+    }
+
+    void create_qsimclient_procs(std::map<int,int>& id_lp); //qsimclient not supported
+    void create_qsimlib_procs(std::map<int,int>& id_lp); //qsimlib not supported
+    void create_qsimproxy_procs(std::map<int,int>& id_lp); //qsimproxy not supported
+    void create_trace_procs(std::map<int,int>& id_lp);
+
+#ifdef LIBKITFOX
+    void connect_proc_kitfox_proxy(KitFoxBuilder* kitfox_builder) {} //no power model for these cores
+#endif
+
+    void connect_proc_cache(CacheBuilder* cache_builder);
+    void connect_proc_qsim_proxy(QsimBuilder* qsim_builder);
+    void print_config(std::ostream&);
+    void print_stats(std::ostream&);
+private:
+    int m_mlp; //max outstanding requests per processor
+    int m_issue_width; //max requests issued per cycle
+    const char* m_trace; //trace file name
+};
+
+
+#endif // #ifndef TRACE_PROC_BUILDER_H
@@ -1,9 +1,37 @@
 #ifndef MANIFOLD_UARCH_KITFOXCOUNTER_H
 #define MANIFOLD_UARCH_KITFOXCOUNTER_H
 
+#ifdef KITFOX_STUB
+/* Stand-ins for the libKitFox types the counters use, so the counters and
+   the stub energy model in models/kitfox/proxy build without libKitFox. */
+namespace libKitFox {
+
+typedef double Count;
+typedef int Comp_ID;
+
+class counter_t
+{
+public:
+    counter_t() { clear(); }
+
+    void clear() { switching = read = read_tag = write = write_tag = search = 0; }
+    counter_t operator*(const Count &c) const
+    {
+        counter_t r;
+        r.switching = switching*c; r.read = read*c; r.read_tag = read_tag*c;
+        r.write = write*c; r.write_tag = write_tag*c; r.search = search*c;
+        return r;
+    }
+
+    Count switching, read, read_tag, write, write_tag, search;
+};
+
+} // namespace libKitFox
+#else
 #include "kitfox-defs.h"
 #include "communicator/kitfox-client.h"
 #include "kitfox.h"
+#endif
 
 namespace manifold {
 namespace uarch {
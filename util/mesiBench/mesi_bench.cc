@@ -0,0 +1,178 @@
+// Micro-benchmark of the MESI client and manager protocol objects: every line
+// has its own client and manager, as in the caches, and each is driven through
+// a fixed round of legal transitions that covers the common requests, the
+// forwarded requests, the evictions and the invalidations. The messages sent
+// are hashed, so two builds of the coherence code can be checked to behave the
+// same, and timed.
+//
+// Usage: mesi_bench [-l lines] [-r rounds]
+//   -l  number of lines (default 4096)
+//   -r  rounds over all the lines (default 200)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdint.h>
+#include <vector>
+
+#include "MESI_client.h"
+#include "MESI_manager.h"
+
+using namespace std;
+using namespace manifold::mcp_cache_namespace;
+
+static uint64_t hash_val = 14695981039346656037ULL;
+static uint64_t num_msgs = 0;
+
+static void hash_msg(int a, int b, int c, int d)
+{
+  int v[4] = { a, b, c, d };
+  for(int i = 0; i < 4; i++) {
+    hash_val ^= (uint32_t)v[i];
+    hash_val *= 1099511628211ULL;
+  }
+}
+
+class Bench_client : public MESI_client
+{
+  public:
+    Bench_client(int id) : MESI_client(id) {}
+
+  protected:
+    void sendmsg(bool req, MESI_messages_t msg, int destID) { hash_msg(req, msg, destID, -2); }
+    void invalidate() { hash_msg(-3, 0, 0, 0); }
+};
+
+class Bench_manager : public MESI_manager
+{
+  public:
+    Bench_manager(int id) : MESI_manager(id) {}
+
+    void recv(int msg, int src) { num_msgs++; process(msg, src); }
+
+    bool process_lower_client_request(void*, bool) { return false; }
+    void process_lower_client_reply(void*) {}
+    bool is_invalidation_request(void*) { return false; }
+
+  protected:
+    void sendmsg(bool req, MESI_messages_t msg, int destID, int fwdID) { hash_msg(req, msg, destID, fwdID); }
+    void client_writeback() { hash_msg(-4, 0, 0, 0); }
+    void invalidate() { hash_msg(-5, 0, 0, 0); }
+    void ignore() { hash_msg(-6, 0, 0, 0); }
+};
+
+static void client_round(ClientInterface* c)
+{
+  static const int msgs[] = {
+    GET_S, MESI_MC_GRANT_E_DATA,    // I -> IE -> E
+    GET_E,                          // E -> M
+    MESI_MC_FWD_S,                  // M -> S
+    GET_E, MESI_MC_GRANT_E_DATA,    // S -> SE -> E
+    MESI_MC_FWD_E,                  // E -> I
+    GET_E, MESI_CC_M_DATA,          // I -> IE -> M
+    GET_EVICT, MESI_MC_GRANT_I,     // M -> MI -> I
+    GET_S, MESI_MC_GRANT_S_DATA,    // I -> IE -> S
+    MESI_MC_DEMAND_I,               // S -> I
+  };
+  for(unsigned i = 0; i < sizeof(msgs)/sizeof(msgs[0]); i++) {
+    num_msgs++;
+    c->process(msgs[i], 7);
+  }
+}
+
+static void manager_round(Bench_manager* m)
+{
+  m->recv(MESI_CM_I_to_S, 0);     // I -> IE
+  m->recv(MESI_CM_UNBLOCK_E, 0);  // -> E, owner 0
+  m->recv(MESI_CM_I_to_S, 1);     // E -> ES
+  m->recv(MESI_CM_UNBLOCK_S, 1);
+  m->recv(MESI_CM_CLEAN, 0);      // -> S {0,1}
+  m->recv(MESI_CM_I_to_S, 2);     // S -> SS
+  m->recv(MESI_CM_UNBLOCK_S, 2);  // -> S {0,1,2}
+  m->recv(MESI_CM_I_to_E, 0);     // S -> SIE, invalidates 1 and 2
+  m->recv(MESI_CM_UNBLOCK_I, 1);
+  m->recv(MESI_CM_UNBLOCK_I, 2);  // -> IE
+  m->recv(MESI_CM_UNBLOCK_E, 0);  // -> E, owner 0
+  m->recv(MESI_CM_I_to_E, 3);     // E -> EE
+  m->recv(MESI_CM_UNBLOCK_E, 3);  // -> E, owner 3
+  m->recv(MESI_CM_M_to_I, 3);     // E -> EI_PUT
+  m->recv(MESI_CM_UNBLOCK_I, 3);  // -> I
+  m->recv(MESI_CM_I_to_E, 4);     // I -> IE
+  m->recv(MESI_CM_UNBLOCK_E, 4);  // -> E, owner 4
+  m->recv(GET_EVICT, 0);          // E -> EI_EVICT
+  m->recv(MESI_CM_UNBLOCK_I_DIRTY, 4); // -> I
+  m->recv(MESI_CM_I_to_E, 5);     // I -> IE
+  m->recv(MESI_CM_UNBLOCK_E, 5);  // -> E, owner 5
+  m->recv(MESI_CM_I_to_S, 6);     // E -> ES
+  m->recv(MESI_CM_WRITEBACK, 5);
+  m->recv(MESI_CM_UNBLOCK_S, 6);  // -> S {5,6}
+  m->recv(GET_EVICT, 0);          // S -> SI_EVICT
+  m->recv(MESI_CM_UNBLOCK_I, 5);
+  m->recv(MESI_CM_UNBLOCK_I, 6);  // -> I
+}
+
+static double now_sec()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+  int num_lines = 4096;
+  int rounds = 200;
+
+  int opt;
+  while((opt = getopt(argc, argv, "l:r:")) != -1) {
+    switch(opt) {
+      case 'l': num_lines = atoi(optarg); break;
+      case 'r': rounds = atoi(optarg); break;
+      default:
+        fprintf(stderr, "Usage: %s [-l lines] [-r rounds]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  vector<ClientInterface*> clients;
+  vector<Bench_manager*> managers;
+  for(int i = 0; i < num_lines; i++) {
+    clients.push_back(new Bench_client(i));
+    managers.push_back(new Bench_manager(i));
+  }
+
+  //visit the lines in a fixed scattered order
+  vector<int> order(num_lines);
+  for(int i = 0; i < num_lines; i++)
+    order[i] = i;
+  srand(1);
+  for(int i = num_lines - 1; i > 0; i--) {
+    int j = rand() % (i + 1);
+    int t = order[i]; order[i] = order[j]; order[j] = t;
+  }
+
+  double start = now_sec();
+  for(int r = 0; r < rounds; r++)
+    for(int i = 0; i < num_lines; i++)
+      client_round(clients[order[i]]);
+  double client_sec = now_sec() - start;
+  uint64_t client_msgs = num_msgs;
+
+  start = now_sec();
+  for(int r = 0; r < rounds; r++)
+    for(int i = 0; i < num_lines; i++)
+      manager_round(managers[order[i]]);
+  double manager_sec = now_sec() - start;
+  uint64_t manager_msgs = num_msgs - client_msgs;
+
+  printf("client:  %llu msgs, %.2f ns/msg\n", (unsigned long long)client_msgs, client_sec * 1e9 / client_msgs);
+  printf("manager: %llu msgs, %.2f ns/msg\n", (unsigned long long)manager_msgs, manager_sec * 1e9 / manager_msgs);
+  printf("hash: %016llx\n", (unsigned long long)hash_val);
+
+  for(int i = 0; i < num_lines; i++) {
+    delete clients[i];
+    delete managers[i];
+  }
+  return 0;
+}
@@ -0,0 +1,128 @@
+// Prints the samples written by an LP (MANIFOLD_SAMPLE) as CSV, one row per
+// sample and one column per counter.
+//
+// Usage: sample_dump [-d] [-c name,...] <prefix>.lp<N>.samples
+//   -d  print the change of each counter since the previous row instead of
+//       its value, e.g. instructions committed per interval
+//   -c  only print the columns whose names contain one of the given strings
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "kernel/stat_sampler.h"
+
+using namespace std;
+using namespace manifold::kernel;
+
+
+static void Usage(const char* prog)
+{
+  cerr << "Usage: " << prog << " [-d] [-c name,...] <samples file>\n";
+  exit(1);
+}
+
+
+static void Read(FILE* f, void* p, size_t n, const char* name)
+{
+  if (fread(p, 1, n, f) != n) {
+    cerr << name << " is truncated\n";
+    exit(1);
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  bool delta = false;
+  vector<string> filters;
+  int opt;
+  while ((opt = getopt(argc, argv, "dc:")) != -1) {
+    switch (opt) {
+      case 'd': delta = true; break;
+      case 'c': {
+        string s = optarg;
+        size_t start = 0;
+        while (start <= s.size()) {
+          size_t comma = s.find(',', start);
+          if (comma == string::npos)
+            comma = s.size();
+          if (comma > start)
+            filters.push_back(s.substr(start, comma - start));
+          start = comma + 1;
+        }
+        break;
+      }
+      default: Usage(argv[0]);
+    }
+  }
+  if (optind != argc - 1)
+    Usage(argv[0]);
+  const char* name = argv[optind];
+
+  FILE* f = fopen(name, "rb");
+  if (f == 0) {
+    cerr << "cannot open " << name << endl;
+    exit(1);
+  }
+
+  Stat_sample_header h;
+  if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != STAT_SAMPLE_MAGIC) {
+    cerr << name << " is not a samples file\n";
+    exit(1);
+  }
+  if (h.version != STAT_SAMPLE_VERSION) {
+    cerr << name << ": version " << h.version << " is not supported\n";
+    exit(1);
+  }
+
+  vector<string> columns(h.num_columns);
+  vector<bool> shown(h.num_columns, true);
+  for (uint32_t i = 0; i < h.num_columns; i++) {
+    uint32_t len;
+    Read(f, &len, sizeof(len), name);
+    columns[i].resize(len);
+    if (len)
+      Read(f, &columns[i][0], len, name);
+
+    if (i > 0 && !filters.empty()) {
+      shown[i] = false;
+      for (size_t j = 0; j < filters.size(); j++)
+        if (columns[i].find(filters[j]) != string::npos)
+          shown[i] = true;
+    }
+  }
+
+  printf("# lp %d, a row every %llu ticks of %g s\n", h.lp, (unsigned long long)h.interval, h.period);
+  for (uint32_t i = 0; i < h.num_columns; i++)
+    if (shown[i])
+      printf("%s%s", i ? "," : "", columns[i].c_str());
+  printf("\n");
+
+  vector<double> prev(h.num_columns, 0);
+  uint32_t rows;
+  while (fread(&rows, sizeof(rows), 1, f) == 1) {
+    vector<double> block((size_t)rows * h.num_columns);
+    if (rows)
+      Read(f, &block[0], block.size() * sizeof(double), name);
+
+    for (uint32_t r = 0; r < rows; r++) {
+      for (uint32_t i = 0; i < h.num_columns; i++) {
+        double v = block[(size_t)i * rows + r];
+        if (shown[i]) {
+          // the tick column is always absolute
+          double out = (delta && i > 0) ? v - prev[i] : v;
+          printf("%s%.17g", i ? "," : "", out);
+        }
+        prev[i] = v;
+      }
+      printf("\n");
+    }
+  }
+  fclose(f);
+  return 0;
+}
@@ -0,0 +1,277 @@
+// Merges the synchronization telemetry logs written by the LPs of a parallel
+// simulation (MANIFOLD_SYNC_LOG) and finds the LPs on the critical path.
+//
+// Usage: sync_merge [-t] [-c timeline.csv] <prefix>.lp0.sync <prefix>.lp1.sync ...
+//   -t  print one line per bucket of simulated time
+//   -c  write the per-LP timeline to a CSV file
+//
+// In each bucket, the critical LP is found by starting from the LP that was
+// blocked the longest and following the predecessor it waited on the most,
+// until reaching an LP that was blocked for less than half of its time; that
+// LP held the others back. If the LPs on the way all wait on each other, the
+// one among them that was blocked the least is taken.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "kernel/sync_telemetry.h"
+
+using namespace std;
+using namespace manifold::kernel;
+
+struct Lp_bucket
+{
+  Lp_bucket() { memset(&b, 0, sizeof(b)); }
+  Sync_log_bucket b;
+  map<int, Sync_log_constraint> constraints;
+};
+
+typedef map<int, Lp_bucket> Bucket_lps; //by LP
+
+struct Lp_total
+{
+  Lp_total() : wall_ns(0), blocked_ns(0), blocks(0), null_sent(0), null_recv(0),
+               syncs(0), window(0), used(0), critical(0) {}
+  uint64_t wall_ns;
+  uint64_t blocked_ns;
+  uint64_t blocks;
+  uint64_t null_sent;
+  uint64_t null_recv;
+  uint64_t syncs;
+  double window;
+  double used;
+  unsigned critical; //buckets in which the LP was critical
+  map<int, uint64_t> blame; //blocked ns by predecessor
+};
+
+
+static void Usage(const char* prog)
+{
+  cerr << "Usage: " << prog << " [-t] [-c timeline.csv] <log>...\n";
+  exit(1);
+}
+
+
+static double Fraction(uint64_t part, uint64_t whole)
+{
+  return whole ? (double)part / whole : 0;
+}
+
+
+//! Reads one log into buckets; returns the bucket width.
+static double Read_log(const char* name, map<uint64_t, Bucket_lps>& buckets, set<int>& lps)
+{
+  FILE* f = fopen(name, "rb");
+  if (f == 0) {
+    cerr << "cannot open " << name << endl;
+    exit(1);
+  }
+
+  Sync_log_header h;
+  if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != SYNC_LOG_MAGIC) {
+    cerr << name << " is not a sync telemetry log\n";
+    exit(1);
+  }
+  if (h.version != SYNC_LOG_VERSION) {
+    cerr << name << ": version " << h.version << " is not supported\n";
+    exit(1);
+  }
+  if (lps.count(h.lp)) {
+    cerr << name << ": LP " << h.lp << " given twice\n";
+    exit(1);
+  }
+  lps.insert(h.lp);
+
+  Sync_log_bucket b;
+  while (fread(&b, sizeof(b), 1, f) == 1) {
+    // Buckets are written whenever the LP moves on, so one may appear twice
+    // if the LP went back in time; add them up.
+    Lp_bucket& lb = buckets[b.bucket][h.lp];
+    lb.b.bucket = b.bucket;
+    lb.b.wall_ns += b.wall_ns;
+    lb.b.blocked_ns += b.blocked_ns;
+    lb.b.blocks += b.blocks;
+    lb.b.null_sent += b.null_sent;
+    lb.b.null_recv += b.null_recv;
+    lb.b.syncs += b.syncs;
+    lb.b.window += b.window;
+    lb.b.used += b.used;
+
+    for (uint32_t i = 0; i < b.num_constraints; i++) {
+      Sync_log_constraint c;
+      if (fread(&c, sizeof(c), 1, f) != 1) {
+        cerr << name << " is truncated\n";
+        exit(1);
+      }
+      Sync_log_constraint& lc = lb.constraints[c.lp];
+      lc.lp = c.lp;
+      lc.blocks += c.blocks;
+      lc.blocked_ns += c.blocked_ns;
+    }
+  }
+  fclose(f);
+  return h.bucket_width;
+}
+
+
+//! LP holding the others back in one bucket, or -1 if no LP was blocked.
+static int Critical_lp(const Bucket_lps& lps)
+{
+  int lp = -1;
+  double most = 0;
+  for (Bucket_lps::const_iterator it = lps.begin(); it != lps.end(); ++it) {
+    double blocked = Fraction(it->second.b.blocked_ns, it->second.b.wall_ns);
+    if (blocked > most) {
+      most = blocked;
+      lp = it->first;
+    }
+  }
+  if (lp < 0)
+    return -1;
+  int least = lp;
+
+  set<int> visited;
+  while (visited.insert(lp).second) {
+    Bucket_lps::const_iterator cur = lps.find(lp);
+    if (cur == lps.end())
+      return lp;
+    double blocked = Fraction(cur->second.b.blocked_ns, cur->second.b.wall_ns);
+    if (blocked < 0.5)
+      return lp;
+    if (blocked < most) {
+      most = blocked;
+      least = lp;
+    }
+
+    // heaviest edge to a single predecessor; barriers and messages in
+    // flight (-1) point at no one
+    int next = -1;
+    uint64_t heaviest = 0;
+    const map<int, Sync_log_constraint>& cs = cur->second.constraints;
+    for (map<int, Sync_log_constraint>::const_iterator c = cs.begin(); c != cs.end(); ++c) {
+      if (c->first >= 0 && c->second.blocked_ns > heaviest) {
+        heaviest = c->second.blocked_ns;
+        next = c->first;
+      }
+    }
+    if (next < 0)
+      return lp;
+    lp = next;
+  }
+
+  // LPs that all wait on each other: the one that waited the least is the
+  // one the others catch up with
+  return least;
+}
+
+
+int main(int argc, char** argv)
+{
+  bool timeline = false;
+  const char* csv_name = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "tc:")) != -1) {
+    switch (opt) {
+      case 't': timeline = true; break;
+      case 'c': csv_name = optarg; break;
+      default: Usage(argv[0]);
+    }
+  }
+  if (optind == argc)
+    Usage(argv[0]);
+
+  map<uint64_t, Bucket_lps> buckets;
+  set<int> lps;
+  double width = 0;
+  for (int i = optind; i < argc; i++) {
+    double w = Read_log(argv[i], buckets, lps);
+    if (width != 0 && w != width) {
+      cerr << argv[i] << ": bucket width " << w << " differs from " << width << endl;
+      exit(1);
+    }
+    width = w;
+  }
+
+  ofstream csv;
+  if (csv_name) {
+    csv.open(csv_name);
+    if (!csv) {
+      cerr << "cannot write " << csv_name << endl;
+      exit(1);
+    }
+    csv << "time,lp,wall_ns,blocked_ns,blocked_frac,blocks,lookahead_used,null_sent,null_recv,syncs,top_constraint,critical\n";
+  }
+
+  map<int, Lp_total> totals;
+  for (map<uint64_t, Bucket_lps>::iterator bit = buckets.begin(); bit != buckets.end(); ++bit) {
+    double time = bit->first * width;
+    int critical = Critical_lp(bit->second);
+    if (critical >= 0)
+      totals[critical].critical++;
+
+    if (timeline)
+      printf("%-12g critical %3d |", time, critical);
+
+    for (Bucket_lps::iterator it = bit->second.begin(); it != bit->second.end(); ++it) {
+      const Sync_log_bucket& b = it->second.b;
+      Lp_total& t = totals[it->first];
+      t.wall_ns += b.wall_ns;
+      t.blocked_ns += b.blocked_ns;
+      t.blocks += b.blocks;
+      t.null_sent += b.null_sent;
+      t.null_recv += b.null_recv;
+      t.syncs += b.syncs;
+      t.window += b.window;
+      t.used += b.used;
+
+      int top = -1;
+      uint64_t heaviest = 0;
+      for (map<int, Sync_log_constraint>::iterator c = it->second.constraints.begin();
+           c != it->second.constraints.end(); ++c) {
+        t.blame[c->first] += c->second.blocked_ns;
+        if (c->second.blocked_ns > heaviest) {
+          heaviest = c->second.blocked_ns;
+          top = c->first;
+        }
+      }
+
+      double util = b.window > 0 ? b.used / b.window : 0;
+      if (timeline)
+        printf(" lp%d %5.1f%% blk %5.1f%% la %u/%u null", it->first,
+               100 * Fraction(b.blocked_ns, b.wall_ns), 100 * util, b.null_sent, b.null_recv);
+      if (csv_name)
+        csv << time << "," << it->first << "," << b.wall_ns << "," << b.blocked_ns << ","
+            << Fraction(b.blocked_ns, b.wall_ns) << "," << b.blocks << "," << util << ","
+            << b.null_sent << "," << b.null_recv << "," << b.syncs << ","
+            << top << "," << (it->first == critical) << "\n";
+    }
+    if (timeline)
+      printf("\n");
+  }
+
+  printf("%zu LPs, %zu buckets of %g s\n\n", lps.size(), buckets.size(), width);
+  printf("%4s %12s %8s %10s %8s %12s %12s %10s %9s  %s\n", "lp", "wall_ms", "blocked", "blocks",
+         "la_used", "null_sent", "null_recv", "syncs", "critical", "blocked on (share of blocked time)");
+  for (map<int, Lp_total>::iterator it = totals.begin(); it != totals.end(); ++it) {
+    const Lp_total& t = it->second;
+    printf("%4d %12.3f %7.1f%% %10lu %7.1f%% %12lu %12lu %10lu %9u ", it->first, t.wall_ns / 1e6,
+           100 * Fraction(t.blocked_ns, t.wall_ns), (unsigned long)t.blocks,
+           t.window > 0 ? 100 * t.used / t.window : 0.0,
+           (unsigned long)t.null_sent, (unsigned long)t.null_recv, (unsigned long)t.syncs, t.critical);
+    for (map<int, uint64_t>::const_iterator b = t.blame.begin(); b != t.blame.end(); ++b) {
+      if (b->first < 0)
+        printf(" sync:%.0f%%", 100 * Fraction(b->second, t.blocked_ns));
+      else
+        printf(" lp%d:%.0f%%", b->first, 100 * Fraction(b->second, t.blocked_ns));
+    }
+    printf("\n");
+  }
+  return 0;
+}
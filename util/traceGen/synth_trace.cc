@@ -0,0 +1,379 @@
+// Writes synthetic per-core traces, so that the trace-driven simulators in
+// simulator/smp/Trace can be run without QSim.
+//
+// Usage: synth_trace [options] <basename>
+//   -f zesto|simple  trace format: zesto trace-core (default) or simple-proc
+//                    TraceProcessor
+//   -n insns         instructions per core (default 100000)
+//   -c cores         number of cores, i.e. files <basename>0 ... (default 16)
+//   -s seed          seed of the address and branch streams (default 1)
+//   -m ld,st,br      fractions of loads, stores and branches (default
+//                    0.25,0.1,0.05); the rest are ALU operations
+//   -L len           instructions in the loop body, at most 64 (default 32)
+//   -w bytes         private working set of each core (default 64K); for
+//                    zesto, those of all cores must fit below 4G
+//   -p stride|random access pattern in the working sets (default stride)
+//   -d bytes         stride (default 8)
+//   -S bytes         size of each shared region (default 16K); all shared
+//                    regions must fit in 128M
+//   -h frac          fraction of accesses that go to the shared region
+//                    (default 0.125)
+//   -g cores         sharing degree: cores per shared region (default: all)
+//   -t frac          fraction of the branches inside the body that are taken
+//                    (default 0.5)
+//   -r frac          fraction of the branches whose outcome is random rather
+//                    than fixed for the branch (default 0.1)
+// Sizes take a K, M or G suffix.
+//
+// Each core runs a loop whose body is built once from the mix, so that an
+// address always holds the same instruction. The last instruction of the
+// body is a branch back to the top; a taken branch inside the body skips the
+// next instruction. Private accesses of core c go to its own working set;
+// shared accesses of cores c/g*g ... c/g*g+g-1 go to the same region, at a
+// random cache line.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+enum Op { ALU, LOAD, STORE, BRANCH };
+
+static const unsigned Max_body_len = 64; //so the back branch fits a rel8
+static const uint64_t Code_base = 0x400000;
+static const uint64_t Private_base = 0x10000000;
+static const uint64_t Private_align = 0x1000000;
+static const uint64_t Shared_base = 0x8000000;
+static const uint64_t Shared_align = 0x100000;
+static const uint64_t Line_size = 64;
+
+struct Params
+{
+  Params() : zesto(true), n(100000), cores(16), seed(1), ld(0.25), st(0.1), br(0.05),
+             body_len(32), wset(64 << 10), random(false), stride(8), shared(16 << 10),
+             share_frac(0.125), degree(0), taken(0.5), random_br(0.1) {}
+  bool zesto;
+  uint64_t n;
+  unsigned cores;
+  uint64_t seed;
+  double ld, st, br;
+  unsigned body_len;
+  uint64_t wset;
+  bool random;
+  uint64_t stride;
+  uint64_t shared;
+  double share_frac;
+  unsigned degree;
+  double taken;
+  double random_br;
+};
+
+struct Slot
+{
+  Op op;
+  bool random; //branch outcome drawn each time
+  bool taken; //fixed outcome otherwise
+};
+
+
+static void Usage(const char* prog)
+{
+  cerr << "Usage: " << prog << " [-f zesto|simple] [-n insns] [-c cores] [-s seed] [-m ld,st,br]\n"
+       << "       [-L len] [-w bytes] [-p stride|random] [-d stride] [-S bytes] [-h frac]\n"
+       << "       [-g cores] [-t frac] [-r frac] <basename>\n";
+  exit(1);
+}
+
+
+static uint64_t Size(const char* s)
+{
+  char* end;
+  uint64_t v = strtoull(s, &end, 0);
+  switch (*end) {
+    case 'k': case 'K': v <<= 10; break;
+    case 'm': case 'M': v <<= 20; break;
+    case 'g': case 'G': v <<= 30; break;
+  }
+  return v;
+}
+
+
+//! xorshift64*
+class Rng
+{
+ public:
+  Rng(uint64_t seed) : s(seed ? seed : 1) {}
+  uint64_t next()
+  {
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return s * 0x2545f4914f6cdd1dULL;
+  }
+  double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+ private:
+  uint64_t s;
+};
+
+
+//! Appends text to a buffer, with the hex conversion done by hand: printf
+//! would be the bottleneck.
+class Out
+{
+ public:
+  Out(FILE* f) : file(f), len(0) {}
+  ~Out() { flush(); }
+
+  void str(const char* s, unsigned n)
+  {
+    memcpy(buf + len, s, n);
+    len += n;
+  }
+
+  void hex(uint64_t v)
+  {
+    char tmp[16];
+    int i = 16;
+    do {
+      tmp[--i] = "0123456789abcdef"[v & 0xf];
+      v >>= 4;
+    } while (v);
+    str(tmp + i, 16 - i);
+  }
+
+  void line()
+  {
+    buf[len++] = '\n';
+    if (len > sizeof(buf) - 256)
+      flush();
+  }
+
+  void flush()
+  {
+    fwrite(buf, 1, len, file);
+    len = 0;
+  }
+
+ private:
+  FILE* file;
+  unsigned len;
+  char buf[1 << 20];
+};
+
+
+//! The loop body: ops in proportion to the mix, in a fixed random order.
+static vector<Slot> Make_body(const Params& p, Rng& rng)
+{
+  vector<Slot> body(p.body_len);
+  unsigned n = p.body_len - 1; //the last slot is the back branch
+  unsigned nld = (unsigned)(p.ld * p.body_len + 0.5);
+  unsigned nst = (unsigned)(p.st * p.body_len + 0.5);
+  unsigned nbr = (unsigned)(p.br * p.body_len + 0.5);
+  nbr = nbr > 0 ? nbr - 1 : 0;
+  for (unsigned i = 0; i < n; i++) {
+    Slot s = { ALU, false, false };
+    if (i < nld)
+      s.op = LOAD;
+    else if (i < nld + nst)
+      s.op = STORE;
+    else if (i < nld + nst + nbr)
+      s.op = BRANCH;
+    body[i] = s;
+  }
+  for (unsigned i = n - 1; i > 0; i--) {
+    unsigned j = rng.next() % (i + 1);
+    Slot t = body[i];
+    body[i] = body[j];
+    body[j] = t;
+  }
+  for (unsigned i = 0; i < n; i++) {
+    if (body[i].op == BRANCH) {
+      body[i].random = rng.uniform() < p.random_br;
+      body[i].taken = rng.uniform() < p.taken;
+    }
+  }
+  Slot back = { BRANCH, false, true };
+  body[n] = back;
+  return body;
+}
+
+
+//! Distance between the working sets of two cores
+static uint64_t Spacing(const Params& p)
+{
+  return (p.wset + Private_align - 1) & ~(Private_align - 1);
+}
+
+
+//! Distance between two shared regions
+static uint64_t Shared_spacing(const Params& p)
+{
+  return (p.shared + Shared_align - 1) & ~(Shared_align - 1);
+}
+
+
+static void Write_core(FILE* f, const Params& p, unsigned core)
+{
+  Rng rng(p.seed * 0x9e3779b97f4a7c15ULL + core + 1);
+  Rng body_rng(p.seed);
+  vector<Slot> body = Make_body(p, body_rng); //same code on all cores
+
+  uint64_t priv = Private_base + core * Spacing(p);
+  unsigned group = p.degree ? core / p.degree : 0;
+  uint64_t shared = Shared_base + group * Shared_spacing(p);
+  uint64_t shared_lines = p.shared / Line_size;
+  uint64_t wset_words = p.wset / 8;
+  uint64_t offset = 0;
+  Out out(f);
+
+  unsigned slot = 0;
+  for (uint64_t i = 0; i < p.n; i++) {
+    const Slot& s = body[slot];
+    uint64_t pc = Code_base + 2 * slot;
+    uint64_t addr = 0;
+    if (s.op == LOAD || s.op == STORE) {
+      if (shared_lines && rng.uniform() < p.share_frac)
+        addr = shared + (rng.next() % shared_lines) * Line_size;
+      else if (p.random)
+        addr = priv + (rng.next() % wset_words) * 8;
+      else {
+        addr = priv + offset;
+        offset = (offset + p.stride) % p.wset;
+      }
+    }
+    bool taken = false;
+    if (s.op == BRANCH)
+      taken = s.random ? (rng.next() & 1) : s.taken;
+
+    if (p.zesto) {
+      out.str("0x", 2);
+      out.hex(pc);
+      switch (s.op) {
+        case ALU: out.str(" 2 0 1 d8 ", 10); break; //add eax,ebx
+        case LOAD: out.str(" 2 1 8b 3 ", 10); break; //mov eax,[ebx]
+        case STORE: out.str(" 2 1 89 3 ", 10); break; //mov [ebx],eax
+        case BRANCH:
+          if (slot == p.body_len - 1) {
+            // jnz back to the top
+            unsigned char rel = (unsigned char)(-2 * (int)p.body_len);
+            out.str(" 2 0 75 ", 8);
+            out.hex(rel);
+            out.str(" ", 1);
+          }
+          else
+            out.str(" 2 0 75 2 ", 10); //jnz over the next instruction
+          break;
+      }
+      out.line();
+      if (s.op == LOAD || s.op == STORE) {
+        out.str(s.op == LOAD ? "0x0 0x" : "0x1 0x", 6);
+        out.hex(addr);
+        out.str(" 4", 2);
+        out.line();
+      }
+    }
+    else {
+      switch (s.op) {
+        case LOAD: out.str("0 ", 2); out.hex(addr); break;
+        case STORE: out.str("1 ", 2); out.hex(addr); break;
+        default: out.str("2", 1); break;
+      }
+      out.line();
+    }
+
+    if (slot == p.body_len - 1)
+      slot = 0;
+    else if (taken && slot + 2 < p.body_len)
+      slot += 2;
+    else
+      slot++;
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  Params p;
+  int opt;
+  while ((opt = getopt(argc, argv, "f:n:c:s:m:L:w:p:d:S:h:g:t:r:")) != -1) {
+    switch (opt) {
+      case 'f':
+        if (strcmp(optarg, "zesto") == 0)
+          p.zesto = true;
+        else if (strcmp(optarg, "simple") == 0)
+          p.zesto = false;
+        else
+          Usage(argv[0]);
+        break;
+      case 'n': p.n = Size(optarg); break;
+      case 'c': p.cores = atoi(optarg); break;
+      case 's': p.seed = strtoull(optarg, 0, 0); break;
+      case 'm':
+        if (sscanf(optarg, "%lf,%lf,%lf", &p.ld, &p.st, &p.br) != 3)
+          Usage(argv[0]);
+        break;
+      case 'L': p.body_len = atoi(optarg); break;
+      case 'w': p.wset = Size(optarg); break;
+      case 'p':
+        if (strcmp(optarg, "stride") == 0)
+          p.random = false;
+        else if (strcmp(optarg, "random") == 0)
+          p.random = true;
+        else
+          Usage(argv[0]);
+        break;
+      case 'd': p.stride = Size(optarg); break;
+      case 'S': p.shared = Size(optarg); break;
+      case 'h': p.share_frac = atof(optarg); break;
+      case 'g': p.degree = atoi(optarg); break;
+      case 't': p.taken = atof(optarg); break;
+      case 'r': p.random_br = atof(optarg); break;
+      default: Usage(argv[0]);
+    }
+  }
+  if (optind != argc - 1 || p.cores == 0)
+    Usage(argv[0]);
+  if (p.body_len < 2 || p.body_len > Max_body_len) {
+    cerr << "the loop body must have 2 to " << Max_body_len << " instructions\n";
+    exit(1);
+  }
+  if (p.ld < 0 || p.st < 0 || p.br < 0 || p.ld + p.st + p.br > 1) {
+    cerr << "the fractions of the mix must add up to at most 1\n";
+    exit(1);
+  }
+  if (p.wset < 8 || p.stride == 0 || p.stride % 8 != 0 || p.wset % 8 != 0) {
+    cerr << "the working set and the stride must be multiples of 8 bytes\n";
+    exit(1);
+  }
+  // the shared regions lie between Shared_base and Private_base, so with
+  // this check the private limit below also covers them
+  unsigned groups = p.degree ? (p.cores + p.degree - 1) / p.degree : 1;
+  if (Shared_base + groups * Shared_spacing(p) > Private_base) {
+    cerr << "the " << groups << " shared regions must fit in "
+         << (Private_base - Shared_base) / 1024 / 1024 << "M\n";
+    exit(1);
+  }
+  if (p.zesto && Private_base + p.cores * Spacing(p) > 0x100000000ULL) {
+    // zesto addresses are 32 bits
+    cerr << "the working sets of all cores must fit below 4G for zesto\n";
+    exit(1);
+  }
+
+  for (unsigned c = 0; c < p.cores; c++) {
+    char name[1024];
+    snprintf(name, sizeof(name), "%s%u", argv[optind], c);
+    FILE* f = fopen(name, "w");
+    if (f == 0) {
+      cerr << "cannot write " << name << endl;
+      exit(1);
+    }
+    Write_core(f, p, c);
+    fclose(f);
+  }
+  return 0;
+}